@@ -0,0 +1,54 @@
+#pragma once
+
+#include <core/matrix.hpp>
+#include <core/vector.hpp>
+
+#include <cstddef>
+#include <random>
+
+namespace bench
+{
+    // Inputs are generated at run time so that the compiler cannot fold the
+    // benchmarked expressions into constants.
+    inline std::mt19937& input_engine()
+    {
+        static std::mt19937 engine{0x61706f6c};
+        return engine;
+    }
+
+    template<typename T>
+    T random_real(T lo = T{-1}, T hi = T{1})
+    {
+        std::uniform_real_distribution<T> dist{lo, hi};
+        return dist(input_engine());
+    }
+
+    template<typename T, std::size_t N>
+    core::Vector<T, N> random_vector()
+    {
+        core::Vector<T, N> out;
+        for (std::size_t i{0}; i < N; ++i)
+        {
+            out[i] = random_real<T>();
+        }
+
+        return out;
+    }
+
+    // Diagonally dominant, so it always has an inverse.
+    template<typename T>
+    core::Matrix<T> random_matrix()
+    {
+        core::Matrix<T> out;
+        for (std::size_t i{0}; i < core::Matrix<T>::num_rows; ++i)
+        {
+            for (std::size_t j{0}; j < core::Matrix<T>::num_cols; ++j)
+            {
+                out(i, j) = (i == j) ? random_real<T>(T{4}, T{8})
+                                     : random_real<T>();
+            }
+        }
+
+        return out;
+    }
+} // namespace bench
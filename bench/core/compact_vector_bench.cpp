@@ -0,0 +1,66 @@
+#include "bench_inputs.hpp"
+
+#include <core/compact_vector.hpp>
+
+#include <catch2/catch.hpp>
+#include <vector>
+
+TEMPLATE_TEST_CASE("[compact_vector] - decode", "[core]", float, double)
+{
+    using Vector = core::Vector3<TestType>;
+
+    // Enough vertices to stream through the cache, as meshes do.
+    constexpr std::size_t count{4096};
+
+    std::vector<Vector> vectors(count);
+    std::vector<core::OctNormal> normals(count);
+    std::vector<core::HalfVector3> halves(count);
+    std::vector<core::QuantisedPoint3> points(count);
+    core::PointQuantiser<TestType> quantiser{core::Bounds3<TestType>{
+        Vector{TestType{-1}}, Vector{TestType{1}}}};
+    for (std::size_t i{0}; i < count; ++i)
+    {
+        vectors[i] = core::normalise(bench::random_vector<TestType, 3>());
+        normals[i] = core::OctNormal{vectors[i]};
+        halves[i]  = core::HalfVector3{vectors[i]};
+        points[i]  = quantiser.encode(vectors[i]);
+    }
+
+    std::vector<Vector> out(count);
+
+    BENCHMARK("Copy")
+    {
+        for (std::size_t i{0}; i < count; ++i)
+        {
+            out[i] = vectors[i];
+        }
+        return out[count - 1];
+    };
+
+    BENCHMARK("OctNormal")
+    {
+        for (std::size_t i{0}; i < count; ++i)
+        {
+            out[i] = normals[i].template decode<TestType>();
+        }
+        return out[count - 1];
+    };
+
+    BENCHMARK("HalfVector3")
+    {
+        for (std::size_t i{0}; i < count; ++i)
+        {
+            out[i] = halves[i].template decode<TestType>();
+        }
+        return out[count - 1];
+    };
+
+    BENCHMARK("QuantisedPoint3")
+    {
+        for (std::size_t i{0}; i < count; ++i)
+        {
+            out[i] = quantiser.decode(points[i]);
+        }
+        return out[count - 1];
+    };
+}
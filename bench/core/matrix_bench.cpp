@@ -0,0 +1,174 @@
+#include "bench_inputs.hpp"
+
+#include <core/matrix.hpp>
+
+#include <array>
+#include <catch2/catch.hpp>
+
+TEMPLATE_TEST_CASE("[Matrix] - construction and access",
+                   "[core]",
+                   float,
+                   double)
+{
+    using Matrix = core::Matrix<TestType>;
+
+    auto m{bench::random_matrix<TestType>()};
+    auto d{bench::random_real<TestType>()};
+    auto elems{m.data};
+    std::size_t i{static_cast<std::size_t>(d > 0)};
+
+    BENCHMARK("Empty constructor")
+    {
+        return Matrix{};
+    };
+
+    BENCHMARK("Diagonal constructor")
+    {
+        return Matrix(d);
+    };
+
+    BENCHMARK("Initializer list constructor")
+    {
+        return Matrix{{d, d, d, d, d, d, d, d, d, d, d, d, d, d, d, d}};
+    };
+
+    BENCHMARK("Array constructor")
+    {
+        return Matrix{elems};
+    };
+
+    BENCHMARK("row")
+    {
+        return m.row(i);
+    };
+
+    BENCHMARK("col")
+    {
+        return m.col(i);
+    };
+
+    BENCHMARK("operator()")
+    {
+        return m(i, i + 1);
+    };
+}
+
+TEMPLATE_TEST_CASE("[Matrix] - operators", "[core]", float, double)
+{
+    using Matrix = core::Matrix<TestType>;
+
+    auto a{bench::random_matrix<TestType>()};
+    auto b{bench::random_matrix<TestType>()};
+    auto v{bench::random_vector<TestType, 4>()};
+    auto s{bench::random_real<TestType>(TestType{1}, TestType{2})};
+
+    BENCHMARK("unary_op")
+    {
+        return core::unary_op(a, [s](TestType x) { return x * s; });
+    };
+
+    BENCHMARK("binary_op")
+    {
+        return core::binary_op(
+            a, b, [](TestType x, TestType y) { return x * y; });
+    };
+
+    BENCHMARK("operator+=")
+    {
+        Matrix out{a};
+        out += b;
+        return out;
+    };
+
+    BENCHMARK("operator-=")
+    {
+        Matrix out{a};
+        out -= b;
+        return out;
+    };
+
+    BENCHMARK("operator*= (scalar)")
+    {
+        Matrix out{a};
+        out *= s;
+        return out;
+    };
+
+    BENCHMARK("operator*= (matrix)")
+    {
+        Matrix out{a};
+        out *= b;
+        return out;
+    };
+
+    BENCHMARK("Unary operator-")
+    {
+        return -a;
+    };
+
+    BENCHMARK("operator==")
+    {
+        return a == b;
+    };
+
+    BENCHMARK("operator!=")
+    {
+        return a != b;
+    };
+
+    BENCHMARK("operator+")
+    {
+        return a + b;
+    };
+
+    BENCHMARK("operator-")
+    {
+        return a - b;
+    };
+
+    BENCHMARK("operator* (matrix, scalar)")
+    {
+        return a * s;
+    };
+
+    BENCHMARK("operator* (scalar, matrix)")
+    {
+        return s * a;
+    };
+
+    BENCHMARK("operator* (matrix, matrix)")
+    {
+        return a * b;
+    };
+
+    BENCHMARK("operator* (matrix, vector)")
+    {
+        return a * v;
+    };
+}
+
+TEMPLATE_TEST_CASE("[Matrix] - functions", "[core]", float, double)
+{
+    auto a{bench::random_matrix<TestType>()};
+    core::Matrix<TestType> identity(TestType{1});
+
+    BENCHMARK("transpose")
+    {
+        return core::transpose(a);
+    };
+
+    BENCHMARK("inverse")
+    {
+        return core::inverse(a);
+    };
+
+    BENCHMARK("is_identity (early exit)")
+    {
+        return core::is_identity(a);
+    };
+
+    BENCHMARK("is_identity (full scan)")
+    {
+        return core::is_identity(identity);
+    };
+}
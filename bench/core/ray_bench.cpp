@@ -0,0 +1,31 @@
+#include "bench_inputs.hpp"
+
+#include <core/ray.hpp>
+
+#include <catch2/catch.hpp>
+#include <sstream>
+
+TEMPLATE_TEST_CASE("[Ray] - functions", "[core]", float, double)
+{
+    auto o{bench::random_vector<TestType, 3>()};
+    auto d{bench::random_vector<TestType, 3>()};
+    auto t{bench::random_real<TestType>(TestType{0}, TestType{10})};
+    core::Ray<TestType> ray{o, d};
+
+    BENCHMARK("Constructor")
+    {
+        return core::Ray<TestType>{o, d};
+    };
+
+    BENCHMARK("operator()")
+    {
+        return ray(t);
+    };
+
+    BENCHMARK("operator<<")
+    {
+        std::ostringstream stream;
+        stream << ray;
+        return stream.str();
+    };
+}
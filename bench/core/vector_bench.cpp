@@ -0,0 +1,263 @@
+#include "bench_inputs.hpp"
+
+#include <core/vector.hpp>
+
+#include <catch2/catch.hpp>
+#include <sstream>
+#include <zeus/compiler.hpp>
+
+static constexpr auto N{3};
+
+TEMPLATE_TEST_CASE("[Vector] - construction and access",
+                   "[core]",
+                   float,
+                   double)
+{
+    using Vector = core::Vector<TestType, N>;
+
+    auto x{bench::random_real<TestType>()};
+    auto y{bench::random_real<TestType>()};
+    auto z{bench::random_real<TestType>()};
+    auto v{bench::random_vector<TestType, N>()};
+    [[maybe_unused]] auto v2{bench::random_vector<TestType, N - 1>()};
+    [[maybe_unused]] auto v4{bench::random_vector<TestType, N + 1>()};
+    std::size_t i{static_cast<std::size_t>(x > 0)};
+
+    BENCHMARK("Empty constructor")
+    {
+        return Vector{};
+    };
+
+    BENCHMARK("Uniform constructor")
+    {
+        return Vector{x};
+    };
+
+    BENCHMARK("Parameterised constructor")
+    {
+        return Vector{x, y, z};
+    };
+
+#if defined(APOLLO_DISABLE_VECTOR_TEMPLATE_SPECIALISATIONS)
+    // Only the generic vector converts between dimensions.
+    BENCHMARK("Lower dimension constructor")
+    {
+        return Vector{v2};
+    };
+
+    // GCC cannot see that the copy fills every element.
+#    if defined(ZEUS_COMPILER_GCC)
+#        pragma GCC diagnostic push
+#        pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#    endif
+    BENCHMARK("Higher dimension constructor")
+    {
+        return Vector{v4};
+    };
+#    if defined(ZEUS_COMPILER_GCC)
+#        pragma GCC diagnostic pop
+#    endif
+#endif
+
+    BENCHMARK("operator[]")
+    {
+        return v[i];
+    };
+
+    BENCHMARK("has_nans")
+    {
+        return core::has_nans(v);
+    };
+}
+
+TEMPLATE_TEST_CASE("[Vector] - operators", "[core]", float, double)
+{
+    using Vector = core::Vector<TestType, N>;
+
+    auto a{bench::random_vector<TestType, N>()};
+    auto b{bench::random_vector<TestType, N>()};
+    auto s{bench::random_real<TestType>(TestType{1}, TestType{2})};
+
+    BENCHMARK("unary_op")
+    {
+        return core::unary_op(a, [s](auto x) { return x * s; });
+    };
+
+    BENCHMARK("binary_op")
+    {
+        return core::binary_op(a, b, [](auto x, auto y) { return x * y; });
+    };
+
+    BENCHMARK("operator+=")
+    {
+        Vector out{a};
+        out += b;
+        return out;
+    };
+
+    BENCHMARK("operator-=")
+    {
+        Vector out{a};
+        out -= b;
+        return out;
+    };
+
+    BENCHMARK("operator*=")
+    {
+        Vector out{a};
+        out *= s;
+        return out;
+    };
+
+    BENCHMARK("operator/=")
+    {
+        Vector out{a};
+        out /= s;
+        return out;
+    };
+
+    BENCHMARK("Unary operator-")
+    {
+        return -a;
+    };
+
+    BENCHMARK("operator==")
+    {
+        return a == b;
+    };
+
+    BENCHMARK("operator!=")
+    {
+        return a != b;
+    };
+
+    BENCHMARK("operator+")
+    {
+        return a + b;
+    };
+
+    BENCHMARK("operator-")
+    {
+        return a - b;
+    };
+
+    BENCHMARK("operator* (vector, scalar)")
+    {
+        return a * s;
+    };
+
+    BENCHMARK("operator* (scalar, vector)")
+    {
+        return s * a;
+    };
+
+    BENCHMARK("operator/")
+    {
+        return a / s;
+    };
+
+    BENCHMARK("operator<<")
+    {
+        std::ostringstream stream;
+        stream << a;
+        return stream.str();
+    };
+}
+
+TEMPLATE_TEST_CASE("[Vector] - geometric functions", "[core]", float, double)
+{
+    using Vector = core::Vector<TestType, N>;
+
+    auto a{bench::random_vector<TestType, N>()};
+    auto b{bench::random_vector<TestType, N>()};
+
+    // coordinate_system requires an exactly unit length input.
+    auto sign{(bench::random_real<TestType>() > 0) ? TestType{1}
+                                                   : TestType{-1}};
+    Vector axis{TestType{0}, TestType{0}, sign};
+
+    BENCHMARK("dot")
+    {
+        return core::dot(a, b);
+    };
+
+    BENCHMARK("length_squared")
+    {
+        return core::length_squared(a);
+    };
+
+    BENCHMARK("length")
+    {
+        return core::length(a);
+    };
+
+    BENCHMARK("abs")
+    {
+        return core::abs(a);
+    };
+
+    BENCHMARK("abs_dot")
+    {
+        return core::abs_dot(a, b);
+    };
+
+    BENCHMARK("cross")
+    {
+        return core::cross(a, b);
+    };
+
+    BENCHMARK("normalise")
+    {
+        return core::normalise(a);
+    };
+
+    BENCHMARK("min_component")
+    {
+        return core::min_component(a);
+    };
+
+    BENCHMARK("max_component")
+    {
+        return core::max_component(a);
+    };
+
+    BENCHMARK("min_dimension")
+    {
+        return core::min_dimension(a);
+    };
+
+    BENCHMARK("max_dimension")
+    {
+        return core::max_dimension(a);
+    };
+
+    BENCHMARK("min")
+    {
+        return core::min(a, b);
+    };
+
+    BENCHMARK("max")
+    {
+        return core::max(a, b);
+    };
+
+    BENCHMARK("permute")
+    {
+        return core::permute(a, 2, 0, 1);
+    };
+
+    BENCHMARK("coordinate_system")
+    {
+        return core::coordinate_system(axis);
+    };
+
+    BENCHMARK("distance")
+    {
+        return core::distance(a, b);
+    };
+
+    BENCHMARK("distance_squared")
+    {
+        return core::distance_squared(a, b);
+    };
+}
@@ -0,0 +1,695 @@
+#include "scenes.hpp"
+
+#include <loaders/scene_cache.hpp>
+
+#include <render/renderer.hpp>
+#include <render/wavefront.hpp>
+
+#include <core/perf_counters.hpp>
+#include <core/profiler.hpp>
+#include <core/stats.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#    include <sys/resource.h>
+#endif
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct Options
+    {
+        std::vector<std::string> scenes;
+        bench::SceneParams params;
+        render::RenderSettings settings;
+        std::string output;
+        std::string image_dir;
+        std::string trace;
+        std::string cache_dir;
+        std::size_t page_budget{0};
+        bool counters{false};
+        bool compress{false};
+        std::optional<shapes::LeafFormat> leaves;
+    };
+
+    struct SceneReport
+    {
+        std::string name;
+        std::size_t primitives{0};
+        std::size_t lights{0};
+        std::size_t mesh_bytes{0};
+        std::string cache;
+        double generate_seconds{0};
+        double build_seconds{0};
+        double render_seconds{0};
+        double write_seconds{0};
+        std::uint64_t rays{0};
+        std::uint64_t shadow_rays{0};
+        std::uint64_t peak_rss_bytes{0};
+        std::string stats;
+        std::string paging;
+        std::string stream;
+        std::vector<double> stage_seconds;
+        core::PerfCounterValues generate_counters;
+        core::PerfCounterValues build_counters;
+        core::PerfCounterValues render_counters;
+        std::vector<core::PerfCounterValues> thread_counters;
+    };
+
+    double seconds_since(Clock::time_point start)
+    {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    // Resets the peak resident set size of the process so that every scene
+    // reports its own high-water mark. Only supported on Linux; elsewhere
+    // the peak accumulates over the whole run.
+    void reset_peak_rss()
+    {
+#if defined(__linux__)
+        std::ofstream file{"/proc/self/clear_refs"};
+        file << "5";
+#endif
+    }
+
+    std::uint64_t peak_rss_bytes()
+    {
+#if defined(__linux__)
+        std::ifstream file{"/proc/self/status"};
+        std::string line;
+        while (std::getline(file, line))
+        {
+            if (line.rfind("VmHWM:", 0) == 0)
+            {
+                return std::stoull(line.substr(6)) * 1024;
+            }
+        }
+
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+        return static_cast<std::uint64_t>(usage.ru_maxrss) * 1024;
+#else
+        return 0;
+#endif
+    }
+
+    void print_usage()
+    {
+        std::cout
+            << "Usage: apollo_render_bench [options]\n"
+            << "  --scene <name>    Scene to run (repeatable, default all)\n"
+            << "  --list            List the available scenes\n"
+            << "  --width <n>       Image width (default 256)\n"
+            << "  --height <n>      Image height (default 192)\n"
+            << "  --spp <n>         Samples per pixel (default 4)\n"
+            << "  --depth <n>       Maximum path depth (default 4)\n"
+            << "  --packet <n>      Rays per packet: 1, 2, 4, 8 or 16\n"
+            << "                    (default 16, 1 disables packets)\n"
+            << "  --stream <n>      Sort bounce rays in streams of n and\n"
+            << "                    compare with a render without them\n"
+            << "  --wavefront       Use the wavefront integrator and report\n"
+            << "                    the time of each stage\n"
+            << "  --wavefront-size <n> Paths per wave (default 16384)\n"
+            << "  --threads <n>     Worker threads (default: all)\n"
+            << "  --scale <x>       Scene size multiplier (default 1)\n"
+            << "  --pin             Pin worker threads to CPUs\n"
+            << "  --output <file>   Write the JSON report to a file\n"
+            << "  --image-dir <dir> Write each rendered image as PPM\n"
+            << "  --counters        Read hardware performance counters\n"
+            << "  --cache-dir <dir> Cache built scenes and reuse them on\n"
+            << "                    later runs with the same parameters\n"
+            << "  --page-budget <MB> Page meshes in from the cache with a\n"
+            << "                    resident budget (needs --cache-dir)\n"
+            << "  --compress        Compress the meshes after the build\n"
+            << "  --leaves <format> Precompute the leaves of the meshes as\n"
+            << "                    full or quantised triangles\n"
+            << "  --trace <file>    Write a Chrome trace of the run (needs\n"
+            << "                    APOLLO_ENABLE_PROFILER)\n";
+    }
+
+    Options parse_options(int argc, char** argv)
+    {
+        Options options;
+        options.settings.samples_per_pixel = 4;
+
+        auto value = [&](int& i) -> std::string {
+            if (i + 1 >= argc)
+            {
+                throw std::runtime_error{
+                    std::string{"error: missing value for "} + argv[i]};
+            }
+            return argv[++i];
+        };
+
+        for (int i{1}; i < argc; ++i)
+        {
+            std::string arg{argv[i]};
+            if (arg == "--scene")
+            {
+                options.scenes.push_back(value(i));
+            }
+            else if (arg == "--width")
+            {
+                options.params.width = std::stoul(value(i));
+            }
+            else if (arg == "--height")
+            {
+                options.params.height = std::stoul(value(i));
+            }
+            else if (arg == "--spp")
+            {
+                options.settings.samples_per_pixel =
+                    static_cast<std::uint32_t>(std::stoul(value(i)));
+            }
+            else if (arg == "--depth")
+            {
+                options.settings.max_depth =
+                    static_cast<std::uint32_t>(std::stoul(value(i)));
+            }
+            else if (arg == "--packet")
+            {
+                options.settings.packet_size = std::stoul(value(i));
+                auto size{options.settings.packet_size};
+                if (size == 0 || size > shapes::max_packet_size ||
+                    (size & (size - 1)) != 0)
+                {
+                    throw std::runtime_error{
+                        "error: --packet must be 1, 2, 4, 8 or 16"};
+                }
+            }
+            else if (arg == "--stream")
+            {
+                options.settings.stream_size = std::stoul(value(i));
+            }
+            else if (arg == "--wavefront")
+            {
+                options.settings.integrator = render::Integrator::wavefront;
+            }
+            else if (arg == "--wavefront-size")
+            {
+                options.settings.wavefront_size = std::stoul(value(i));
+            }
+            else if (arg == "--threads")
+            {
+                options.settings.num_threads = std::stoul(value(i));
+            }
+            else if (arg == "--scale")
+            {
+                options.params.scale = static_cast<core::Real>(
+                    std::stod(value(i)));
+            }
+            else if (arg == "--pin")
+            {
+                options.settings.pin_threads = true;
+            }
+            else if (arg == "--output")
+            {
+                options.output = value(i);
+            }
+            else if (arg == "--image-dir")
+            {
+                options.image_dir = value(i);
+            }
+            else if (arg == "--trace")
+            {
+                options.trace = value(i);
+            }
+            else if (arg == "--cache-dir")
+            {
+                options.cache_dir = value(i);
+            }
+            else if (arg == "--page-budget")
+            {
+                options.page_budget = static_cast<std::size_t>(
+                    std::stod(value(i)) * 1024 * 1024);
+            }
+            else if (arg == "--compress")
+            {
+                options.compress = true;
+            }
+            else if (arg == "--leaves")
+            {
+                auto format{value(i)};
+                if (format == "full")
+                {
+                    options.leaves = shapes::LeafFormat::full;
+                }
+                else if (format == "quantised")
+                {
+                    options.leaves = shapes::LeafFormat::quantised;
+                }
+                else
+                {
+                    throw std::runtime_error{
+                        "error: --leaves must be full or quantised"};
+                }
+            }
+            else if (arg == "--counters")
+            {
+                options.counters               = true;
+                options.settings.perf_counters = true;
+            }
+            else if (arg == "--list")
+            {
+                for (auto& generator : bench::scene_generators())
+                {
+                    std::cout << generator.name << ": "
+                              << generator.description << '\n';
+                }
+                std::exit(0);
+            }
+            else if (arg == "--help" || arg == "-h")
+            {
+                print_usage();
+                std::exit(0);
+            }
+            else
+            {
+                throw std::runtime_error{"error: unknown option " + arg};
+            }
+        }
+
+        if (options.page_budget > 0 && options.cache_dir.empty())
+        {
+            throw std::runtime_error{
+                "error: --page-budget requires --cache-dir"};
+        }
+
+        if ((options.compress || options.leaves) && options.page_budget > 0)
+        {
+            throw std::runtime_error{"error: --compress and --leaves cannot "
+                                     "be used with --page-budget"};
+        }
+
+        if (options.compress && options.leaves)
+        {
+            throw std::runtime_error{
+                "error: --compress cannot be used with --leaves"};
+        }
+
+        if (options.settings.num_threads == 0)
+        {
+            options.settings.num_threads =
+                std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        return options;
+    }
+
+    SceneReport run_scene(bench::SceneGenerator const& generator,
+                          Options const& options)
+    {
+        APOLLO_PROFILE_ZONE(generator.name.c_str());
+        SceneReport report;
+        report.name = generator.name;
+        reset_peak_rss();
+
+        // Generation and building run on this thread, so its own counters
+        // cover them.
+        auto read_counters = [&options]() {
+            return options.counters ? core::thread_perf_counters().read()
+                                    : core::PerfCounterValues{};
+        };
+
+        // Generated scenes have no source files, so the cache is keyed by
+        // everything that affects generation instead.
+        std::string cache_path;
+        if (!options.cache_dir.empty())
+        {
+            std::ostringstream name;
+            name << options.cache_dir << '/' << generator.name << '_'
+                 << options.params.width << 'x' << options.params.height
+                 << '_' << options.params.scale << '_' << options.params.seed
+                 << (sizeof(core::Real) == sizeof(float) ? "_f" : "_d")
+                 << ".cache";
+            cache_path = name.str();
+        }
+
+        auto counters{read_counters()};
+        auto start{Clock::now()};
+        loaders::SceneCacheLoadOptions load_options;
+        load_options.page_budget = options.page_budget;
+        auto cached{cache_path.empty()
+                        ? std::nullopt
+                        : loaders::load_scene_cache(cache_path, load_options)};
+        auto scene = [&]() {
+            APOLLO_PROFILE_ZONE("scene load");
+            return cached ? std::move(*cached)
+                          : generator.generate(options.params);
+        }();
+        report.generate_seconds  = seconds_since(start);
+        report.generate_counters = read_counters() - counters;
+
+        // A cached scene is already built.
+        if (!cached)
+        {
+            counters = read_counters();
+            start    = Clock::now();
+            scene.build();
+            report.build_seconds  = seconds_since(start);
+            report.build_counters = read_counters() - counters;
+
+            if (!cache_path.empty())
+            {
+                loaders::write_scene_cache(scene, {}, cache_path);
+            }
+
+            // Paged meshes only exist in a scene read back from the cache.
+            if (options.page_budget > 0)
+            {
+                auto paged{loaders::load_scene_cache(cache_path, load_options)};
+                if (!paged)
+                {
+                    throw std::runtime_error{
+                        "error: cannot read back scene cache " + cache_path};
+                }
+                scene = std::move(*paged);
+            }
+        }
+
+        if (!cache_path.empty())
+        {
+            report.cache = cached ? "hit" : "miss";
+        }
+
+        // Compressed meshes and precomputed leaves cannot be cached, so
+        // they are made after the cache is written or read, and the time
+        // counts as build time.
+        if (options.compress)
+        {
+            start = Clock::now();
+            scene.compress_meshes();
+            report.build_seconds += seconds_since(start);
+        }
+
+        if (options.leaves)
+        {
+            start = Clock::now();
+            scene.precompute_mesh_leaves(*options.leaves);
+            report.build_seconds += seconds_since(start);
+        }
+
+        report.primitives = scene.num_primitives();
+        report.lights     = scene.lights().size();
+        report.mesh_bytes = scene.mesh_bytes();
+
+        core::reset_stats();
+        auto result{render::render(scene, options.settings)};
+        report.render_seconds = result.seconds;
+        report.rays           = result.rays;
+        report.shadow_rays    = result.shadow_rays;
+        report.thread_counters = result.thread_counters;
+        report.stage_seconds   = result.stage_seconds;
+        for (auto& values : result.thread_counters)
+        {
+            report.render_counters += values;
+        }
+
+        if (auto pager = scene.pager())
+        {
+            auto paging{pager->stats()};
+            std::ostringstream out;
+            out << "{\"budget_bytes\": " << pager->budget()
+                << ", \"meshes\": " << pager->size()
+                << ", \"misses\": " << paging.misses
+                << ", \"evictions\": " << paging.evictions
+                << ", \"bytes_loaded\": " << paging.bytes_loaded
+                << ", \"resident_bytes\": " << paging.resident_bytes
+                << ", \"peak_resident_bytes\": "
+                << paging.peak_resident_bytes << "}";
+            report.paging = out.str();
+        }
+
+#if defined(APOLLO_ENABLE_STATS)
+        auto stats{core::collect_stats()};
+        stats.seconds = result.seconds;
+        report.stats  = core::stats_to_json(stats);
+#endif
+
+        // Paged scenes do not use streams.
+        if (options.settings.stream_size > 0 && scene.pager() == nullptr)
+        {
+            auto settings{options.settings};
+            settings.stream_size = 0;
+            auto unsorted{render::render(scene, settings)};
+
+            auto& stream = result.stream;
+            std::ostringstream out;
+            out << std::setprecision(9)
+                << "{\"size\": " << options.settings.stream_size
+                << ", \"batches\": " << stream.batches
+                << ", \"rays\": " << stream.rays
+                << ", \"sort_seconds\": " << stream.sort_seconds
+                << ", \"trace_seconds\": " << stream.trace_seconds
+                << ", \"unsorted_render_seconds\": " << unsorted.seconds
+                << ", \"speedup\": "
+                << (result.seconds > 0 ? unsorted.seconds / result.seconds
+                                       : 0.0)
+                << "}";
+            report.stream = out.str();
+        }
+
+        if (!options.image_dir.empty())
+        {
+            start = Clock::now();
+            render::write_ppm(result.image,
+                              options.image_dir + "/" + generator.name +
+                                  ".ppm");
+            report.write_seconds = seconds_since(start);
+        }
+
+        report.peak_rss_bytes = peak_rss_bytes();
+        return report;
+    }
+
+    // Counters of the render phase divided by the number of rays traced.
+    std::string per_ray_json(core::PerfCounterValues const& values,
+                             std::uint64_t rays)
+    {
+        std::ostringstream out;
+        out << std::setprecision(6) << "{";
+        bool first{true};
+        for (std::size_t i{0}; i < core::num_perf_counters; ++i)
+        {
+            auto counter{static_cast<core::PerfCounter>(i)};
+            if (!values.has(counter) || rays == 0)
+            {
+                continue;
+            }
+
+            out << (first ? "" : ", ") << '"'
+                << core::perf_counter_name(counter) << "\": "
+                << static_cast<double>(values[counter]) / rays;
+            first = false;
+        }
+        out << "}";
+
+        return out.str();
+    }
+
+    std::string counters_json(SceneReport const& r)
+    {
+        if (r.render_counters.empty())
+        {
+            return "{\"available\": false}";
+        }
+
+        std::ostringstream out;
+        out << "{\"available\": true"
+            << ", \"generate\": "
+            << core::perf_counters_to_json(r.generate_counters)
+            << ", \"build\": " << core::perf_counters_to_json(r.build_counters)
+            << ", \"render\": "
+            << core::perf_counters_to_json(r.render_counters)
+            << ", \"render_per_ray\": "
+            << per_ray_json(r.render_counters, r.rays + r.shadow_rays)
+            << ", \"threads\": [";
+        for (std::size_t i{0}; i < r.thread_counters.size(); ++i)
+        {
+            out << (i == 0 ? "" : ", ")
+                << core::perf_counters_to_json(r.thread_counters[i]);
+        }
+        out << "]}";
+
+        return out.str();
+    }
+
+    std::string to_json(Options const& options,
+                        std::vector<SceneReport> const& reports)
+    {
+        std::ostringstream out;
+        out << std::setprecision(9);
+        out << "{\n"
+            << "  \"real_type\": \""
+            << (sizeof(core::Real) == sizeof(float) ? "float" : "double")
+            << "\",\n"
+            << "  \"accum_type\": \""
+            << (sizeof(core::AccumReal) == sizeof(float) ? "float" : "double")
+            << "\",\n"
+            << "  \"width\": " << options.params.width << ",\n"
+            << "  \"height\": " << options.params.height << ",\n"
+            << "  \"samples_per_pixel\": "
+            << options.settings.samples_per_pixel << ",\n"
+            << "  \"max_depth\": " << options.settings.max_depth << ",\n"
+            << "  \"packet_size\": " << options.settings.packet_size << ",\n"
+            << "  \"stream_size\": " << options.settings.stream_size << ",\n"
+            << "  \"integrator\": \""
+            << (options.settings.integrator == render::Integrator::wavefront
+                    ? "wavefront"
+                    : "path")
+            << "\",\n"
+            << "  \"threads\": " << options.settings.num_threads << ",\n"
+            << "  \"scale\": " << options.params.scale << ",\n"
+            << "  \"scenes\": [";
+
+        for (std::size_t i{0}; i < reports.size(); ++i)
+        {
+            auto& r = reports[i];
+            auto total_rays{r.rays + r.shadow_rays};
+            auto rays_per_second{
+                r.render_seconds > 0 ? total_rays / r.render_seconds : 0.0};
+            auto total{r.generate_seconds + r.build_seconds +
+                       r.render_seconds + r.write_seconds};
+
+            out << (i == 0 ? "\n" : ",\n") << "    {\n"
+                << "      \"name\": \"" << r.name << "\",\n"
+                << "      \"primitives\": " << r.primitives << ",\n"
+                << "      \"lights\": " << r.lights << ",\n"
+                << "      \"mesh_bytes\": " << r.mesh_bytes << ",\n";
+            if (!r.cache.empty())
+            {
+                out << "      \"cache\": \"" << r.cache << "\",\n";
+            }
+            out << "      \"rays\": " << r.rays << ",\n"
+                << "      \"shadow_rays\": " << r.shadow_rays << ",\n"
+                << "      \"rays_per_second\": " << rays_per_second << ",\n"
+                << "      \"build_seconds\": " << r.build_seconds << ",\n"
+                << "      \"peak_rss_bytes\": " << r.peak_rss_bytes << ",\n"
+                << "      \"phases\": {"
+                << "\"generate\": " << r.generate_seconds
+                << ", \"build\": " << r.build_seconds
+                << ", \"render\": " << r.render_seconds
+                << ", \"write\": " << r.write_seconds
+                << ", \"total\": " << total << "}";
+            if (!r.paging.empty())
+            {
+                out << ",\n      \"paging\": " << r.paging;
+            }
+            if (!r.stream.empty())
+            {
+                out << ",\n      \"stream\": " << r.stream;
+            }
+            if (!r.stage_seconds.empty())
+            {
+                out << ",\n      \"stages\": {";
+                for (std::size_t s{0}; s < r.stage_seconds.size(); ++s)
+                {
+                    auto stage{static_cast<render::WavefrontStage>(s)};
+                    out << (s == 0 ? "" : ", ") << '"'
+                        << render::wavefront_stage_name(stage)
+                        << "\": " << r.stage_seconds[s];
+                }
+                out << "}";
+            }
+            if (!r.stats.empty())
+            {
+                out << ",\n      \"stats\": " << r.stats;
+            }
+            if (options.counters)
+            {
+                out << ",\n      \"counters\": " << counters_json(r);
+            }
+            out << "\n    }";
+        }
+
+        out << "\n  ]\n}\n";
+        return out.str();
+    }
+} // namespace
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        auto options{parse_options(argc, argv)};
+
+        std::vector<bench::SceneGenerator const*> selected;
+        for (auto& generator : bench::scene_generators())
+        {
+            if (options.scenes.empty() ||
+                std::find(options.scenes.begin(),
+                          options.scenes.end(),
+                          generator.name) != options.scenes.end())
+            {
+                selected.push_back(&generator);
+            }
+        }
+
+        if (selected.size() <
+            std::max<std::size_t>(options.scenes.size(), 1))
+        {
+            throw std::runtime_error{"error: unknown scene requested"};
+        }
+
+        if (options.counters && !core::perf_counters_supported())
+        {
+            std::cerr << "warning: hardware counters are unavailable, "
+                      << "reporting timings only\n";
+        }
+
+        APOLLO_PROFILE_THREAD_NAME("main");
+        core::set_profile_counters(options.counters &&
+                                   core::perf_counters_supported());
+        std::vector<SceneReport> reports;
+        for (auto generator : selected)
+        {
+            std::cerr << "Running " << generator->name << "...\n";
+            reports.push_back(run_scene(*generator, options));
+        }
+
+        auto json{to_json(options, reports)};
+        if (options.output.empty())
+        {
+            std::cout << json;
+        }
+        else
+        {
+            std::ofstream file{options.output};
+            if (!(file << json))
+            {
+                throw std::runtime_error{"error: unable to write " +
+                                         options.output};
+            }
+        }
+
+        if (!options.trace.empty())
+        {
+#if defined(APOLLO_ENABLE_PROFILER)
+            core::write_chrome_trace(options.trace);
+#else
+            std::cerr << "warning: built without APOLLO_ENABLE_PROFILER, "
+                      << "no trace written\n";
+#endif
+        }
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,293 @@
+#include "scenes.hpp"
+
+#include <shapes/mesh_instance.hpp>
+#include <shapes/moving_mesh_instance.hpp>
+#include <shapes/sphere.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace bench
+{
+    namespace
+    {
+        constexpr Real pi{3.14159265358979323846};
+
+        std::size_t scaled(std::size_t count, Real scale)
+        {
+            return std::max<std::size_t>(
+                1, static_cast<std::size_t>(std::lround(count * scale)));
+        }
+
+        core::Vector3<Real> random_colour(std::mt19937_64& engine)
+        {
+            std::uniform_real_distribution<Real> dist{0.2f, 0.9f};
+            return core::Vector3<Real>{
+                dist(engine), dist(engine), dist(engine)};
+        }
+
+        render::Camera make_camera(SceneParams const& params,
+                                   core::Point3<Real> const& eye,
+                                   core::Point3<Real> const& look_at,
+                                   Real fov)
+        {
+            return render::Camera{eye,
+                                  look_at,
+                                  core::Vector3<Real>{0, 1, 0},
+                                  fov,
+                                  params.width,
+                                  params.height};
+        }
+
+        // Axis aligned box made of 12 triangles.
+        shapes::TriangleMesh make_box(core::Point3<Real> const& lo,
+                                      core::Point3<Real> const& hi,
+                                      std::uint32_t material)
+        {
+            std::vector<core::Point3<Real>> positions;
+            for (std::size_t i{0}; i < 8; ++i)
+            {
+                positions.emplace_back((i & 1) ? hi[0] : lo[0],
+                                       (i & 2) ? hi[1] : lo[1],
+                                       (i & 4) ? hi[2] : lo[2]);
+            }
+
+            std::vector<std::uint32_t> indices{
+                0, 2, 1, 1, 2, 3, 4, 5, 6, 5, 7, 6, 0, 1, 4, 1, 5, 4,
+                2, 6, 3, 3, 6, 7, 0, 4, 2, 2, 4, 6, 1, 3, 5, 3, 7, 5};
+            return shapes::TriangleMesh{positions, indices, material};
+        }
+    } // namespace
+
+    shapes::TriangleMesh make_grid_mesh(std::size_t resolution,
+                                        Real size,
+                                        Real amplitude,
+                                        std::uint32_t material)
+    {
+        std::vector<core::Point3<Real>> positions;
+        positions.reserve((resolution + 1) * (resolution + 1));
+        for (std::size_t j{0}; j <= resolution; ++j)
+        {
+            for (std::size_t i{0}; i <= resolution; ++i)
+            {
+                auto u{static_cast<Real>(i) / resolution};
+                auto v{static_cast<Real>(j) / resolution};
+                auto h{amplitude * static_cast<Real>(std::sin(u * 6 * pi) *
+                                                     std::cos(v * 4 * pi))};
+                positions.emplace_back((u - Real{0.5}) * size,
+                                       h,
+                                       (v - Real{0.5}) * size);
+            }
+        }
+
+        std::vector<std::uint32_t> indices;
+        indices.reserve(resolution * resolution * 6);
+        auto row{static_cast<std::uint32_t>(resolution + 1)};
+        for (std::uint32_t j{0}; j < resolution; ++j)
+        {
+            for (std::uint32_t i{0}; i < resolution; ++i)
+            {
+                auto v0{j * row + i};
+                indices.insert(indices.end(),
+                               {v0, v0 + row, v0 + 1, v0 + 1, v0 + row,
+                                v0 + row + 1});
+            }
+        }
+
+        return shapes::TriangleMesh{positions, std::move(indices), material};
+    }
+
+    render::Scene make_sphere_field(SceneParams const& params)
+    {
+        std::mt19937_64 engine{params.seed};
+        std::uniform_real_distribution<Real> unit{0, 1};
+
+        render::Scene scene;
+        auto ground = scene.add_material({core::Vector3<Real>{Real{0.6}}});
+        scene.add_shape(std::make_unique<shapes::Sphere>(
+            core::Point3<Real>{0, -10000, 0}, Real{10000}, ground));
+
+        std::vector<std::uint32_t> materials;
+        for (std::size_t i{0}; i < 16; ++i)
+        {
+            materials.push_back(scene.add_material({random_colour(engine)}));
+        }
+
+        auto side{scaled(64, std::sqrt(params.scale))};
+        auto spacing{Real{1}};
+        auto extent{side * spacing};
+        for (std::size_t j{0}; j < side; ++j)
+        {
+            for (std::size_t i{0}; i < side; ++i)
+            {
+                auto radius{Real{0.15} + Real{0.3} * unit(engine)};
+                auto x{(i + unit(engine) * Real{0.3}) * spacing - extent / 2};
+                auto z{(j + unit(engine) * Real{0.3}) * spacing - extent / 2};
+                scene.add_shape(std::make_unique<shapes::Sphere>(
+                    core::Point3<Real>{x, radius, z},
+                    radius,
+                    materials[(i * 7 + j * 3) % materials.size()]));
+            }
+        }
+
+        scene.add_light({core::Point3<Real>{extent, extent, extent},
+                         core::Vector3<Real>{extent * extent}});
+        scene.add_light({core::Point3<Real>{-extent, extent / 2, 0},
+                         core::Vector3<Real>{extent * extent / 4}});
+        scene.set_camera(make_camera(
+            params,
+            core::Point3<Real>{0, extent / 3, extent * Real{0.7}},
+            core::Point3<Real>{0, 0, -extent / 8},
+            Real{50}));
+        return scene;
+    }
+
+    namespace
+    {
+        // With `motion`, every instance also slides and turns while the
+        // shutter is open.
+        render::Scene make_grid_scene(SceneParams const& params, bool motion)
+        {
+            std::mt19937_64 engine{params.seed};
+            std::uniform_real_distribution<Real> unit{0, 1};
+
+            render::Scene scene;
+            auto material =
+                scene.add_material({core::Vector3<Real>{Real{0.7}}});
+            auto mesh = scene.add_mesh(
+                make_grid_mesh(128, Real{4}, Real{0.2}, material));
+
+            auto side{scaled(8, std::sqrt(params.scale))};
+            auto spacing{Real{4.5}};
+            auto extent{side * spacing};
+            for (std::size_t j{0}; j < side; ++j)
+            {
+                for (std::size_t i{0}; i < side; ++i)
+                {
+                    auto transform =
+                        core::translate(core::Vector3<Real>{
+                            (i + Real{0.5}) * spacing - extent / 2,
+                            unit(engine),
+                            (j + Real{0.5}) * spacing - extent / 2}) *
+                        core::rotate(unit(engine) * 2 * pi,
+                                     core::Vector3<Real>{0, 1, 0});
+                    if (!motion)
+                    {
+                        scene.add_shape(
+                            std::make_unique<shapes::MeshInstance>(mesh,
+                                                                   transform));
+                        continue;
+                    }
+
+                    core::Vector3<Real> slide{unit(engine) - Real{0.5},
+                                              0,
+                                              unit(engine) - Real{0.5}};
+                    auto turn{unit(engine) * pi / 4};
+                    auto end = core::translate(slide) * transform *
+                               core::rotate(turn,
+                                            core::Vector3<Real>{0, 1, 0});
+                    core::AnimatedTransform<Real> motion_transform{
+                        transform, Real{0}, end, Real{1}};
+                    scene.add_shape(
+                        std::make_unique<shapes::MovingMeshInstance>(
+                            mesh, motion_transform));
+                }
+            }
+
+            scene.add_light({core::Point3<Real>{0, extent, extent / 2},
+                             core::Vector3<Real>{extent * extent}});
+            auto camera{make_camera(
+                params,
+                core::Point3<Real>{0, extent / 2, extent * Real{0.8}},
+                core::Point3<Real>{},
+                Real{45})};
+            if (motion)
+            {
+                camera.set_shutter(Real{0}, Real{1});
+            }
+            scene.set_camera(camera);
+            return scene;
+        }
+    } // namespace
+
+    render::Scene make_instanced_grid(SceneParams const& params)
+    {
+        return make_grid_scene(params, false);
+    }
+
+    render::Scene make_moving_grid(SceneParams const& params)
+    {
+        return make_grid_scene(params, true);
+    }
+
+    render::Scene make_light_room(SceneParams const& params)
+    {
+        std::mt19937_64 engine{params.seed};
+        std::uniform_real_distribution<Real> unit{0, 1};
+
+        render::Scene scene;
+        auto walls = scene.add_material({core::Vector3<Real>{Real{0.75}}});
+        Real width{20}, height{8};
+
+        // Inward facing box; normals are flipped by the integrator as
+        // needed, so winding does not matter.
+        scene.add_shape(std::make_unique<shapes::TriangleMesh>(
+            make_box(core::Point3<Real>{-width / 2, 0, -width / 2},
+                     core::Point3<Real>{width / 2, height, width / 2},
+                     walls)));
+
+        for (std::size_t i{0}; i < scaled(200, params.scale); ++i)
+        {
+            auto material = scene.add_material({random_colour(engine)});
+            auto radius{Real{0.2} + Real{0.6} * unit(engine)};
+            scene.add_shape(std::make_unique<shapes::Sphere>(
+                core::Point3<Real>{(unit(engine) - Real{0.5}) * (width - 2),
+                                   radius,
+                                   (unit(engine) - Real{0.5}) * (width - 2)},
+                radius,
+                material));
+        }
+
+        auto side{scaled(8, std::sqrt(params.scale))};
+        for (std::size_t j{0}; j < side; ++j)
+        {
+            for (std::size_t i{0}; i < side; ++i)
+            {
+                auto x{((i + Real{0.5}) / side - Real{0.5}) * (width - 1)};
+                auto z{((j + Real{0.5}) / side - Real{0.5}) * (width - 1)};
+                scene.add_light(
+                    {core::Point3<Real>{x, height - Real{0.1}, z},
+                     core::Vector3<Real>{Real{40} / (side * side)} +
+                         random_colour(engine) * (Real{4} / (side * side))});
+            }
+        }
+
+        scene.set_camera(make_camera(
+            params,
+            core::Point3<Real>{0, height / 2, width / 2 - Real{0.5}},
+            core::Point3<Real>{0, 1, 0},
+            Real{70}));
+        return scene;
+    }
+
+    std::vector<SceneGenerator> const& scene_generators()
+    {
+        static std::vector<SceneGenerator> const generators{
+            {"sphere_field",
+             "grid of spheres on a ground plane",
+             make_sphere_field},
+            {"instanced_grid",
+             "instanced tessellated height fields",
+             make_instanced_grid},
+            {"moving_grid",
+             "instanced height fields with motion blur",
+             make_moving_grid},
+            {"light_room",
+             "room lit by a grid of point lights",
+             make_light_room},
+        };
+
+        return generators;
+    }
+} // namespace bench
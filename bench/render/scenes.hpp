@@ -0,0 +1,54 @@
+#pragma once
+
+#include <render/scene.hpp>
+#include <shapes/triangle_mesh.hpp>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace bench
+{
+    using core::Real;
+
+    // Parameters shared by every procedural scene. `scale` grows the amount
+    // of geometry (and lights) roughly linearly.
+    struct SceneParams
+    {
+        std::size_t width{256};
+        std::size_t height{192};
+        Real scale{1};
+        std::uint64_t seed{1};
+    };
+
+    struct SceneGenerator
+    {
+        std::string name;
+        std::string description;
+        std::function<render::Scene(SceneParams const&)> generate;
+    };
+
+    // Square height field of `resolution` x `resolution` quads covering
+    // [-size / 2, size / 2] in x and z.
+    shapes::TriangleMesh make_grid_mesh(std::size_t resolution,
+                                        Real size,
+                                        Real amplitude,
+                                        std::uint32_t material);
+
+    // Thousands of spheres of varying size resting on a ground plane.
+    render::Scene make_sphere_field(SceneParams const& params);
+
+    // A tessellated height field instanced many times with random rotations,
+    // which stresses the two-level hierarchy.
+    render::Scene make_instanced_grid(SceneParams const& params);
+
+    // The instanced height fields moving while the shutter is open, which
+    // interpolates a transform for every ray that reaches an instance.
+    render::Scene make_moving_grid(SceneParams const& params);
+
+    // Closed room with a few objects and a grid of point lights on the
+    // ceiling, which makes shadow rays dominate.
+    render::Scene make_light_room(SceneParams const& params);
+
+    std::vector<SceneGenerator> const& scene_generators();
+} // namespace bench
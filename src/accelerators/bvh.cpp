@@ -0,0 +1,336 @@
+#include "bvh.hpp"
+
+#include <core/large_allocator.hpp>
+#include <core/profiler.hpp>
+
+#include <algorithm>
+#include <limits>
+
+namespace accelerators
+{
+    namespace
+    {
+        // Cost of visiting an interior node relative to one primitive test.
+        constexpr Real traversal_cost{0.125};
+
+        struct BuildPrimitive
+        {
+            core::Bounds3<Real> bounds;
+            core::Point3<Real> centroid;
+            std::uint32_t index;
+        };
+
+        struct Bin
+        {
+            core::Bounds3<Real> bounds;
+            std::size_t count{0};
+        };
+
+        class Builder
+        {
+        public:
+            Builder(BvhBuildOptions const& options,
+                    std::vector<BvhNode>& nodes,
+                    std::vector<std::uint32_t>& indices) :
+                m_options{options}, m_nodes{nodes}, m_indices{indices}
+            {}
+
+            std::uint32_t build(std::vector<BuildPrimitive>& prims,
+                                std::size_t begin,
+                                std::size_t end,
+                                std::size_t depth)
+            {
+                auto node_index{static_cast<std::uint32_t>(m_nodes.size())};
+                m_nodes.emplace_back();
+
+                core::Bounds3<Real> bounds, centroid_bounds;
+                for (auto i{begin}; i < end; ++i)
+                {
+                    bounds = core::bounds_union(bounds, prims[i].bounds);
+                    centroid_bounds =
+                        core::bounds_union(centroid_bounds, prims[i].centroid);
+                }
+                m_nodes[node_index].bounds = bounds;
+
+                // Once only median splits can still finish the range within
+                // Bvh::max_depth, the surface area heuristic is no longer
+                // used, as its splits can be arbitrarily uneven.
+                auto count{end - begin};
+                auto median_only{depth + median_depth(count) >=
+                                 Bvh::max_depth};
+                auto axis{core::max_extent(centroid_bounds)};
+                auto degenerate{centroid_bounds.p_max[axis] ==
+                                centroid_bounds.p_min[axis]};
+                if (count == 1 || ((degenerate || median_only) &&
+                                   count <= m_options.max_leaf_size))
+                {
+                    make_leaf(node_index, prims, begin, end);
+                    return node_index;
+                }
+
+                auto mid{begin + count / 2};
+                if (degenerate)
+                {
+                    // Every centroid coincides, so no plane separates them.
+                    // Split the range in half to bound the leaf size.
+                }
+                else if (median_only)
+                {
+                    split_median(prims, begin, mid, end, axis);
+                }
+                else
+                {
+                    auto sah_mid{split_sah(
+                        prims, begin, end, axis, bounds, centroid_bounds)};
+                    if (sah_mid == end)
+                    {
+                        make_leaf(node_index, prims, begin, end);
+                        return node_index;
+                    }
+
+                    if (sah_mid == begin)
+                    {
+                        split_median(prims, begin, mid, end, axis);
+                    }
+                    else
+                    {
+                        mid = sah_mid;
+                    }
+                }
+
+                build(prims, begin, mid, depth + 1);
+                auto second{build(prims, mid, end, depth + 1)};
+
+                auto& node  = m_nodes[node_index];
+                node.offset = second;
+                node.axis   = static_cast<std::uint8_t>(axis);
+                return node_index;
+            }
+
+        private:
+            // Levels of median splits needed to bring `count` primitives
+            // down to leaves.
+            std::size_t median_depth(std::size_t count) const
+            {
+                std::size_t levels{0};
+                while (count > m_options.max_leaf_size)
+                {
+                    count = (count + 1) / 2;
+                    ++levels;
+                }
+                return levels;
+            }
+
+            void make_leaf(std::uint32_t node_index,
+                           std::vector<BuildPrimitive> const& prims,
+                           std::size_t begin,
+                           std::size_t end)
+            {
+                auto& node  = m_nodes[node_index];
+                node.offset = static_cast<std::uint32_t>(m_indices.size());
+                node.count  = static_cast<std::uint16_t>(end - begin);
+                for (auto i{begin}; i < end; ++i)
+                {
+                    m_indices.push_back(prims[i].index);
+                }
+            }
+
+            static void split_median(std::vector<BuildPrimitive>& prims,
+                                     std::size_t begin,
+                                     std::size_t mid,
+                                     std::size_t end,
+                                     std::size_t axis)
+            {
+                std::nth_element(prims.begin() + begin,
+                                 prims.begin() + mid,
+                                 prims.begin() + end,
+                                 [axis](auto const& a, auto const& b) {
+                                     return a.centroid[axis] <
+                                            b.centroid[axis];
+                                 });
+            }
+
+            // Binned surface area heuristic. Returns the partition point, or
+            // `end` when the range fits in a leaf and that is cheaper than
+            // any split.
+            std::size_t split_sah(std::vector<BuildPrimitive>& prims,
+                                  std::size_t begin,
+                                  std::size_t end,
+                                  std::size_t axis,
+                                  core::Bounds3<Real> const& bounds,
+                                  core::Bounds3<Real> const& centroid_bounds)
+            {
+                auto num_bins{m_options.num_bins};
+                auto group_size{m_options.group_size};
+                auto tests = [group_size](std::size_t count) {
+                    return static_cast<Real>((count + group_size - 1) /
+                                             group_size);
+                };
+                auto bin_of = [&](BuildPrimitive const& prim) {
+                    auto b{static_cast<std::size_t>(
+                        num_bins *
+                        core::offset(centroid_bounds, prim.centroid)[axis])};
+                    return std::min(b, num_bins - 1);
+                };
+
+                std::vector<Bin> bins(num_bins);
+                for (auto i{begin}; i < end; ++i)
+                {
+                    auto& bin = bins[bin_of(prims[i])];
+                    ++bin.count;
+                    bin.bounds =
+                        core::bounds_union(bin.bounds, prims[i].bounds);
+                }
+
+                // Sweep from the right to get the cost of every suffix, then
+                // from the left to evaluate each split.
+                std::vector<Real> right_cost(num_bins, 0);
+                core::Bounds3<Real> right_bounds;
+                std::size_t right_count{0};
+                for (auto b{num_bins - 1}; b > 0; --b)
+                {
+                    right_bounds = core::bounds_union(right_bounds,
+                                                      bins[b].bounds);
+                    right_count += bins[b].count;
+                    right_cost[b] = tests(right_count) *
+                                    core::surface_area(right_bounds);
+                }
+
+                auto best_cost{std::numeric_limits<Real>::max()};
+                std::size_t best_split{0};
+                core::Bounds3<Real> left_bounds;
+                std::size_t left_count{0};
+                for (std::size_t b{0}; b < num_bins - 1; ++b)
+                {
+                    left_bounds = core::bounds_union(left_bounds,
+                                                     bins[b].bounds);
+                    left_count += bins[b].count;
+                    auto cost{tests(left_count) *
+                                  core::surface_area(left_bounds) +
+                              right_cost[b + 1]};
+                    if (cost < best_cost)
+                    {
+                        best_cost  = cost;
+                        best_split = b;
+                    }
+                }
+
+                auto count{end - begin};
+                auto area{core::surface_area(bounds)};
+                auto split_cost{traversal_cost +
+                                (area > 0 ? best_cost / area : Real{0})};
+                if (split_cost >= tests(count) &&
+                    count <= m_options.max_leaf_size)
+                {
+                    return end;
+                }
+
+                auto it = std::partition(prims.begin() + begin,
+                                         prims.begin() + end,
+                                         [&](BuildPrimitive const& prim) {
+                                             return bin_of(prim) <= best_split;
+                                         });
+                return static_cast<std::size_t>(it - prims.begin());
+            }
+
+            BvhBuildOptions m_options;
+            std::vector<BvhNode>& m_nodes;
+            std::vector<std::uint32_t>& m_indices;
+        };
+    } // namespace
+
+    Bvh::Bvh(std::vector<core::Bounds3<Real>> const& primitive_bounds,
+             BvhBuildOptions const& options)
+    {
+        APOLLO_PROFILE_ZONE("bvh build");
+        ASSERT(options.group_size > 0);
+        ASSERT(options.max_leaf_size > 0);
+        if (primitive_bounds.empty())
+        {
+            return;
+        }
+
+        std::vector<BuildPrimitive> prims;
+        prims.reserve(primitive_bounds.size());
+        for (std::size_t i{0}; i < primitive_bounds.size(); ++i)
+        {
+            auto& b = primitive_bounds[i];
+            prims.push_back(
+                {b, core::centroid(b), static_cast<std::uint32_t>(i)});
+        }
+
+        std::vector<BvhNode> nodes;
+        std::vector<std::uint32_t> indices;
+        nodes.reserve(2 * prims.size());
+        indices.reserve(prims.size());
+
+        Builder builder{options, nodes, indices};
+        builder.build(prims, 0, prims.size(), 0);
+        nodes.shrink_to_fit();
+
+        m_nodes   = core::make_large_array(std::move(nodes));
+        m_indices = core::make_large_array(std::move(indices));
+    }
+
+    std::vector<std::uint32_t>
+    Bvh::make_leaves_contiguous(std::size_t alignment)
+    {
+        ASSERT(alignment > 0);
+        auto align = [alignment](std::vector<std::uint32_t>& order) {
+            auto size{(order.size() + alignment - 1) / alignment * alignment};
+            order.resize(size, padding);
+        };
+
+        std::vector<BvhNode> nodes{m_nodes.begin(), m_nodes.end()};
+        std::vector<std::uint32_t> order;
+        for (auto& node : nodes)
+        {
+            if (!node.is_leaf())
+            {
+                continue;
+            }
+
+            align(order);
+            auto offset{static_cast<std::uint32_t>(order.size())};
+            for (std::uint32_t i{0}; i < node.count; ++i)
+            {
+                order.push_back(primitive(node, i));
+            }
+            node.offset = offset;
+        }
+        align(order);
+
+        m_nodes   = core::make_large_array(std::move(nodes));
+        m_indices = {};
+        return order;
+    }
+
+    void
+    Bvh::refit(std::vector<core::Bounds3<Real>> const& primitive_bounds)
+    {
+        // Both children of a node are stored after it, so a backwards sweep
+        // reaches them first.
+        std::vector<BvhNode> nodes{m_nodes.begin(), m_nodes.end()};
+        for (auto i{nodes.size()}; i-- > 0;)
+        {
+            auto& node = nodes[i];
+            core::Bounds3<Real> bounds;
+            if (node.is_leaf())
+            {
+                for (std::uint32_t j{0}; j < node.count; ++j)
+                {
+                    bounds = core::bounds_union(
+                        bounds, primitive_bounds[primitive(node, j)]);
+                }
+            }
+            else
+            {
+                bounds = core::bounds_union(nodes[i + 1].bounds,
+                                            nodes[node.offset].bounds);
+            }
+            node.bounds = bounds;
+        }
+
+        m_nodes = core::make_large_array(std::move(nodes));
+    }
+} // namespace accelerators
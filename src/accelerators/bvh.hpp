@@ -0,0 +1,567 @@
+#pragma once
+
+#include <core/bounds.hpp>
+#include <core/ray.hpp>
+#include <core/ray_packet.hpp>
+#include <core/real.hpp>
+#include <core/shared_array.hpp>
+#include <core/stats.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace accelerators
+{
+    using core::Real;
+
+    // Node of a flattened BVH. Nodes are stored depth first, so the first
+    // child of an interior node always follows it directly and only the
+    // second child needs to be referenced.
+    struct BvhNode
+    {
+        core::Bounds3<Real> bounds;
+
+        // Leaves: index of the first primitive in Bvh::indices(), or of the
+        // first primitive itself if the hierarchy has no indices.
+        // Interior nodes: index of the second child.
+        std::uint32_t offset{0};
+
+        // Number of primitives in a leaf, 0 for interior nodes.
+        std::uint16_t count{0};
+
+        // Split axis of interior nodes.
+        std::uint8_t axis{0};
+
+        bool is_leaf() const
+        {
+            return count != 0;
+        }
+    };
+
+    // Nodes are stored as flat arrays in scene caches.
+    static_assert(std::is_trivially_copyable_v<BvhNode>);
+
+    struct BvhBuildOptions
+    {
+        std::size_t max_leaf_size{4};
+        std::size_t num_bins{16};
+
+        // Number of primitives of a leaf that the caller tests at once. The
+        // surface area heuristic counts a test per group rather than per
+        // primitive, which favours leaves that fill their groups.
+        std::size_t group_size{1};
+    };
+
+    // Bounding volume hierarchy over an arbitrary set of primitives that are
+    // only known through their bounds. Primitive tests are delegated to the
+    // caller, which lets the same structure serve as both the top-level
+    // hierarchy over shapes and the bottom-level one inside meshes.
+    class Bvh
+    {
+    public:
+        // Placeholder for the unused primitive numbers between aligned
+        // leaves (see make_leaves_contiguous()).
+        static constexpr std::uint32_t padding{
+            std::numeric_limits<std::uint32_t>::max()};
+
+        // Deepest level a node can be at, counting the root as level 0. The
+        // builder keeps to it, and the traversal stacks, which hold at most
+        // one entry per level, are sized by it.
+        static constexpr std::size_t max_depth{64};
+
+        Bvh() = default;
+
+        explicit Bvh(std::vector<core::Bounds3<Real>> const& primitive_bounds,
+                     BvhBuildOptions const& options = {});
+
+        // Wraps a hierarchy built earlier, such as one mapped from a scene
+        // cache, without copying it.
+        Bvh(core::SharedArray<BvhNode> nodes,
+            core::SharedArray<std::uint32_t> indices) :
+            m_nodes{std::move(nodes)}, m_indices{std::move(indices)}
+        {}
+
+        core::Bounds3<Real> bounds() const
+        {
+            return m_nodes.empty() ? core::Bounds3<Real>{}
+                                   : m_nodes.front().bounds;
+        }
+
+        core::SharedArray<BvhNode> const& nodes() const
+        {
+            return m_nodes;
+        }
+
+        // Primitives referenced by the leaves. Empty if the primitives were
+        // renumbered to match the leaves (see make_leaves_contiguous()).
+        core::SharedArray<std::uint32_t> const& indices() const
+        {
+            return m_indices;
+        }
+
+        bool empty() const
+        {
+            return m_nodes.empty();
+        }
+
+        // Renumbers the primitives in the order the leaves reference them,
+        // so that every leaf covers a contiguous range of them, and drops the
+        // index array. Returns the old number of each primitive in the new
+        // order, which the caller must apply to its own primitives. With an
+        // `alignment` above 1 every leaf starts at a multiple of it, and the
+        // numbers skipped to get there, as well as those that round the
+        // total up to a multiple of it, are returned as `padding`.
+        std::vector<std::uint32_t>
+        make_leaves_contiguous(std::size_t alignment = 1);
+
+        // Recomputes the bounds of every node from new bounds of the
+        // primitives, keeping the structure of the hierarchy. Meant for
+        // primitives that have moved slightly, as the quality of the
+        // hierarchy degrades with the distance they move.
+        void refit(std::vector<core::Bounds3<Real>> const& primitive_bounds);
+
+        // Visits the primitives whose bounds the ray enters, nearest node
+        // first. `test(primitive, t_max)` must return true on a hit and
+        // shrink `t_max` to the hit distance. Returns true if any primitive
+        // was hit.
+        template<typename PrimitiveTest>
+        bool intersect(core::Ray<Real> const& ray,
+                       Real& t_max,
+                       PrimitiveTest&& test) const
+        {
+            if (m_nodes.empty())
+            {
+                return false;
+            }
+
+            core::Vector3<Real> inv_dir{
+                Real{1} / ray.d[0], Real{1} / ray.d[1], Real{1} / ray.d[2]};
+            TraversalCounts counts;
+            auto leaf_test{primitive_leaf_test<false>(test, counts)};
+            auto hit{
+                traverse<false>(0, ray, inv_dir, t_max, leaf_test, counts)};
+            counts.commit();
+            return hit;
+        }
+
+        // Like intersect(), but hands each leaf to `test(first, count,
+        // t_max)` as a whole, for callers that store the primitives of a
+        // leaf together and test them at once. The primitives of the leaf
+        // are numbered `first` to `first + count - 1`, so the leaves must be
+        // contiguous (see make_leaves_contiguous()).
+        template<typename LeafTest>
+        bool intersect_leaves(core::Ray<Real> const& ray,
+                              Real& t_max,
+                              LeafTest&& test) const
+        {
+            ASSERT(m_indices.empty());
+            if (m_nodes.empty())
+            {
+                return false;
+            }
+
+            core::Vector3<Real> inv_dir{
+                Real{1} / ray.d[0], Real{1} / ray.d[1], Real{1} / ray.d[2]};
+            TraversalCounts counts;
+            auto leaf_test = [&](BvhNode const& node, Real& t) {
+                counts.primitive_tests += node.count;
+                return test(node.offset, std::uint32_t{node.count}, t);
+            };
+            auto hit{
+                traverse<false>(0, ray, inv_dir, t_max, leaf_test, counts)};
+            counts.commit();
+            return hit;
+        }
+
+        // Traverses the hierarchy with the lanes of `mask` together. Every
+        // lane visits nodes in the order intersect() would and tests boxes
+        // with its own t_max, so each finds exactly the same hit.
+        // `test(primitive, mask)` must test the lanes of `mask`, shrink their
+        // entries of `t_max` on a hit and return the lanes that hit. Returns
+        // the lanes that hit anything.
+        //
+        // Nodes that the bounds of the whole packet miss are skipped without
+        // testing its lanes one by one. Packets whose rays do not share the
+        // signs of their directions, and lanes left on their own, are traced
+        // as single rays.
+        template<std::size_t N, typename PacketTest>
+        std::uint32_t intersect_packet(core::RayPacket<Real, N> const& packet,
+                                       std::uint32_t mask,
+                                       std::array<Real, N>& t_max,
+                                       PacketTest&& test) const
+        {
+            return traverse_packet<false>(packet, mask, t_max, test);
+        }
+
+        // Answers whether anything lies along the ray in (0, t_max), as
+        // needed by shadow rays. The distance never shrinks, and the
+        // traversal stops at the first primitive for which
+        // `test(primitive)` returns true. Children are still visited nearest
+        // first, as occluders near the origin are then found sooner.
+        template<typename PrimitiveTest>
+        bool occluded(core::Ray<Real> const& ray,
+                      Real t_max,
+                      PrimitiveTest&& test) const
+        {
+            if (m_nodes.empty())
+            {
+                return false;
+            }
+
+            core::Vector3<Real> inv_dir{
+                Real{1} / ray.d[0], Real{1} / ray.d[1], Real{1} / ray.d[2]};
+            auto any_test = [&](std::uint32_t primitive, Real&) {
+                return test(primitive);
+            };
+            TraversalCounts counts;
+            auto leaf_test{primitive_leaf_test<true>(any_test, counts)};
+            auto hit{
+                traverse<true>(0, ray, inv_dir, t_max, leaf_test, counts)};
+            counts.commit();
+            return hit;
+        }
+
+        // occluded() with the leaves handed to `test(first, count)` as a
+        // whole, as for intersect_leaves().
+        template<typename LeafTest>
+        bool occluded_leaves(core::Ray<Real> const& ray,
+                             Real t_max,
+                             LeafTest&& test) const
+        {
+            ASSERT(m_indices.empty());
+            if (m_nodes.empty())
+            {
+                return false;
+            }
+
+            core::Vector3<Real> inv_dir{
+                Real{1} / ray.d[0], Real{1} / ray.d[1], Real{1} / ray.d[2]};
+            TraversalCounts counts;
+            auto leaf_test = [&](BvhNode const& node, Real&) {
+                counts.primitive_tests += node.count;
+                return test(node.offset, std::uint32_t{node.count});
+            };
+            auto hit{
+                traverse<true>(0, ray, inv_dir, t_max, leaf_test, counts)};
+            counts.commit();
+            return hit;
+        }
+
+        // occluded() for the lanes of `mask` together. `test(primitive,
+        // mask)` must return the lanes of `mask` that the primitive
+        // occludes. Lanes stop taking part as soon as they are occluded, and
+        // the traversal ends once every lane is. Returns the occluded lanes.
+        template<std::size_t N, typename PacketTest>
+        std::uint32_t occluded_packet(core::RayPacket<Real, N> const& packet,
+                                      std::uint32_t mask,
+                                      std::array<Real, N> t_max,
+                                      PacketTest&& test) const
+        {
+            return traverse_packet<true>(packet, mask, t_max, test);
+        }
+
+    private:
+        struct TraversalCounts
+        {
+            std::uint64_t nodes_visited{0};
+            std::uint64_t primitive_tests{0};
+
+            void commit() const
+            {
+                core::increment_stat(core::StatCounter::bvh_nodes_visited,
+                                     nodes_visited);
+                core::increment_stat(core::StatCounter::primitive_tests,
+                                     primitive_tests);
+            }
+        };
+
+        std::uint32_t primitive(BvhNode const& node, std::uint32_t i) const
+        {
+            return m_indices.empty() ? node.offset + i
+                                     : m_indices[node.offset + i];
+        }
+
+        // Leaf test that hands the primitives of a leaf to `test(primitive,
+        // t_max)` one at a time. With `any_hit` it returns at the first hit.
+        template<bool any_hit, typename PrimitiveTest>
+        auto primitive_leaf_test(PrimitiveTest& test,
+                                 TraversalCounts& counts) const
+        {
+            return [this, &test, &counts](BvhNode const& node, Real& t_max) {
+                bool hit{false};
+                for (std::uint32_t i{0}; i < node.count; ++i)
+                {
+                    ++counts.primitive_tests;
+                    if (test(primitive(node, i), t_max))
+                    {
+                        if constexpr (any_hit)
+                        {
+                            return true;
+                        }
+                        hit = true;
+                    }
+                }
+                return hit;
+            };
+        }
+
+        static std::uint32_t count_lanes(std::uint32_t mask)
+        {
+            mask = mask - ((mask >> 1) & 0x55555555);
+            mask = (mask & 0x33333333) + ((mask >> 2) & 0x33333333);
+            return (((mask + (mask >> 4)) & 0x0f0f0f0f) * 0x01010101) >> 24;
+        }
+
+        // Single-ray traversal of the subtree under `root`. Leaves are
+        // handed to `test(node, t_max)`, which returns whether anything in
+        // them was hit. With `any_hit` the traversal returns at the first
+        // hit.
+        template<bool any_hit, typename LeafTest>
+        bool traverse(std::uint32_t root,
+                      core::Ray<Real> const& ray,
+                      core::Vector3<Real> const& inv_dir,
+                      Real& t_max,
+                      LeafTest& test,
+                      TraversalCounts& counts) const
+        {
+            std::array<int, 3> dir_is_neg{
+                inv_dir[0] < 0, inv_dir[1] < 0, inv_dir[2] < 0};
+
+            std::array<std::uint32_t, max_depth> stack;
+            std::size_t stack_size{0};
+            std::uint32_t current{root};
+            bool hit{false};
+
+            while (true)
+            {
+                auto& node = m_nodes[current];
+                ++counts.nodes_visited;
+                if (core::intersect_p(
+                        node.bounds, ray, inv_dir, dir_is_neg, t_max))
+                {
+                    if (node.is_leaf())
+                    {
+                        if (test(node, t_max))
+                        {
+                            if constexpr (any_hit)
+                            {
+                                return true;
+                            }
+                            hit = true;
+                        }
+                    }
+                    else if (dir_is_neg[node.axis])
+                    {
+                        ASSERT(stack_size < stack.size());
+                        stack[stack_size++] = current + 1;
+                        current             = node.offset;
+                        continue;
+                    }
+                    else
+                    {
+                        ASSERT(stack_size < stack.size());
+                        stack[stack_size++] = node.offset;
+                        current             = current + 1;
+                        continue;
+                    }
+                }
+
+                if (stack_size == 0)
+                {
+                    break;
+                }
+                current = stack[--stack_size];
+            }
+
+            return hit;
+        }
+
+        // Traces one lane of a packet through the subtree under `root`.
+        // Returns the lane's bit if it hit anything.
+        template<bool any_hit, std::size_t N, typename PacketTest>
+        std::uint32_t traverse_lane(std::uint32_t root,
+                                    core::RayPacket<Real, N> const& packet,
+                                    std::size_t lane,
+                                    std::array<Real, N>& t_max,
+                                    PacketTest& test,
+                                    TraversalCounts& counts) const
+        {
+            // `t` is the lane's entry of `t_max`, which the packet test
+            // updates itself.
+            auto bit{std::uint32_t{1} << lane};
+            auto lane_test = [&](std::uint32_t primitive, Real&) {
+                return test(primitive, bit) != 0;
+            };
+            auto leaf_test{primitive_leaf_test<any_hit>(lane_test, counts)};
+
+            auto hit{traverse<any_hit>(root,
+                                       packet.ray(lane),
+                                       packet.inv_dir(lane),
+                                       t_max[lane],
+                                       leaf_test,
+                                       counts)};
+            return hit ? bit : 0;
+        }
+
+        // Packet traversal behind intersect_packet() and occluded_packet().
+        // With `any_hit` lanes drop out of the traversal at their first hit.
+        template<bool any_hit, std::size_t N, typename PacketTest>
+        std::uint32_t traverse_packet(core::RayPacket<Real, N> const& packet,
+                                      std::uint32_t mask,
+                                      std::array<Real, N>& t_max,
+                                      PacketTest& test) const
+        {
+            if (m_nodes.empty() || mask == 0)
+            {
+                return 0;
+            }
+
+            TraversalCounts counts;
+            std::uint32_t hits{0};
+            auto interval{core::packet_interval(packet, mask)};
+            if (!interval.valid)
+            {
+                for (std::size_t lane{0}; lane < N; ++lane)
+                {
+                    if (mask & (std::uint32_t{1} << lane))
+                    {
+                        hits |= traverse_lane<any_hit>(
+                            0, packet, lane, t_max, test, counts);
+                    }
+                }
+
+                counts.commit();
+                return hits;
+            }
+
+            // Once coherence has dropped to a quarter of the lanes, what is
+            // left of them is cheaper to trace one ray at a time.
+            auto single_ray_lanes{std::max(count_lanes(mask) / 4, 1u)};
+
+            // Distances only shrink, so their maximum at the start bounds
+            // them for the whole traversal.
+            auto max_t{Real{0}};
+            for (std::size_t lane{0}; lane < N; ++lane)
+            {
+                auto bit{std::uint32_t{1} << lane};
+                max_t = std::max(max_t, (mask & bit) ? t_max[lane] : Real{0});
+            }
+
+            struct Entry
+            {
+                std::uint32_t node;
+                std::uint32_t mask;
+            };
+
+            std::array<Entry, max_depth> stack;
+            std::size_t stack_size{0};
+            Entry current{0, mask};
+
+            while (true)
+            {
+                auto& node = m_nodes[current.node];
+                auto active{current.mask};
+                if constexpr (any_hit)
+                {
+                    active &= ~hits;
+                }
+
+                auto num_active{count_lanes(active)};
+                if (num_active <= single_ray_lanes)
+                {
+                    for (std::size_t lane{0}; lane < N; ++lane)
+                    {
+                        if (active & (std::uint32_t{1} << lane))
+                        {
+                            hits |= traverse_lane<any_hit>(current.node,
+                                                           packet,
+                                                           lane,
+                                                           t_max,
+                                                           test,
+                                                           counts);
+                        }
+                    }
+                    active = 0;
+                }
+                else
+                {
+                    // A node the packet misses as a whole counts as a single
+                    // visit; otherwise every lane is tested.
+                    ++counts.nodes_visited;
+                    if (core::intersect_p(node.bounds, interval, max_t))
+                    {
+                        counts.nodes_visited += num_active - 1;
+                        active = core::intersect_p(node.bounds,
+                                                   packet,
+                                                   active,
+                                                   interval.dir_is_neg,
+                                                   t_max);
+                    }
+                    else
+                    {
+                        active = 0;
+                    }
+                }
+
+                if (active != 0)
+                {
+                    if (node.is_leaf())
+                    {
+                        for (std::uint32_t i{0}; i < node.count && active != 0;
+                             ++i)
+                        {
+                            counts.primitive_tests += count_lanes(active);
+                            auto found{test(primitive(node, i), active)};
+                            hits |= found;
+                            if constexpr (any_hit)
+                            {
+                                active &= ~found;
+                            }
+                        }
+                    }
+                    else if (interval.dir_is_neg[node.axis])
+                    {
+                        ASSERT(stack_size < stack.size());
+                        stack[stack_size++] = Entry{current.node + 1, active};
+                        current             = Entry{node.offset, active};
+                        continue;
+                    }
+                    else
+                    {
+                        ASSERT(stack_size < stack.size());
+                        stack[stack_size++] = Entry{node.offset, active};
+                        current = Entry{current.node + 1, active};
+                        continue;
+                    }
+                }
+
+                if constexpr (any_hit)
+                {
+                    // Entries whose lanes have all been occluded since they
+                    // were pushed are dropped.
+                    while (stack_size != 0 &&
+                           (stack[stack_size - 1].mask & ~hits) == 0)
+                    {
+                        --stack_size;
+                    }
+                }
+
+                if (stack_size == 0)
+                {
+                    break;
+                }
+                current = stack[--stack_size];
+            }
+
+            counts.commit();
+            return hits;
+        }
+
+        core::SharedArray<BvhNode> m_nodes;
+        core::SharedArray<std::uint32_t> m_indices;
+    };
+} // namespace accelerators
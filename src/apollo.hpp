@@ -0,0 +1,12 @@
+#pragma once
+
+#include <string_view>
+
+namespace apollo
+{
+    static constexpr auto apollo_version_major{0};
+    static constexpr auto apollo_version_minor{0};
+    static constexpr auto apollo_version_patch{0};
+
+    static constexpr std::string_view apollo_version_string{"0.0.0"};
+}
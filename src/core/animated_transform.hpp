@@ -0,0 +1,351 @@
+#pragma once
+
+#include "bounds.hpp"
+#include "float_error.hpp"
+#include "matrix.hpp"
+#include "quaternion.hpp"
+#include "transform.hpp"
+#include "vector.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+
+namespace core
+{
+    // Affine transform that moves from `start` at `start_time` to `end` at
+    // `end_time`, for motion blur. Each keyframe is split once, when the
+    // transform is built, into a translation, a rotation and a scale, which
+    // are then interpolated separately: linearly for the translation and the
+    // scale, and along the shortest arc for the rotation. Interpolating the
+    // matrices directly instead would shrink objects as they turn.
+    //
+    // interpolate() builds the transform at a given time together with its
+    // inverse, without calling core::inverse(), and the arc of the rotation
+    // is set up ahead of time, so it is cheap enough to be done for every
+    // ray. Times outside the interval are clamped to it.
+    template<typename T>
+    class AnimatedTransform
+    {
+    public:
+        // Number of intervals over which motion_bounds() samples a rotation.
+        static constexpr std::size_t motion_steps{16};
+
+        explicit AnimatedTransform(Transform<T> const& t) :
+            AnimatedTransform{t, T{0}, t, T{1}}
+        {}
+
+        AnimatedTransform(Transform<T> const& start,
+                          T start_time,
+                          Transform<T> const& end,
+                          T end_time) :
+            m_start{start},
+            m_end{end},
+            m_keys{decompose(start.m), decompose(end.m)},
+            m_start_time{start_time},
+            m_end_time{end_time},
+            m_animated{start.m != end.m}
+        {
+            ASSERT(start_time <= end_time);
+            if (m_animated && !(start_time < end_time))
+            {
+                throw std::runtime_error{
+                    "error: animated transform has an empty time interval"};
+            }
+
+            // Reflections are kept in the scale, which would turn singular
+            // on its way between a reflected keyframe and one that is not.
+            if ((det3(m_keys[0].scale) < T{0}) !=
+                (det3(m_keys[1].scale) < T{0}))
+            {
+                throw std::runtime_error{"error: animated transform reflects "
+                                         "only one of its keyframes"};
+            }
+
+            // q and -q are the same rotation; pick the one that turns the
+            // short way round.
+            if (dot(m_keys[0].rotation, m_keys[1].rotation) < T{0})
+            {
+                m_keys[1].rotation = -m_keys[1].rotation;
+            }
+            m_arc   = QuaternionArc<T>{m_keys[0].rotation, m_keys[1].rotation};
+            m_angle = T{2} * m_arc.angle();
+
+            m_translates_only = true;
+            for (std::size_t i{0}; i < 3; ++i)
+            {
+                for (std::size_t j{0}; j < 3; ++j)
+                {
+                    m_translates_only =
+                        m_translates_only && start.m(i, j) == end.m(i, j);
+                }
+            }
+        }
+
+        bool is_animated() const
+        {
+            return m_animated;
+        }
+
+        T start_time() const
+        {
+            return m_start_time;
+        }
+
+        T end_time() const
+        {
+            return m_end_time;
+        }
+
+        // Transform at `time`. The keyframes are returned exactly at either
+        // end of the interval and beyond.
+        Transform<T> interpolate(T time) const
+        {
+            if (!m_animated || time <= m_start_time)
+            {
+                return m_start;
+            }
+            if (time >= m_end_time)
+            {
+                return m_end;
+            }
+
+            return compose((time - m_start_time) / (m_end_time - m_start_time));
+        }
+
+        // Box enclosing `b` under the transform at every time of the
+        // interval, padded for the rounding of Transform::point(). The box
+        // is transformed at `motion_steps` + 1 evenly spaced times when the
+        // transform turns, and only at the keyframes otherwise. Between two
+        // samples a point strays from the segment joining its sampled
+        // positions by at most h^2 / 8 times its largest acceleration, for
+        // a step h, and the result is grown by that much.
+        Bounds3<T> motion_bounds(Bounds3<T> const& b) const
+        {
+            if (!m_animated || is_empty(b))
+            {
+                return padded_bounds(m_start, b);
+            }
+
+            auto steps{(m_angle > T{0}) ? motion_steps : std::size_t{1}};
+            auto out{bounds_union(padded_bounds(m_start, b),
+                                  padded_bounds(m_end, b))};
+            for (std::size_t i{1}; i < steps; ++i)
+            {
+                auto u{static_cast<T>(i) / static_cast<T>(steps)};
+                out = bounds_union(out, padded_bounds(compose(u), b));
+            }
+
+            // With time scaled to [0, 1], the rotation turns at a constant
+            // rate of m_angle and the scale changes at a constant rate, so
+            // the acceleration of a point p is at most
+            // angle^2 |S p| + 2 angle |(S1 - S0) p|.
+            T radius{0};
+            for (std::size_t i{0}; i < 8; ++i)
+            {
+                Point3<T> corner{b[i & 1][0], b[(i >> 1) & 1][1],
+                                 b[(i >> 2) & 1][2]};
+                radius = std::max(radius, length(corner));
+            }
+
+            auto s_max{std::max(norm(m_keys[0].scale), norm(m_keys[1].scale))};
+            auto ds{norm(m_keys[1].scale - m_keys[0].scale)};
+            auto accel{(m_angle * m_angle * s_max + T{2} * m_angle * ds) *
+                       radius};
+            auto h{T{1} / static_cast<T>(steps)};
+
+            // Interpolating the keyframes rounds differently from
+            // transforming by them.
+            auto reach{std::max(length(m_keys[0].translation),
+                                length(m_keys[1].translation)) +
+                       s_max * radius};
+            Vector3<T> grow{accel * h * h / T{8} + gamma<T>(16) * reach};
+            out.p_min -= grow;
+            out.p_max += grow;
+            return out;
+        }
+
+    private:
+        struct Keyframe
+        {
+            Vector3<T> translation;
+            Quaternion<T> rotation;
+
+            // Stretch that remains once the rotation is taken out, in the
+            // upper 3x3 block. Not diagonal in general.
+            Matrix<T> scale;
+        };
+
+        // Splits `mat` into translation, rotation and scale, such that
+        // mat = T R S. R is found by polar decomposition: averaging a matrix
+        // with its inverse transpose converges to the nearest orthonormal
+        // one.
+        static Keyframe decompose(Matrix<T> const& mat)
+        {
+            if (mat(3, 0) != T{0} || mat(3, 1) != T{0} || mat(3, 2) != T{0} ||
+                mat(3, 3) != T{1})
+            {
+                throw std::runtime_error{
+                    "error: animated transforms must be affine"};
+            }
+
+            Keyframe key;
+            Matrix<T> linear{mat};
+            for (std::size_t i{0}; i < 3; ++i)
+            {
+                key.translation[i] = mat(i, 3);
+                linear(i, 3)       = T{0};
+            }
+
+            Matrix<T> r{linear};
+            for (int iteration{0}; iteration < 100; ++iteration)
+            {
+                auto next{(r + inverse(transpose(r))) * T{0.5}};
+                T change{0};
+                for (std::size_t i{0}; i < Matrix<T>::size; ++i)
+                {
+                    change = std::max(change,
+                                      std::abs(next.data[i] - r.data[i]));
+                }
+
+                r = next;
+                if (change < T{1e-4})
+                {
+                    break;
+                }
+            }
+
+            // A reflection has no quaternion, so it is left in the scale.
+            if (det3(r) < T{0})
+            {
+                r = -r;
+                r(3, 3) = T{1};
+            }
+
+            // The scale is taken against the rotation as the quaternion
+            // stores it, so that the two multiply back to `mat`.
+            key.rotation = normalise(Quaternion<T>{r});
+            key.scale    = transpose(key.rotation.to_matrix()) * linear;
+            return key;
+        }
+
+        static T det3(Matrix<T> const& m)
+        {
+            return m(0, 0) * (m(1, 1) * m(2, 2) - m(1, 2) * m(2, 1)) -
+                   m(0, 1) * (m(1, 0) * m(2, 2) - m(1, 2) * m(2, 0)) +
+                   m(0, 2) * (m(1, 0) * m(2, 1) - m(1, 1) * m(2, 0));
+        }
+
+        // Frobenius norm of the upper 3x3 block, which bounds how much it
+        // stretches any vector.
+        static T norm(Matrix<T> const& m)
+        {
+            T sum{0};
+            for (std::size_t i{0}; i < 3; ++i)
+            {
+                for (std::size_t j{0}; j < 3; ++j)
+                {
+                    sum += m(i, j) * m(i, j);
+                }
+            }
+            return static_cast<T>(std::sqrt(sum));
+        }
+
+        // Transform at fraction `u` of the interval. The inverse is
+        // S^-1 R^T T^-1, with S^-1 from the adjugate of the scale.
+        Transform<T> compose(T u) const
+        {
+            auto& k0 = m_keys[0];
+            auto& k1 = m_keys[1];
+            auto t{k0.translation * (T{1} - u) + k1.translation * u};
+            if (m_translates_only)
+            {
+                // Only the last columns change.
+                auto out{m_start};
+                for (std::size_t i{0}; i < 3; ++i)
+                {
+                    out.m(i, 3)     = t[i];
+                    out.m_inv(i, 3) = -(out.m_inv(i, 0) * t[0] +
+                                        out.m_inv(i, 1) * t[1] +
+                                        out.m_inv(i, 2) * t[2]);
+                }
+                return out;
+            }
+
+            auto r{m_arc(u).to_matrix()};
+            auto s{k0.scale * (T{1} - u) + k1.scale * u};
+
+            auto det{det3(s)};
+            ASSERT(det != T{0});
+            auto inv_det{T{1} / det};
+            Matrix<T> s_inv(T{1});
+            s_inv(0, 0) = (s(1, 1) * s(2, 2) - s(1, 2) * s(2, 1)) * inv_det;
+            s_inv(0, 1) = (s(0, 2) * s(2, 1) - s(0, 1) * s(2, 2)) * inv_det;
+            s_inv(0, 2) = (s(0, 1) * s(1, 2) - s(0, 2) * s(1, 1)) * inv_det;
+            s_inv(1, 0) = (s(1, 2) * s(2, 0) - s(1, 0) * s(2, 2)) * inv_det;
+            s_inv(1, 1) = (s(0, 0) * s(2, 2) - s(0, 2) * s(2, 0)) * inv_det;
+            s_inv(1, 2) = (s(0, 2) * s(1, 0) - s(0, 0) * s(1, 2)) * inv_det;
+            s_inv(2, 0) = (s(1, 0) * s(2, 1) - s(1, 1) * s(2, 0)) * inv_det;
+            s_inv(2, 1) = (s(0, 1) * s(2, 0) - s(0, 0) * s(2, 1)) * inv_det;
+            s_inv(2, 2) = (s(0, 0) * s(1, 1) - s(0, 1) * s(1, 0)) * inv_det;
+
+            Matrix<T> m(T{1});
+            Matrix<T> inv(T{1});
+            for (std::size_t i{0}; i < 3; ++i)
+            {
+                for (std::size_t j{0}; j < 3; ++j)
+                {
+                    m(i, j) = r(i, 0) * s(0, j) + r(i, 1) * s(1, j) +
+                              r(i, 2) * s(2, j);
+                    inv(i, j) = s_inv(i, 0) * r(j, 0) +
+                                s_inv(i, 1) * r(j, 1) + s_inv(i, 2) * r(j, 2);
+                }
+                m(i, 3) = t[i];
+            }
+            for (std::size_t i{0}; i < 3; ++i)
+            {
+                inv(i, 3) = -(inv(i, 0) * t[0] + inv(i, 1) * t[1] +
+                              inv(i, 2) * t[2]);
+            }
+
+            return Transform<T>{m, inv};
+        }
+
+        static Bounds3<T> padded_bounds(Transform<T> const& t,
+                                        Bounds3<T> const& b)
+        {
+            Bounds3<T> out;
+            if (is_empty(b))
+            {
+                return out;
+            }
+
+            for (std::size_t i{0}; i < 8; ++i)
+            {
+                Point3<T> corner{b[i & 1][0], b[(i >> 1) & 1][1],
+                                 b[(i >> 2) & 1][2]};
+                Vector3<T> error;
+                auto p{t.point(corner, Vector3<T>{}, error)};
+                out = bounds_union(out, p - error);
+                out = bounds_union(out, p + error);
+            }
+
+            return out;
+        }
+
+        Transform<T> m_start;
+        Transform<T> m_end;
+        std::array<Keyframe, 2> m_keys;
+        QuaternionArc<T> m_arc;
+        T m_start_time;
+        T m_end_time;
+
+        // Angle the rotation turns through over the interval.
+        T m_angle{0};
+        bool m_animated;
+
+        // Whether the keyframes share their upper 3x3 block.
+        bool m_translates_only{false};
+    };
+} // namespace core
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace core
+{
+    template<typename T>
+    constexpr T one_minus_epsilon()
+    {
+        static_assert(std::is_floating_point<T>::value);
+
+        // Largest representable value strictly less than 1.
+        if constexpr (std::is_same<T, float>::value)
+        {
+            return 0x1.fffffep-1f;
+        }
+        else
+        {
+            return 0x1.fffffffffffffp-1;
+        }
+    }
+
+    constexpr std::uint32_t reverse_bits_32(std::uint32_t n)
+    {
+        n = (n << 16) | (n >> 16);
+        n = ((n & 0x00ff00ff) << 8) | ((n & 0xff00ff00) >> 8);
+        n = ((n & 0x0f0f0f0f) << 4) | ((n & 0xf0f0f0f0) >> 4);
+        n = ((n & 0x33333333) << 2) | ((n & 0xcccccccc) >> 2);
+        n = ((n & 0x55555555) << 1) | ((n & 0xaaaaaaaa) >> 1);
+        return n;
+    }
+
+    constexpr std::uint64_t reverse_bits_64(std::uint64_t n)
+    {
+        std::uint64_t lo{reverse_bits_32(static_cast<std::uint32_t>(n))};
+        std::uint64_t hi{reverse_bits_32(static_cast<std::uint32_t>(n >> 32))};
+        return (lo << 32) | hi;
+    }
+
+    // Spreads the low 10 bits of `x` so that two zero bits follow each one.
+    constexpr std::uint32_t left_shift_3(std::uint32_t x)
+    {
+        x &= 0x3ff;
+        x = (x | (x << 16)) & 0x030000ff;
+        x = (x | (x << 8)) & 0x0300f00f;
+        x = (x | (x << 4)) & 0x030c30c3;
+        x = (x | (x << 2)) & 0x09249249;
+        return x;
+    }
+
+    // Interleaves the low 10 bits of each coordinate into a 30-bit Morton
+    // code, with `x` in the lowest bit.
+    constexpr std::uint32_t
+    encode_morton_3(std::uint32_t x, std::uint32_t y, std::uint32_t z)
+    {
+        return (left_shift_3(z) << 2) | (left_shift_3(y) << 1) |
+               left_shift_3(x);
+    }
+
+    // Returns the top `bits` bits of `n`, handling the cases where `bits` is 0
+    // or 32 without relying on undefined shifts.
+    constexpr std::uint32_t top_bits(std::uint32_t n, std::uint32_t bits)
+    {
+        return (bits == 0) ? 0 : n >> (32 - bits);
+    }
+
+    // Maps a 32-bit fixed-point value to [0, 1).
+    template<typename T>
+    T unit_from_bits(std::uint32_t bits)
+    {
+        static_assert(std::is_floating_point<T>::value);
+        return std::min(static_cast<T>(bits) * T{0x1p-32},
+                        one_minus_epsilon<T>());
+    }
+
+    // Maps a 64-bit value to [0, 1), using as many of the top bits as the
+    // mantissa of T can hold so the result is exact.
+    template<typename T>
+    T unit_from_bits(std::uint64_t bits)
+    {
+        static_assert(std::is_floating_point<T>::value);
+        constexpr auto mantissa{std::numeric_limits<T>::digits};
+        return static_cast<T>(bits >> (64 - mantissa)) *
+               (T{1} / static_cast<T>(std::uint64_t{1} << mantissa));
+    }
+} // namespace core
@@ -0,0 +1,158 @@
+#pragma once
+
+#include "ray.hpp"
+#include "vector.hpp"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+
+namespace core
+{
+    // Axis-aligned bounding box. A default constructed box is empty: its
+    // minimum is larger than its maximum, so the union with any point or box
+    // yields that point or box.
+    template<typename T>
+    class Bounds3
+    {
+    public:
+        Bounds3() :
+            p_min{std::numeric_limits<T>::max()},
+            p_max{std::numeric_limits<T>::lowest()}
+        {}
+
+        explicit Bounds3(Point3<T> const& p) : p_min{p}, p_max{p}
+        {}
+
+        Bounds3(Point3<T> const& a, Point3<T> const& b) :
+            p_min{core::min(a, b)}, p_max{core::max(a, b)}
+        {}
+
+        Point3<T> const& operator[](std::size_t i) const
+        {
+            ASSERT(i < 2);
+            return (i == 0) ? p_min : p_max;
+        }
+
+        Point3<T> p_min;
+        Point3<T> p_max;
+    };
+
+    template<typename T>
+    bool operator==(Bounds3<T> const& lhs, Bounds3<T> const& rhs)
+    {
+        return lhs.p_min == rhs.p_min && lhs.p_max == rhs.p_max;
+    }
+
+    template<typename T>
+    bool operator!=(Bounds3<T> const& lhs, Bounds3<T> const& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template<typename T>
+    bool is_empty(Bounds3<T> const& b)
+    {
+        return b.p_min[0] > b.p_max[0] || b.p_min[1] > b.p_max[1] ||
+               b.p_min[2] > b.p_max[2];
+    }
+
+    template<typename T>
+    Bounds3<T> bounds_union(Bounds3<T> const& b, Point3<T> const& p)
+    {
+        Bounds3<T> out;
+        out.p_min = min(b.p_min, p);
+        out.p_max = max(b.p_max, p);
+        return out;
+    }
+
+    template<typename T>
+    Bounds3<T> bounds_union(Bounds3<T> const& a, Bounds3<T> const& b)
+    {
+        Bounds3<T> out;
+        out.p_min = min(a.p_min, b.p_min);
+        out.p_max = max(a.p_max, b.p_max);
+        return out;
+    }
+
+    template<typename T>
+    bool inside(Point3<T> const& p, Bounds3<T> const& b)
+    {
+        return p[0] >= b.p_min[0] && p[0] <= b.p_max[0] &&
+               p[1] >= b.p_min[1] && p[1] <= b.p_max[1] &&
+               p[2] >= b.p_min[2] && p[2] <= b.p_max[2];
+    }
+
+    template<typename T>
+    Vector3<T> diagonal(Bounds3<T> const& b)
+    {
+        return b.p_max - b.p_min;
+    }
+
+    template<typename T>
+    Point3<T> centroid(Bounds3<T> const& b)
+    {
+        return (b.p_min + b.p_max) * T{0.5};
+    }
+
+    template<typename T>
+    T surface_area(Bounds3<T> const& b)
+    {
+        if (is_empty(b))
+        {
+            return T{0};
+        }
+
+        auto d{diagonal(b)};
+        return T{2} * (d[0] * d[1] + d[0] * d[2] + d[1] * d[2]);
+    }
+
+    template<typename T>
+    std::size_t max_extent(Bounds3<T> const& b)
+    {
+        return max_dimension(diagonal(b));
+    }
+
+    // Position of `p` relative to the corners of the box: the minimum maps to
+    // 0 and the maximum to 1 along each axis.
+    template<typename T>
+    Vector3<T> offset(Bounds3<T> const& b, Point3<T> const& p)
+    {
+        auto out{p - b.p_min};
+        for (std::size_t i{0}; i < 3; ++i)
+        {
+            if (b.p_max[i] > b.p_min[i])
+            {
+                out[i] /= b.p_max[i] - b.p_min[i];
+            }
+        }
+
+        return out;
+    }
+
+    // Slab test against a ray whose reciprocal direction and direction signs
+    // have already been computed, as they are shared by every box visited
+    // during a traversal.
+    template<typename T>
+    bool intersect_p(Bounds3<T> const& b,
+                     Ray<T> const& ray,
+                     Vector3<T> const& inv_dir,
+                     std::array<int, 3> const& dir_is_neg,
+                     T t_max)
+    {
+        auto t_min{(b[dir_is_neg[0]][0] - ray.o[0]) * inv_dir[0]};
+        auto t_far{(b[1 - dir_is_neg[0]][0] - ray.o[0]) * inv_dir[0]};
+
+        for (std::size_t i{1}; i < 3; ++i)
+        {
+            auto near{(b[dir_is_neg[i]][i] - ray.o[i]) * inv_dir[i]};
+            auto far{(b[1 - dir_is_neg[i]][i] - ray.o[i]) * inv_dir[i]};
+
+            // Written so that NaNs from 0 * inf never shrink the interval.
+            t_min = (near > t_min) ? near : t_min;
+            t_far = (far < t_far) ? far : t_far;
+        }
+
+        return t_min <= t_far && t_far > T{0} && t_min < t_max;
+    }
+} // namespace core
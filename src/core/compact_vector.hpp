@@ -0,0 +1,288 @@
+#pragma once
+
+#include "bounds.hpp"
+#include "float_error.hpp"
+#include "vector.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace core
+{
+    // Compact storage for vectors that are written once and read many times,
+    // such as per-vertex data. Each type encodes when the data is stored and
+    // decodes where it is used, with a handful of operations and no branches
+    // on the data.
+
+    // IEEE 754 binary16 conversions. Encoding rounds to nearest even, values
+    // beyond the range of a half become infinities and NaNs stay NaNs.
+    inline std::uint16_t float_to_half(float value)
+    {
+        constexpr std::uint32_t half_overflow{(127 + 16) << 23};
+        constexpr std::uint32_t half_normal_min{(127 - 14) << 23};
+        constexpr std::uint32_t float_inf{255 << 23};
+
+        // 0.5, whose ulp is the smallest half subnormal: adding it rounds the
+        // subnormal's bits into the bottom of the mantissa.
+        constexpr std::uint32_t magic_bits{(127 - 1) << 23};
+
+        std::uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(float));
+        auto sign{bits & 0x80000000u};
+        bits ^= sign;
+
+        std::uint32_t half;
+        if (bits >= half_overflow)
+        {
+            half = (bits > float_inf) ? 0x7e00 : 0x7c00;
+        }
+        else if (bits < half_normal_min)
+        {
+            float magnitude, magic;
+            std::memcpy(&magnitude, &bits, sizeof(float));
+            std::memcpy(&magic, &magic_bits, sizeof(float));
+            magnitude += magic;
+            std::memcpy(&half, &magnitude, sizeof(float));
+            half -= magic_bits;
+        }
+        else
+        {
+            auto mantissa_odd{(bits >> 13) & 1};
+            bits += (static_cast<std::uint32_t>(15 - 127) << 23) + 0xfff;
+            bits += mantissa_odd;
+            half = bits >> 13;
+        }
+
+        return static_cast<std::uint16_t>(half | (sign >> 16));
+    }
+
+    inline float half_to_float(std::uint16_t half)
+    {
+        // The exponent and mantissa shifted into place are the value scaled
+        // by 2^-112, subnormals included, so one multiplication rebiases them.
+        constexpr float rebias{0x1p112f};
+        std::uint32_t magnitude{half & 0x7fffu};
+        std::uint32_t sign{(half & 0x8000u) << 16};
+        std::uint32_t shifted{magnitude << 13};
+
+        float value;
+        std::memcpy(&value, &shifted, sizeof(float));
+        value *= rebias;
+
+        std::uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(float));
+        bits |= (magnitude >= 0x7c00) ? 0x7f800000u : 0;
+        bits |= sign;
+        std::memcpy(&value, &bits, sizeof(float));
+        return value;
+    }
+
+    // A vector with each component stored as a half: 11 significant bits
+    // and magnitudes of up to 65504, in a quarter of the space of doubles.
+    template<std::size_t N>
+    class HalfVector
+    {
+    public:
+        HalfVector() = default;
+
+        template<typename T>
+        explicit HalfVector(Vector<T, N> const& v)
+        {
+            for (std::size_t i{0}; i < N; ++i)
+            {
+                m_bits[i] = float_to_half(static_cast<float>(v[i]));
+            }
+        }
+
+        template<typename T>
+        Vector<T, N> decode() const
+        {
+            Vector<T, N> out;
+            for (std::size_t i{0}; i < N; ++i)
+            {
+                out[i] = static_cast<T>(half_to_float(m_bits[i]));
+            }
+
+            return out;
+        }
+
+        std::array<std::uint16_t, N> const& bits() const
+        {
+            return m_bits;
+        }
+
+    private:
+        std::array<std::uint16_t, N> m_bits{};
+    };
+
+    using HalfVector3 = HalfVector<3>;
+
+    // A unit vector in 32 bits. The direction is projected onto the
+    // octahedron |x| + |y| + |z| = 1, whose lower half is folded over the
+    // upper one, and the two coordinates of the projection are stored at 16
+    // bits each (Meyer et al. 2010). Decoded directions are within 0.003
+    // degrees of the encoded ones.
+    class OctNormal
+    {
+    public:
+        OctNormal() = default;
+
+        template<typename T>
+        explicit OctNormal(Normal3<T> const& n)
+        {
+            ASSERT(length_squared(n) > T{0});
+
+            // Encoding is rare, so it works in double and keeps the
+            // neighbouring grid point that decodes closest to `n`, which
+            // cuts the worst error of plain rounding by a third (Cigolle et
+            // al. 2014).
+            auto dn{normalise(vector_cast<double>(n))};
+            auto l1{std::abs(dn[0]) + std::abs(dn[1]) + std::abs(dn[2])};
+            auto u{dn[0] / l1};
+            auto v{dn[1] / l1};
+            if (dn[2] < 0)
+            {
+                auto folded_u{(1 - std::abs(v)) * (u >= 0 ? 1.0 : -1.0)};
+                auto folded_v{(1 - std::abs(u)) * (v >= 0 ? 1.0 : -1.0)};
+                u = folded_u;
+                v = folded_v;
+            }
+
+            auto base_u{std::floor(u * scale)};
+            auto base_v{std::floor(v * scale)};
+            auto best{-std::numeric_limits<double>::infinity()};
+            for (int i{0}; i < 4; ++i)
+            {
+                OctNormal candidate{pack(base_u + (i & 1), base_v + (i >> 1))};
+                auto d{dot(candidate.decode<double>(), dn)};
+                if (d > best)
+                {
+                    best   = d;
+                    m_bits = candidate.m_bits;
+                }
+            }
+        }
+
+        template<typename T>
+        Normal3<T> decode() const
+        {
+            // The grid coordinates are integers, so the unfolding is exact
+            // without dividing them by the scale first; the normalisation
+            // removes it.
+            auto u{static_cast<T>(unpack(m_bits))};
+            auto v{static_cast<T>(unpack(m_bits >> 16))};
+            auto z{T{scale} - std::abs(u) - std::abs(v)};
+            auto fold{std::max(-z, T{0})};
+            u -= std::copysign(fold, u);
+            v -= std::copysign(fold, v);
+            auto inv_length{T{1} / std::sqrt(u * u + v * v + z * z)};
+            return Normal3<T>{u * inv_length, v * inv_length, z * inv_length};
+        }
+
+        std::uint32_t bits() const
+        {
+            return m_bits;
+        }
+
+    private:
+        static constexpr int scale{32767};
+
+        explicit OctNormal(std::uint32_t bits) : m_bits{bits}
+        {}
+
+        static std::uint32_t pack(double u, double v)
+        {
+            auto to_bits = [](double x) {
+                auto q{std::clamp(static_cast<int>(x), -scale, scale)};
+                return std::uint32_t{static_cast<std::uint16_t>(q)};
+            };
+            return to_bits(u) | (to_bits(v) << 16);
+        }
+
+        static std::int16_t unpack(std::uint32_t bits)
+        {
+            return static_cast<std::int16_t>(static_cast<std::uint16_t>(bits));
+        }
+
+        std::uint32_t m_bits{0};
+    };
+
+    // A point stored as 16-bit fractions of a bounding box, typically that of
+    // the mesh it belongs to. Decoded points never leave the box, so bounds
+    // computed before quantisation remain valid.
+    struct QuantisedPoint3
+    {
+        std::array<std::uint16_t, 3> bits{};
+    };
+
+    template<typename T>
+    class PointQuantiser
+    {
+    public:
+        PointQuantiser() = default;
+
+        explicit PointQuantiser(Bounds3<T> const& bounds) :
+            m_origin{bounds.p_min}
+        {
+            ASSERT(!is_empty(bounds));
+
+            auto d{diagonal(bounds)};
+            for (std::size_t i{0}; i < 3; ++i)
+            {
+                m_step[i]     = d[i] / T{max_level};
+                m_inv_step[i] = (d[i] > 0) ? T{max_level} / d[i] : T{0};
+                m_error[i]    = m_step[i] * T{0.5} +
+                             gamma<T>(6) * (std::abs(bounds.p_min[i]) +
+                                            std::abs(bounds.p_max[i]));
+
+                // Rounding is monotonic, so once the last level decodes
+                // inside the box every level does.
+                while (m_origin[i] + T{max_level} * m_step[i] >
+                       bounds.p_max[i])
+                {
+                    m_step[i] = next_float_down(m_step[i]);
+                }
+            }
+        }
+
+        // Points outside the box are clamped to it.
+        QuantisedPoint3 encode(Point3<T> const& p) const
+        {
+            QuantisedPoint3 out;
+            for (std::size_t i{0}; i < 3; ++i)
+            {
+                auto level{std::round((p[i] - m_origin[i]) * m_inv_step[i])};
+                out.bits[i] = static_cast<std::uint16_t>(
+                    std::clamp(level, T{0}, T{max_level}));
+            }
+
+            return out;
+        }
+
+        Point3<T> decode(QuantisedPoint3 const& q) const
+        {
+            return Point3<T>{m_origin[0] + q.bits[0] * m_step[0],
+                             m_origin[1] + q.bits[1] * m_step[1],
+                             m_origin[2] + q.bits[2] * m_step[2]};
+        }
+
+        // Bound on the distance along each axis between a point of the box
+        // and its decoded value, rounding included.
+        Vector3<T> const& error() const
+        {
+            return m_error;
+        }
+
+    private:
+        static constexpr std::uint16_t max_level{65535};
+
+        Point3<T> m_origin;
+        Vector3<T> m_step;
+        Vector3<T> m_inv_step;
+        Vector3<T> m_error;
+    };
+} // namespace core
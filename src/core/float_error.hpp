@@ -0,0 +1,75 @@
+#pragma once
+
+#include "vector.hpp"
+
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+namespace core
+{
+    // Bound on the relative error of a single correctly rounded operation.
+    template<typename T>
+    constexpr T machine_epsilon()
+    {
+        static_assert(std::is_floating_point<T>::value);
+        return std::numeric_limits<T>::epsilon() * T{0.5};
+    }
+
+    // Bound on the relative error accumulated by `n` successive rounded
+    // operations, (1 + e)^n - 1 <= n e / (1 - n e) (Higham 2002).
+    template<typename T>
+    constexpr T gamma(int n)
+    {
+        auto ne{static_cast<T>(n) * machine_epsilon<T>()};
+        return ne / (T{1} - ne);
+    }
+
+    template<typename T>
+    T next_float_up(T v)
+    {
+        return std::nextafter(v, std::numeric_limits<T>::infinity());
+    }
+
+    template<typename T>
+    T next_float_down(T v)
+    {
+        return std::nextafter(v, -std::numeric_limits<T>::infinity());
+    }
+
+    // |a| x |b|, which bounds the terms of each component of cross(a, b).
+    template<typename T>
+    Vector3<T> abs_cross(Vector3<T> const& a, Vector3<T> const& b)
+    {
+        return Vector3<T>{std::abs(a[1] * b[2]) + std::abs(a[2] * b[1]),
+                          std::abs(a[2] * b[0]) + std::abs(a[0] * b[2]),
+                          std::abs(a[0] * b[1]) + std::abs(a[1] * b[0])};
+    }
+
+    // Origin for rays leaving a surface at `p` on the side `n` points to,
+    // where each coordinate of `p` is within `error` of the true surface.
+    // The origin is moved along `n` just past the box that bounds that
+    // error, and rounded away from the surface so the move survives the
+    // addition, which keeps the rays from finding the surface they leave.
+    template<typename T>
+    Point3<T> offset_ray_origin(Point3<T> const& p,
+                                Vector3<T> const& error,
+                                Normal3<T> const& n)
+    {
+        auto offset{n * dot(abs(n), error)};
+        auto origin{p + offset};
+        for (std::size_t i{0}; i < 3; ++i)
+        {
+            if (offset[i] > 0)
+            {
+                origin[i] = next_float_up(origin[i]);
+            }
+            else if (offset[i] < 0)
+            {
+                origin[i] = next_float_down(origin[i]);
+            }
+        }
+
+        return origin;
+    }
+} // namespace core
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace core
+{
+    // 64-bit finaliser from "Better Bit Mixing" (variant 13). Every output
+    // bit depends on every input bit, so it can be used directly to turn
+    // counters into seeds.
+    constexpr std::uint64_t mix_bits(std::uint64_t v)
+    {
+        v ^= (v >> 31);
+        v *= 0x7fb5d329728ea185;
+        v ^= (v >> 27);
+        v *= 0x81dadef4bc2dd44d;
+        v ^= (v >> 33);
+        return v;
+    }
+
+    inline std::uint64_t murmur_hash_64a(unsigned char const* key,
+                                         std::size_t len,
+                                         std::uint64_t seed)
+    {
+        constexpr std::uint64_t m{0xc6a4a7935bd1e995ull};
+        constexpr int r{47};
+
+        std::uint64_t h{seed ^ (len * m)};
+
+        auto end = key + 8 * (len / 8);
+        while (key != end)
+        {
+            std::uint64_t k;
+            std::memcpy(&k, key, sizeof(std::uint64_t));
+            key += 8;
+
+            k *= m;
+            k ^= k >> r;
+            k *= m;
+
+            h ^= k;
+            h *= m;
+        }
+
+        switch (len & 7)
+        {
+        case 7:
+            h ^= std::uint64_t(key[6]) << 48;
+            [[fallthrough]];
+        case 6:
+            h ^= std::uint64_t(key[5]) << 40;
+            [[fallthrough]];
+        case 5:
+            h ^= std::uint64_t(key[4]) << 32;
+            [[fallthrough]];
+        case 4:
+            h ^= std::uint64_t(key[3]) << 24;
+            [[fallthrough]];
+        case 3:
+            h ^= std::uint64_t(key[2]) << 16;
+            [[fallthrough]];
+        case 2:
+            h ^= std::uint64_t(key[1]) << 8;
+            [[fallthrough]];
+        case 1:
+            h ^= std::uint64_t(key[0]);
+            h *= m;
+        }
+
+        h ^= h >> r;
+        h *= m;
+        h ^= h >> r;
+
+        return h;
+    }
+
+    template<typename... Args>
+    std::uint64_t hash(Args... args)
+    {
+        static_assert((std::is_trivially_copyable<Args>::value && ...));
+
+        constexpr std::size_t size{(sizeof(Args) + ... + 0)};
+        unsigned char buffer[size];
+
+        std::size_t offset{0};
+        ((std::memcpy(buffer + offset, &args, sizeof(Args)),
+          offset += sizeof(Args)),
+         ...);
+
+        return murmur_hash_64a(buffer, size, 0);
+    }
+} // namespace core
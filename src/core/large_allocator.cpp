@@ -0,0 +1,223 @@
+#include "large_allocator.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+#if defined(__linux__)
+#    include <sys/mman.h>
+#    include <sys/syscall.h>
+#    include <unistd.h>
+#elif defined(_WIN32)
+#    define WIN32_LEAN_AND_MEAN
+#    include <windows.h>
+#endif
+
+namespace core
+{
+    namespace
+    {
+        constexpr std::size_t round_up(std::size_t size, std::size_t alignment)
+        {
+            return (size + alignment - 1) / alignment * alignment;
+        }
+
+#if defined(__linux__)
+        // Values from <linux/mempolicy.h>. We issue the system call directly
+        // so there is no dependency on libnuma.
+        constexpr int mpol_bind{2};
+        constexpr int mpol_interleave{3};
+
+        void* map_anonymous(std::size_t size, int extra_flags)
+        {
+            auto ptr = mmap(nullptr,
+                            size,
+                            PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS | extra_flags,
+                            -1,
+                            0);
+            return (ptr == MAP_FAILED) ? nullptr : ptr;
+        }
+
+        // Maps `size` bytes aligned to the huge page size so that the whole
+        // range can be promoted to transparent huge pages.
+        void* map_huge_aligned(std::size_t size)
+        {
+            auto padded{size + huge_page_size};
+            auto raw = static_cast<char*>(map_anonymous(padded, 0));
+            if (raw == nullptr)
+            {
+                return nullptr;
+            }
+
+            auto addr{reinterpret_cast<std::uintptr_t>(raw)};
+            auto aligned{round_up(addr, huge_page_size)};
+            auto head{aligned - addr};
+            auto tail{padded - head - size};
+
+            if (head != 0)
+            {
+                munmap(raw, head);
+            }
+            if (tail != 0)
+            {
+                munmap(raw + head + size, tail);
+            }
+
+            return raw + head;
+        }
+
+        bool apply_numa_policy(void* ptr,
+                               std::size_t size,
+                               AllocationPolicy const& policy)
+        {
+            if (policy.numa == NumaPolicy::local)
+            {
+                return true;
+            }
+
+            constexpr std::size_t bits{sizeof(unsigned long) * 8};
+            std::array<unsigned long, 16> mask{};
+            auto set_node = [&mask](int id) {
+                auto node{static_cast<std::size_t>(id)};
+                if (node < mask.size() * bits)
+                {
+                    mask[node / bits] |= 1ul << (node % bits);
+                }
+            };
+
+            int mode{mpol_bind};
+            if (policy.numa == NumaPolicy::interleave)
+            {
+                mode = mpol_interleave;
+                for (auto& node : numa_nodes())
+                {
+                    set_node(node.id);
+                }
+            }
+            else
+            {
+                set_node(policy.node);
+            }
+
+            return syscall(SYS_mbind,
+                           ptr,
+                           size,
+                           mode,
+                           mask.data(),
+                           mask.size() * bits + 1,
+                           0) == 0;
+        }
+#endif
+    } // namespace
+
+    LargeAllocation allocate_large(std::size_t size,
+                                   AllocationPolicy const& policy)
+    {
+        LargeAllocation out;
+
+#if defined(__linux__)
+        auto page_size{static_cast<std::size_t>(sysconf(_SC_PAGESIZE))};
+        out.size = round_up(size, page_size);
+
+        if (policy.pages == PagePolicy::explicit_huge)
+        {
+            auto huge_size{round_up(size, huge_page_size)};
+            if ((out.ptr = map_anonymous(huge_size, MAP_HUGETLB)) != nullptr)
+            {
+                out.size  = huge_size;
+                out.pages = PagePolicy::explicit_huge;
+            }
+        }
+
+        if (out.ptr == nullptr && policy.pages != PagePolicy::standard &&
+            size >= huge_page_size)
+        {
+            auto huge_size{round_up(size, huge_page_size)};
+            if ((out.ptr = map_huge_aligned(huge_size)) != nullptr)
+            {
+                out.size = huge_size;
+                if (madvise(out.ptr, out.size, MADV_HUGEPAGE) == 0)
+                {
+                    out.pages = PagePolicy::transparent_huge;
+                }
+            }
+        }
+
+        if (out.ptr == nullptr)
+        {
+            out.ptr = map_anonymous(out.size, 0);
+        }
+
+        if (out.ptr == nullptr)
+        {
+            throw std::bad_alloc{};
+        }
+
+        out.numa_applied = apply_numa_policy(out.ptr, out.size, policy);
+#elif defined(_WIN32)
+        if (policy.pages == PagePolicy::explicit_huge)
+        {
+            auto large_page{GetLargePageMinimum()};
+            if (large_page != 0)
+            {
+                auto huge_size{round_up(size, large_page)};
+                out.ptr = VirtualAlloc(nullptr,
+                                       huge_size,
+                                       MEM_RESERVE | MEM_COMMIT |
+                                           MEM_LARGE_PAGES,
+                                       PAGE_READWRITE);
+                if (out.ptr != nullptr)
+                {
+                    out.size  = huge_size;
+                    out.pages = PagePolicy::explicit_huge;
+                }
+            }
+        }
+
+        if (out.ptr == nullptr)
+        {
+            out.size = size;
+            if (policy.numa == NumaPolicy::bind)
+            {
+                out.ptr = VirtualAllocExNuma(GetCurrentProcess(),
+                                             nullptr,
+                                             size,
+                                             MEM_RESERVE | MEM_COMMIT,
+                                             PAGE_READWRITE,
+                                             static_cast<DWORD>(policy.node));
+                out.numa_applied = (out.ptr != nullptr);
+            }
+
+            if (out.ptr == nullptr)
+            {
+                out.ptr = VirtualAlloc(
+                    nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+            }
+        }
+
+        if (out.ptr == nullptr)
+        {
+            throw std::bad_alloc{};
+        }
+#else
+        out.size = round_up(size, huge_page_size);
+        out.ptr  = ::operator new(out.size, std::align_val_t{huge_page_size});
+        std::memset(out.ptr, 0, out.size);
+#endif
+
+        return out;
+    }
+
+    void free_large(LargeAllocation const& allocation)
+    {
+#if defined(__linux__)
+        munmap(allocation.ptr, allocation.size);
+#elif defined(_WIN32)
+        VirtualFree(allocation.ptr, 0, MEM_RELEASE);
+#else
+        ::operator delete(allocation.ptr, std::align_val_t{huge_page_size});
+#endif
+    }
+} // namespace core
@@ -0,0 +1,258 @@
+#pragma once
+
+#include "shared_array.hpp"
+#include "topology.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace core
+{
+    // Page size requested for a large allocation. Each option silently falls
+    // back to the next smaller one when the system cannot provide it, so a
+    // request for explicit huge pages always succeeds on a machine without
+    // a configured huge page pool.
+    enum class PagePolicy
+    {
+        standard,
+        transparent_huge,
+        explicit_huge
+    };
+
+    // Placement of the pages of a large allocation across NUMA nodes.
+    enum class NumaPolicy
+    {
+        // First touch: pages land on the node of the thread that writes them.
+        local,
+        // Pages are spread round-robin over all nodes.
+        interleave,
+        // Pages are placed on AllocationPolicy::node.
+        bind
+    };
+
+    struct AllocationPolicy
+    {
+        PagePolicy pages{PagePolicy::transparent_huge};
+        NumaPolicy numa{NumaPolicy::interleave};
+        int node{0};
+    };
+
+    // Describes what the system actually provided, which may be less than
+    // what was asked for.
+    struct LargeAllocation
+    {
+        void* ptr{nullptr};
+        std::size_t size{0};
+        PagePolicy pages{PagePolicy::standard};
+        bool numa_applied{false};
+    };
+
+    // Allocations of at least this size are worth backing with huge pages.
+    inline constexpr std::size_t huge_page_size{2 * 1024 * 1024};
+
+    // Returns zero-filled memory aligned to at least a page. Throws
+    // std::bad_alloc if no memory could be obtained at all.
+    LargeAllocation allocate_large(std::size_t size,
+                                   AllocationPolicy const& policy);
+
+    void free_large(LargeAllocation const& allocation);
+
+    // Owning, fixed-size array of trivially copyable elements allocated with
+    // allocate_large. Meant for big read-mostly arrays such as BVH nodes,
+    // vertex buffers and instance transforms.
+    template<typename T>
+    class LargeBuffer
+    {
+    public:
+        static_assert(std::is_trivially_copyable<T>::value);
+
+        LargeBuffer() = default;
+
+        // The memory comes back zero-filled and untouched. Types that are
+        // trivially default constructible are left as they are, so their
+        // pages are only faulted in, and placed under a first-touch policy,
+        // by whichever thread first writes them. Other types are constructed
+        // here, which touches every page from the calling thread.
+        explicit LargeBuffer(std::size_t count,
+                             AllocationPolicy const& policy = {}) :
+            m_count{count}
+        {
+            if (count != 0)
+            {
+                m_allocation = allocate_large(count * sizeof(T), policy);
+                if constexpr (!std::is_trivially_default_constructible_v<T>)
+                {
+                    std::uninitialized_default_construct_n(data(), count);
+                }
+            }
+        }
+
+        // Copy of the `count` elements at `source`. The copy is the first
+        // write to the buffer.
+        LargeBuffer(T const* source,
+                    std::size_t count,
+                    AllocationPolicy const& policy = {}) :
+            m_count{count}
+        {
+            if (count != 0)
+            {
+                m_allocation = allocate_large(count * sizeof(T), policy);
+                std::uninitialized_copy_n(source, count, data());
+            }
+        }
+
+        ~LargeBuffer()
+        {
+            if (m_allocation.ptr != nullptr)
+            {
+                free_large(m_allocation);
+            }
+        }
+
+        LargeBuffer(LargeBuffer const&) = delete;
+        LargeBuffer& operator=(LargeBuffer const&) = delete;
+
+        LargeBuffer(LargeBuffer&& other) noexcept :
+            m_allocation{std::exchange(other.m_allocation, {})},
+            m_count{std::exchange(other.m_count, 0)}
+        {}
+
+        LargeBuffer& operator=(LargeBuffer&& other) noexcept
+        {
+            std::swap(m_allocation, other.m_allocation);
+            std::swap(m_count, other.m_count);
+            return *this;
+        }
+
+        T* data()
+        {
+            return static_cast<T*>(m_allocation.ptr);
+        }
+
+        T const* data() const
+        {
+            return static_cast<T const*>(m_allocation.ptr);
+        }
+
+        std::size_t size() const
+        {
+            return m_count;
+        }
+
+        bool empty() const
+        {
+            return m_count == 0;
+        }
+
+        T& operator[](std::size_t i)
+        {
+            return data()[i];
+        }
+
+        T const& operator[](std::size_t i) const
+        {
+            return data()[i];
+        }
+
+        T* begin()
+        {
+            return data();
+        }
+
+        T* end()
+        {
+            return data() + m_count;
+        }
+
+        T const* begin() const
+        {
+            return data();
+        }
+
+        T const* end() const
+        {
+            return data() + m_count;
+        }
+
+        LargeAllocation const& allocation() const
+        {
+            return m_allocation;
+        }
+
+    private:
+        LargeAllocation m_allocation;
+        std::size_t m_count{0};
+    };
+
+    // Read-only copy of `values` shared as a SharedArray. Arrays of at
+    // least a huge page are copied into a LargeBuffer, so they get the
+    // pages and the placement of `policy`. Smaller ones are kept in their
+    // vector, as they would waste most of a page.
+    template<typename T>
+    SharedArray<T> make_large_array(std::vector<T> values,
+                                    AllocationPolicy const& policy = {})
+    {
+        if (values.size() * sizeof(T) < huge_page_size)
+        {
+            return SharedArray<T>{std::move(values)};
+        }
+
+        auto buffer = std::make_shared<LargeBuffer<T> const>(
+            values.data(), values.size(), policy);
+        return SharedArray<T>{buffer->data(), buffer->size(), buffer};
+    }
+
+    // One copy of a read-only array per NUMA node, so that every thread reads
+    // from memory attached to its own socket. On single-node machines this is
+    // a single buffer.
+    template<typename T>
+    class ReplicatedBuffer
+    {
+    public:
+        ReplicatedBuffer() = default;
+
+        ReplicatedBuffer(T const* source,
+                         std::size_t count,
+                         PagePolicy pages = PagePolicy::transparent_huge)
+        {
+            for (auto& node : numa_nodes())
+            {
+                AllocationPolicy policy{pages, NumaPolicy::bind, node.id};
+                m_node_ids.push_back(node.id);
+                m_replicas.emplace_back(source, count, policy);
+            }
+        }
+
+        // Replica closest to the CPU the calling thread is running on.
+        LargeBuffer<T> const& local() const
+        {
+            return replica(current_numa_node());
+        }
+
+        LargeBuffer<T> const& replica(int node) const
+        {
+            for (std::size_t i{0}; i < m_node_ids.size(); ++i)
+            {
+                if (m_node_ids[i] == node)
+                {
+                    return m_replicas[i];
+                }
+            }
+
+            return m_replicas.front();
+        }
+
+        std::size_t num_replicas() const
+        {
+            return m_replicas.size();
+        }
+
+    private:
+        std::vector<int> m_node_ids;
+        std::vector<LargeBuffer<T>> m_replicas;
+    };
+} // namespace core
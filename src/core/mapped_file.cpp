@@ -0,0 +1,177 @@
+#include "mapped_file.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#    define WIN32_LEAN_AND_MEAN
+#    define NOMINMAX
+#    include <windows.h>
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+namespace core
+{
+    namespace
+    {
+        void touch_pages(void const* data, std::size_t size, std::size_t page)
+        {
+            auto bytes = static_cast<unsigned char const volatile*>(data);
+            for (std::size_t i{0}; i < size; i += page)
+            {
+                static_cast<void>(bytes[i]);
+            }
+        }
+    } // namespace
+
+#if defined(_WIN32)
+    MappedFile::MappedFile(std::string const& path)
+    {
+        m_file = CreateFileA(path.c_str(),
+                             GENERIC_READ,
+                             FILE_SHARE_READ,
+                             nullptr,
+                             OPEN_EXISTING,
+                             FILE_ATTRIBUTE_NORMAL,
+                             nullptr);
+        if (m_file == INVALID_HANDLE_VALUE)
+        {
+            throw std::runtime_error{"error: unable to open " + path};
+        }
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(m_file, &size))
+        {
+            CloseHandle(m_file);
+            throw std::runtime_error{"error: unable to read size of " + path};
+        }
+
+        m_size = static_cast<std::size_t>(size.QuadPart);
+        if (m_size == 0)
+        {
+            return;
+        }
+
+        m_mapping =
+            CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        m_data = (m_mapping != nullptr)
+                     ? MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0)
+                     : nullptr;
+        if (m_data == nullptr)
+        {
+            if (m_mapping != nullptr)
+            {
+                CloseHandle(m_mapping);
+            }
+            CloseHandle(m_file);
+            throw std::runtime_error{"error: unable to map " + path};
+        }
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (m_data != nullptr)
+        {
+            UnmapViewOfFile(m_data);
+            CloseHandle(m_mapping);
+        }
+        CloseHandle(m_file);
+    }
+
+    void MappedFile::discard(std::size_t offset, std::size_t size) const
+    {
+        if (m_data == nullptr || offset >= m_size)
+        {
+            return;
+        }
+
+        // Unlocking pages that are not locked removes them from the working
+        // set.
+        VirtualUnlock(static_cast<char*>(m_data) + offset,
+                      std::min(size, m_size - offset));
+    }
+
+    void MappedFile::prefetch() const
+    {
+        if (m_data == nullptr)
+        {
+            return;
+        }
+
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        touch_pages(m_data, m_size, info.dwPageSize);
+    }
+#else
+    MappedFile::MappedFile(std::string const& path)
+    {
+        auto fd{open(path.c_str(), O_RDONLY)};
+        if (fd < 0)
+        {
+            throw std::runtime_error{"error: unable to open " + path};
+        }
+
+        struct stat info;
+        if (fstat(fd, &info) != 0)
+        {
+            close(fd);
+            throw std::runtime_error{"error: unable to read size of " + path};
+        }
+
+        m_size = static_cast<std::size_t>(info.st_size);
+        if (m_size != 0)
+        {
+            auto ptr = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+            if (ptr == MAP_FAILED)
+            {
+                close(fd);
+                throw std::runtime_error{"error: unable to map " + path};
+            }
+            m_data = ptr;
+        }
+
+        // The mapping stays valid after the descriptor is closed.
+        close(fd);
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (m_data != nullptr)
+        {
+            munmap(m_data, m_size);
+        }
+    }
+
+    void MappedFile::discard(std::size_t offset, std::size_t size) const
+    {
+        if (m_data == nullptr || offset >= m_size)
+        {
+            return;
+        }
+
+        // madvise needs a page aligned start; the pages shared with
+        // neighbouring data are simply read back when next needed.
+        auto page{static_cast<std::size_t>(sysconf(_SC_PAGESIZE))};
+        auto begin{offset / page * page};
+        auto end{std::min(offset + size, m_size)};
+        madvise(static_cast<char*>(m_data) + begin, end - begin, MADV_DONTNEED);
+    }
+
+    void MappedFile::prefetch() const
+    {
+        if (m_data == nullptr)
+        {
+            return;
+        }
+
+        // Lets the kernel issue large reads before the pages are touched.
+        madvise(m_data, m_size, MADV_WILLNEED);
+        touch_pages(
+            m_data, m_size, static_cast<std::size_t>(sysconf(_SC_PAGESIZE)));
+    }
+#endif
+} // namespace core
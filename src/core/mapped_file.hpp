@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace core
+{
+    // Read-only memory mapping of a whole file. Pages are loaded on demand
+    // by the OS and shared with every other process mapping the same file.
+    class MappedFile
+    {
+    public:
+        // Throws std::runtime_error if the file cannot be opened or mapped.
+        explicit MappedFile(std::string const& path);
+        ~MappedFile();
+
+        MappedFile(MappedFile const&) = delete;
+        MappedFile& operator=(MappedFile const&) = delete;
+
+        unsigned char const* data() const
+        {
+            return static_cast<unsigned char const*>(m_data);
+        }
+
+        std::size_t size() const
+        {
+            return m_size;
+        }
+
+        // Drops the pages covering [offset, offset + size) from the
+        // resident set of the process, for data that has been copied out.
+        // The contents remain readable and are read back on the next access.
+        void discard(std::size_t offset, std::size_t size) const;
+
+        // Reads the whole file into memory now rather than on first access,
+        // so that a thread dedicated to I/O can wait for the disk instead of
+        // the thread that later uses the data.
+        void prefetch() const;
+
+    private:
+        void* m_data{nullptr};
+        std::size_t m_size{0};
+#if defined(_WIN32)
+        void* m_file{nullptr};
+        void* m_mapping{nullptr};
+#endif
+    };
+} // namespace core
@@ -81,9 +81,9 @@ namespace core
             ASSERT(i < num_cols);
 
             Vector<T, 4> vec;
-            for (std::size_t j{0}; j < num_cols; ++j)
+            for (std::size_t j{0}; j < num_rows; ++j)
             {
-                vec.data[j] = data[num_cols * i + j];
+                vec.data[j] = data[num_cols * j + i];
             }
 
             return vec;
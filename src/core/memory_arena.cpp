@@ -0,0 +1,139 @@
+#include "memory_arena.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <zeus/assert.hpp>
+
+namespace core
+{
+    namespace
+    {
+        std::atomic<std::size_t> global_high_water{0};
+
+        constexpr std::size_t round_up(std::size_t size, std::size_t alignment)
+        {
+            return (size + alignment - 1) & ~(alignment - 1);
+        }
+
+        std::byte* allocate_block(std::size_t size)
+        {
+            return static_cast<std::byte*>(
+                ::operator new(size, std::align_val_t{cache_line_size}));
+        }
+
+        void free_block(std::byte* ptr)
+        {
+            ::operator delete(ptr, std::align_val_t{cache_line_size});
+        }
+    } // namespace
+
+    MemoryArena::MemoryArena(std::size_t block_size) :
+        m_block_size{round_up(block_size, cache_line_size)}
+    {
+        m_blocks.push_back({allocate_block(m_block_size), m_block_size});
+    }
+
+    MemoryArena::~MemoryArena()
+    {
+        publish_high_water_mark();
+        for (auto& block : m_blocks)
+        {
+            free_block(block.data);
+        }
+    }
+
+    void* MemoryArena::allocate(std::size_t size, std::size_t alignment)
+    {
+        ASSERT(alignment != 0 && (alignment & (alignment - 1)) == 0);
+        ASSERT(alignment <= cache_line_size);
+
+        auto offset{round_up(m_offset, alignment)};
+        if (offset + size > m_blocks[m_current].size)
+        {
+            next_block(size);
+            offset = 0;
+        }
+
+        auto ptr = m_blocks[m_current].data + offset;
+        m_offset = offset + size;
+        m_high_water_mark = std::max(m_high_water_mark, bytes_in_use());
+        return ptr;
+    }
+
+    void MemoryArena::reset()
+    {
+        publish_high_water_mark();
+        m_current            = 0;
+        m_offset             = 0;
+        m_bytes_before_block = 0;
+    }
+
+    std::size_t MemoryArena::bytes_reserved() const
+    {
+        std::size_t total{0};
+        for (auto& block : m_blocks)
+        {
+            total += block.size;
+        }
+
+        return total;
+    }
+
+    std::size_t MemoryArena::global_high_water_mark()
+    {
+        return global_high_water.load(std::memory_order_relaxed);
+    }
+
+    void MemoryArena::next_block(std::size_t min_size)
+    {
+        // Whatever is left at the end of the current block is wasted, but
+        // still counts as used so the high water mark reflects the memory the
+        // arena actually needed.
+        m_bytes_before_block += m_blocks[m_current].size;
+
+        // Look for a spare block that was allocated before the last reset and
+        // is big enough, and move it right after the current one.
+        auto first_spare = m_blocks.begin() + m_current + 1;
+        auto it          = std::find_if(
+            first_spare, m_blocks.end(), [min_size](Block const& block) {
+                return block.size >= min_size;
+            });
+
+        if (it != m_blocks.end())
+        {
+            std::iter_swap(first_spare, it);
+        }
+        else
+        {
+            auto size{
+                std::max(m_block_size, round_up(min_size, cache_line_size))};
+            m_blocks.insert(first_spare, {allocate_block(size), size});
+        }
+
+        ++m_current;
+        m_offset = 0;
+    }
+
+    void MemoryArena::publish_high_water_mark()
+    {
+        // Only touch the shared value when this arena has grown, which stops
+        // happening once the arena reaches its steady state.
+        if (m_high_water_mark <= m_published_high_water_mark)
+        {
+            return;
+        }
+
+        m_published_high_water_mark = m_high_water_mark;
+        auto current{global_high_water.load(std::memory_order_relaxed)};
+        while (current < m_high_water_mark &&
+               !global_high_water.compare_exchange_weak(
+                   current, m_high_water_mark, std::memory_order_relaxed))
+        {}
+    }
+
+    MemoryArena& thread_arena()
+    {
+        thread_local MemoryArena arena;
+        return arena;
+    }
+} // namespace core
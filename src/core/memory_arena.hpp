@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace core
+{
+    inline constexpr std::size_t cache_line_size{64};
+
+    // Bump-pointer allocator for short-lived objects. Memory is handed out
+    // from cache-line aligned blocks and is only reclaimed all at once by
+    // reset(), which keeps the blocks around for reuse. Once an arena has
+    // grown to its working size it never touches the general heap again.
+    //
+    // Objects allocated from an arena are never destroyed, so only trivially
+    // destructible types may be constructed in it.
+    class MemoryArena
+    {
+    public:
+        static constexpr std::size_t default_block_size{256 * 1024};
+
+        explicit MemoryArena(std::size_t block_size = default_block_size);
+        ~MemoryArena();
+
+        MemoryArena(MemoryArena const&) = delete;
+        MemoryArena& operator=(MemoryArena const&) = delete;
+
+        void* allocate(std::size_t size,
+                       std::size_t alignment = alignof(std::max_align_t));
+
+        template<typename T, typename... Args>
+        T* alloc(Args&&... args)
+        {
+            static_assert(std::is_trivially_destructible<T>::value);
+            auto ptr = allocate(sizeof(T), alignof(T));
+            return new (ptr) T{std::forward<Args>(args)...};
+        }
+
+        template<typename T>
+        T* alloc_array(std::size_t count)
+        {
+            static_assert(std::is_trivially_destructible<T>::value);
+            auto ptr = static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+            std::uninitialized_value_construct_n(ptr, count);
+            return ptr;
+        }
+
+        // Releases every allocation made since the last reset. Intended to be
+        // called once per sample.
+        void reset();
+
+        std::size_t bytes_in_use() const
+        {
+            return m_bytes_before_block + m_offset;
+        }
+
+        std::size_t bytes_reserved() const;
+
+        std::size_t high_water_mark() const
+        {
+            return m_high_water_mark;
+        }
+
+        // Largest high water mark seen by any arena, in any thread, at the
+        // time it was last reset or destroyed.
+        static std::size_t global_high_water_mark();
+
+    private:
+        struct Block
+        {
+            std::byte* data;
+            std::size_t size;
+        };
+
+        void next_block(std::size_t min_size);
+        void publish_high_water_mark();
+
+        std::size_t m_block_size;
+        std::vector<Block> m_blocks;
+        std::size_t m_current{0};
+        std::size_t m_offset{0};
+        std::size_t m_bytes_before_block{0};
+        std::size_t m_high_water_mark{0};
+        std::size_t m_published_high_water_mark{0};
+    };
+
+    // Arena owned by the calling thread.
+    MemoryArena& thread_arena();
+
+    // Resets the given arena when the scope ends, which is the usual way of
+    // bracketing the work for a single sample.
+    class ArenaScope
+    {
+    public:
+        explicit ArenaScope(MemoryArena& arena = thread_arena()) :
+            m_arena{arena}
+        {}
+
+        ~ArenaScope()
+        {
+            m_arena.reset();
+        }
+
+        ArenaScope(ArenaScope const&) = delete;
+        ArenaScope& operator=(ArenaScope const&) = delete;
+
+    private:
+        MemoryArena& m_arena;
+    };
+} // namespace core
@@ -0,0 +1,211 @@
+#include "perf_counters.hpp"
+
+#include <sstream>
+
+#if defined(__linux__)
+#    include <linux/perf_event.h>
+#    include <sys/syscall.h>
+#    include <unistd.h>
+#endif
+
+namespace core
+{
+    namespace
+    {
+#if defined(__linux__)
+        struct CounterConfig
+        {
+            std::uint32_t type;
+            std::uint64_t config;
+        };
+
+        constexpr std::uint64_t cache_read_miss(std::uint64_t cache)
+        {
+            return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                   (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        }
+
+        // Indexed by PerfCounter.
+        constexpr std::array<CounterConfig, num_perf_counters> configs{{
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HW_CACHE, cache_read_miss(PERF_COUNT_HW_CACHE_L1D)},
+            {PERF_TYPE_HW_CACHE, cache_read_miss(PERF_COUNT_HW_CACHE_LL)},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        }};
+
+        int open_counter(CounterConfig const& config, int group_fd)
+        {
+            perf_event_attr attr{};
+            attr.size           = sizeof(attr);
+            attr.type           = config.type;
+            attr.config         = config.config;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv     = 1;
+            attr.read_format    = PERF_FORMAT_GROUP |
+                               PERF_FORMAT_TOTAL_TIME_ENABLED |
+                               PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            // Measure the calling thread on whichever CPU it runs.
+            return static_cast<int>(
+                syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+        }
+#endif
+    } // namespace
+
+    std::string_view perf_counter_name(PerfCounter counter)
+    {
+        switch (counter)
+        {
+        case PerfCounter::cycles:
+            return "cycles";
+        case PerfCounter::instructions:
+            return "instructions";
+        case PerfCounter::l1d_misses:
+            return "l1d_misses";
+        case PerfCounter::llc_misses:
+            return "llc_misses";
+        case PerfCounter::branch_misses:
+            return "branch_misses";
+        default:
+            return "unknown";
+        }
+    }
+
+    PerfCounterGroup::PerfCounterGroup()
+    {
+        m_fds.fill(-1);
+
+#if defined(__linux__)
+        int leader{-1};
+        for (std::size_t i{0}; i < num_perf_counters; ++i)
+        {
+            // Counters the PMU does not support fail to open and are simply
+            // left out of the group.
+            auto fd{open_counter(configs[i], leader)};
+            if (fd < 0)
+            {
+                continue;
+            }
+
+            m_fds[i] = fd;
+            m_mask |= 1u << i;
+            if (leader < 0)
+            {
+                leader = fd;
+            }
+        }
+#endif
+    }
+
+    PerfCounterGroup::~PerfCounterGroup()
+    {
+#if defined(__linux__)
+        // Close the members before the leader.
+        for (auto i{num_perf_counters}; i-- > 0;)
+        {
+            if (m_fds[i] >= 0)
+            {
+                close(m_fds[i]);
+            }
+        }
+#endif
+    }
+
+    PerfCounterValues PerfCounterGroup::read() const
+    {
+        PerfCounterValues result;
+
+#if defined(__linux__)
+        if (m_mask == 0)
+        {
+            return result;
+        }
+
+        int leader{-1};
+        for (auto fd : m_fds)
+        {
+            if (fd >= 0)
+            {
+                leader = fd;
+                break;
+            }
+        }
+
+        // Layout of PERF_FORMAT_GROUP with both time fields: nr,
+        // time_enabled, time_running, then one value per member in the
+        // order they were opened.
+        std::array<std::uint64_t, 3 + num_perf_counters> buffer{};
+        auto bytes{::read(leader, buffer.data(), sizeof(buffer))};
+        if (bytes < static_cast<ssize_t>(3 * sizeof(std::uint64_t)))
+        {
+            return result;
+        }
+
+        auto enabled{buffer[1]};
+        auto running{buffer[2]};
+        if (running == 0)
+        {
+            return result;
+        }
+
+        auto scale{(running < enabled)
+                       ? static_cast<double>(enabled) / running
+                       : 1.0};
+        std::size_t member{0};
+        for (std::size_t i{0}; i < num_perf_counters && member < buffer[0];
+             ++i)
+        {
+            if (m_fds[i] < 0)
+            {
+                continue;
+            }
+
+            result.values[i] = static_cast<std::uint64_t>(
+                static_cast<double>(buffer[3 + member++]) * scale);
+        }
+        result.mask = m_mask;
+#endif
+
+        return result;
+    }
+
+    PerfCounterGroup& thread_perf_counters()
+    {
+        thread_local PerfCounterGroup group;
+        return group;
+    }
+
+    bool perf_counters_supported()
+    {
+        static bool const supported{PerfCounterGroup{}.available()};
+        return supported;
+    }
+
+    std::string perf_counters_to_json(PerfCounterValues const& values)
+    {
+        std::ostringstream out;
+        out << "{";
+        bool first{true};
+        for (std::size_t i{0}; i < num_perf_counters; ++i)
+        {
+            auto counter{static_cast<PerfCounter>(i)};
+            if (!values.has(counter))
+            {
+                continue;
+            }
+
+            out << (first ? "" : ", ") << '"' << perf_counter_name(counter)
+                << "\": " << values[counter];
+            first = false;
+        }
+
+        if (values.ipc() > 0)
+        {
+            out << (first ? "" : ", ") << "\"ipc\": " << values.ipc();
+        }
+        out << "}";
+
+        return out.str();
+    }
+} // namespace core
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace core
+{
+    enum class PerfCounter : std::size_t
+    {
+        cycles = 0,
+        instructions,
+        l1d_misses,
+        llc_misses,
+        branch_misses,
+        count
+    };
+
+    inline constexpr std::size_t num_perf_counters{
+        static_cast<std::size_t>(PerfCounter::count)};
+
+    std::string_view perf_counter_name(PerfCounter counter);
+
+    // A snapshot (or difference of snapshots) of the hardware counters.
+    // Counters the machine does not expose are absent from `mask`.
+    struct PerfCounterValues
+    {
+        std::array<std::uint64_t, num_perf_counters> values{};
+        std::uint32_t mask{0};
+
+        bool has(PerfCounter counter) const
+        {
+            return (mask & (1u << static_cast<std::size_t>(counter))) != 0;
+        }
+
+        std::uint64_t operator[](PerfCounter counter) const
+        {
+            return values[static_cast<std::size_t>(counter)];
+        }
+
+        bool empty() const
+        {
+            return mask == 0;
+        }
+
+        // Instructions per cycle, or 0 if either counter is missing.
+        double ipc() const
+        {
+            if (!has(PerfCounter::cycles) || !has(PerfCounter::instructions) ||
+                (*this)[PerfCounter::cycles] == 0)
+            {
+                return 0.0;
+            }
+
+            return static_cast<double>((*this)[PerfCounter::instructions]) /
+                   (*this)[PerfCounter::cycles];
+        }
+
+        PerfCounterValues& operator+=(PerfCounterValues const& rhs)
+        {
+            mask = (mask == 0) ? rhs.mask : (mask & rhs.mask);
+            for (std::size_t i{0}; i < num_perf_counters; ++i)
+            {
+                values[i] += rhs.values[i];
+            }
+
+            return *this;
+        }
+    };
+
+    // Counts accumulated between two snapshots taken on the same thread.
+    inline PerfCounterValues operator-(PerfCounterValues const& end,
+                                       PerfCounterValues const& start)
+    {
+        PerfCounterValues result;
+        result.mask = end.mask & start.mask;
+        for (std::size_t i{0}; i < num_perf_counters; ++i)
+        {
+            result.values[i] = (end.values[i] > start.values[i])
+                                   ? end.values[i] - start.values[i]
+                                   : 0;
+        }
+
+        return result;
+    }
+
+    // Hardware counters of the thread that created the group, read with a
+    // single system call. Uses perf_event_open on Linux; elsewhere, or when
+    // the kernel refuses access (see perf_event_paranoid), no counters are
+    // available and reads return empty values.
+    class PerfCounterGroup
+    {
+    public:
+        PerfCounterGroup();
+        ~PerfCounterGroup();
+
+        PerfCounterGroup(PerfCounterGroup const&) = delete;
+        PerfCounterGroup& operator=(PerfCounterGroup const&) = delete;
+
+        bool available() const
+        {
+            return m_mask != 0;
+        }
+
+        // Running totals since the group was opened, scaled up if the
+        // kernel had to multiplex the counters.
+        PerfCounterValues read() const;
+
+    private:
+        std::array<int, num_perf_counters> m_fds;
+        std::uint32_t m_mask{0};
+    };
+
+    // Counter group of the calling thread, opened on first use.
+    PerfCounterGroup& thread_perf_counters();
+
+    // Whether any counter can be opened on this machine. Checked once.
+    bool perf_counters_supported();
+
+    // JSON object with the available counters and the derived IPC.
+    std::string perf_counters_to_json(PerfCounterValues const& values);
+} // namespace core
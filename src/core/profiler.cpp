@@ -0,0 +1,279 @@
+#include "profiler.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+
+namespace core
+{
+    namespace
+    {
+        struct Registry
+        {
+            std::mutex mutex;
+            std::vector<ThreadProfile*> threads;
+            std::vector<std::string> names;
+            std::vector<ThreadTrace> retired;
+            std::uint32_t next_id{0};
+        };
+
+        Registry& registry()
+        {
+            // Leaked on purpose so that threads exiting during static
+            // destruction can still retire their events.
+            static auto instance = new Registry;
+            return *instance;
+        }
+
+        // Must be called with the registry locked.
+        std::string& thread_name(Registry& reg, std::uint32_t id)
+        {
+            if (id >= reg.names.size())
+            {
+                reg.names.resize(id + 1);
+            }
+
+            return reg.names[id];
+        }
+
+        ThreadTrace make_trace(Registry& reg, ThreadProfile const& profile)
+        {
+            ThreadTrace trace;
+            trace.thread_id = profile.thread_id;
+            trace.name      = thread_name(reg, profile.thread_id);
+
+            auto count{profile.count.load(std::memory_order_acquire)};
+            auto kept{std::min<std::uint64_t>(count, profile_buffer_size)};
+            trace.dropped = count - kept;
+            trace.events.reserve(kept);
+            for (auto i{count - kept}; i < count; ++i)
+            {
+                trace.events.push_back(
+                    profile.events[i % profile_buffer_size]);
+            }
+
+            return trace;
+        }
+
+        // Owns the ring buffer of one thread and hands its events over to
+        // the registry when the thread exits.
+        class ThreadProfileHolder
+        {
+        public:
+            ThreadProfileHolder()
+            {
+                auto& reg = registry();
+                std::scoped_lock lock{reg.mutex};
+                m_profile.thread_id = reg.next_id++;
+                reg.threads.push_back(&m_profile);
+            }
+
+            ~ThreadProfileHolder()
+            {
+                detail::current_thread_profile = nullptr;
+
+                auto& reg = registry();
+                std::scoped_lock lock{reg.mutex};
+                if (m_profile.count.load(std::memory_order_relaxed) != 0)
+                {
+                    reg.retired.push_back(make_trace(reg, m_profile));
+                }
+
+                reg.threads.erase(std::remove(reg.threads.begin(),
+                                              reg.threads.end(),
+                                              &m_profile),
+                                  reg.threads.end());
+            }
+
+            ThreadProfile& profile()
+            {
+                return m_profile;
+            }
+
+        private:
+            ThreadProfile m_profile;
+        };
+
+        std::string escape(std::string const& str)
+        {
+            std::string result;
+            for (auto c : str)
+            {
+                if (c == '"' || c == '\\')
+                {
+                    result.push_back('\\');
+                }
+                else if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    continue;
+                }
+                result.push_back(c);
+            }
+
+            return result;
+        }
+    } // namespace
+
+    namespace detail
+    {
+        thread_local ThreadProfile* current_thread_profile{nullptr};
+
+        ThreadProfile& register_thread_profile()
+        {
+            thread_local ThreadProfileHolder holder;
+            current_thread_profile = &holder.profile();
+            return holder.profile();
+        }
+    } // namespace detail
+
+    void set_profile_thread_name(std::string const& name)
+    {
+        auto id{detail::thread_profile().thread_id};
+
+        auto& reg = registry();
+        std::scoped_lock lock{reg.mutex};
+        thread_name(reg, id) = name;
+    }
+
+    std::vector<ThreadTrace> collect_profile()
+    {
+        auto& reg = registry();
+        std::scoped_lock lock{reg.mutex};
+
+        std::vector<ThreadTrace> traces{reg.retired};
+        for (auto profile : reg.threads)
+        {
+            if (profile->count.load(std::memory_order_acquire) != 0)
+            {
+                traces.push_back(make_trace(reg, *profile));
+            }
+        }
+
+        std::sort(traces.begin(),
+                  traces.end(),
+                  [](ThreadTrace const& a, ThreadTrace const& b) {
+                      return a.thread_id < b.thread_id;
+                  });
+        return traces;
+    }
+
+    void reset_profile()
+    {
+        auto& reg = registry();
+        std::scoped_lock lock{reg.mutex};
+
+        reg.retired.clear();
+        for (auto profile : reg.threads)
+        {
+            profile->count.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    std::string profile_to_chrome_json(std::vector<ThreadTrace> const& traces)
+    {
+        auto origin{std::numeric_limits<std::uint64_t>::max()};
+        for (auto& trace : traces)
+        {
+            for (auto& event : trace.events)
+            {
+                origin = std::min(origin, event.start_ns);
+            }
+        }
+
+        auto micros = [origin](std::uint64_t ns) {
+            return static_cast<double>(ns - origin) / 1000.0;
+        };
+
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(3);
+        out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+
+        bool first{true};
+        auto separator = [&first]() {
+            auto sep{first ? "\n" : ",\n"};
+            first = false;
+            return sep;
+        };
+
+        for (auto& trace : traces)
+        {
+            auto name{trace.name.empty()
+                          ? "thread " + std::to_string(trace.thread_id)
+                          : trace.name};
+            out << separator()
+                << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, "
+                << "\"tid\": " << trace.thread_id
+                << ", \"args\": {\"name\": \"" << escape(name) << "\"}}";
+            out << separator()
+                << "{\"name\": \"thread_sort_index\", \"ph\": \"M\", "
+                << "\"pid\": 1, \"tid\": " << trace.thread_id
+                << ", \"args\": {\"sort_index\": " << trace.thread_id
+                << "}}";
+
+            for (auto& event : trace.events)
+            {
+                out << separator() << "{\"name\": \""
+                    << escape(event.name != nullptr ? event.name : "")
+                    << "\", \"cat\": \"apollo\", \"ph\": \"X\", \"pid\": 1, "
+                    << "\"tid\": " << trace.thread_id
+                    << ", \"ts\": " << micros(event.start_ns)
+                    << ", \"dur\": "
+                    << static_cast<double>(event.end_ns - event.start_ns) /
+                           1000.0;
+
+                std::vector<std::string> args;
+                if (event.arg >= 0)
+                {
+                    args.push_back("\"index\": " + std::to_string(event.arg));
+                }
+
+                for (std::size_t i{0}; i < num_perf_counters; ++i)
+                {
+                    auto counter{static_cast<PerfCounter>(i)};
+                    if (event.counters.has(counter))
+                    {
+                        auto value{event.counters[counter]};
+                        args.push_back('"' +
+                                       std::string{perf_counter_name(counter)} +
+                                       "\": " + std::to_string(value));
+                    }
+                }
+
+                if (event.counters.ipc() > 0)
+                {
+                    std::ostringstream ipc;
+                    ipc << "\"ipc\": " << event.counters.ipc();
+                    args.push_back(ipc.str());
+                }
+
+                if (!args.empty())
+                {
+                    out << ", \"args\": {";
+                    for (std::size_t i{0}; i < args.size(); ++i)
+                    {
+                        out << (i == 0 ? "" : ", ") << args[i];
+                    }
+                    out << "}";
+                }
+                out << "}";
+            }
+        }
+
+        out << "\n]}\n";
+        return out.str();
+    }
+
+    void write_chrome_trace(std::string const& path)
+    {
+        std::ofstream file{path};
+        if (!(file << profile_to_chrome_json(collect_profile())))
+        {
+            throw std::runtime_error{"error: unable to write trace to " +
+                                     path};
+        }
+    }
+} // namespace core
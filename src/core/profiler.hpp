@@ -0,0 +1,180 @@
+#pragma once
+
+#include "perf_counters.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace core
+{
+    // A completed zone. The name must have static storage duration (or at
+    // least outlive the export), as only the pointer is recorded.
+    struct ProfileEvent
+    {
+        char const* name{nullptr};
+        std::uint64_t start_ns{0};
+        std::uint64_t end_ns{0};
+
+        // Optional payload such as a tile index, negative when unused.
+        std::int64_t arg{-1};
+
+        // Hardware counters spent inside the zone, empty unless enabled
+        // with set_profile_counters.
+        PerfCounterValues counters{};
+    };
+
+    // Number of events each thread keeps. Once full, the oldest events are
+    // overwritten.
+    inline constexpr std::size_t profile_buffer_size{1 << 14};
+
+    // Ring buffer owned by a single thread. Only the owning thread writes
+    // it; `count` is the total number of events ever recorded and is
+    // published with release semantics so the buffer can be read once the
+    // thread has finished working.
+    struct ThreadProfile
+    {
+        std::vector<ProfileEvent> events =
+            std::vector<ProfileEvent>(profile_buffer_size);
+        std::atomic<std::uint64_t> count{0};
+        std::uint32_t thread_id{0};
+    };
+
+    namespace detail
+    {
+        extern thread_local ThreadProfile* current_thread_profile;
+
+        ThreadProfile& register_thread_profile();
+
+        inline ThreadProfile& thread_profile()
+        {
+            auto profile = current_thread_profile;
+            return (profile != nullptr) ? *profile : register_thread_profile();
+        }
+
+        inline std::atomic<bool> profile_counters{false};
+    } // namespace detail
+
+    // Makes every zone also read the hardware counters of its thread. Each
+    // read is a system call, so this is best left off for very small zones.
+    inline void set_profile_counters(bool enabled)
+    {
+        detail::profile_counters.store(enabled, std::memory_order_relaxed);
+    }
+
+    inline bool profile_counters_enabled()
+    {
+        return detail::profile_counters.load(std::memory_order_relaxed);
+    }
+
+    // Nanoseconds on a monotonic clock.
+    inline std::uint64_t profile_now()
+    {
+        return static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch())
+                .count());
+    }
+
+    inline void record_profile_event(ProfileEvent const& event)
+    {
+        auto& profile = detail::thread_profile();
+        auto count{profile.count.load(std::memory_order_relaxed)};
+        profile.events[count % profile_buffer_size] = event;
+        profile.count.store(count + 1, std::memory_order_release);
+    }
+
+    // Names the calling thread in exported traces.
+    void set_profile_thread_name(std::string const& name);
+
+    // Records the lifetime of the enclosing scope. Use the macros below
+    // rather than this class directly so zones compile out when the
+    // profiler is disabled.
+    class ProfileZone
+    {
+    public:
+        explicit ProfileZone(char const* name, std::int64_t arg = -1) :
+            m_name{name},
+            m_arg{arg},
+            m_counting{profile_counters_enabled()}
+        {
+            if (m_counting)
+            {
+                m_counters = thread_perf_counters().read();
+            }
+            m_start = profile_now();
+        }
+
+        ~ProfileZone()
+        {
+            ProfileEvent event{m_name, m_start, profile_now(), m_arg};
+            if (m_counting)
+            {
+                event.counters = thread_perf_counters().read() - m_counters;
+            }
+            record_profile_event(event);
+        }
+
+        ProfileZone(ProfileZone const&) = delete;
+        ProfileZone& operator=(ProfileZone const&) = delete;
+
+    private:
+        char const* m_name;
+        std::int64_t m_arg;
+        bool m_counting;
+        PerfCounterValues m_counters;
+        std::uint64_t m_start{0};
+    };
+
+    struct ThreadTrace
+    {
+        std::uint32_t thread_id{0};
+        std::string name;
+
+        // Events in the order they finished.
+        std::vector<ProfileEvent> events;
+
+        // Events lost because the ring buffer wrapped around.
+        std::uint64_t dropped{0};
+    };
+
+    // Gathers the events of every thread that has recorded a zone, including
+    // threads that have already exited. As with the statistics, this is
+    // meant to be called once the profiled work has finished.
+    std::vector<ThreadTrace> collect_profile();
+
+    // Discards every recorded event.
+    void reset_profile();
+
+    // Chrome trace-event JSON, viewable in chrome://tracing or Perfetto.
+    // Timestamps are relative to the earliest event.
+    std::string profile_to_chrome_json(std::vector<ThreadTrace> const& traces);
+
+    void write_chrome_trace(std::string const& path);
+} // namespace core
+
+#define APOLLO_PROFILE_CONCAT_IMPL(a, b) a##b
+#define APOLLO_PROFILE_CONCAT(a, b) APOLLO_PROFILE_CONCAT_IMPL(a, b)
+
+#if defined(APOLLO_ENABLE_PROFILER)
+#    define APOLLO_PROFILE_ZONE(name)                  \
+        ::core::ProfileZone APOLLO_PROFILE_CONCAT(    \
+            apollo_profile_zone_, __LINE__)           \
+        {                                             \
+            name                                      \
+        }
+#    define APOLLO_PROFILE_ZONE_ARG(name, arg)        \
+        ::core::ProfileZone APOLLO_PROFILE_CONCAT(    \
+            apollo_profile_zone_, __LINE__)           \
+        {                                             \
+            name, static_cast<std::int64_t>(arg)      \
+        }
+#    define APOLLO_PROFILE_THREAD_NAME(name) \
+        ::core::set_profile_thread_name(name)
+#else
+#    define APOLLO_PROFILE_ZONE(name)
+#    define APOLLO_PROFILE_ZONE_ARG(name, arg)
+#    define APOLLO_PROFILE_THREAD_NAME(name)
+#endif
@@ -0,0 +1,198 @@
+#pragma once
+
+#include "matrix.hpp"
+#include "vector.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace core
+{
+    // Rotation stored as a unit quaternion w + v, which interpolates along
+    // the shortest arc between two orientations (see slerp()). A default
+    // constructed quaternion is the identity.
+    template<typename T>
+    class Quaternion
+    {
+    public:
+        Quaternion() = default;
+
+        Quaternion(Vector3<T> const& vec, T scalar) : v{vec}, w{scalar}
+        {}
+
+        // Rotation held in the upper 3x3 block of `mat`, which must be
+        // orthonormal with a positive determinant.
+        explicit Quaternion(Matrix<T> const& mat)
+        {
+            auto trace{mat(0, 0) + mat(1, 1) + mat(2, 2)};
+            if (trace > T{0})
+            {
+                auto s{static_cast<T>(std::sqrt(trace + T{1}))};
+                w = s * T{0.5};
+                s = T{0.5} / s;
+                v[0] = (mat(2, 1) - mat(1, 2)) * s;
+                v[1] = (mat(0, 2) - mat(2, 0)) * s;
+                v[2] = (mat(1, 0) - mat(0, 1)) * s;
+                return;
+            }
+
+            // Near a half turn w is small, so the largest component of v is
+            // found first and the others are derived from it.
+            std::size_t i{0};
+            if (mat(1, 1) > mat(0, 0))
+            {
+                i = 1;
+            }
+            if (mat(2, 2) > mat(i, i))
+            {
+                i = 2;
+            }
+            auto j{(i + 1) % 3};
+            auto k{(j + 1) % 3};
+
+            auto s{static_cast<T>(
+                std::sqrt(mat(i, i) - mat(j, j) - mat(k, k) + T{1}))};
+            v[i] = s * T{0.5};
+            if (s != T{0})
+            {
+                s = T{0.5} / s;
+            }
+            w    = (mat(k, j) - mat(j, k)) * s;
+            v[j] = (mat(j, i) + mat(i, j)) * s;
+            v[k] = (mat(k, i) + mat(i, k)) * s;
+        }
+
+        Matrix<T> to_matrix() const
+        {
+            auto xx{v[0] * v[0]}, yy{v[1] * v[1]}, zz{v[2] * v[2]};
+            auto xy{v[0] * v[1]}, xz{v[0] * v[2]}, yz{v[1] * v[2]};
+            auto wx{v[0] * w}, wy{v[1] * w}, wz{v[2] * w};
+
+            Matrix<T> mat(T{1});
+            mat(0, 0) = T{1} - T{2} * (yy + zz);
+            mat(0, 1) = T{2} * (xy - wz);
+            mat(0, 2) = T{2} * (xz + wy);
+            mat(1, 0) = T{2} * (xy + wz);
+            mat(1, 1) = T{1} - T{2} * (xx + zz);
+            mat(1, 2) = T{2} * (yz - wx);
+            mat(2, 0) = T{2} * (xz - wy);
+            mat(2, 1) = T{2} * (yz + wx);
+            mat(2, 2) = T{1} - T{2} * (xx + yy);
+            return mat;
+        }
+
+        Vector3<T> v;
+        T w{1};
+    };
+
+    template<typename T>
+    Quaternion<T> operator+(Quaternion<T> const& lhs, Quaternion<T> const& rhs)
+    {
+        return Quaternion<T>{lhs.v + rhs.v, lhs.w + rhs.w};
+    }
+
+    template<typename T>
+    Quaternion<T> operator-(Quaternion<T> const& lhs, Quaternion<T> const& rhs)
+    {
+        return Quaternion<T>{lhs.v - rhs.v, lhs.w - rhs.w};
+    }
+
+    template<typename T>
+    Quaternion<T> operator-(Quaternion<T> const& q)
+    {
+        return Quaternion<T>{-q.v, -q.w};
+    }
+
+    template<typename T>
+    Quaternion<T> operator*(Quaternion<T> const& q, T s)
+    {
+        return Quaternion<T>{q.v * s, q.w * s};
+    }
+
+    template<typename T>
+    Quaternion<T> operator*(T s, Quaternion<T> const& q)
+    {
+        return q * s;
+    }
+
+    template<typename T>
+    T dot(Quaternion<T> const& lhs, Quaternion<T> const& rhs)
+    {
+        return dot(lhs.v, rhs.v) + lhs.w * rhs.w;
+    }
+
+    template<typename T>
+    Quaternion<T> normalise(Quaternion<T> const& q)
+    {
+        return q * (T{1} / static_cast<T>(std::sqrt(dot(q, q))));
+    }
+
+    // Angle of the arc between two unit quaternions on the 4D sphere, which
+    // is half the angle of the rotation taking one orientation to the other.
+    template<typename T>
+    T angle_between(Quaternion<T> const& q0, Quaternion<T> const& q1)
+    {
+        auto cos_theta{std::clamp(dot(q0, q1), T{-1}, T{1})};
+        return static_cast<T>(std::acos(cos_theta));
+    }
+
+    // Great arc from `q0` at t = 0 to `q1` at t = 1, along which the
+    // rotation turns at a constant rate. The angle and the direction of the
+    // arc are found once, so each point along it costs a sine and a cosine.
+    // Takes the long way round if the two quaternions are more than a
+    // quarter turn apart on the 4D sphere; flip the sign of one of them to
+    // avoid that.
+    template<typename T>
+    class QuaternionArc
+    {
+    public:
+        QuaternionArc() = default;
+
+        QuaternionArc(Quaternion<T> const& q0, Quaternion<T> const& q1) :
+            m_q0{q0}, m_q1{q1}
+        {
+            auto cos_theta{dot(q0, q1)};
+
+            // Nearly parallel, where the perpendicular is not defined.
+            m_linear = cos_theta > T{0.9995};
+            if (!m_linear)
+            {
+                m_theta = angle_between(q0, q1);
+                m_perp  = normalise(q1 - q0 * cos_theta);
+            }
+        }
+
+        Quaternion<T> operator()(T t) const
+        {
+            if (m_linear)
+            {
+                return normalise(m_q0 * (T{1} - t) + m_q1 * t);
+            }
+
+            auto theta{m_theta * t};
+            return m_q0 * static_cast<T>(std::cos(theta)) +
+                   m_perp * static_cast<T>(std::sin(theta));
+        }
+
+        // Arc between the end points, half the angle the rotation turns
+        // through.
+        T angle() const
+        {
+            return m_linear ? angle_between(m_q0, m_q1) : m_theta;
+        }
+
+    private:
+        Quaternion<T> m_q0;
+        Quaternion<T> m_q1;
+        Quaternion<T> m_perp;
+        T m_theta{0};
+        bool m_linear{true};
+    };
+
+    // Spherical linear interpolation; see QuaternionArc.
+    template<typename T>
+    Quaternion<T> slerp(T t, Quaternion<T> const& q0, Quaternion<T> const& q1)
+    {
+        return QuaternionArc<T>{q0, q1}(t);
+    }
+} // namespace core
@@ -13,7 +13,8 @@ namespace core
     public:
         Ray() = default;
 
-        Ray(Point3<T> const& origin, Point3<T> const& dir) : o{origin}, d{dir}
+        Ray(Point3<T> const& origin, Point3<T> const& dir, T t = T{0}) :
+            o{origin}, d{dir}, time{t}
         {}
 
         Point3<T> operator()(T t) const
@@ -23,6 +24,10 @@ namespace core
 
         Point3<T> o;
         Vector3<T> d;
+
+        // Instant within the shutter interval at which the ray is traced,
+        // for geometry that moves (see AnimatedTransform).
+        T time{0};
     };
 
     template<typename T>
@@ -0,0 +1,218 @@
+#pragma once
+
+#include "bounds.hpp"
+#include "ray.hpp"
+#include "vector.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace core
+{
+    // Bit of each lane in a lane mask. Loops over lanes test and build masks
+    // through this table rather than by shifting, which keeps them
+    // vectorisable.
+    template<std::size_t N>
+    constexpr std::array<std::uint32_t, N> lane_bits()
+    {
+        std::array<std::uint32_t, N> bits{};
+        for (std::size_t lane{0}; lane < N; ++lane)
+        {
+            bits[lane] = std::uint32_t{1} << lane;
+        }
+        return bits;
+    }
+
+    // Up to N rays stored as structure of arrays, one lane per ray. Which
+    // lanes are in use is given by a separate bit mask, so the same packet
+    // can be narrowed as lanes finish without being copied. Unused lanes are
+    // zero, which lets per-lane loops run over every lane and mask the
+    // results afterwards.
+    template<typename T, std::size_t N>
+    class RayPacket
+    {
+    public:
+        static_assert(std::is_floating_point<T>::value);
+        static_assert(N > 0 && N <= 32, "lane masks are 32 bits wide");
+
+        static constexpr std::size_t num_lanes{N};
+
+        static constexpr std::uint32_t full_mask()
+        {
+            return (N == 32) ? ~std::uint32_t{0}
+                             : (std::uint32_t{1} << N) - 1;
+        }
+
+        // The reciprocal direction is computed exactly as single-ray
+        // traversal does, so both agree on every box test.
+        void set(std::size_t lane, Ray<T> const& ray)
+        {
+            for (std::size_t i{0}; i < 3; ++i)
+            {
+                o[i][lane]     = ray.o[i];
+                d[i][lane]     = ray.d[i];
+                inv_d[i][lane] = T{1} / ray.d[i];
+            }
+            time[lane] = ray.time;
+        }
+
+        Ray<T> ray(std::size_t lane) const
+        {
+            return Ray<T>{Point3<T>{o[0][lane], o[1][lane], o[2][lane]},
+                          Vector3<T>{d[0][lane], d[1][lane], d[2][lane]},
+                          time[lane]};
+        }
+
+        Vector3<T> inv_dir(std::size_t lane) const
+        {
+            return Vector3<T>{inv_d[0][lane], inv_d[1][lane], inv_d[2][lane]};
+        }
+
+        std::array<std::array<T, N>, 3> o{};
+        std::array<std::array<T, N>, 3> d{};
+        std::array<std::array<T, N>, 3> inv_d{};
+        std::array<T, N> time{};
+    };
+
+    // Slab test of every lane of `packet` against `b`, computed exactly as
+    // the single-ray intersect_p() does. Lanes must share `dir_is_neg`.
+    // Returns the lanes of `mask` that pass.
+    template<typename T, std::size_t N>
+    std::uint32_t intersect_p(Bounds3<T> const& b,
+                              RayPacket<T, N> const& packet,
+                              std::uint32_t mask,
+                              std::array<int, 3> const& dir_is_neg,
+                              std::array<T, N> const& t_max)
+    {
+        std::array<T, N> t_min{}, t_far{};
+        for (std::size_t i{0}; i < 3; ++i)
+        {
+            auto near_plane{b[dir_is_neg[i]][i]};
+            auto far_plane{b[1 - dir_is_neg[i]][i]};
+            auto& o     = packet.o[i];
+            auto& inv_d = packet.inv_d[i];
+            for (std::size_t lane{0}; lane < N; ++lane)
+            {
+                auto near{(near_plane - o[lane]) * inv_d[lane]};
+                auto far{(far_plane - o[lane]) * inv_d[lane]};
+                if (i == 0)
+                {
+                    t_min[lane] = near;
+                    t_far[lane] = far;
+                }
+                else
+                {
+                    t_min[lane] = (near > t_min[lane]) ? near : t_min[lane];
+                    t_far[lane] = (far < t_far[lane]) ? far : t_far[lane];
+                }
+            }
+        }
+
+        constexpr auto bits{lane_bits<N>()};
+        std::uint32_t passed{0};
+        for (std::size_t lane{0}; lane < N; ++lane)
+        {
+            auto active{mask & bits[lane]};
+            bool hit = (t_min[lane] <= t_far[lane]) & (t_far[lane] > T{0}) &
+                       (t_min[lane] < t_max[lane]) & (active != 0);
+            passed |= hit ? active : 0;
+        }
+        return passed;
+    }
+
+    // Ranges of the origins and reciprocal directions of the active lanes of
+    // a packet. Only valid if every lane points the same way along each
+    // axis and no direction component is zero.
+    template<typename T>
+    struct PacketInterval
+    {
+        Vector3<T> o_min, o_max;
+        Vector3<T> inv_min, inv_max;
+        std::array<int, 3> dir_is_neg{0, 0, 0};
+        bool valid{false};
+    };
+
+    template<typename T, std::size_t N>
+    PacketInterval<T> packet_interval(RayPacket<T, N> const& packet,
+                                      std::uint32_t mask)
+    {
+        constexpr auto inf{std::numeric_limits<T>::infinity()};
+        PacketInterval<T> interval;
+        if (mask == 0)
+        {
+            return interval;
+        }
+
+        constexpr auto bits{lane_bits<N>()};
+        for (std::size_t i{0}; i < 3; ++i)
+        {
+            auto o_min{inf}, o_max{-inf}, inv_min{inf}, inv_max{-inf};
+            bool nan{false};
+            for (std::size_t lane{0}; lane < N; ++lane)
+            {
+                auto used{(mask & bits[lane]) != 0};
+                auto o{packet.o[i][lane]};
+                auto inv{packet.inv_d[i][lane]};
+                o_min   = std::min(o_min, used ? o : inf);
+                o_max   = std::max(o_max, used ? o : -inf);
+                inv_min = std::min(inv_min, used ? inv : inf);
+                inv_max = std::max(inv_max, used ? inv : -inf);
+                nan     = nan | (used & (inv != inv));
+            }
+
+            if (nan || !std::isfinite(inv_min) || !std::isfinite(inv_max) ||
+                (inv_min < 0) != (inv_max < 0))
+            {
+                return interval;
+            }
+
+            interval.o_min[i]      = o_min;
+            interval.o_max[i]      = o_max;
+            interval.inv_min[i]    = inv_min;
+            interval.inv_max[i]    = inv_max;
+            interval.dir_is_neg[i] = inv_max < 0;
+        }
+
+        interval.valid = true;
+        return interval;
+    }
+
+    // Returns false only if no ray of the interval can pass the slab test
+    // against `b` with a t_max of at most `t_max`. Rounding is monotonic, so
+    // the slab distances of every lane, computed as in the single-ray test,
+    // lie between those computed at the corners of the interval.
+    template<typename T>
+    bool intersect_p(Bounds3<T> const& b,
+                     PacketInterval<T> const& interval,
+                     T t_max)
+    {
+        // Products at the four corners of (plane - o) x inv_d.
+        auto corners = [&](T plane, std::size_t i) {
+            auto lo{plane - interval.o_max[i]};
+            auto hi{plane - interval.o_min[i]};
+            return std::array<T, 4>{lo * interval.inv_min[i],
+                                    lo * interval.inv_max[i],
+                                    hi * interval.inv_min[i],
+                                    hi * interval.inv_max[i]};
+        };
+
+        auto& dir_is_neg = interval.dir_is_neg;
+        auto t_min{-std::numeric_limits<T>::infinity()};
+        auto t_far{std::numeric_limits<T>::infinity()};
+        for (std::size_t i{0}; i < 3; ++i)
+        {
+            auto near{corners(b[dir_is_neg[i]][i], i)};
+            auto far{corners(b[1 - dir_is_neg[i]][i], i)};
+            t_min = std::max(
+                {t_min, std::min({near[0], near[1], near[2], near[3]})});
+            t_far = std::min(
+                {t_far, std::max({far[0], far[1], far[2], far[3]})});
+        }
+
+        return t_min <= t_far && t_far > T{0} && t_min < t_max;
+    }
+} // namespace core
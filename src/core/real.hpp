@@ -2,9 +2,23 @@
 
 namespace core
 {
+    // Precision of geometry, rays, traversal and shading.
 #if defined(APOLLO_USE_FLOAT)
     using Real = float;
 #elif defined(APOLLO_USE_DOUBLE)
     using Real = double;
 #endif
+
+    // Precision of long sums, such as the radiance gathered along a path
+    // and the samples of a pixel, where the rounding of every addition
+    // builds up. Mixed-precision builds keep Real as float for bandwidth
+    // and SIMD width and only widen these. Values cross between the two
+    // through explicit conversions such as vector_cast().
+#if defined(APOLLO_USE_MIXED_PRECISION)
+    using AccumReal = double;
+#else
+    using AccumReal = Real;
+#endif
+
+    static_assert(sizeof(AccumReal) >= sizeof(Real));
 } // namespace core
@@ -0,0 +1,230 @@
+#pragma once
+
+#include "bits.hpp"
+#include "real.hpp"
+#include "vector.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+namespace core
+{
+    using PhiloxCounter = std::array<std::uint32_t, 4>;
+    using PhiloxKey     = std::array<std::uint32_t, 2>;
+
+    namespace philox
+    {
+        inline constexpr std::uint32_t multiplier_0{0xd2511f53};
+        inline constexpr std::uint32_t multiplier_1{0xcd9e8d57};
+        inline constexpr std::uint32_t weyl_0{0x9e3779b9};
+        inline constexpr std::uint32_t weyl_1{0xbb67ae85};
+        inline constexpr std::size_t rounds{10};
+
+        // Number of counters evaluated side by side by the batched path.
+        // Each lane is independent, so the loops below map directly onto
+        // vector registers.
+        inline constexpr std::size_t lanes{8};
+    } // namespace philox
+
+    // Philox4x32-10 (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2,
+    // 3"). A bijection of the 128-bit counter for every key, so distinct
+    // counters never produce correlated streams.
+    constexpr PhiloxCounter philox_4x32(PhiloxCounter ctr, PhiloxKey key)
+    {
+        for (std::size_t r{0}; r < philox::rounds; ++r)
+        {
+            auto p0{std::uint64_t{philox::multiplier_0} * ctr[0]};
+            auto p1{std::uint64_t{philox::multiplier_1} * ctr[2]};
+
+            ctr = {static_cast<std::uint32_t>(p1 >> 32) ^ ctr[1] ^ key[0],
+                   static_cast<std::uint32_t>(p1),
+                   static_cast<std::uint32_t>(p0 >> 32) ^ ctr[3] ^ key[1],
+                   static_cast<std::uint32_t>(p0)};
+
+            key[0] += philox::weyl_0;
+            key[1] += philox::weyl_1;
+        }
+
+        return ctr;
+    }
+
+    // Structure-of-arrays version of philox_4x32 that evaluates
+    // philox::lanes counters at once.
+    inline void philox_4x32_lanes(std::uint32_t* x0,
+                                  std::uint32_t* x1,
+                                  std::uint32_t* x2,
+                                  std::uint32_t* x3,
+                                  PhiloxKey key)
+    {
+        for (std::size_t r{0}; r < philox::rounds; ++r)
+        {
+            for (std::size_t l{0}; l < philox::lanes; ++l)
+            {
+                auto p0{std::uint64_t{philox::multiplier_0} * x0[l]};
+                auto p1{std::uint64_t{philox::multiplier_1} * x2[l]};
+
+                auto y0{static_cast<std::uint32_t>(p1 >> 32) ^ x1[l] ^ key[0]};
+                auto y2{static_cast<std::uint32_t>(p0 >> 32) ^ x3[l] ^ key[1]};
+
+                x1[l] = static_cast<std::uint32_t>(p1);
+                x3[l] = static_cast<std::uint32_t>(p0);
+                x0[l] = y0;
+                x2[l] = y2;
+            }
+
+            key[0] += philox::weyl_0;
+            key[1] += philox::weyl_1;
+        }
+    }
+
+    // Stateless random number generator. Every value is a pure function of
+    // (seed, pixel, sample, dimension), so results do not depend on which
+    // thread evaluates them or in what order, and there is no state to share
+    // between threads.
+    //
+    // Each Philox evaluation yields 128 bits, which are split into four
+    // floats or two doubles. Dimension d therefore lives in block
+    // d / values_per_block<T>, and the single-value and batched paths agree
+    // bit for bit.
+    class CounterRng
+    {
+    public:
+        template<typename T>
+        static constexpr std::uint32_t values_per_block{
+            std::is_same<T, float>::value ? 4 : 2};
+
+        CounterRng() = default;
+
+        explicit CounterRng(std::uint64_t seed) :
+            m_key{static_cast<std::uint32_t>(seed),
+                  static_cast<std::uint32_t>(seed >> 32)}
+        {}
+
+        static std::uint64_t pixel_index(Point2<int> const& pixel)
+        {
+            return std::uint64_t{static_cast<std::uint32_t>(pixel[0])} |
+                   (std::uint64_t{static_cast<std::uint32_t>(pixel[1])}
+                    << 32);
+        }
+
+        template<typename T = Real>
+        T uniform(std::uint64_t pixel,
+                  std::uint32_t sample,
+                  std::uint32_t dimension) const
+        {
+            static_assert(std::is_floating_point<T>::value);
+
+            constexpr auto per_block{values_per_block<T>};
+            auto out = philox_4x32(
+                make_counter(dimension / per_block, sample, pixel), m_key);
+            return to_unit<T>(out.data(), dimension % per_block);
+        }
+
+        template<typename T = Real>
+        T uniform(Point2<int> const& pixel,
+                  std::uint32_t sample,
+                  std::uint32_t dimension) const
+        {
+            return uniform<T>(pixel_index(pixel), sample, dimension);
+        }
+
+        // Writes the values of dimensions [first_dimension, first_dimension +
+        // count) to `out`.
+        template<typename T = Real>
+        void fill_uniform(std::uint64_t pixel,
+                          std::uint32_t sample,
+                          std::uint32_t first_dimension,
+                          std::size_t count,
+                          T* out) const
+        {
+            static_assert(std::is_floating_point<T>::value);
+
+            if (count == 0)
+            {
+                return;
+            }
+
+            constexpr auto per_block{values_per_block<T>};
+            auto first_block{first_dimension / per_block};
+            auto last_block{static_cast<std::uint32_t>(
+                (first_dimension + count - 1) / per_block)};
+
+            std::array<std::uint32_t, philox::lanes> x0, x1, x2, x3;
+            for (auto block{first_block}; block <= last_block;
+                 block += philox::lanes)
+            {
+                for (std::size_t l{0}; l < philox::lanes; ++l)
+                {
+                    x0[l] = block + static_cast<std::uint32_t>(l);
+                    x1[l] = sample;
+                    x2[l] = static_cast<std::uint32_t>(pixel);
+                    x3[l] = static_cast<std::uint32_t>(pixel >> 32);
+                }
+
+                philox_4x32_lanes(
+                    x0.data(), x1.data(), x2.data(), x3.data(), m_key);
+
+                auto num_blocks{std::min<std::size_t>(philox::lanes,
+                                                      last_block - block + 1)};
+                for (std::size_t l{0}; l < num_blocks; ++l)
+                {
+                    std::uint32_t words[4]{x0[l], x1[l], x2[l], x3[l]};
+                    for (std::uint32_t w{0}; w < per_block; ++w)
+                    {
+                        auto dim{std::size_t{block + l} * per_block + w};
+                        if (dim >= first_dimension &&
+                            dim < first_dimension + count)
+                        {
+                            out[dim - first_dimension] = to_unit<T>(words, w);
+                        }
+                    }
+                }
+
+                if (last_block - block < philox::lanes)
+                {
+                    break;
+                }
+            }
+        }
+
+        template<typename T = Real>
+        void fill_uniform(Point2<int> const& pixel,
+                          std::uint32_t sample,
+                          std::uint32_t first_dimension,
+                          std::size_t count,
+                          T* out) const
+        {
+            fill_uniform<T>(
+                pixel_index(pixel), sample, first_dimension, count, out);
+        }
+
+    private:
+        static constexpr PhiloxCounter make_counter(std::uint32_t block,
+                                                    std::uint32_t sample,
+                                                    std::uint64_t pixel)
+        {
+            return {block,
+                    sample,
+                    static_cast<std::uint32_t>(pixel),
+                    static_cast<std::uint32_t>(pixel >> 32)};
+        }
+
+        template<typename T>
+        static T to_unit(std::uint32_t const* words, std::uint32_t i)
+        {
+            if constexpr (std::is_same<T, float>::value)
+            {
+                return unit_from_bits<T>(std::uint64_t{words[i]} << 32);
+            }
+            else
+            {
+                return unit_from_bits<T>(
+                    (std::uint64_t{words[2 * i]} << 32) | words[2 * i + 1]);
+            }
+        }
+
+        PhiloxKey m_key{0, 0};
+    };
+} // namespace core
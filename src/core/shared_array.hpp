@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace core
+{
+    // Read-only contiguous array whose storage is either owned, when built
+    // from a std::vector, or borrowed from memory kept alive by an owner
+    // such as a memory-mapped file. Copies share the same storage.
+    template<typename T>
+    class SharedArray
+    {
+    public:
+        SharedArray() = default;
+
+        explicit SharedArray(std::vector<T> values)
+        {
+            auto storage =
+                std::make_shared<std::vector<T> const>(std::move(values));
+            m_data  = storage->data();
+            m_size  = storage->size();
+            m_owner = std::move(storage);
+        }
+
+        // Borrows `size` elements at `data`, which must remain valid for as
+        // long as `owner` is alive.
+        SharedArray(T const* data,
+                    std::size_t size,
+                    std::shared_ptr<void const> owner) :
+            m_data{data}, m_size{size}, m_owner{std::move(owner)}
+        {}
+
+        T const& operator[](std::size_t i) const
+        {
+            return m_data[i];
+        }
+
+        T const* data() const
+        {
+            return m_data;
+        }
+
+        std::size_t size() const
+        {
+            return m_size;
+        }
+
+        bool empty() const
+        {
+            return m_size == 0;
+        }
+
+        T const* begin() const
+        {
+            return m_data;
+        }
+
+        T const* end() const
+        {
+            return m_data + m_size;
+        }
+
+        T const& front() const
+        {
+            return m_data[0];
+        }
+
+        T const& back() const
+        {
+            return m_data[m_size - 1];
+        }
+
+    private:
+        T const* m_data{nullptr};
+        std::size_t m_size{0};
+        std::shared_ptr<void const> m_owner;
+    };
+} // namespace core
@@ -0,0 +1,250 @@
+#include "stats.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace core
+{
+    namespace
+    {
+        struct Registry
+        {
+            std::mutex mutex;
+            std::vector<ThreadStats*> threads;
+            StatsReport retired;
+        };
+
+        Registry& registry()
+        {
+            // Leaked on purpose so that threads exiting during static
+            // destruction can still retire their counters.
+            static auto instance = new Registry;
+            return *instance;
+        }
+
+        void accumulate(StatsReport& report, ThreadStats const& stats)
+        {
+            for (std::size_t i{0}; i < num_stat_counters; ++i)
+            {
+                report.counters[i] +=
+                    stats.counters[i].load(std::memory_order_relaxed);
+            }
+
+            for (std::size_t i{0}; i < num_path_length_buckets; ++i)
+            {
+                report.path_lengths[i] +=
+                    stats.path_lengths[i].load(std::memory_order_relaxed);
+            }
+        }
+
+        // Owns the counters of one thread and hands them over to the
+        // registry when the thread exits.
+        class ThreadStatsHolder
+        {
+        public:
+            ThreadStatsHolder()
+            {
+                auto& reg = registry();
+                std::scoped_lock lock{reg.mutex};
+                reg.threads.push_back(&m_stats);
+            }
+
+            ~ThreadStatsHolder()
+            {
+                detail::current_thread_stats = nullptr;
+
+                auto& reg = registry();
+                std::scoped_lock lock{reg.mutex};
+                accumulate(reg.retired, m_stats);
+                reg.threads.erase(std::remove(reg.threads.begin(),
+                                              reg.threads.end(),
+                                              &m_stats),
+                                  reg.threads.end());
+            }
+
+            ThreadStats& stats()
+            {
+                return m_stats;
+            }
+
+        private:
+            ThreadStats m_stats;
+        };
+
+        double mean_path_length(StatsReport const& report)
+        {
+            std::uint64_t paths{0}, total{0};
+            for (std::size_t i{0}; i < num_path_length_buckets; ++i)
+            {
+                paths += report.path_lengths[i];
+                total += i * report.path_lengths[i];
+            }
+
+            return (paths == 0) ? 0.0 : static_cast<double>(total) / paths;
+        }
+
+        double ratio(std::uint64_t num, std::uint64_t den)
+        {
+            return (den == 0) ? 0.0 : static_cast<double>(num) / den;
+        }
+    } // namespace
+
+    namespace detail
+    {
+        thread_local ThreadStats* current_thread_stats{nullptr};
+
+        ThreadStats& register_thread_stats()
+        {
+            thread_local ThreadStatsHolder holder;
+            current_thread_stats = &holder.stats();
+            return holder.stats();
+        }
+    } // namespace detail
+
+    std::string_view stat_counter_name(StatCounter counter)
+    {
+        switch (counter)
+        {
+        case StatCounter::rays_traced:
+            return "rays_traced";
+        case StatCounter::shadow_rays:
+            return "shadow_rays";
+        case StatCounter::bvh_nodes_visited:
+            return "bvh_nodes_visited";
+        case StatCounter::primitive_tests:
+            return "primitive_tests";
+        case StatCounter::samples:
+            return "samples";
+        case StatCounter::pixels:
+            return "pixels";
+        case StatCounter::geometry_page_hits:
+            return "geometry_page_hits";
+        case StatCounter::geometry_page_misses:
+            return "geometry_page_misses";
+        case StatCounter::geometry_page_evictions:
+            return "geometry_page_evictions";
+        case StatCounter::path_suspensions:
+            return "path_suspensions";
+        default:
+            return "unknown";
+        }
+    }
+
+    StatsReport collect_stats()
+    {
+        auto& reg = registry();
+        std::scoped_lock lock{reg.mutex};
+
+        StatsReport report{reg.retired};
+        for (auto stats : reg.threads)
+        {
+            accumulate(report, *stats);
+        }
+
+        return report;
+    }
+
+    void reset_stats()
+    {
+        auto& reg = registry();
+        std::scoped_lock lock{reg.mutex};
+
+        reg.retired = {};
+        for (auto stats : reg.threads)
+        {
+            for (auto& counter : stats->counters)
+            {
+                counter.store(0, std::memory_order_relaxed);
+            }
+
+            for (auto& bucket : stats->path_lengths)
+            {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    std::string stats_to_text(StatsReport const& report)
+    {
+        std::ostringstream out;
+        out << "Render statistics\n";
+        for (std::size_t i{0}; i < num_stat_counters; ++i)
+        {
+            out << "  " << std::left << std::setw(24)
+                << stat_counter_name(static_cast<StatCounter>(i))
+                << report.counters[i] << '\n';
+        }
+
+        auto rays{report[StatCounter::rays_traced] +
+                  report[StatCounter::shadow_rays]};
+        out << "  " << std::setw(24) << "samples_per_pixel"
+            << ratio(report[StatCounter::samples], report[StatCounter::pixels])
+            << '\n';
+        out << "  " << std::setw(24) << "nodes_per_ray"
+            << ratio(report[StatCounter::bvh_nodes_visited], rays) << '\n';
+        out << "  " << std::setw(24) << "tests_per_ray"
+            << ratio(report[StatCounter::primitive_tests], rays) << '\n';
+        if (report.seconds > 0)
+        {
+            out << "  " << std::setw(24) << "rays_per_second"
+                << static_cast<double>(rays) / report.seconds << '\n';
+        }
+
+        out << "  " << std::setw(24) << "mean_path_length"
+            << mean_path_length(report) << '\n';
+        out << "Path length histogram\n";
+        for (std::size_t i{0}; i < num_path_length_buckets; ++i)
+        {
+            if (report.path_lengths[i] == 0)
+            {
+                continue;
+            }
+
+            out << "  " << std::right << std::setw(3) << i
+                << ((i == num_path_length_buckets - 1) ? "+" : " ") << "  "
+                << report.path_lengths[i] << '\n';
+        }
+
+        return out.str();
+    }
+
+    std::string stats_to_json(StatsReport const& report)
+    {
+        std::ostringstream out;
+        out << "{\"counters\": {";
+        for (std::size_t i{0}; i < num_stat_counters; ++i)
+        {
+            out << (i == 0 ? "" : ", ") << '"'
+                << stat_counter_name(static_cast<StatCounter>(i))
+                << "\": " << report.counters[i];
+        }
+
+        auto rays{report[StatCounter::rays_traced] +
+                  report[StatCounter::shadow_rays]};
+        auto rays_per_second{
+            (report.seconds > 0) ? static_cast<double>(rays) / report.seconds
+                                 : 0.0};
+        out << "}, \"derived\": {"
+            << "\"samples_per_pixel\": "
+            << ratio(report[StatCounter::samples], report[StatCounter::pixels])
+            << ", \"nodes_per_ray\": "
+            << ratio(report[StatCounter::bvh_nodes_visited], rays)
+            << ", \"tests_per_ray\": "
+            << ratio(report[StatCounter::primitive_tests], rays)
+            << ", \"rays_per_second\": " << rays_per_second
+            << ", \"mean_path_length\": " << mean_path_length(report)
+            << "}, \"seconds\": " << report.seconds
+            << ", \"path_lengths\": [";
+        for (std::size_t i{0}; i < num_path_length_buckets; ++i)
+        {
+            out << (i == 0 ? "" : ", ") << report.path_lengths[i];
+        }
+        out << "]}";
+
+        return out.str();
+    }
+} // namespace core
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace core
+{
+    enum class StatCounter : std::size_t
+    {
+        rays_traced = 0,
+        shadow_rays,
+        bvh_nodes_visited,
+        primitive_tests,
+        samples,
+        pixels,
+        geometry_page_hits,
+        geometry_page_misses,
+        geometry_page_evictions,
+        path_suspensions,
+        count
+    };
+
+    inline constexpr std::size_t num_stat_counters{
+        static_cast<std::size_t>(StatCounter::count)};
+
+    // Path lengths at or above the last bucket are accumulated in it.
+    inline constexpr std::size_t num_path_length_buckets{65};
+
+    std::string_view stat_counter_name(StatCounter counter);
+
+    // Counters owned by a single thread. Only the owning thread writes them,
+    // so increments are a plain load and store; the atomics exist solely so
+    // that the final merge can read them without a data race.
+    struct ThreadStats
+    {
+        std::array<std::atomic<std::uint64_t>, num_stat_counters> counters{};
+        std::array<std::atomic<std::uint64_t>, num_path_length_buckets>
+            path_lengths{};
+    };
+
+    namespace detail
+    {
+        extern thread_local ThreadStats* current_thread_stats;
+
+        ThreadStats& register_thread_stats();
+
+        inline ThreadStats& thread_stats()
+        {
+            auto stats = current_thread_stats;
+            return (stats != nullptr) ? *stats : register_thread_stats();
+        }
+
+        inline void bump(std::atomic<std::uint64_t>& value, std::uint64_t n)
+        {
+            value.store(value.load(std::memory_order_relaxed) + n,
+                        std::memory_order_relaxed);
+        }
+    } // namespace detail
+
+    inline void increment_stat([[maybe_unused]] StatCounter counter,
+                               [[maybe_unused]] std::uint64_t n = 1)
+    {
+#if defined(APOLLO_ENABLE_STATS)
+        detail::bump(detail::thread_stats()
+                         .counters[static_cast<std::size_t>(counter)],
+                     n);
+#endif
+    }
+
+    inline void record_path_length([[maybe_unused]] std::size_t length)
+    {
+#if defined(APOLLO_ENABLE_STATS)
+        auto bucket{length < num_path_length_buckets
+                        ? length
+                        : num_path_length_buckets - 1};
+        detail::bump(detail::thread_stats().path_lengths[bucket], 1);
+#endif
+    }
+
+    struct StatsReport
+    {
+        std::array<std::uint64_t, num_stat_counters> counters{};
+        std::array<std::uint64_t, num_path_length_buckets> path_lengths{};
+        double seconds{0};
+
+        std::uint64_t operator[](StatCounter counter) const
+        {
+            return counters[static_cast<std::size_t>(counter)];
+        }
+    };
+
+    // Merges the counters of every thread that has recorded statistics,
+    // including threads that have already exited. Intended to be called once
+    // rendering has finished.
+    StatsReport collect_stats();
+
+    // Clears every counter, typically before starting a render.
+    void reset_stats();
+
+    std::string stats_to_text(StatsReport const& report);
+    std::string stats_to_json(StatsReport const& report);
+} // namespace core
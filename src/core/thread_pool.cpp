@@ -0,0 +1,63 @@
+#include "thread_pool.hpp"
+
+#include <algorithm>
+
+namespace core
+{
+    ThreadPool::ThreadPool(std::size_t num_threads,
+                           std::function<void(std::size_t)> on_start)
+    {
+        if (num_threads == 0)
+        {
+            num_threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        m_threads.reserve(num_threads);
+        for (std::size_t i{0}; i < num_threads; ++i)
+        {
+            m_threads.emplace_back([this, i, on_start]() {
+                if (on_start)
+                {
+                    on_start(i);
+                }
+                run();
+            });
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::scoped_lock lock{m_mutex};
+            m_stop = true;
+        }
+        m_condition.notify_all();
+
+        for (auto& thread : m_threads)
+        {
+            thread.join();
+        }
+    }
+
+    void ThreadPool::run()
+    {
+        for (;;)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock lock{m_mutex};
+                m_condition.wait(
+                    lock, [this]() { return m_stop || !m_tasks.empty(); });
+                if (m_tasks.empty())
+                {
+                    return;
+                }
+
+                task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+            }
+
+            task();
+        }
+    }
+} // namespace core
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace core
+{
+    // Fixed set of worker threads consuming a FIFO queue of tasks. Meant for
+    // coarse work such as loading files, and for renders that hand out work
+    // many times over and so keep one pool for their whole length.
+    class ThreadPool
+    {
+    public:
+        // 0 selects one thread per hardware thread. If given,
+        // `on_start(index)` runs on every worker before it takes any task,
+        // with the index of the worker, for instance to pin it.
+        explicit ThreadPool(std::size_t num_threads = 0,
+                            std::function<void(std::size_t)> on_start = {});
+
+        // Finishes every queued task before joining the workers.
+        ~ThreadPool();
+
+        ThreadPool(ThreadPool const&) = delete;
+        ThreadPool& operator=(ThreadPool const&) = delete;
+
+        // Queues `fn` and returns a future for its result. Exceptions thrown
+        // by the task are rethrown by the future.
+        template<typename Fn>
+        std::future<std::invoke_result_t<std::decay_t<Fn>>> submit(Fn&& fn)
+        {
+            using Result = std::invoke_result_t<std::decay_t<Fn>>;
+
+            auto task = std::make_shared<std::packaged_task<Result()>>(
+                std::forward<Fn>(fn));
+            auto future{task->get_future()};
+            {
+                std::scoped_lock lock{m_mutex};
+                m_tasks.emplace_back([task]() { (*task)(); });
+            }
+            m_condition.notify_one();
+
+            return future;
+        }
+
+        std::size_t size() const
+        {
+            return m_threads.size();
+        }
+
+    private:
+        void run();
+
+        std::vector<std::thread> m_threads;
+        std::deque<std::function<void()>> m_tasks;
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        bool m_stop{false};
+    };
+} // namespace core
@@ -0,0 +1,273 @@
+#include "topology.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#if defined(__linux__)
+#    include <filesystem>
+#    include <sched.h>
+#elif defined(_WIN32)
+#    define WIN32_LEAN_AND_MEAN
+#    include <windows.h>
+#endif
+
+namespace core
+{
+    namespace
+    {
+        std::vector<NumaNode> fallback_topology()
+        {
+            auto count{std::max(1u, std::thread::hardware_concurrency())};
+            NumaNode node{0, {}};
+            for (unsigned int i{0}; i < count; ++i)
+            {
+                node.cpus.push_back(static_cast<int>(i));
+            }
+
+            return {node};
+        }
+
+#if defined(__linux__)
+        // Parses lists of the form "0-3,8,10-11".
+        std::vector<int> parse_cpu_list(std::string const& list)
+        {
+            std::vector<int> cpus;
+            std::stringstream stream{list};
+            std::string range;
+            while (std::getline(stream, range, ','))
+            {
+                if (range.empty() || range == "\n")
+                {
+                    continue;
+                }
+
+                auto dash{range.find('-')};
+                auto first{std::stoi(range.substr(0, dash))};
+                auto last{(dash == std::string::npos)
+                              ? first
+                              : std::stoi(range.substr(dash + 1))};
+                for (auto cpu{first}; cpu <= last; ++cpu)
+                {
+                    cpus.push_back(cpu);
+                }
+            }
+
+            return cpus;
+        }
+
+        std::vector<NumaNode> discover_topology()
+        {
+            namespace fs = std::filesystem;
+
+            std::vector<NumaNode> nodes;
+            std::error_code ec;
+            fs::path root{"/sys/devices/system/node"};
+            for (auto& entry : fs::directory_iterator{root, ec})
+            {
+                auto name{entry.path().filename().string()};
+                if (name.rfind("node", 0) != 0 ||
+                    name.find_first_not_of("0123456789", 4) !=
+                        std::string::npos ||
+                    name.size() == 4)
+                {
+                    continue;
+                }
+
+                std::ifstream file{entry.path() / "cpulist"};
+                std::string list;
+                std::getline(file, list);
+
+                NumaNode node{std::stoi(name.substr(4)), parse_cpu_list(list)};
+                if (!node.cpus.empty())
+                {
+                    nodes.push_back(std::move(node));
+                }
+            }
+
+            if (nodes.empty())
+            {
+                return fallback_topology();
+            }
+
+            std::sort(nodes.begin(), nodes.end(), [](auto& a, auto& b) {
+                return a.id < b.id;
+            });
+            return nodes;
+        }
+#elif defined(_WIN32)
+        std::vector<NumaNode> discover_topology()
+        {
+            ULONG highest{0};
+            if (!GetNumaHighestNodeNumber(&highest))
+            {
+                return fallback_topology();
+            }
+
+            std::vector<NumaNode> nodes;
+            for (ULONG id{0}; id <= highest; ++id)
+            {
+                ULONGLONG mask{0};
+                if (!GetNumaNodeProcessorMask(static_cast<UCHAR>(id), &mask))
+                {
+                    continue;
+                }
+
+                NumaNode node{static_cast<int>(id), {}};
+                for (int cpu{0}; cpu < 64; ++cpu)
+                {
+                    if (mask & (ULONGLONG{1} << cpu))
+                    {
+                        node.cpus.push_back(cpu);
+                    }
+                }
+
+                if (!node.cpus.empty())
+                {
+                    nodes.push_back(std::move(node));
+                }
+            }
+
+            return nodes.empty() ? fallback_topology() : nodes;
+        }
+#else
+        std::vector<NumaNode> discover_topology()
+        {
+            return fallback_topology();
+        }
+#endif
+
+        // All CPUs, ordered by node.
+        std::vector<int> const& ordered_cpus()
+        {
+            static std::vector<int> const cpus = []() {
+                std::vector<int> out;
+                for (auto& node : numa_nodes())
+                {
+                    out.insert(out.end(), node.cpus.begin(), node.cpus.end());
+                }
+                return out;
+            }();
+
+            return cpus;
+        }
+
+        std::size_t pool_slot(std::size_t index, std::size_t num_threads)
+        {
+            auto total{ordered_cpus().size()};
+            return (index * total) / std::max<std::size_t>(num_threads, 1) %
+                   total;
+        }
+    } // namespace
+
+    std::vector<NumaNode> const& numa_nodes()
+    {
+        static std::vector<NumaNode> const nodes{discover_topology()};
+        return nodes;
+    }
+
+    int current_numa_node()
+    {
+#if defined(__linux__)
+        auto cpu{sched_getcpu()};
+        if (cpu < 0)
+        {
+            return 0;
+        }
+
+        for (auto& node : numa_nodes())
+        {
+            if (std::find(node.cpus.begin(), node.cpus.end(), cpu) !=
+                node.cpus.end())
+            {
+                return node.id;
+            }
+        }
+#elif defined(_WIN32)
+        PROCESSOR_NUMBER number;
+        GetCurrentProcessorNumberEx(&number);
+        USHORT node{0};
+        if (GetNumaProcessorNodeEx(&number, &node))
+        {
+            return static_cast<int>(node);
+        }
+#endif
+        return 0;
+    }
+
+    int numa_node_for_thread(std::size_t index, std::size_t num_threads)
+    {
+        auto cpu{ordered_cpus()[pool_slot(index, num_threads)]};
+        for (auto& node : numa_nodes())
+        {
+            if (std::find(node.cpus.begin(), node.cpus.end(), cpu) !=
+                node.cpus.end())
+            {
+                return node.id;
+            }
+        }
+
+        return numa_nodes().front().id;
+    }
+
+    bool pin_thread_to_numa_node(int node)
+    {
+        auto& nodes = numa_nodes();
+        auto it     = std::find_if(nodes.begin(), nodes.end(), [node](auto& n) {
+            return n.id == node;
+        });
+        if (it == nodes.end())
+        {
+            return false;
+        }
+
+#if defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (auto cpu : it->cpus)
+        {
+            CPU_SET(cpu, &set);
+        }
+        return sched_setaffinity(0, sizeof(set), &set) == 0;
+#elif defined(_WIN32)
+        DWORD_PTR mask{0};
+        for (auto cpu : it->cpus)
+        {
+            mask |= DWORD_PTR{1} << cpu;
+        }
+        return SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+#else
+        return false;
+#endif
+    }
+
+    bool pin_thread_to_cpu(int cpu)
+    {
+#if defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        return sched_setaffinity(0, sizeof(set), &set) == 0;
+#elif defined(_WIN32)
+        return SetThreadAffinityMask(GetCurrentThread(),
+                                     DWORD_PTR{1} << cpu) != 0;
+#else
+        (void)cpu;
+        return false;
+#endif
+    }
+
+    bool pin_pool_thread(std::size_t index, std::size_t num_threads)
+    {
+        if (num_threads <= ordered_cpus().size())
+        {
+            return pin_thread_to_cpu(
+                ordered_cpus()[pool_slot(index, num_threads)]);
+        }
+
+        return pin_thread_to_numa_node(
+            numa_node_for_thread(index, num_threads));
+    }
+} // namespace core
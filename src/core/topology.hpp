@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace core
+{
+    struct NumaNode
+    {
+        int id;
+        std::vector<int> cpus;
+    };
+
+    // NUMA nodes of the machine, discovered once on first use. Platforms
+    // without NUMA information report a single node holding every CPU.
+    std::vector<NumaNode> const& numa_nodes();
+
+    // Node of the CPU the calling thread is currently running on, or 0 if
+    // this cannot be determined.
+    int current_numa_node();
+
+    // Node that thread `index` out of `num_threads` in a worker pool should
+    // run on. Threads are split into contiguous groups, one per node, with
+    // sizes proportional to the number of CPUs on each node.
+    int numa_node_for_thread(std::size_t index, std::size_t num_threads);
+
+    // Restricts the calling thread to the CPUs of the given node. Returns
+    // false, leaving the affinity untouched, where this is unsupported.
+    bool pin_thread_to_numa_node(int node);
+
+    // Restricts the calling thread to a single CPU.
+    bool pin_thread_to_cpu(int cpu);
+
+    // Pins worker `index` of a pool of `num_threads` following the topology:
+    // the thread is bound to its node, and to a single CPU of that node when
+    // there are no more threads than CPUs.
+    bool pin_pool_thread(std::size_t index, std::size_t num_threads);
+} // namespace core
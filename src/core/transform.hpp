@@ -0,0 +1,234 @@
+#pragma once
+
+#include "bounds.hpp"
+#include "float_error.hpp"
+#include "matrix.hpp"
+#include "ray.hpp"
+#include "ray_packet.hpp"
+#include "vector.hpp"
+
+#include <cmath>
+
+namespace core
+{
+    // Affine transformation stored together with its inverse, so that
+    // normals and world-to-object rays never require an inversion.
+    template<typename T>
+    class Transform
+    {
+    public:
+        Transform() : m(T{1}), m_inv(T{1})
+        {}
+
+        explicit Transform(Matrix<T> const& mat) : m{mat}, m_inv{inverse(mat)}
+        {}
+
+        Transform(Matrix<T> const& mat, Matrix<T> const& inv) :
+            m{mat}, m_inv{inv}
+        {}
+
+        Point3<T> point(Point3<T> const& p) const
+        {
+            Point3<T> out;
+            for (std::size_t i{0}; i < 3; ++i)
+            {
+                out[i] = m(i, 0) * p[0] + m(i, 1) * p[1] + m(i, 2) * p[2] +
+                         m(i, 3);
+            }
+
+            auto w{m(3, 0) * p[0] + m(3, 1) * p[1] + m(3, 2) * p[2] + m(3, 3)};
+            return (w == T{1}) ? out : out / w;
+        }
+
+        // Transforms a point whose coordinates are each within `error` of
+        // the true point, and returns a bound on the error of the result in
+        // `out_error`. Assumes the transform is affine.
+        Point3<T> point(Point3<T> const& p,
+                        Vector3<T> const& error,
+                        Vector3<T>& out_error) const
+        {
+            Vector3<T> bound;
+            for (std::size_t i{0}; i < 3; ++i)
+            {
+                auto rounding{std::abs(m(i, 0) * p[0]) +
+                              std::abs(m(i, 1) * p[1]) +
+                              std::abs(m(i, 2) * p[2]) + std::abs(m(i, 3))};
+                auto carried{std::abs(m(i, 0)) * error[0] +
+                             std::abs(m(i, 1)) * error[1] +
+                             std::abs(m(i, 2)) * error[2]};
+                bound[i] =
+                    gamma<T>(3) * rounding + (gamma<T>(3) + 1) * carried;
+            }
+
+            out_error = bound;
+            return point(p);
+        }
+
+        Vector3<T> vector(Vector3<T> const& v) const
+        {
+            Vector3<T> out;
+            for (std::size_t i{0}; i < 3; ++i)
+            {
+                out[i] = m(i, 0) * v[0] + m(i, 1) * v[1] + m(i, 2) * v[2];
+            }
+
+            return out;
+        }
+
+        // Normals transform with the inverse transpose.
+        Normal3<T> normal(Normal3<T> const& n) const
+        {
+            Normal3<T> out;
+            for (std::size_t i{0}; i < 3; ++i)
+            {
+                out[i] = m_inv(0, i) * n[0] + m_inv(1, i) * n[1] +
+                         m_inv(2, i) * n[2];
+            }
+
+            return out;
+        }
+
+        // The direction is not renormalised, so parametric distances along
+        // the transformed ray match those along the original one.
+        Ray<T> ray(Ray<T> const& r) const
+        {
+            return Ray<T>{point(r.o), vector(r.d), r.time};
+        }
+
+        // Transforms every lane as ray() would, with the same arithmetic.
+        template<std::size_t N>
+        RayPacket<T, N> ray(RayPacket<T, N> const& packet) const
+        {
+            // For affine transforms w is exactly 1 at any finite origin, so
+            // the division can be skipped.
+            auto affine{m(3, 0) == T{0} && m(3, 1) == T{0} &&
+                        m(3, 2) == T{0} && m(3, 3) == T{1}};
+
+            RayPacket<T, N> out;
+            out.time = packet.time;
+            auto& o = packet.o;
+            auto& d = packet.d;
+            for (std::size_t i{0}; i < 3; ++i)
+            {
+                for (std::size_t lane{0}; lane < N; ++lane)
+                {
+                    out.o[i][lane] = m(i, 0) * o[0][lane] +
+                                     m(i, 1) * o[1][lane] +
+                                     m(i, 2) * o[2][lane] + m(i, 3);
+                    out.d[i][lane] = m(i, 0) * d[0][lane] +
+                                     m(i, 1) * d[1][lane] +
+                                     m(i, 2) * d[2][lane];
+                    out.inv_d[i][lane] = T{1} / out.d[i][lane];
+                }
+            }
+
+            if (!affine)
+            {
+                for (std::size_t lane{0}; lane < N; ++lane)
+                {
+                    auto w{m(3, 0) * o[0][lane] + m(3, 1) * o[1][lane] +
+                           m(3, 2) * o[2][lane] + m(3, 3)};
+                    for (std::size_t i{0}; i < 3; ++i)
+                    {
+                        out.o[i][lane] = (w == T{1}) ? out.o[i][lane]
+                                                     : out.o[i][lane] / w;
+                    }
+                }
+            }
+            return out;
+        }
+
+        Bounds3<T> bounds(Bounds3<T> const& b) const
+        {
+            Bounds3<T> out;
+            for (std::size_t i{0}; i < 8; ++i)
+            {
+                Point3<T> corner{b[i & 1][0], b[(i >> 1) & 1][1],
+                                 b[(i >> 2) & 1][2]};
+                out = bounds_union(out, point(corner));
+            }
+
+            return out;
+        }
+
+        Matrix<T> m;
+        Matrix<T> m_inv;
+    };
+
+    template<typename T>
+    Transform<T> inverse(Transform<T> const& t)
+    {
+        return Transform<T>{t.m_inv, t.m};
+    }
+
+    template<typename T>
+    Transform<T> operator*(Transform<T> const& lhs, Transform<T> const& rhs)
+    {
+        return Transform<T>{lhs.m * rhs.m, rhs.m_inv * lhs.m_inv};
+    }
+
+    template<typename T>
+    bool is_identity(Transform<T> const& t)
+    {
+        return is_identity(t.m);
+    }
+
+    template<typename T>
+    Transform<T> translate(Vector3<T> const& delta)
+    {
+        // clang-format off
+        Matrix<T> mat{
+            T{1}, T{0}, T{0}, delta[0],
+            T{0}, T{1}, T{0}, delta[1],
+            T{0}, T{0}, T{1}, delta[2],
+            T{0}, T{0}, T{0}, T{1}};
+        Matrix<T> inv{
+            T{1}, T{0}, T{0}, -delta[0],
+            T{0}, T{1}, T{0}, -delta[1],
+            T{0}, T{0}, T{1}, -delta[2],
+            T{0}, T{0}, T{0}, T{1}};
+        // clang-format on
+        return Transform<T>{mat, inv};
+    }
+
+    template<typename T>
+    Transform<T> scale(T x, T y, T z)
+    {
+        // clang-format off
+        Matrix<T> mat{
+            x,    T{0}, T{0}, T{0},
+            T{0}, y,    T{0}, T{0},
+            T{0}, T{0}, z,    T{0},
+            T{0}, T{0}, T{0}, T{1}};
+        Matrix<T> inv{
+            T{1} / x, T{0},     T{0},     T{0},
+            T{0},     T{1} / y, T{0},     T{0},
+            T{0},     T{0},     T{1} / z, T{0},
+            T{0},     T{0},     T{0},     T{1}};
+        // clang-format on
+        return Transform<T>{mat, inv};
+    }
+
+    // Rotation of `theta` radians around the (normalised) `axis`.
+    template<typename T>
+    Transform<T> rotate(T theta, Vector3<T> const& axis)
+    {
+        auto a{normalise(axis)};
+        auto sin_theta{static_cast<T>(std::sin(theta))};
+        auto cos_theta{static_cast<T>(std::cos(theta))};
+
+        Matrix<T> mat(T{1});
+        mat(0, 0) = a[0] * a[0] + (T{1} - a[0] * a[0]) * cos_theta;
+        mat(0, 1) = a[0] * a[1] * (T{1} - cos_theta) - a[2] * sin_theta;
+        mat(0, 2) = a[0] * a[2] * (T{1} - cos_theta) + a[1] * sin_theta;
+        mat(1, 0) = a[0] * a[1] * (T{1} - cos_theta) + a[2] * sin_theta;
+        mat(1, 1) = a[1] * a[1] + (T{1} - a[1] * a[1]) * cos_theta;
+        mat(1, 2) = a[1] * a[2] * (T{1} - cos_theta) - a[0] * sin_theta;
+        mat(2, 0) = a[0] * a[2] * (T{1} - cos_theta) - a[1] * sin_theta;
+        mat(2, 1) = a[1] * a[2] * (T{1} - cos_theta) + a[0] * sin_theta;
+        mat(2, 2) = a[2] * a[2] + (T{1} - a[2] * a[2]) * cos_theta;
+
+        // Rotations are orthogonal, so the inverse is the transpose.
+        return Transform<T>{mat, transpose(mat)};
+    }
+} // namespace core
@@ -81,6 +81,19 @@ namespace core
         std::array<T, N> data;
     };
 
+    // Converts every component to U. Vectors of different precisions never
+    // convert implicitly, so every change of precision is visible.
+    template<typename U, typename T, std::size_t N>
+    Vector<U, N> vector_cast(Vector<T, N> const& vec)
+    {
+        Vector<U, N> out;
+        for (std::size_t i{0}; i < N; ++i)
+        {
+            out.data[i] = static_cast<U>(vec.data[i]);
+        }
+        return out;
+    }
+
     template<typename T, std::size_t N>
     using Point = Vector<T, N>;
 
@@ -0,0 +1,570 @@
+#include "lua_scene.hpp"
+#include "scene_cache.hpp"
+
+#include <shapes/sphere.hpp>
+
+#include <core/profiler.hpp>
+
+#include <array>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+extern "C"
+{
+#include <lauxlib.h>
+#include <lua.h>
+#include <lualib.h>
+}
+
+namespace fs = std::filesystem;
+
+namespace loaders
+{
+    namespace
+    {
+        constexpr Real pi{3.14159265358979323846};
+
+        constexpr char const* transform_type{"apollo.transform"};
+        constexpr char const* mesh_type{"apollo.mesh"};
+
+        using Triple = std::array<Real, 3>;
+
+        // State shared by the bindings, passed to each as an upvalue.
+        struct Context
+        {
+            SceneBuilder builder;
+            fs::path base_dir;
+        };
+
+        class LuaState
+        {
+        public:
+            LuaState() : m_state{luaL_newstate()}
+            {
+                if (m_state == nullptr)
+                {
+                    throw std::runtime_error{
+                        "error: unable to create Lua state"};
+                }
+            }
+
+            ~LuaState()
+            {
+                lua_close(m_state);
+            }
+
+            LuaState(LuaState const&) = delete;
+            LuaState& operator=(LuaState const&) = delete;
+
+            lua_State* get() const
+            {
+                return m_state;
+            }
+
+        private:
+            lua_State* m_state;
+        };
+
+        Context& context(lua_State* L)
+        {
+            return *static_cast<Context*>(
+                lua_touserdata(L, lua_upvalueindex(1)));
+        }
+
+        // Bindings report errors with C++ exceptions. Lua raises its errors
+        // with longjmp, which must not skip the destructors of live C++
+        // objects, so the message is copied into a plain buffer and the
+        // error raised once the exception has been destroyed.
+        template<int (*Fn)(lua_State*)>
+        int bind(lua_State* L)
+        {
+            char message[512];
+            try
+            {
+                return Fn(L);
+            }
+            catch (std::exception const& e)
+            {
+                std::snprintf(message, sizeof(message), "%s", e.what());
+            }
+
+            return luaL_error(L, "%s", message);
+        }
+
+        Real to_real(lua_State* L, int index, char const* what)
+        {
+            int is_number{0};
+            auto value{lua_tonumberx(L, index, &is_number)};
+            if (is_number == 0)
+            {
+                throw std::runtime_error{std::string{what} +
+                                         " must be a number"};
+            }
+
+            return static_cast<Real>(value);
+        }
+
+        Triple to_triple(lua_State* L, int index, char const* what)
+        {
+            index = lua_absindex(L, index);
+            if (!lua_istable(L, index) || lua_rawlen(L, index) != 3)
+            {
+                throw std::runtime_error{std::string{what} +
+                                         " must be a table of 3 numbers"};
+            }
+
+            Triple result;
+            for (int i{0}; i < 3; ++i)
+            {
+                lua_geti(L, index, i + 1);
+                result[i] = to_real(L, -1, what);
+                lua_pop(L, 1);
+            }
+
+            return result;
+        }
+
+        void check_table(lua_State* L, char const* function)
+        {
+            if (!lua_istable(L, 1))
+            {
+                throw std::runtime_error{std::string{function} +
+                                         " expects a table"};
+            }
+        }
+
+        // Pushes field `key` of the table argument and returns whether it
+        // is set. Nothing is left on the stack when it is not.
+        bool push_field(lua_State* L, char const* key)
+        {
+            lua_getfield(L, 1, key);
+            if (lua_isnil(L, -1))
+            {
+                lua_pop(L, 1);
+                return false;
+            }
+
+            return true;
+        }
+
+        Real number_field(lua_State* L,
+                          char const* key,
+                          std::optional<Real> fallback = {})
+        {
+            if (!push_field(L, key))
+            {
+                if (!fallback)
+                {
+                    throw std::runtime_error{std::string{"missing field "} +
+                                             key};
+                }
+                return *fallback;
+            }
+
+            auto value{to_real(L, -1, key)};
+            lua_pop(L, 1);
+            return value;
+        }
+
+        Triple triple_field(lua_State* L,
+                            char const* key,
+                            std::optional<Triple> fallback = {})
+        {
+            if (!push_field(L, key))
+            {
+                if (!fallback)
+                {
+                    throw std::runtime_error{std::string{"missing field "} +
+                                             key};
+                }
+                return *fallback;
+            }
+
+            auto value{to_triple(L, -1, key)};
+            lua_pop(L, 1);
+            return value;
+        }
+
+        std::size_t size_field(lua_State* L, char const* key)
+        {
+            auto value{number_field(L, key)};
+            if (value < 1 || value != static_cast<Real>(
+                                          static_cast<std::size_t>(value)))
+            {
+                throw std::runtime_error{std::string{key} +
+                                         " must be a positive integer"};
+            }
+
+            return static_cast<std::size_t>(value);
+        }
+
+        std::uint32_t material_field(lua_State* L)
+        {
+            auto value{number_field(L, "material", Real{0})};
+            auto id{static_cast<std::uint32_t>(value)};
+            if (value < 0 || static_cast<Real>(id) != value ||
+                id >= context(L).builder.num_materials())
+            {
+                throw std::runtime_error{"invalid material id"};
+            }
+
+            return id;
+        }
+
+        core::Point3<Real> to_point(Triple const& t)
+        {
+            return core::Point3<Real>{t[0], t[1], t[2]};
+        }
+
+        core::Vector3<Real> to_vector(Triple const& t)
+        {
+            return core::Vector3<Real>{t[0], t[1], t[2]};
+        }
+
+        void push_transform(lua_State* L, core::Transform<Real> const& t)
+        {
+            auto data = lua_newuserdata(L, sizeof(core::Transform<Real>));
+            new (data) core::Transform<Real>{t};
+            luaL_setmetatable(L, transform_type);
+        }
+
+        core::Transform<Real> const&
+        to_transform(lua_State* L, int index, char const* what)
+        {
+            auto data = luaL_testudata(L, index, transform_type);
+            if (data == nullptr)
+            {
+                throw std::runtime_error{std::string{what} +
+                                         " must be a transform"};
+            }
+
+            return *static_cast<core::Transform<Real>*>(data);
+        }
+
+        int camera(lua_State* L)
+        {
+            check_table(L, "camera");
+            auto eye{triple_field(L, "eye")};
+            auto look_at{triple_field(L, "look_at")};
+            auto up{triple_field(L, "up", Triple{0, 1, 0})};
+            auto fov{number_field(L, "fov", Real{45})};
+            auto width{size_field(L, "width")};
+            auto height{size_field(L, "height")};
+
+            context(L).builder.set_camera(render::Camera{to_point(eye),
+                                                         to_point(look_at),
+                                                         to_vector(up),
+                                                         fov,
+                                                         width,
+                                                         height});
+            return 0;
+        }
+
+        int material(lua_State* L)
+        {
+            check_table(L, "material");
+            auto albedo{triple_field(L, "albedo", Triple{0.5, 0.5, 0.5})};
+
+            auto id{context(L).builder.add_material({to_vector(albedo)})};
+            lua_pushinteger(L, static_cast<lua_Integer>(id));
+            return 1;
+        }
+
+        int sphere(lua_State* L)
+        {
+            check_table(L, "sphere");
+            auto center{triple_field(L, "center")};
+            auto radius{number_field(L, "radius")};
+            if (radius <= 0)
+            {
+                throw std::runtime_error{"radius must be positive"};
+            }
+
+            context(L).builder.add_shape(std::make_unique<shapes::Sphere>(
+                to_point(center), radius, material_field(L)));
+            return 0;
+        }
+
+        int light(lua_State* L)
+        {
+            check_table(L, "light");
+            auto position{triple_field(L, "position")};
+            auto intensity{triple_field(L, "intensity")};
+
+            context(L).builder.add_light(
+                {to_point(position), to_vector(intensity)});
+            return 0;
+        }
+
+        int mesh(lua_State* L)
+        {
+            std::string file;
+            std::uint32_t material{0};
+            if (lua_type(L, 1) == LUA_TSTRING)
+            {
+                file = lua_tostring(L, 1);
+            }
+            else
+            {
+                check_table(L, "mesh");
+                if (!push_field(L, "file") || lua_type(L, -1) != LUA_TSTRING)
+                {
+                    throw std::runtime_error{"mesh requires a file name"};
+                }
+                file = lua_tostring(L, -1);
+                lua_pop(L, 1);
+                material = material_field(L);
+            }
+
+            auto& ctx = context(L);
+            fs::path path{file};
+            if (path.is_relative())
+            {
+                path = ctx.base_dir / path;
+            }
+
+            auto handle{ctx.builder.request_mesh(path.string(), material)};
+            auto data = lua_newuserdata(L, sizeof(SceneBuilder::MeshHandle));
+            new (data) SceneBuilder::MeshHandle{handle};
+            luaL_setmetatable(L, mesh_type);
+            return 1;
+        }
+
+        int instance(lua_State* L)
+        {
+            check_table(L, "instance");
+            lua_getfield(L, 1, "mesh");
+            auto data = luaL_testudata(L, -1, mesh_type);
+            if (data == nullptr)
+            {
+                throw std::runtime_error{"instance requires a mesh"};
+            }
+            auto handle{*static_cast<SceneBuilder::MeshHandle*>(data)};
+            lua_pop(L, 1);
+
+            core::Transform<Real> transform;
+            if (push_field(L, "transform"))
+            {
+                transform = to_transform(L, -1, "transform");
+                lua_pop(L, 1);
+            }
+
+            context(L).builder.add_instance(handle, transform);
+            return 0;
+        }
+
+        int translate(lua_State* L)
+        {
+            push_transform(L,
+                           core::translate(core::Vector3<Real>{
+                               to_real(L, 1, "x"),
+                               to_real(L, 2, "y"),
+                               to_real(L, 3, "z")}));
+            return 1;
+        }
+
+        int scale(lua_State* L)
+        {
+            auto x{to_real(L, 1, "x")};
+            if (lua_gettop(L) == 1)
+            {
+                push_transform(L, core::scale(x, x, x));
+            }
+            else
+            {
+                push_transform(
+                    L, core::scale(x, to_real(L, 2, "y"), to_real(L, 3, "z")));
+            }
+            return 1;
+        }
+
+        int rotate(lua_State* L)
+        {
+            auto degrees{to_real(L, 1, "angle")};
+            auto axis{to_vector(to_triple(L, 2, "axis"))};
+            if (core::length_squared(axis) == 0)
+            {
+                throw std::runtime_error{"rotation axis must not be zero"};
+            }
+
+            push_transform(L, core::rotate(degrees * pi / 180, axis));
+            return 1;
+        }
+
+        int matrix(lua_State* L)
+        {
+            if (!lua_istable(L, 1) || lua_rawlen(L, 1) != 16)
+            {
+                throw std::runtime_error{
+                    "matrix expects a table of 16 numbers"};
+            }
+
+            std::array<Real, 16> values;
+            for (int i{0}; i < 16; ++i)
+            {
+                lua_geti(L, 1, i + 1);
+                values[i] = to_real(L, -1, "matrix element");
+                lua_pop(L, 1);
+            }
+
+            push_transform(L,
+                           core::Transform<Real>{core::Matrix<Real>{values}});
+            return 1;
+        }
+
+        int identity(lua_State* L)
+        {
+            push_transform(L, core::Transform<Real>{});
+            return 1;
+        }
+
+        int inverse(lua_State* L)
+        {
+            push_transform(L, core::inverse(to_transform(L, 1, "argument")));
+            return 1;
+        }
+
+        int multiply(lua_State* L)
+        {
+            push_transform(L,
+                           to_transform(L, 1, "left operand") *
+                               to_transform(L, 2, "right operand"));
+            return 1;
+        }
+
+        void open_libraries(lua_State* L)
+        {
+            luaL_requiref(L, "_G", luaopen_base, 1);
+            luaL_requiref(L, LUA_MATHLIBNAME, luaopen_math, 1);
+            luaL_requiref(L, LUA_STRLIBNAME, luaopen_string, 1);
+            luaL_requiref(L, LUA_TABLIBNAME, luaopen_table, 1);
+            lua_pop(L, 4);
+        }
+
+        void register_bindings(lua_State* L, Context& ctx)
+        {
+            luaL_newmetatable(L, transform_type);
+            lua_pushcfunction(L, bind<multiply>);
+            lua_setfield(L, -2, "__mul");
+            lua_pop(L, 1);
+
+            luaL_newmetatable(L, mesh_type);
+            lua_pop(L, 1);
+
+            auto add = [&](char const* name, lua_CFunction fn) {
+                lua_pushlightuserdata(L, &ctx);
+                lua_pushcclosure(L, fn, 1);
+                lua_setglobal(L, name);
+            };
+
+            add("camera", bind<camera>);
+            add("material", bind<material>);
+            add("sphere", bind<sphere>);
+            add("light", bind<light>);
+            add("mesh", bind<mesh>);
+            add("instance", bind<instance>);
+            add("translate", bind<translate>);
+            add("scale", bind<scale>);
+            add("rotate", bind<rotate>);
+            add("matrix", bind<matrix>);
+            add("identity", bind<identity>);
+            add("inverse", bind<inverse>);
+        }
+
+        render::Scene run_script(std::string const& script,
+                                 std::string const& chunk_name,
+                                 fs::path const& base_dir,
+                                 SceneBuilderOptions const& options,
+                                 std::vector<std::string>* assets = nullptr)
+        {
+            APOLLO_PROFILE_ZONE("scene load");
+
+            Context ctx{SceneBuilder{options}, base_dir};
+            {
+                LuaState lua;
+                auto L = lua.get();
+                open_libraries(L);
+                register_bindings(L, ctx);
+
+                if (luaL_loadbufferx(L,
+                                     script.data(),
+                                     script.size(),
+                                     chunk_name.c_str(),
+                                     "t") != LUA_OK ||
+                    lua_pcall(L, 0, 0, 0) != LUA_OK)
+                {
+                    auto message = lua_tostring(L, -1);
+                    throw std::runtime_error{
+                        std::string{"error: "} +
+                        (message != nullptr ? message : "unknown Lua error")};
+                }
+            }
+
+            if (assets != nullptr)
+            {
+                *assets = ctx.builder.asset_paths();
+            }
+
+            return ctx.builder.finish();
+        }
+
+        std::string read_script(std::string const& path)
+        {
+            std::ifstream file{path};
+            if (!file)
+            {
+                throw std::runtime_error{"error: unable to open " + path};
+            }
+
+            std::ostringstream script;
+            script << file.rdbuf();
+            return script.str();
+        }
+    } // namespace
+
+    render::Scene load_lua_scene(std::string const& path,
+                                 SceneBuilderOptions const& options)
+    {
+        return run_script(read_script(path),
+                          "@" + path,
+                          fs::path{path}.parent_path(),
+                          options);
+    }
+
+    render::Scene
+    load_lua_scene_from_string(std::string const& script,
+                               std::string const& base_dir,
+                               SceneBuilderOptions const& options)
+    {
+        return run_script(script, "=scene", base_dir, options);
+    }
+
+    render::Scene load_lua_scene_cached(std::string const& path,
+                                        std::string const& cache_path,
+                                        SceneBuilderOptions const& options)
+    {
+        if (auto scene = load_scene_cache(cache_path))
+        {
+            return std::move(*scene);
+        }
+
+        std::vector<std::string> assets;
+        auto scene{run_script(read_script(path),
+                              "@" + path,
+                              fs::path{path}.parent_path(),
+                              options,
+                              &assets)};
+        scene.build(options.bvh);
+
+        std::vector<std::string> sources{path};
+        sources.insert(sources.end(), assets.begin(), assets.end());
+        write_scene_cache(scene, sources, cache_path);
+        return scene;
+    }
+} // namespace loaders
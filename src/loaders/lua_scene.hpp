@@ -0,0 +1,47 @@
+#pragma once
+
+#include "scene_builder.hpp"
+
+#include <string>
+
+namespace loaders
+{
+    // Evaluates a Lua scene description and returns the scene, ready for
+    // Scene::build(). Scripts describe the scene by calling:
+    //
+    //   camera{eye = {x, y, z}, look_at = {x, y, z}, up = {x, y, z},
+    //          fov = degrees, width = n, height = n}
+    //   material{albedo = {r, g, b}}             -- returns a material id
+    //   sphere{center = {x, y, z}, radius = r, material = id}
+    //   light{position = {x, y, z}, intensity = {r, g, b}}
+    //   mesh{file = "path.obj", material = id}   -- returns a mesh handle
+    //   instance{mesh = handle, transform = t}
+    //
+    // Transforms are built with translate(x, y, z), scale(x [, y, z]),
+    // rotate(degrees, {x, y, z}), matrix{16 row-major values}, identity()
+    // and inverse(t), and compose with `*`. Meshes are OBJ or PLY files,
+    // with paths relative to the script. They start loading on a thread pool
+    // as soon as mesh{} is called, so files load concurrently with the rest
+    // of the script.
+    //
+    // Only the base, math, string and table libraries are available to
+    // scripts. Throws std::runtime_error on script or asset errors.
+    render::Scene load_lua_scene(std::string const& path,
+                                 SceneBuilderOptions const& options = {});
+
+    // As above, for a script held in memory. Relative asset paths are
+    // resolved against `base_dir`.
+    render::Scene
+    load_lua_scene_from_string(std::string const& script,
+                               std::string const& base_dir,
+                               SceneBuilderOptions const& options = {});
+
+    // As load_lua_scene(), but reuses the binary scene cache at `cache_path`
+    // while neither the script nor any mesh it loads has changed. Otherwise
+    // the script is evaluated, the scene built and the cache rewritten. The
+    // returned scene is already built.
+    render::Scene
+    load_lua_scene_cached(std::string const& path,
+                          std::string const& cache_path,
+                          SceneBuilderOptions const& options = {});
+} // namespace loaders
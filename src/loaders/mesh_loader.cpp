@@ -0,0 +1,213 @@
+#include "mesh_loader.hpp"
+#include "obj.hpp"
+#include "ply.hpp"
+
+#include <core/large_allocator.hpp>
+#include <core/thread_pool.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <exception>
+#include <filesystem>
+#include <stdexcept>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace loaders
+{
+    namespace
+    {
+        enum class MeshFormat
+        {
+            obj,
+            ply
+        };
+
+        MeshFormat mesh_format(std::string const& path)
+        {
+            auto extension{fs::path{path}.extension().string()};
+            std::transform(extension.begin(),
+                           extension.end(),
+                           extension.begin(),
+                           [](char c) {
+                               return static_cast<char>(
+                                   std::tolower(static_cast<unsigned char>(c)));
+                           });
+
+            if (extension == ".obj")
+            {
+                return MeshFormat::obj;
+            }
+            if (extension == ".ply")
+            {
+                return MeshFormat::ply;
+            }
+
+            throw std::runtime_error{"error: unsupported mesh format " + path};
+        }
+    } // namespace
+
+    shapes::TriangleMesh load_mesh(std::string const& path,
+                                   std::uint32_t material,
+                                   MeshLoadOptions const& options)
+    {
+        // The format is checked before the file is opened.
+        mesh_format(path);
+        return load_mesh(core::MappedFile{path}, path, material, options);
+    }
+
+    shapes::TriangleMesh load_mesh(core::MappedFile const& file,
+                                   std::string const& path,
+                                   std::uint32_t material,
+                                   MeshLoadOptions const& options)
+    {
+        switch (mesh_format(path))
+        {
+        case MeshFormat::obj:
+            return load_obj(file, path, material, options);
+        case MeshFormat::ply:
+        default:
+            return load_ply(file, path, material, options);
+        }
+    }
+
+    namespace detail
+    {
+        std::size_t num_chunks(std::size_t size,
+                               std::size_t min_chunk_size,
+                               MeshLoadOptions const& options)
+        {
+            std::size_t num_threads{options.num_threads};
+            if (num_threads == 0)
+            {
+                num_threads = std::max(1u, std::thread::hardware_concurrency());
+            }
+
+            auto chunks{size / std::max<std::size_t>(min_chunk_size, 1)};
+            return std::clamp<std::size_t>(chunks, 1, num_threads);
+        }
+
+        void parallel_chunks(std::size_t num_chunks,
+                             MeshLoadOptions const& options,
+                             std::function<void(std::size_t)> const& fn)
+        {
+            std::vector<std::exception_ptr> errors(num_chunks);
+            std::atomic<std::size_t> next{0};
+            auto run = [&]() {
+                for (auto chunk{next++}; chunk < num_chunks; chunk = next++)
+                {
+                    try
+                    {
+                        fn(chunk);
+                    }
+                    catch (...)
+                    {
+                        errors[chunk] = std::current_exception();
+                    }
+                }
+            };
+
+            auto num_threads{options.num_threads == 0
+                                 ? num_chunks
+                                 : std::min(num_chunks, options.num_threads)};
+            if (num_threads <= 1)
+            {
+                run();
+            }
+            else
+            {
+                auto num_helpers{num_threads - 1};
+                core::ThreadPool pool{num_helpers};
+                std::vector<std::future<void>> helpers;
+                for (std::size_t i{0}; i < num_helpers; ++i)
+                {
+                    helpers.push_back(pool.submit(run));
+                }
+
+                run();
+                for (auto& helper : helpers)
+                {
+                    helper.get();
+                }
+            }
+
+            for (auto& error : errors)
+            {
+                if (error)
+                {
+                    std::rethrow_exception(error);
+                }
+            }
+        }
+
+        shapes::TriangleMesh
+        make_mesh(std::array<std::vector<Real>, 3> coordinates,
+                  std::vector<std::uint32_t> indices,
+                  std::uint32_t material,
+                  MeshLoadOptions const& options)
+        {
+            if (indices.size() % 3 != 0)
+            {
+                throw std::runtime_error{
+                    "error: triangle mesh index count is not a multiple of 3"};
+            }
+
+            // Both loops are memory bound, so chunks are kept large.
+            constexpr std::size_t min_elements{std::size_t{1} << 16};
+
+            auto num_vertices{coordinates[0].size()};
+            auto index_chunks{
+                num_chunks(indices.size(), min_elements, options)};
+            std::atomic<bool> out_of_range{false};
+            parallel_chunks(index_chunks, options, [&](std::size_t chunk) {
+                auto begin{indices.size() * chunk / index_chunks};
+                auto end{indices.size() * (chunk + 1) / index_chunks};
+                if (std::any_of(indices.begin() + begin,
+                                indices.begin() + end,
+                                [num_vertices](std::uint32_t index) {
+                                    return index >= num_vertices;
+                                }))
+                {
+                    out_of_range = true;
+                }
+            });
+            if (out_of_range)
+            {
+                throw std::runtime_error{
+                    "error: triangle mesh index is out of range"};
+            }
+
+            auto vertex_chunks{num_chunks(num_vertices, min_elements, options)};
+            std::vector<core::Bounds3<Real>> chunk_bounds(vertex_chunks);
+            parallel_chunks(vertex_chunks, options, [&](std::size_t chunk) {
+                auto begin{num_vertices * chunk / vertex_chunks};
+                auto end{num_vertices * (chunk + 1) / vertex_chunks};
+                auto& bounds = chunk_bounds[chunk];
+                for (auto i{begin}; i < end; ++i)
+                {
+                    bounds = core::bounds_union(
+                        bounds,
+                        core::Point3<Real>{coordinates[0][i],
+                                           coordinates[1][i],
+                                           coordinates[2][i]});
+                }
+            });
+
+            core::Bounds3<Real> bounds;
+            for (auto& b : chunk_bounds)
+            {
+                bounds = core::bounds_union(bounds, b);
+            }
+
+            return shapes::TriangleMesh{
+                {core::make_large_array(std::move(coordinates[0])),
+                 core::make_large_array(std::move(coordinates[1])),
+                 core::make_large_array(std::move(coordinates[2]))},
+                core::make_large_array(std::move(indices)),
+                bounds,
+                material};
+        }
+    } // namespace detail
+} // namespace loaders
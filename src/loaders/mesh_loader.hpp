@@ -0,0 +1,80 @@
+#pragma once
+
+#include <shapes/triangle_mesh.hpp>
+
+#include <core/mapped_file.hpp>
+
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace loaders
+{
+    using core::Real;
+
+    struct MeshLoadOptions
+    {
+        // Threads used to parse a single file; 0 selects one per hardware
+        // thread.
+        std::size_t num_threads{0};
+
+        // Files are split into chunks of at least this many bytes, so small
+        // files are parsed entirely on the calling thread.
+        std::size_t min_chunk_size{std::size_t{1} << 20};
+    };
+
+    // Loads an OBJ or PLY mesh, chosen by the extension of `path`. Throws
+    // std::runtime_error if the format is unknown or the file cannot be
+    // read.
+    shapes::TriangleMesh load_mesh(std::string const& path,
+                                   std::uint32_t material = 0,
+                                   MeshLoadOptions const& options = {});
+
+    // As above, for a file that is already mapped. `path` selects the
+    // format and names the file in error messages.
+    shapes::TriangleMesh load_mesh(core::MappedFile const& file,
+                                   std::string const& path,
+                                   std::uint32_t material = 0,
+                                   MeshLoadOptions const& options = {});
+
+    namespace detail
+    {
+        // Parses the number at the start of [first, last), allowing a
+        // leading '+'. Returns the end of the number or nullptr if there is
+        // none.
+        template<typename T>
+        char const* parse_number(char const* first, char const* last, T& value)
+        {
+            if (first != last && *first == '+')
+            {
+                ++first;
+            }
+
+            auto [end, error] = std::from_chars(first, last, value);
+            return error == std::errc{} ? end : nullptr;
+        }
+
+        // Number of chunks to split `size` bytes (or elements) into.
+        std::size_t num_chunks(std::size_t size,
+                               std::size_t min_chunk_size,
+                               MeshLoadOptions const& options);
+
+        // Calls fn(chunk) for every chunk in [0, num_chunks), using the
+        // calling thread and up to num_threads - 1 others. Once every chunk
+        // has run, rethrows the exception of the first chunk that failed.
+        void parallel_chunks(std::size_t num_chunks,
+                             MeshLoadOptions const& options,
+                             std::function<void(std::size_t)> const& fn);
+
+        // Checks the indices against the number of vertices, computes the
+        // bounds and wraps the arrays without copying them.
+        shapes::TriangleMesh
+        make_mesh(std::array<std::vector<Real>, 3> coordinates,
+                  std::vector<std::uint32_t> indices,
+                  std::uint32_t material,
+                  MeshLoadOptions const& options);
+    } // namespace detail
+} // namespace loaders
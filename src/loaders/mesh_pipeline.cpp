@@ -0,0 +1,163 @@
+#include "mesh_pipeline.hpp"
+
+#include <core/mapped_file.hpp>
+#include <core/profiler.hpp>
+
+#include <optional>
+
+namespace loaders
+{
+    // A mesh on its way through the pipeline. A stage that fails sets the
+    // exception on the promise and the later stages skip the job.
+    struct MeshPipeline::Job
+    {
+        std::string path;
+        std::uint32_t material{0};
+        std::promise<shapes::TriangleMesh> result;
+        std::unique_ptr<core::MappedFile> file;
+        std::optional<shapes::TriangleMesh> mesh;
+        bool failed{false};
+
+        template<typename Fn>
+        void run_stage(Fn&& fn)
+        {
+            if (failed)
+            {
+                return;
+            }
+
+            try
+            {
+                fn();
+            }
+            catch (...)
+            {
+                failed = true;
+                result.set_exception(std::current_exception());
+            }
+        }
+    };
+
+#if defined(APOLLO_BUILD_PARALLEL)
+    MeshPipeline::MeshPipeline(MeshPipelineOptions const& options) :
+        m_options{options},
+        m_read_node{m_graph,
+                    std::max<std::size_t>(options.num_io_threads, 1),
+                    [this](JobPtr job) {
+                        read(*job);
+                        return job;
+                    }},
+        m_parse_node{m_graph,
+                     tbb::flow::unlimited,
+                     [this](JobPtr job) {
+                         parse(*job);
+                         return job;
+                     }},
+        m_build_node{m_graph, tbb::flow::unlimited, [this](JobPtr job) {
+                         build(*job);
+                         return tbb::flow::continue_msg{};
+                     }}
+    {
+        tbb::flow::make_edge(m_read_node, m_parse_node);
+        tbb::flow::make_edge(m_parse_node, m_build_node);
+    }
+
+    MeshPipeline::~MeshPipeline()
+    {
+        wait();
+    }
+
+    void MeshPipeline::wait()
+    {
+        m_graph.wait_for_all();
+    }
+#else
+    MeshPipeline::MeshPipeline(MeshPipelineOptions const& options) :
+        m_options{options},
+        m_cpu_pool{options.num_threads},
+        m_io_pool{std::max<std::size_t>(options.num_io_threads, 1)}
+    {}
+
+    MeshPipeline::~MeshPipeline() = default;
+
+    void MeshPipeline::wait()
+    {
+        std::unique_lock lock{m_mutex};
+        m_finished.wait(lock, [this]() { return m_num_pending == 0; });
+    }
+
+    void MeshPipeline::finish()
+    {
+        {
+            std::scoped_lock lock{m_mutex};
+            --m_num_pending;
+        }
+        m_finished.notify_all();
+    }
+#endif
+
+    std::future<shapes::TriangleMesh>
+    MeshPipeline::load(std::string const& path, std::uint32_t material)
+    {
+        auto job{std::make_shared<Job>()};
+        job->path     = path;
+        job->material = material;
+        auto future{job->result.get_future()};
+
+#if defined(APOLLO_BUILD_PARALLEL)
+        m_read_node.try_put(job);
+#else
+        {
+            std::scoped_lock lock{m_mutex};
+            ++m_num_pending;
+        }
+
+        m_io_pool.submit([this, job]() {
+            APOLLO_PROFILE_THREAD_NAME("asset reader");
+            read(*job);
+            if (job->failed)
+            {
+                finish();
+                return;
+            }
+
+            m_cpu_pool.submit([this, job]() {
+                APOLLO_PROFILE_THREAD_NAME("asset loader");
+                parse(*job);
+                build(*job);
+                finish();
+            });
+        });
+#endif
+
+        return future;
+    }
+
+    void MeshPipeline::read(Job& job) const
+    {
+        job.run_stage([&]() {
+            APOLLO_PROFILE_ZONE("mesh read");
+            job.file = std::make_unique<core::MappedFile>(job.path);
+            job.file->prefetch();
+        });
+    }
+
+    void MeshPipeline::parse(Job& job) const
+    {
+        job.run_stage([&]() {
+            job.mesh = load_mesh(
+                *job.file, job.path, job.material, m_options.mesh);
+        });
+
+        // The mesh no longer refers to the file once parsed.
+        job.file.reset();
+    }
+
+    void MeshPipeline::build(Job& job) const
+    {
+        job.run_stage([&]() {
+            job.mesh->build(m_options.bvh);
+            job.result.set_value(std::move(*job.mesh));
+        });
+    }
+} // namespace loaders
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "mesh_loader.hpp"
+
+#include <accelerators/bvh.hpp>
+
+#include <core/thread_pool.hpp>
+
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#if defined(APOLLO_BUILD_PARALLEL)
+#    include <tbb/flow_graph.h>
+#endif
+
+namespace loaders
+{
+    struct MeshPipelineOptions
+    {
+        // Threads that read files ahead of parsing. Reads mostly wait on the
+        // disk, so a few are enough.
+        std::size_t num_io_threads{2};
+
+        // Threads that parse and build meshes; 0 selects one per hardware
+        // thread. Ignored with APOLLO_BUILD_PARALLEL, where TBB schedules
+        // the work.
+        std::size_t num_threads{0};
+
+        accelerators::BvhBuildOptions bvh;
+        MeshLoadOptions mesh;
+    };
+
+    // Loads meshes in stages: the file is read into memory, parsed and its
+    // hierarchy built, after which the mesh is ready. Each mesh moves on as
+    // soon as a stage is done with it, so one file is read while others are
+    // parsed or built. Reads run on threads of their own; parsing and
+    // building share the others. With APOLLO_BUILD_PARALLEL the stages are
+    // nodes of a TBB flow graph.
+    class MeshPipeline
+    {
+    public:
+        explicit MeshPipeline(MeshPipelineOptions const& options = {});
+
+        // Waits for every mesh still in the pipeline.
+        ~MeshPipeline();
+
+        MeshPipeline(MeshPipeline const&) = delete;
+        MeshPipeline& operator=(MeshPipeline const&) = delete;
+
+        // Queues the mesh at `path` (an OBJ or PLY file) and returns a
+        // future for it, already built. Errors from any stage are rethrown
+        // by the future.
+        std::future<shapes::TriangleMesh> load(std::string const& path,
+                                               std::uint32_t material = 0);
+
+        // Blocks until every queued mesh is ready. Call this before waiting
+        // on the futures: TBB may have no worker threads of its own, in
+        // which case the graph only runs on threads that wait for it.
+        void wait();
+
+    private:
+        struct Job;
+        using JobPtr = std::shared_ptr<Job>;
+
+        void read(Job& job) const;
+        void parse(Job& job) const;
+        void build(Job& job) const;
+
+        MeshPipelineOptions m_options;
+
+#if defined(APOLLO_BUILD_PARALLEL)
+        tbb::flow::graph m_graph;
+        tbb::flow::function_node<JobPtr, JobPtr> m_read_node;
+        tbb::flow::function_node<JobPtr, JobPtr> m_parse_node;
+        tbb::flow::function_node<JobPtr> m_build_node;
+#else
+        void finish();
+
+        std::mutex m_mutex;
+        std::condition_variable m_finished;
+        std::size_t m_num_pending{0};
+
+        // Reads hand their meshes to the CPU threads, so those are declared
+        // first and outlive them.
+        core::ThreadPool m_cpu_pool;
+        core::ThreadPool m_io_pool;
+#endif
+    };
+} // namespace loaders
@@ -0,0 +1,289 @@
+#include "obj.hpp"
+
+#include <core/mapped_file.hpp>
+#include <core/profiler.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace loaders
+{
+    namespace
+    {
+        [[noreturn]] void fail(std::string const& path,
+                               std::size_t line,
+                               std::string const& message)
+        {
+            throw std::runtime_error{"error: " + path + ":" +
+                                     std::to_string(line) + ": " + message};
+        }
+
+        // Resolves a 1-based (or negative, relative) OBJ index.
+        bool resolve_index(long index,
+                           std::size_t num_positions,
+                           std::uint32_t& resolved)
+        {
+            auto position{(index < 0)
+                              ? static_cast<long>(num_positions) + index
+                              : index - 1};
+            if (position < 0 ||
+                position >= static_cast<long>(num_positions))
+            {
+                return false;
+            }
+
+            resolved = static_cast<std::uint32_t>(position);
+            return true;
+        }
+
+        bool is_space(char c)
+        {
+            return c == ' ' || c == '\t' || c == '\r';
+        }
+
+        char const* skip_spaces(char const* p, char const* end)
+        {
+            while (p != end && is_space(*p))
+            {
+                ++p;
+            }
+            return p;
+        }
+
+        char const* end_of_token(char const* p, char const* end)
+        {
+            while (p != end && !is_space(*p))
+            {
+                ++p;
+            }
+            return p;
+        }
+
+        enum class Statement
+        {
+            vertex,
+            face,
+            other
+        };
+
+        // Reads the keyword at the start of a line and moves `p` past it.
+        Statement read_statement(char const*& p, char const* end)
+        {
+            p = skip_spaces(p, end);
+            auto keyword{p};
+            p = end_of_token(p, end);
+            if (p - keyword != 1)
+            {
+                return Statement::other;
+            }
+
+            switch (*keyword)
+            {
+            case 'v':
+                return Statement::vertex;
+            case 'f':
+                return Statement::face;
+            default:
+                return Statement::other;
+            }
+        }
+
+        template<typename Fn>
+        void for_each_line(char const* begin, char const* end, Fn&& fn)
+        {
+            while (begin != end)
+            {
+                auto size{static_cast<std::size_t>(end - begin)};
+                auto newline =
+                    static_cast<char const*>(std::memchr(begin, '\n', size));
+                fn(begin, newline != nullptr ? newline : end);
+                begin = newline != nullptr ? newline + 1 : end;
+            }
+        }
+
+        // What a chunk contains, or once summed, where it starts.
+        struct ChunkCounts
+        {
+            std::size_t lines{0};
+            std::size_t vertices{0};
+            std::size_t triangles{0};
+        };
+
+        ChunkCounts count_chunk(char const* begin, char const* end)
+        {
+            ChunkCounts counts;
+            for_each_line(begin, end, [&](char const* p, char const* line_end) {
+                ++counts.lines;
+                switch (read_statement(p, line_end))
+                {
+                case Statement::vertex:
+                    ++counts.vertices;
+                    break;
+                case Statement::face:
+                {
+                    std::size_t num_vertices{0};
+                    for (p = skip_spaces(p, line_end); p != line_end;
+                         p = skip_spaces(end_of_token(p, line_end), line_end))
+                    {
+                        ++num_vertices;
+                    }
+                    if (num_vertices > 2)
+                    {
+                        counts.triangles += num_vertices - 2;
+                    }
+                    break;
+                }
+                case Statement::other:
+                    break;
+                }
+            });
+
+            return counts;
+        }
+
+        void parse_chunk(char const* begin,
+                         char const* end,
+                         ChunkCounts const& start,
+                         std::string const& path,
+                         std::array<std::vector<Real>, 3>& coordinates,
+                         std::vector<std::uint32_t>& indices)
+        {
+            auto line{start.lines + 1};
+            auto vertex{start.vertices};
+            auto index{3 * start.triangles};
+
+            for_each_line(begin, end, [&](char const* p, char const* line_end) {
+                switch (read_statement(p, line_end))
+                {
+                case Statement::vertex:
+                    for (auto& axis : coordinates)
+                    {
+                        p = detail::parse_number(
+                            skip_spaces(p, line_end), line_end, axis[vertex]);
+                        if (p == nullptr)
+                        {
+                            fail(path, line, "malformed vertex");
+                        }
+                    }
+                    ++vertex;
+                    break;
+                case Statement::face:
+                {
+                    std::uint32_t first{0};
+                    std::uint32_t previous{0};
+                    std::size_t num_vertices{0};
+                    for (p = skip_spaces(p, line_end); p != line_end;
+                         p = skip_spaces(p, line_end))
+                    {
+                        // Only the position index before any '/' is used.
+                        auto token_end{end_of_token(p, line_end)};
+                        long value{0};
+                        auto number_end{
+                            detail::parse_number(p, token_end, value)};
+                        std::uint32_t current{0};
+                        if (number_end == nullptr ||
+                            (number_end != token_end && *number_end != '/') ||
+                            !resolve_index(value, vertex, current))
+                        {
+                            fail(path,
+                                 line,
+                                 "invalid face vertex " +
+                                     std::string{p, token_end});
+                        }
+
+                        if (num_vertices == 0)
+                        {
+                            first = current;
+                        }
+                        else if (num_vertices >= 2)
+                        {
+                            indices[index++] = first;
+                            indices[index++] = previous;
+                            indices[index++] = current;
+                        }
+
+                        previous = current;
+                        ++num_vertices;
+                        p        = token_end;
+                    }
+
+                    if (num_vertices < 3)
+                    {
+                        fail(path, line, "face has fewer than 3 vertices");
+                    }
+                    break;
+                }
+                case Statement::other:
+                    break;
+                }
+
+                ++line;
+            });
+        }
+    } // namespace
+
+    shapes::TriangleMesh load_obj(std::string const& path,
+                                  std::uint32_t material,
+                                  MeshLoadOptions const& options)
+    {
+        return load_obj(core::MappedFile{path}, path, material, options);
+    }
+
+    shapes::TriangleMesh load_obj(core::MappedFile const& file,
+                                  std::string const& path,
+                                  std::uint32_t material,
+                                  MeshLoadOptions const& options)
+    {
+        APOLLO_PROFILE_ZONE("obj load");
+
+        auto data = reinterpret_cast<char const*>(file.data());
+        auto end{data + file.size()};
+
+        // Chunks end after a newline, so no line straddles two of them.
+        auto num_chunks{
+            detail::num_chunks(file.size(), options.min_chunk_size, options)};
+        std::vector<char const*> splits(num_chunks + 1, end);
+        splits[0] = data;
+        for (std::size_t i{1}; i < num_chunks; ++i)
+        {
+            auto p{std::max(data + file.size() * i / num_chunks,
+                            splits[i - 1])};
+            auto newline = static_cast<char const*>(
+                std::memchr(p, '\n', static_cast<std::size_t>(end - p)));
+            splits[i] = newline != nullptr ? newline + 1 : end;
+        }
+
+        // The first pass counts vertices and triangles so that every chunk
+        // knows where to write its own.
+        std::vector<ChunkCounts> starts(num_chunks + 1);
+        detail::parallel_chunks(num_chunks, options, [&](std::size_t chunk) {
+            starts[chunk + 1] = count_chunk(splits[chunk], splits[chunk + 1]);
+        });
+        for (std::size_t i{1}; i <= num_chunks; ++i)
+        {
+            starts[i].lines += starts[i - 1].lines;
+            starts[i].vertices += starts[i - 1].vertices;
+            starts[i].triangles += starts[i - 1].triangles;
+        }
+
+        std::array<std::vector<Real>, 3> coordinates;
+        for (auto& axis : coordinates)
+        {
+            axis.resize(starts[num_chunks].vertices);
+        }
+        std::vector<std::uint32_t> indices(3 * starts[num_chunks].triangles);
+
+        detail::parallel_chunks(num_chunks, options, [&](std::size_t chunk) {
+            parse_chunk(splits[chunk],
+                        splits[chunk + 1],
+                        starts[chunk],
+                        path,
+                        coordinates,
+                        indices);
+        });
+
+        return detail::make_mesh(
+            std::move(coordinates), std::move(indices), material, options);
+    }
+} // namespace loaders
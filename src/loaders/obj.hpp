@@ -0,0 +1,25 @@
+#pragma once
+
+#include "mesh_loader.hpp"
+
+#include <string>
+
+namespace loaders
+{
+    // Reads the vertex positions and faces of a Wavefront OBJ file into a
+    // single triangle mesh. Polygons are triangulated as fans; texture
+    // coordinates, normals, groups and materials are ignored. The file is
+    // mapped and split into chunks at line boundaries, which are parsed in
+    // parallel straight into the vertex and index arrays of the mesh.
+    // Throws std::runtime_error if the file cannot be read or is malformed.
+    shapes::TriangleMesh load_obj(std::string const& path,
+                                  std::uint32_t material = 0,
+                                  MeshLoadOptions const& options = {});
+
+    // As above, for a file that is already mapped. `path` is only used in
+    // error messages.
+    shapes::TriangleMesh load_obj(core::MappedFile const& file,
+                                  std::string const& path,
+                                  std::uint32_t material = 0,
+                                  MeshLoadOptions const& options = {});
+} // namespace loaders
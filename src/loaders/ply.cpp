@@ -0,0 +1,760 @@
+#include "ply.hpp"
+
+#include <core/mapped_file.hpp>
+#include <core/profiler.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+
+namespace loaders
+{
+    namespace
+    {
+        [[noreturn]] void fail(std::string const& path,
+                               std::string const& message)
+        {
+            throw std::runtime_error{"error: " + path + ": " + message};
+        }
+
+        enum class PlyType
+        {
+            int8,
+            uint8,
+            int16,
+            uint16,
+            int32,
+            uint32,
+            float32,
+            float64
+        };
+
+        enum class PlyFormat
+        {
+            ascii,
+            binary_little_endian,
+            binary_big_endian
+        };
+
+        struct PlyProperty
+        {
+            std::string name;
+            PlyType type{PlyType::float32};
+            bool is_list{false};
+            PlyType count_type{PlyType::uint8};
+        };
+
+        struct PlyElement
+        {
+            std::string name;
+            std::size_t count{0};
+            std::vector<PlyProperty> properties;
+        };
+
+        struct PlyHeader
+        {
+            PlyFormat format{PlyFormat::ascii};
+            std::vector<PlyElement> elements;
+
+            // Bytes up to and including the end_header line.
+            std::size_t size{0};
+        };
+
+        std::optional<PlyType> parse_type(std::string const& name)
+        {
+            if (name == "char" || name == "int8")
+            {
+                return PlyType::int8;
+            }
+            if (name == "uchar" || name == "uint8")
+            {
+                return PlyType::uint8;
+            }
+            if (name == "short" || name == "int16")
+            {
+                return PlyType::int16;
+            }
+            if (name == "ushort" || name == "uint16")
+            {
+                return PlyType::uint16;
+            }
+            if (name == "int" || name == "int32")
+            {
+                return PlyType::int32;
+            }
+            if (name == "uint" || name == "uint32")
+            {
+                return PlyType::uint32;
+            }
+            if (name == "float" || name == "float32")
+            {
+                return PlyType::float32;
+            }
+            if (name == "double" || name == "float64")
+            {
+                return PlyType::float64;
+            }
+            return std::nullopt;
+        }
+
+        std::size_t type_size(PlyType type)
+        {
+            switch (type)
+            {
+            case PlyType::int8:
+            case PlyType::uint8:
+                return 1;
+            case PlyType::int16:
+            case PlyType::uint16:
+                return 2;
+            case PlyType::int32:
+            case PlyType::uint32:
+            case PlyType::float32:
+                return 4;
+            case PlyType::float64:
+                return 8;
+            }
+            return 0;
+        }
+
+        constexpr std::array<char const*, 3> axis_names{"x", "y", "z"};
+
+        bool is_vertex_list(PlyProperty const& property)
+        {
+            return property.is_list && (property.name == "vertex_indices" ||
+                                        property.name == "vertex_index");
+        }
+
+        PlyHeader read_header(char const* data,
+                              std::size_t size,
+                              std::string const& path)
+        {
+            PlyHeader header;
+            bool has_format{false};
+            for (std::size_t pos{0}, number{0};; ++number)
+            {
+                char const* newline{nullptr};
+                if (pos < size)
+                {
+                    newline = static_cast<char const*>(
+                        std::memchr(data + pos, '\n', size - pos));
+                }
+                if (newline == nullptr)
+                {
+                    fail(path, "missing end_header");
+                }
+
+                std::istringstream stream{std::string{data + pos, newline}};
+                pos = static_cast<std::size_t>(newline - data) + 1;
+
+                std::string keyword;
+                stream >> keyword;
+                if (number == 0)
+                {
+                    if (keyword != "ply")
+                    {
+                        fail(path, "not a PLY file");
+                    }
+                }
+                else if (keyword == "format")
+                {
+                    std::string format;
+                    stream >> format;
+                    if (format == "ascii")
+                    {
+                        header.format = PlyFormat::ascii;
+                    }
+                    else if (format == "binary_little_endian")
+                    {
+                        header.format = PlyFormat::binary_little_endian;
+                    }
+                    else if (format == "binary_big_endian")
+                    {
+                        header.format = PlyFormat::binary_big_endian;
+                    }
+                    else
+                    {
+                        fail(path, "unsupported format " + format);
+                    }
+                    has_format = true;
+                }
+                else if (keyword == "element")
+                {
+                    PlyElement element;
+                    if (!(stream >> element.name >> element.count))
+                    {
+                        fail(path, "malformed element");
+                    }
+                    header.elements.push_back(std::move(element));
+                }
+                else if (keyword == "property")
+                {
+                    if (header.elements.empty())
+                    {
+                        fail(path, "property outside of an element");
+                    }
+
+                    PlyProperty property;
+                    std::string type, count_type;
+                    stream >> type;
+                    property.is_list = (type == "list");
+                    if (property.is_list)
+                    {
+                        stream >> count_type >> type;
+                        auto parsed{parse_type(count_type)};
+                        if (!parsed)
+                        {
+                            fail(path, "unknown property type " + count_type);
+                        }
+                        property.count_type = *parsed;
+                    }
+
+                    auto parsed{parse_type(type)};
+                    if (!parsed || !(stream >> property.name))
+                    {
+                        fail(path, "malformed property");
+                    }
+                    property.type = *parsed;
+                    header.elements.back().properties.push_back(
+                        std::move(property));
+                }
+                else if (keyword == "end_header")
+                {
+                    if (!has_format)
+                    {
+                        fail(path, "missing format");
+                    }
+                    header.size = pos;
+                    return header;
+                }
+            }
+        }
+
+        bool host_is_little_endian()
+        {
+            std::uint16_t value{1};
+            unsigned char first;
+            std::memcpy(&first, &value, 1);
+            return first == 1;
+        }
+
+        template<typename T>
+        T read_raw(unsigned char const* p, bool swap)
+        {
+            std::array<unsigned char, sizeof(T)> bytes;
+            std::memcpy(bytes.data(), p, sizeof(T));
+            if (swap)
+            {
+                std::reverse(bytes.begin(), bytes.end());
+            }
+
+            T value;
+            std::memcpy(&value, bytes.data(), sizeof(T));
+            return value;
+        }
+
+        template<typename T>
+        T read_value(unsigned char const* p, PlyType type, bool swap)
+        {
+            switch (type)
+            {
+            case PlyType::int8:
+                return static_cast<T>(read_raw<std::int8_t>(p, swap));
+            case PlyType::uint8:
+                return static_cast<T>(read_raw<std::uint8_t>(p, swap));
+            case PlyType::int16:
+                return static_cast<T>(read_raw<std::int16_t>(p, swap));
+            case PlyType::uint16:
+                return static_cast<T>(read_raw<std::uint16_t>(p, swap));
+            case PlyType::int32:
+                return static_cast<T>(read_raw<std::int32_t>(p, swap));
+            case PlyType::uint32:
+                return static_cast<T>(read_raw<std::uint32_t>(p, swap));
+            case PlyType::float32:
+                return static_cast<T>(read_raw<float>(p, swap));
+            case PlyType::float64:
+                return static_cast<T>(read_raw<double>(p, swap));
+            }
+            return T{};
+        }
+
+        // Copies one property of `count` consecutive items into `out`. With
+        // native byte order this is a plain strided load.
+        template<typename T>
+        void copy_strided(unsigned char const* p,
+                          std::size_t stride,
+                          std::size_t count,
+                          bool swap,
+                          Real* out)
+        {
+            for (std::size_t i{0}; i < count; ++i)
+            {
+                out[i] = static_cast<Real>(read_raw<T>(p + i * stride, swap));
+            }
+        }
+
+        void copy_property(unsigned char const* p,
+                           PlyType type,
+                           std::size_t stride,
+                           std::size_t count,
+                           bool swap,
+                           Real* out)
+        {
+            switch (type)
+            {
+            case PlyType::int8:
+                return copy_strided<std::int8_t>(p, stride, count, swap, out);
+            case PlyType::uint8:
+                return copy_strided<std::uint8_t>(p, stride, count, swap, out);
+            case PlyType::int16:
+                return copy_strided<std::int16_t>(p, stride, count, swap, out);
+            case PlyType::uint16:
+                return copy_strided<std::uint16_t>(
+                    p, stride, count, swap, out);
+            case PlyType::int32:
+                return copy_strided<std::int32_t>(p, stride, count, swap, out);
+            case PlyType::uint32:
+                return copy_strided<std::uint32_t>(
+                    p, stride, count, swap, out);
+            case PlyType::float32:
+                return copy_strided<float>(p, stride, count, swap, out);
+            case PlyType::float64:
+                return copy_strided<double>(p, stride, count, swap, out);
+            }
+        }
+
+        std::uint32_t to_index(long long value, std::string const& path)
+        {
+            if (value < 0 || value > std::numeric_limits<std::uint32_t>::max())
+            {
+                fail(path, "vertex index is out of range");
+            }
+            return static_cast<std::uint32_t>(value);
+        }
+
+        // Appends the fan triangulation of a polygon.
+        template<typename Fn>
+        void triangulate(std::size_t num_vertices,
+                         Fn&& vertex,
+                         std::vector<std::uint32_t>& indices,
+                         std::string const& path)
+        {
+            if (num_vertices < 3)
+            {
+                fail(path, "face has fewer than 3 vertices");
+            }
+
+            auto first{vertex(0)};
+            auto previous{vertex(1)};
+            for (std::size_t i{2}; i < num_vertices; ++i)
+            {
+                auto current{vertex(i)};
+                indices.insert(indices.end(), {first, previous, current});
+                previous = current;
+            }
+        }
+
+        class BinaryReader
+        {
+        public:
+            BinaryReader(unsigned char const* begin,
+                         unsigned char const* end,
+                         bool swap,
+                         MeshLoadOptions const& options,
+                         std::string const& path) :
+                m_p{begin}, m_end{end}, m_swap{swap}, m_options{options},
+                m_path{path}
+            {}
+
+            void read(PlyElement const& element,
+                      std::array<std::vector<Real>, 3>& coordinates,
+                      std::vector<std::uint32_t>& indices)
+            {
+                if (element.name == "vertex")
+                {
+                    read_vertices(element, coordinates);
+                }
+                else if (element.name == "face" &&
+                         std::any_of(element.properties.begin(),
+                                     element.properties.end(),
+                                     is_vertex_list))
+                {
+                    read_faces(element, indices);
+                }
+                else
+                {
+                    for (std::size_t i{0}; i < element.count; ++i)
+                    {
+                        m_p += item_size(element);
+                    }
+                }
+            }
+
+        private:
+            std::size_t remaining() const
+            {
+                return static_cast<std::size_t>(m_end - m_p);
+            }
+
+            // Size of the item at the current position, checked against the
+            // end of the file.
+            std::size_t item_size(PlyElement const& element) const
+            {
+                std::size_t size{0};
+                for (auto& property : element.properties)
+                {
+                    if (!property.is_list)
+                    {
+                        size += type_size(property.type);
+                        continue;
+                    }
+
+                    auto count_size{type_size(property.count_type)};
+                    if (size + count_size > remaining())
+                    {
+                        fail(m_path, "unexpected end of file");
+                    }
+
+                    auto count{read_value<long long>(
+                        m_p + size, property.count_type, m_swap)};
+                    size += count_size;
+                    if (count < 0 ||
+                        static_cast<std::size_t>(count) >
+                            (remaining() - size) / type_size(property.type))
+                    {
+                        fail(m_path, "unexpected end of file");
+                    }
+                    size += static_cast<std::size_t>(count) *
+                            type_size(property.type);
+                }
+
+                if (size > remaining())
+                {
+                    fail(m_path, "unexpected end of file");
+                }
+                return size;
+            }
+
+            void read_vertices(PlyElement const& element,
+                               std::array<std::vector<Real>, 3>& coordinates)
+            {
+                std::size_t stride{0};
+                std::array<std::optional<std::size_t>, 3> offsets;
+                std::array<PlyType, 3> types{};
+                for (auto& property : element.properties)
+                {
+                    if (property.is_list)
+                    {
+                        fail(m_path, "vertices with list properties");
+                    }
+
+                    for (std::size_t axis{0}; axis < 3; ++axis)
+                    {
+                        if (property.name == axis_names[axis])
+                        {
+                            offsets[axis] = stride;
+                            types[axis]   = property.type;
+                        }
+                    }
+                    stride += type_size(property.type);
+                }
+
+                if (!offsets[0] || !offsets[1] || !offsets[2])
+                {
+                    fail(m_path, "missing vertex coordinates");
+                }
+                if (element.count > remaining() / stride)
+                {
+                    fail(m_path, "unexpected end of file");
+                }
+
+                // Vertices have a fixed size, so chunks start anywhere.
+                auto count{element.count};
+                auto num_chunks{detail::num_chunks(
+                    count * stride, m_options.min_chunk_size, m_options)};
+                for (auto& axis : coordinates)
+                {
+                    axis.resize(count);
+                }
+
+                detail::parallel_chunks(
+                    num_chunks, m_options, [&](std::size_t chunk) {
+                        auto begin{count * chunk / num_chunks};
+                        auto end{count * (chunk + 1) / num_chunks};
+                        for (std::size_t axis{0}; axis < 3; ++axis)
+                        {
+                            copy_property(m_p + begin * stride + *offsets[axis],
+                                          types[axis],
+                                          stride,
+                                          end - begin,
+                                          m_swap,
+                                          coordinates[axis].data() + begin);
+                        }
+                    });
+
+                m_p += count * stride;
+            }
+
+            void read_faces(PlyElement const& element,
+                            std::vector<std::uint32_t>& indices)
+            {
+                if (element.properties.size() == 1 &&
+                    read_triangles(element, indices))
+                {
+                    return;
+                }
+
+                indices.clear();
+                for (std::size_t i{0}; i < element.count; ++i)
+                {
+                    auto next{m_p + item_size(element)};
+                    for (auto& property : element.properties)
+                    {
+                        if (!property.is_list)
+                        {
+                            m_p += type_size(property.type);
+                            continue;
+                        }
+
+                        auto count{static_cast<std::size_t>(
+                            read_value<long long>(
+                                m_p, property.count_type, m_swap))};
+                        m_p += type_size(property.count_type);
+                        auto index_size{type_size(property.type)};
+                        if (is_vertex_list(property))
+                        {
+                            auto vertex = [&](std::size_t k) {
+                                return to_index(
+                                    read_value<long long>(m_p + k * index_size,
+                                                          property.type,
+                                                          m_swap),
+                                    m_path);
+                            };
+                            triangulate(count, vertex, indices, m_path);
+                        }
+                        m_p += count * index_size;
+                    }
+                    m_p = next;
+                }
+            }
+
+            // Fast path for faces holding only a vertex list, as long as
+            // every face is a triangle: faces then have a fixed size and are
+            // read in parallel. Returns false otherwise.
+            bool read_triangles(PlyElement const& element,
+                                std::vector<std::uint32_t>& indices)
+            {
+                auto& list = element.properties[0];
+                auto count_size{type_size(list.count_type)};
+                auto index_size{type_size(list.type)};
+                auto face_size{count_size + 3 * index_size};
+                if (element.count > remaining() / face_size)
+                {
+                    return false;
+                }
+
+                auto count{element.count};
+                auto num_chunks{detail::num_chunks(
+                    count * face_size, m_options.min_chunk_size, m_options)};
+                indices.resize(3 * count);
+                std::atomic<bool> triangles{true};
+                detail::parallel_chunks(
+                    num_chunks, m_options, [&](std::size_t chunk) {
+                        auto begin{count * chunk / num_chunks};
+                        auto end{count * (chunk + 1) / num_chunks};
+                        for (auto i{begin}; i < end && triangles; ++i)
+                        {
+                            auto face{m_p + i * face_size};
+                            if (read_value<long long>(
+                                    face, list.count_type, m_swap) != 3)
+                            {
+                                triangles = false;
+                                return;
+                            }
+
+                            for (std::size_t k{0}; k < 3; ++k)
+                            {
+                                indices[3 * i + k] = to_index(
+                                    read_value<long long>(
+                                        face + count_size + k * index_size,
+                                        list.type,
+                                        m_swap),
+                                    m_path);
+                            }
+                        }
+                    });
+
+                if (triangles)
+                {
+                    m_p += count * face_size;
+                }
+                return triangles;
+            }
+
+            unsigned char const* m_p;
+            unsigned char const* m_end;
+            bool m_swap;
+            MeshLoadOptions const& m_options;
+            std::string const& m_path;
+        };
+
+        class AsciiReader
+        {
+        public:
+            AsciiReader(char const* begin,
+                        char const* end,
+                        std::string const& path) :
+                m_p{begin}, m_end{end}, m_path{path}
+            {}
+
+            void read(PlyElement const& element,
+                      std::array<std::vector<Real>, 3>& coordinates,
+                      std::vector<std::uint32_t>& indices)
+            {
+                auto is_vertex{element.name == "vertex"};
+                auto is_face{element.name == "face"};
+                if (is_vertex)
+                {
+                    for (auto& axis : coordinates)
+                    {
+                        axis.assign(element.count, Real{0});
+                    }
+                }
+
+                std::array<bool, 3> found{};
+                std::vector<std::uint32_t> face;
+                for (std::size_t i{0}; i < element.count; ++i)
+                {
+                    for (auto& property : element.properties)
+                    {
+                        if (!property.is_list)
+                        {
+                            auto value{next()};
+                            for (std::size_t axis{0}; is_vertex && axis < 3;
+                                 ++axis)
+                            {
+                                if (property.name == axis_names[axis])
+                                {
+                                    coordinates[axis][i] =
+                                        static_cast<Real>(value);
+                                    found[axis] = true;
+                                }
+                            }
+                            continue;
+                        }
+
+                        auto count{next()};
+                        if (count < 0)
+                        {
+                            fail(m_path, "negative list size");
+                        }
+
+                        face.clear();
+                        for (std::size_t k{0};
+                             k < static_cast<std::size_t>(count);
+                             ++k)
+                        {
+                            auto value{next()};
+                            if (is_face && is_vertex_list(property))
+                            {
+                                face.push_back(to_index(
+                                    static_cast<long long>(value), m_path));
+                            }
+                        }
+
+                        if (is_face && is_vertex_list(property))
+                        {
+                            triangulate(
+                                face.size(),
+                                [&face](std::size_t k) { return face[k]; },
+                                indices,
+                                m_path);
+                        }
+                    }
+                }
+
+                if (is_vertex && element.count > 0 &&
+                    !(found[0] && found[1] && found[2]))
+                {
+                    fail(m_path, "missing vertex coordinates");
+                }
+            }
+
+        private:
+            double next()
+            {
+                while (m_p != m_end &&
+                       (*m_p == ' ' || *m_p == '\t' || *m_p == '\r' ||
+                        *m_p == '\n'))
+                {
+                    ++m_p;
+                }
+
+                double value{0};
+                auto end{detail::parse_number(m_p, m_end, value)};
+                if (end == nullptr)
+                {
+                    fail(m_path, "malformed or missing value");
+                }
+
+                m_p = end;
+                return value;
+            }
+
+            char const* m_p;
+            char const* m_end;
+            std::string const& m_path;
+        };
+    } // namespace
+
+    shapes::TriangleMesh load_ply(std::string const& path,
+                                  std::uint32_t material,
+                                  MeshLoadOptions const& options)
+    {
+        return load_ply(core::MappedFile{path}, path, material, options);
+    }
+
+    shapes::TriangleMesh load_ply(core::MappedFile const& file,
+                                  std::string const& path,
+                                  std::uint32_t material,
+                                  MeshLoadOptions const& options)
+    {
+        APOLLO_PROFILE_ZONE("ply load");
+
+        auto header{read_header(
+            reinterpret_cast<char const*>(file.data()), file.size(), path)};
+
+        std::array<std::vector<Real>, 3> coordinates;
+        std::vector<std::uint32_t> indices;
+        if (header.format == PlyFormat::ascii)
+        {
+            auto data = reinterpret_cast<char const*>(file.data());
+            AsciiReader reader{data + header.size, data + file.size(), path};
+            for (auto& element : header.elements)
+            {
+                reader.read(element, coordinates, indices);
+            }
+        }
+        else
+        {
+            auto little_endian{header.format ==
+                               PlyFormat::binary_little_endian};
+            BinaryReader reader{file.data() + header.size,
+                                file.data() + file.size(),
+                                little_endian != host_is_little_endian(),
+                                options,
+                                path};
+            for (auto& element : header.elements)
+            {
+                reader.read(element, coordinates, indices);
+            }
+        }
+
+        return detail::make_mesh(
+            std::move(coordinates), std::move(indices), material, options);
+    }
+} // namespace loaders
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "mesh_loader.hpp"
+
+#include <string>
+
+namespace loaders
+{
+    // Reads the vertex positions and faces of a PLY file (ASCII or binary,
+    // either endianness) into a single triangle mesh. Polygons are
+    // triangulated as fans and other elements and properties are skipped.
+    // Binary vertices are copied from the mapped file in parallel without
+    // any parsing; binary faces take the same path when every face is a
+    // triangle. Throws std::runtime_error if the file cannot be read, is
+    // malformed or has no x, y and z vertex properties.
+    shapes::TriangleMesh load_ply(std::string const& path,
+                                  std::uint32_t material = 0,
+                                  MeshLoadOptions const& options = {});
+
+    // As above, for a file that is already mapped. `path` is only used in
+    // error messages.
+    shapes::TriangleMesh load_ply(core::MappedFile const& file,
+                                  std::string const& path,
+                                  std::uint32_t material = 0,
+                                  MeshLoadOptions const& options = {});
+} // namespace loaders
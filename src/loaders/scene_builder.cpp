@@ -0,0 +1,130 @@
+#include "scene_builder.hpp"
+
+#include <shapes/mesh_instance.hpp>
+
+#include <core/profiler.hpp>
+
+#include <stdexcept>
+
+namespace loaders
+{
+    SceneBuilder::SceneBuilder(SceneBuilderOptions const& options)
+    {
+        MeshPipelineOptions pipeline;
+        pipeline.num_io_threads = options.num_io_threads;
+        pipeline.num_threads    = options.num_threads;
+        pipeline.bvh            = options.bvh;
+        pipeline.mesh           = options.mesh;
+        m_pipeline              = std::make_unique<MeshPipeline>(pipeline);
+    }
+
+    std::uint32_t SceneBuilder::add_material(render::Material const& material)
+    {
+        ++m_num_materials;
+        return m_scene.add_material(material);
+    }
+
+    void SceneBuilder::add_shape(std::unique_ptr<shapes::Shape> shape)
+    {
+        m_scene.add_shape(std::move(shape));
+    }
+
+    void SceneBuilder::add_light(render::PointLight const& light)
+    {
+        m_scene.add_light(light);
+    }
+
+    void SceneBuilder::set_camera(render::Camera const& camera)
+    {
+        m_scene.set_camera(camera);
+    }
+
+    SceneBuilder::MeshHandle
+    SceneBuilder::request_mesh(std::string const& path,
+                               std::uint32_t material)
+    {
+        auto key{std::make_pair(path, material)};
+        if (auto it = m_mesh_handles.find(key); it != m_mesh_handles.end())
+        {
+            return it->second;
+        }
+
+        m_meshes.push_back(m_pipeline->load(path, material));
+
+        auto handle{static_cast<MeshHandle>(m_meshes.size() - 1)};
+        m_mesh_handles.emplace(std::move(key), handle);
+        return handle;
+    }
+
+    void
+    SceneBuilder::add_instance(MeshHandle mesh,
+                               core::Transform<Real> const& object_to_world)
+    {
+        if (mesh >= m_meshes.size())
+        {
+            throw std::runtime_error{"error: invalid mesh handle"};
+        }
+
+        m_instances.emplace_back(mesh, object_to_world);
+    }
+
+    std::vector<std::string> SceneBuilder::asset_paths() const
+    {
+        // Handles are keyed by path first, so duplicates are adjacent.
+        std::vector<std::string> paths;
+        for (auto& [key, handle] : m_mesh_handles)
+        {
+            if (paths.empty() || paths.back() != key.first)
+            {
+                paths.push_back(key.first);
+            }
+        }
+
+        return paths;
+    }
+
+    render::Scene SceneBuilder::finish()
+    {
+        APOLLO_PROFILE_ZONE("scene assets wait");
+        m_pipeline->wait();
+
+        // Wait for every mesh, even after a failure, so no load is left
+        // running once the error is reported.
+        std::vector<std::shared_ptr<shapes::TriangleMesh>> meshes;
+        std::exception_ptr error;
+        for (auto& future : m_meshes)
+        {
+            try
+            {
+                meshes.push_back(m_scene.add_mesh(future.get()));
+            }
+            catch (...)
+            {
+                if (!error)
+                {
+                    error = std::current_exception();
+                }
+                meshes.push_back(nullptr);
+            }
+        }
+
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+
+        for (auto& [handle, transform] : m_instances)
+        {
+            m_scene.add_shape(std::make_unique<shapes::MeshInstance>(
+                meshes[handle], transform));
+        }
+
+        auto scene{std::move(m_scene)};
+        m_scene         = render::Scene{};
+        m_num_materials = 1;
+        m_meshes.clear();
+        m_mesh_handles.clear();
+        m_instances.clear();
+        return scene;
+    }
+} // namespace loaders
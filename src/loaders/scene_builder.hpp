@@ -0,0 +1,95 @@
+#pragma once
+
+#include "mesh_pipeline.hpp"
+
+#include <render/scene.hpp>
+#include <shapes/shape.hpp>
+
+#include <core/transform.hpp>
+
+#include <future>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace loaders
+{
+    struct SceneBuilderOptions
+    {
+        // Threads used to load assets; 0 selects one per hardware thread.
+        std::size_t num_threads{0};
+
+        // Threads that read asset files ahead of the loading threads.
+        std::size_t num_io_threads{2};
+
+        // Meshes are built as soon as they are loaded.
+        accelerators::BvhBuildOptions bvh;
+
+        // Large files are additionally split across threads of their own.
+        MeshLoadOptions mesh;
+    };
+
+    // Front end shared by scene description formats. Geometry stored inline
+    // is added straight away, while referenced asset files enter a
+    // MeshPipeline as soon as they are requested, so a description that
+    // references many files reads, parses and builds them concurrently while
+    // it is still being evaluated. finish() waits for the outstanding assets
+    // and assembles the scene.
+    class SceneBuilder
+    {
+    public:
+        using MeshHandle = std::uint32_t;
+
+        explicit SceneBuilder(SceneBuilderOptions const& options = {});
+
+        std::uint32_t add_material(render::Material const& material);
+
+        void add_shape(std::unique_ptr<shapes::Shape> shape);
+
+        void add_light(render::PointLight const& light);
+
+        void set_camera(render::Camera const& camera);
+
+        // Starts loading the mesh at `path` (an OBJ or PLY file) in the
+        // background. Requesting the same file with the same material again
+        // returns the existing handle.
+        MeshHandle request_mesh(std::string const& path,
+                                std::uint32_t material = 0);
+
+        // Places a requested mesh in the scene. The mesh may still be
+        // loading.
+        void add_instance(MeshHandle mesh,
+                          core::Transform<Real> const& object_to_world = {});
+
+        std::size_t num_materials() const
+        {
+            return m_num_materials;
+        }
+
+        std::size_t num_meshes() const
+        {
+            return m_meshes.size();
+        }
+
+        // Every asset file requested so far, each listed once.
+        std::vector<std::string> asset_paths() const;
+
+        // Waits for every asset and returns the scene, ready for
+        // Scene::build(). Rethrows the first loading error. The builder is
+        // left empty.
+        render::Scene finish();
+
+    private:
+        std::unique_ptr<MeshPipeline> m_pipeline;
+        render::Scene m_scene;
+        std::size_t m_num_materials{1};
+
+        std::vector<std::future<shapes::TriangleMesh>> m_meshes;
+        std::map<std::pair<std::string, std::uint32_t>, MeshHandle>
+            m_mesh_handles;
+        std::vector<std::pair<MeshHandle, core::Transform<Real>>>
+            m_instances;
+    };
+} // namespace loaders
@@ -0,0 +1,688 @@
+#include "scene_cache.hpp"
+
+#include <shapes/mesh_instance.hpp>
+#include <shapes/paged_mesh_instance.hpp>
+#include <shapes/sphere.hpp>
+
+#include <core/hash.hpp>
+#include <core/mapped_file.hpp>
+#include <core/profiler.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+namespace fs = std::filesystem;
+
+namespace loaders
+{
+    namespace
+    {
+        constexpr std::array<char, 8> cache_magic{
+            'A', 'P', 'O', 'L', 'L', 'O', 'S', 'C'};
+
+        // Every array starts on a cache line.
+        constexpr std::size_t cache_alignment{64};
+
+        // Location of an array in the cache: byte offset from the start of
+        // the file and number of elements.
+        struct ArrayRecord
+        {
+            std::uint64_t offset{0};
+            std::uint64_t count{0};
+        };
+
+        struct SourceRecord
+        {
+            ArrayRecord path;
+            std::uint64_t hash{0};
+        };
+
+        struct MeshRecord
+        {
+            std::array<ArrayRecord, 3> coordinates;
+            ArrayRecord indices;
+            ArrayRecord nodes;
+            ArrayRecord bvh_indices;
+            core::Bounds3<Real> bounds;
+            std::uint32_t material{0};
+        };
+
+        enum class ShapeKind : std::uint32_t
+        {
+            sphere = 0,
+            mesh,
+            instance
+        };
+
+        struct ShapeRecord
+        {
+            ShapeKind kind{ShapeKind::sphere};
+
+            // Spheres only.
+            std::uint32_t material{0};
+            core::Point3<Real> center;
+            Real radius{0};
+
+            // Meshes and instances: index of the mesh record.
+            std::uint32_t mesh{0};
+
+            // Instances only.
+            core::Transform<Real> transform;
+        };
+
+        struct Header
+        {
+            std::array<char, 8> magic{};
+            std::uint32_t version{0};
+            std::uint32_t real_size{0};
+            std::uint64_t file_size{0};
+            std::uint32_t has_bvh{0};
+            render::Camera camera;
+
+            ArrayRecord sources;
+            ArrayRecord materials;
+            ArrayRecord lights;
+            ArrayRecord meshes;
+            ArrayRecord shapes;
+
+            // Top-level hierarchy, when has_bvh is set.
+            ArrayRecord nodes;
+            ArrayRecord bvh_indices;
+        };
+
+        static_assert(std::is_trivially_copyable_v<Header>);
+        static_assert(std::is_trivially_copyable_v<MeshRecord>);
+        static_assert(std::is_trivially_copyable_v<ShapeRecord>);
+        static_assert(std::is_trivially_copyable_v<render::Material>);
+        static_assert(std::is_trivially_copyable_v<render::PointLight>);
+
+        std::size_t round_up(std::size_t size, std::size_t alignment)
+        {
+            return (size + alignment - 1) / alignment * alignment;
+        }
+
+        class CacheWriter
+        {
+        public:
+            CacheWriter() : m_bytes(sizeof(Header))
+            {}
+
+            template<typename T>
+            ArrayRecord write(T const* data, std::size_t count)
+            {
+                static_assert(std::is_trivially_copyable_v<T>);
+
+                m_bytes.resize(round_up(m_bytes.size(), cache_alignment));
+                ArrayRecord record{m_bytes.size(), count};
+                auto bytes = reinterpret_cast<unsigned char const*>(data);
+                m_bytes.insert(m_bytes.end(), bytes, bytes + count * sizeof(T));
+                return record;
+            }
+
+            template<typename Container>
+            ArrayRecord write(Container const& values)
+            {
+                return write(values.data(), values.size());
+            }
+
+            std::vector<unsigned char>& bytes()
+            {
+                return m_bytes;
+            }
+
+        private:
+            std::vector<unsigned char> m_bytes;
+        };
+
+        // Checked access to the arrays of a mapped cache. Throws
+        // std::runtime_error on records pointing outside the file.
+        class CacheReader
+        {
+        public:
+            explicit CacheReader(std::shared_ptr<core::MappedFile const> file) :
+                m_file{std::move(file)}
+            {}
+
+            template<typename T>
+            T const* data(ArrayRecord const& record) const
+            {
+                auto size{m_file->size()};
+                if (record.offset > size || record.offset % alignof(T) != 0 ||
+                    record.count > (size - record.offset) / sizeof(T))
+                {
+                    throw std::runtime_error{"error: corrupt scene cache"};
+                }
+
+                return reinterpret_cast<T const*>(m_file->data() +
+                                                  record.offset);
+            }
+
+            // Array used in place, keeping the mapping alive.
+            template<typename T>
+            core::SharedArray<T> shared(ArrayRecord const& record) const
+            {
+                return core::SharedArray<T>{
+                    data<T>(record), record.count, m_file};
+            }
+
+            // Small arrays of records are copied out of the mapping.
+            template<typename T>
+            std::vector<T> copy(ArrayRecord const& record) const
+            {
+                auto values = data<T>(record);
+                std::vector<T> result(record.count);
+                std::memcpy(
+                    result.data(), values, record.count * sizeof(T));
+                return result;
+            }
+
+            // Copies an array out of the mapping and drops its pages, so
+            // only the copy stays resident.
+            template<typename T>
+            core::SharedArray<T> page_in(ArrayRecord const& record) const
+            {
+                auto values{copy<T>(record)};
+                m_file->discard(record.offset, record.count * sizeof(T));
+                return core::SharedArray<T>{std::move(values)};
+            }
+
+            template<typename T>
+            std::size_t bytes(ArrayRecord const& record) const
+            {
+                data<T>(record);
+                return record.count * sizeof(T);
+            }
+
+        private:
+            std::shared_ptr<core::MappedFile const> m_file;
+        };
+
+        // Whether a hierarchy over `num_primitives` primitives can be
+        // traversed safely: children follow their parents, no node is
+        // deeper than the traversal stacks allow and leaves only reference
+        // existing primitives.
+        bool is_valid_hierarchy(CacheReader const& reader,
+                                ArrayRecord const& node_record,
+                                ArrayRecord const& index_record,
+                                std::size_t num_primitives)
+        {
+            auto nodes = reader.data<accelerators::BvhNode>(node_record);
+            auto indices = reader.data<std::uint32_t>(index_record);
+            auto num_nodes{node_record.count};
+
+            // Without indices, leaves number the primitives directly.
+            auto leaf_range{index_record.count == 0 ? num_primitives
+                                                    : index_record.count};
+
+            std::vector<std::size_t> depths(num_nodes, 0);
+            for (std::size_t i{0}; i < num_nodes; ++i)
+            {
+                auto& node = nodes[i];
+                if (node.is_leaf())
+                {
+                    if (std::uint64_t{node.offset} + node.count > leaf_range)
+                    {
+                        return false;
+                    }
+                    continue;
+                }
+
+                if (node.offset <= i + 1 || node.offset >= num_nodes ||
+                    depths[i] >= accelerators::Bvh::max_depth)
+                {
+                    return false;
+                }
+
+                depths[i + 1] = std::max(depths[i + 1], depths[i] + 1);
+                depths[node.offset] =
+                    std::max(depths[node.offset], depths[i] + 1);
+            }
+
+            return std::all_of(
+                indices, indices + index_record.count, [&](auto index) {
+                    return index < num_primitives;
+                });
+        }
+
+        std::unique_ptr<shapes::Sphere> make_sphere(ShapeRecord const& record)
+        {
+            return std::make_unique<shapes::Sphere>(
+                record.center, record.radius, record.material);
+        }
+
+        // Replaces every mesh and mesh instance by a paged instance. Meshes
+        // are copied out of the mapping when paged in, so the mapping itself
+        // does not keep them resident.
+        void add_paged_shapes(render::Scene& scene,
+                              CacheReader const& reader,
+                              std::vector<MeshRecord> const& meshes,
+                              std::vector<ShapeRecord> const& shape_records,
+                              bool has_bvh,
+                              std::size_t budget)
+        {
+            auto load = [reader, meshes, has_bvh](std::size_t id) {
+                auto& record = meshes[id];
+                accelerators::Bvh bvh;
+                if (has_bvh)
+                {
+                    bvh = accelerators::Bvh{
+                        reader.page_in<accelerators::BvhNode>(record.nodes),
+                        reader.page_in<std::uint32_t>(record.bvh_indices)};
+                }
+
+                shapes::TriangleMesh mesh{
+                    {reader.page_in<Real>(record.coordinates[0]),
+                     reader.page_in<Real>(record.coordinates[1]),
+                     reader.page_in<Real>(record.coordinates[2])},
+                    reader.page_in<std::uint32_t>(record.indices),
+                    record.bounds,
+                    record.material,
+                    std::move(bvh)};
+                if (!mesh.is_built())
+                {
+                    mesh.build();
+                }
+                return mesh;
+            };
+
+            // Sizes are checked against the file here, so paging in cannot
+            // fail later on a corrupt cache.
+            auto pager = std::make_shared<shapes::GeometryPager>(budget, load);
+            for (auto& record : meshes)
+            {
+                auto size{reader.bytes<Real>(record.coordinates[0]) +
+                          reader.bytes<Real>(record.coordinates[1]) +
+                          reader.bytes<Real>(record.coordinates[2]) +
+                          reader.bytes<std::uint32_t>(record.indices)};
+                if (has_bvh)
+                {
+                    size +=
+                        reader.bytes<accelerators::BvhNode>(record.nodes) +
+                        reader.bytes<std::uint32_t>(record.bvh_indices);
+                }
+                pager->add(size);
+            }
+
+            for (auto& record : shape_records)
+            {
+                if (record.kind == ShapeKind::sphere)
+                {
+                    scene.add_shape(make_sphere(record));
+                    continue;
+                }
+
+                auto& mesh = meshes[record.mesh];
+                scene.add_shape(std::make_unique<shapes::PagedMeshInstance>(
+                    pager,
+                    record.mesh,
+                    mesh.bounds,
+                    mesh.indices.count / 3,
+                    record.kind == ShapeKind::instance
+                        ? record.transform
+                        : core::Transform<Real>{}));
+            }
+
+            scene.set_pager(std::move(pager));
+        }
+    } // namespace
+
+    std::uint64_t hash_file(std::string const& path)
+    {
+        core::MappedFile file{path};
+        return core::murmur_hash_64a(file.data(), file.size(), 0);
+    }
+
+    void write_scene_cache(render::Scene const& scene,
+                           std::vector<std::string> const& sources,
+                           std::string const& path,
+                           SceneCacheOptions const& options)
+    {
+        APOLLO_PROFILE_ZONE("scene cache write");
+
+        if (options.include_bvh && !scene.shapes().empty() &&
+            scene.bvh().empty())
+        {
+            throw std::runtime_error{
+                "error: the scene must be built before caching its "
+                "hierarchy"};
+        }
+
+        CacheWriter writer;
+        Header header;
+        header.magic     = cache_magic;
+        header.version   = scene_cache_version;
+        header.real_size = sizeof(Real);
+        header.has_bvh   = options.include_bvh ? 1 : 0;
+        header.camera    = scene.camera();
+
+        std::vector<SourceRecord> source_records;
+        for (auto& source : sources)
+        {
+            source_records.push_back(
+                {writer.write(source.data(), source.size()),
+                 hash_file(source)});
+        }
+        header.sources   = writer.write(source_records);
+        header.materials = writer.write(scene.materials());
+        header.lights    = writer.write(scene.lights());
+
+        std::vector<MeshRecord> meshes;
+        std::map<shapes::TriangleMesh const*, std::uint32_t> mesh_ids;
+        auto add_mesh = [&](shapes::TriangleMesh const& mesh) {
+            auto [it, inserted] = mesh_ids.emplace(
+                &mesh, static_cast<std::uint32_t>(meshes.size()));
+            if (!inserted)
+            {
+                return it->second;
+            }
+
+            if (mesh.is_compressed())
+            {
+                throw std::runtime_error{
+                    "error: compressed meshes cannot be cached"};
+            }
+
+            if (mesh.has_precomputed_leaves())
+            {
+                throw std::runtime_error{
+                    "error: meshes with precomputed leaves cannot be cached"};
+            }
+
+            MeshRecord record;
+            for (std::size_t axis{0}; axis < 3; ++axis)
+            {
+                record.coordinates[axis] =
+                    writer.write(mesh.coordinates(axis));
+            }
+            record.indices  = writer.write(mesh.indices());
+            record.bounds   = mesh.bounds();
+            record.material = mesh.material();
+            if (options.include_bvh)
+            {
+                if (!mesh.is_built())
+                {
+                    throw std::runtime_error{
+                        "error: every mesh must be built before caching "
+                        "its hierarchy"};
+                }
+                record.nodes       = writer.write(mesh.bvh().nodes());
+                record.bvh_indices = writer.write(mesh.bvh().indices());
+            }
+
+            meshes.push_back(record);
+            return it->second;
+        };
+
+        for (auto& mesh : scene.meshes())
+        {
+            add_mesh(*mesh);
+        }
+
+        std::vector<ShapeRecord> shape_records;
+        for (auto& shape : scene.shapes())
+        {
+            ShapeRecord record;
+            if (auto sphere = dynamic_cast<shapes::Sphere const*>(shape.get()))
+            {
+                record.kind     = ShapeKind::sphere;
+                record.material = sphere->material();
+                record.center   = sphere->center();
+                record.radius   = sphere->radius();
+            }
+            else if (auto mesh =
+                         dynamic_cast<shapes::TriangleMesh const*>(shape.get()))
+            {
+                record.kind = ShapeKind::mesh;
+                record.mesh = add_mesh(*mesh);
+            }
+            else if (auto instance = dynamic_cast<shapes::MeshInstance const*>(
+                         shape.get()))
+            {
+                record.kind      = ShapeKind::instance;
+                record.mesh      = add_mesh(instance->mesh());
+                record.transform = instance->transform();
+            }
+            else
+            {
+                throw std::runtime_error{
+                    "error: scene cache cannot store this shape type"};
+            }
+
+            shape_records.push_back(record);
+        }
+
+        header.meshes = writer.write(meshes);
+        header.shapes = writer.write(shape_records);
+        if (options.include_bvh)
+        {
+            header.nodes       = writer.write(scene.bvh().nodes());
+            header.bvh_indices = writer.write(scene.bvh().indices());
+        }
+
+        auto& bytes = writer.bytes();
+        header.file_size = bytes.size();
+        std::memcpy(bytes.data(), &header, sizeof(Header));
+
+        // Write next to the destination and rename, so processes that have
+        // the old cache mapped keep a consistent file.
+        auto temp_path{path + ".tmp"};
+        {
+            std::ofstream file{temp_path, std::ios::binary};
+            if (!file.write(reinterpret_cast<char const*>(bytes.data()),
+                            static_cast<std::streamsize>(bytes.size())))
+            {
+                throw std::runtime_error{"error: unable to write " +
+                                         temp_path};
+            }
+        }
+
+        std::error_code error;
+        fs::rename(temp_path, path, error);
+        if (error)
+        {
+            fs::remove(temp_path, error);
+            throw std::runtime_error{"error: unable to write " + path};
+        }
+    }
+
+    std::optional<render::Scene>
+    load_scene_cache(std::string const& path,
+                     SceneCacheLoadOptions const& options)
+    {
+        APOLLO_PROFILE_ZONE("scene cache load");
+
+        std::error_code error;
+        if (!fs::is_regular_file(path, error))
+        {
+            return std::nullopt;
+        }
+
+        try
+        {
+            auto file = std::make_shared<core::MappedFile const>(path);
+            if (file->size() < sizeof(Header))
+            {
+                return std::nullopt;
+            }
+
+            Header header;
+            std::memcpy(&header, file->data(), sizeof(Header));
+            if (header.magic != cache_magic ||
+                header.version != scene_cache_version ||
+                header.real_size != sizeof(Real) ||
+                header.file_size != file->size())
+            {
+                return std::nullopt;
+            }
+
+            CacheReader reader{file};
+            for (auto& source : reader.copy<SourceRecord>(header.sources))
+            {
+                auto chars = reader.data<char>(source.path);
+                std::string source_path{chars, source.path.count};
+                if (!fs::is_regular_file(source_path, error) ||
+                    hash_file(source_path) != source.hash)
+                {
+                    return std::nullopt;
+                }
+            }
+
+            render::Scene scene;
+            scene.set_camera(header.camera);
+
+            // Material 0 is the default one every scene starts with.
+            auto materials{reader.copy<render::Material>(header.materials)};
+            for (std::size_t i{1}; i < materials.size(); ++i)
+            {
+                scene.add_material(materials[i]);
+            }
+
+            for (auto& light : reader.copy<render::PointLight>(header.lights))
+            {
+                scene.add_light(light);
+            }
+
+            auto meshes{reader.copy<MeshRecord>(header.meshes)};
+            auto shape_records{reader.copy<ShapeRecord>(header.shapes)};
+
+            auto make_mesh = [&](MeshRecord const& record) {
+                accelerators::Bvh bvh;
+                if (header.has_bvh != 0)
+                {
+                    bvh = accelerators::Bvh{
+                        reader.shared<accelerators::BvhNode>(record.nodes),
+                        reader.shared<std::uint32_t>(record.bvh_indices)};
+                }
+
+                return shapes::TriangleMesh{
+                    {reader.shared<Real>(record.coordinates[0]),
+                     reader.shared<Real>(record.coordinates[1]),
+                     reader.shared<Real>(record.coordinates[2])},
+                    reader.shared<std::uint32_t>(record.indices),
+                    record.bounds,
+                    record.material,
+                    std::move(bvh)};
+            };
+
+            // Meshes placed directly are owned by their shape; every other
+            // mesh is shared through the scene. The writer never does both
+            // with one mesh.
+            std::vector<bool> placed(meshes.size(), false);
+            std::vector<bool> instanced(meshes.size(), false);
+            for (auto& record : shape_records)
+            {
+                if ((record.kind != ShapeKind::sphere &&
+                     record.mesh >= meshes.size()) ||
+                    record.material >= materials.size() ||
+                    record.kind > ShapeKind::instance)
+                {
+                    return std::nullopt;
+                }
+
+                if (record.kind == ShapeKind::mesh)
+                {
+                    placed[record.mesh] = true;
+                }
+                else if (record.kind == ShapeKind::instance)
+                {
+                    instanced[record.mesh] = true;
+                }
+
+                if (record.kind != ShapeKind::sphere &&
+                    placed[record.mesh] && instanced[record.mesh])
+                {
+                    return std::nullopt;
+                }
+            }
+
+            // Traversal trusts the hierarchies, so they are checked once
+            // here rather than on every ray.
+            if (header.has_bvh != 0)
+            {
+                for (auto& record : meshes)
+                {
+                    if (!is_valid_hierarchy(reader,
+                                            record.nodes,
+                                            record.bvh_indices,
+                                            record.indices.count / 3))
+                    {
+                        return std::nullopt;
+                    }
+                }
+
+                if (!is_valid_hierarchy(reader,
+                                        header.nodes,
+                                        header.bvh_indices,
+                                        shape_records.size()))
+                {
+                    return std::nullopt;
+                }
+            }
+
+            if (options.page_budget > 0)
+            {
+                add_paged_shapes(scene,
+                                 reader,
+                                 meshes,
+                                 shape_records,
+                                 header.has_bvh != 0,
+                                 options.page_budget);
+            }
+            else
+            {
+                std::vector<std::shared_ptr<shapes::TriangleMesh>> shared(
+                    meshes.size());
+                for (std::size_t i{0}; i < meshes.size(); ++i)
+                {
+                    if (!placed[i])
+                    {
+                        shared[i] = scene.add_mesh(make_mesh(meshes[i]));
+                    }
+                }
+
+                for (auto& record : shape_records)
+                {
+                    if (record.kind == ShapeKind::sphere)
+                    {
+                        scene.add_shape(make_sphere(record));
+                    }
+                    else if (record.kind == ShapeKind::mesh)
+                    {
+                        scene.add_shape(std::make_unique<shapes::TriangleMesh>(
+                            make_mesh(meshes[record.mesh])));
+                    }
+                    else
+                    {
+                        scene.add_shape(std::make_unique<shapes::MeshInstance>(
+                            shared[record.mesh], record.transform));
+                    }
+                }
+            }
+
+            if (header.has_bvh != 0)
+            {
+                scene.set_bvh(accelerators::Bvh{
+                    reader.shared<accelerators::BvhNode>(header.nodes),
+                    reader.shared<std::uint32_t>(header.bvh_indices)});
+            }
+            else
+            {
+                scene.build();
+            }
+
+            return scene;
+        }
+        catch (std::runtime_error const&)
+        {
+            // Unreadable or corrupt caches are treated as stale.
+            return std::nullopt;
+        }
+    }
+} // namespace loaders
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <render/scene.hpp>
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace loaders
+{
+    using core::Real;
+
+    // Bumped whenever the layout of the cache changes.
+    inline constexpr std::uint32_t scene_cache_version{2};
+
+    struct SceneCacheOptions
+    {
+        // Store the built hierarchies of the meshes and of the scene, so a
+        // cached scene needs no building at all. Requires a built scene.
+        bool include_bvh{true};
+    };
+
+    struct SceneCacheLoadOptions
+    {
+        // 0 uses all geometry in place from the mapping. Otherwise meshes are
+        // paged in from the cache as rays reach them, into a pool of at most
+        // this many bytes, through the shapes::GeometryPager of the scene.
+        std::size_t page_budget{0};
+    };
+
+    // Hash of the contents of a file, used to detect changed sources.
+    // Throws std::runtime_error if the file cannot be read.
+    std::uint64_t hash_file(std::string const& path);
+
+    // Writes the scene (camera, materials, lights, spheres, meshes, mesh
+    // instances and optionally the hierarchies) to a binary cache at `path`.
+    // Arrays are stored flat, without pointers, and aligned so they can be
+    // used straight from a mapping. `sources` lists the files the scene was
+    // created from; the cache becomes stale when any of them changes. Throws
+    // std::runtime_error on failure or if the scene holds shapes the cache
+    // cannot represent.
+    void write_scene_cache(render::Scene const& scene,
+                           std::vector<std::string> const& sources,
+                           std::string const& path,
+                           SceneCacheOptions const& options = {});
+
+    // Maps the cache at `path` and returns the scene, ready to render. Mesh
+    // geometry and hierarchies are used in place from the mapping, which
+    // stays alive for as long as the scene does, or paged in on demand (see
+    // SceneCacheLoadOptions); hierarchies missing from the cache are built.
+    // Returns std::nullopt if the file is missing, was written by a
+    // different version or Real type, is truncated or otherwise corrupt, or
+    // if any of its sources has changed.
+    std::optional<render::Scene>
+    load_scene_cache(std::string const& path,
+                     SceneCacheLoadOptions const& options = {});
+} // namespace loaders
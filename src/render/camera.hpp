@@ -0,0 +1,88 @@
+#pragma once
+
+#include <core/ray.hpp>
+#include <core/real.hpp>
+#include <core/vector.hpp>
+
+#include <cmath>
+
+namespace render
+{
+    using core::Real;
+
+    // Pinhole camera. Raster coordinates have their origin at the top left
+    // corner of the image, with y pointing down. The shutter is closed by
+    // default, so every ray is at time 0; set_shutter() opens it for motion
+    // blur.
+    class Camera
+    {
+    public:
+        Camera() = default;
+
+        Camera(core::Point3<Real> const& eye,
+               core::Point3<Real> const& look_at,
+               core::Vector3<Real> const& up,
+               Real fov_degrees,
+               std::size_t width,
+               std::size_t height) :
+            m_eye{eye}, m_width{width}, m_height{height}
+        {
+            auto w{core::normalise(eye - look_at)};
+            auto u{core::normalise(core::cross(up, w))};
+            auto v{core::cross(w, u)};
+
+            auto tan_half{static_cast<Real>(
+                std::tan(fov_degrees * Real{0.5} * Real{3.14159265358979}
+                         / Real{180}))};
+            auto aspect{static_cast<Real>(width) / static_cast<Real>(height)};
+
+            m_du     = u * (Real{2} * tan_half * aspect / width);
+            m_dv     = v * (Real{-2} * tan_half / height);
+            m_corner = -w - u * (tan_half * aspect) + v * tan_half;
+        }
+
+        core::Ray<Real> generate_ray(Real x, Real y, Real time = 0) const
+        {
+            return core::Ray<Real>{
+                m_eye, core::normalise(m_corner + m_du * x + m_dv * y), time};
+        }
+
+        void set_shutter(Real open, Real close)
+        {
+            ASSERT(open <= close);
+            m_shutter_open  = open;
+            m_shutter_close = close;
+        }
+
+        bool has_shutter() const
+        {
+            return m_shutter_open < m_shutter_close;
+        }
+
+        // Time at fraction `u` of the shutter interval.
+        Real shutter_time(Real u) const
+        {
+            return m_shutter_open + u * (m_shutter_close - m_shutter_open);
+        }
+
+        std::size_t width() const
+        {
+            return m_width;
+        }
+
+        std::size_t height() const
+        {
+            return m_height;
+        }
+
+    private:
+        core::Point3<Real> m_eye;
+        core::Vector3<Real> m_corner;
+        core::Vector3<Real> m_du;
+        core::Vector3<Real> m_dv;
+        std::size_t m_width{0};
+        std::size_t m_height{0};
+        Real m_shutter_open{0};
+        Real m_shutter_close{0};
+    };
+} // namespace render
@@ -0,0 +1,52 @@
+#include "image.hpp"
+
+#include <core/profiler.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+
+namespace render
+{
+    namespace
+    {
+        unsigned char to_srgb8(float value)
+        {
+            value = std::clamp(value, 0.0f, 1.0f);
+            auto encoded{(value <= 0.0031308f)
+                             ? 12.92f * value
+                             : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f};
+            return static_cast<unsigned char>(encoded * 255.0f + 0.5f);
+        }
+    } // namespace
+
+    void write_ppm(Image const& image, std::string const& path)
+    {
+        APOLLO_PROFILE_ZONE("image write");
+        std::ofstream file{path, std::ios::binary};
+        if (!file)
+        {
+            throw std::runtime_error{"error: unable to open " + path +
+                                     " for writing"};
+        }
+
+        file << "P6\n" << image.width() << ' ' << image.height() << "\n255\n";
+
+        std::vector<unsigned char> bytes;
+        bytes.reserve(image.pixels().size() * 3);
+        for (auto& pixel : image.pixels())
+        {
+            bytes.push_back(to_srgb8(pixel[0]));
+            bytes.push_back(to_srgb8(pixel[1]));
+            bytes.push_back(to_srgb8(pixel[2]));
+        }
+
+        file.write(reinterpret_cast<char const*>(bytes.data()),
+                   static_cast<std::streamsize>(bytes.size()));
+        if (!file)
+        {
+            throw std::runtime_error{"error: unable to write " + path};
+        }
+    }
+} // namespace render
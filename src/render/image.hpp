@@ -0,0 +1,55 @@
+#pragma once
+
+#include <core/vector.hpp>
+
+#include <string>
+#include <vector>
+
+namespace render
+{
+    // Linear RGB image stored in row-major order.
+    class Image
+    {
+    public:
+        Image() = default;
+
+        Image(std::size_t width, std::size_t height) :
+            m_width{width}, m_height{height}, m_pixels(width * height)
+        {}
+
+        core::Vector3<float>& operator()(std::size_t x, std::size_t y)
+        {
+            return m_pixels[y * m_width + x];
+        }
+
+        core::Vector3<float> const& operator()(std::size_t x,
+                                               std::size_t y) const
+        {
+            return m_pixels[y * m_width + x];
+        }
+
+        std::size_t width() const
+        {
+            return m_width;
+        }
+
+        std::size_t height() const
+        {
+            return m_height;
+        }
+
+        std::vector<core::Vector3<float>> const& pixels() const
+        {
+            return m_pixels;
+        }
+
+    private:
+        std::size_t m_width{0};
+        std::size_t m_height{0};
+        std::vector<core::Vector3<float>> m_pixels;
+    };
+
+    // Writes the image as a binary PPM with an sRGB transfer curve. Throws
+    // std::runtime_error if the file cannot be written.
+    void write_ppm(Image const& image, std::string const& path);
+} // namespace render
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <core/real.hpp>
+#include <core/vector.hpp>
+
+namespace render
+{
+    using core::Real;
+
+    struct PointLight
+    {
+        core::Point3<Real> position;
+        core::Vector3<Real> intensity;
+    };
+} // namespace render
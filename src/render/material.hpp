@@ -0,0 +1,15 @@
+#pragma once
+
+#include <core/real.hpp>
+#include <core/vector.hpp>
+
+namespace render
+{
+    using core::Real;
+
+    // Lambertian reflector.
+    struct Material
+    {
+        core::Vector3<Real> albedo{Real{0.5}};
+    };
+} // namespace render
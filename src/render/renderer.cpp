@@ -0,0 +1,911 @@
+#include "renderer.hpp"
+#include "shading.hpp"
+#include "wavefront.hpp"
+
+#include <core/bits.hpp>
+#include <core/memory_arena.hpp>
+#include <core/profiler.hpp>
+#include <core/rng.hpp>
+#include <core/stats.hpp>
+#include <core/topology.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace render
+{
+    namespace
+    {
+        struct RayCounts
+        {
+            std::uint64_t rays{0};
+            std::uint64_t shadow_rays{0};
+        };
+
+        double seconds_since(std::chrono::steady_clock::time_point start)
+        {
+            return std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                .count();
+        }
+
+        struct TileJob;
+
+        // Continuation of a path. Everything the path needs is kept here, so
+        // it can be suspended at any query and resumed later on.
+        struct PathState
+        {
+            core::Ray<Real> ray;
+            core::Vector3<AccumReal> radiance;
+            core::Vector3<Real> throughput{Real{1}};
+            std::uint64_t pixel{0};
+            std::uint32_t sample{0};
+            std::uint32_t depth{0};
+            std::size_t length{0};
+
+            // Set while the lights are sampled from the current hit.
+            bool shading{false};
+            std::size_t light{0};
+            core::Point3<Real> origin;
+            core::Normal3<Real> normal;
+            core::Vector3<Real> albedo;
+
+            TileJob* tile{nullptr};
+            std::size_t slot{0};
+            std::uint32_t suspensions{0};
+
+            // Pager generation before the query that suspended the path.
+            std::uint64_t generation{0};
+        };
+
+        // A tile whose paths are still being traced. Every sample has its
+        // own slot so that pixels are summed in sample order, whatever the
+        // order in which their paths finish.
+        struct TileJob
+        {
+            Tile tile;
+            std::vector<core::Vector3<AccumReal>> samples;
+            std::size_t remaining{0};
+        };
+
+        enum class PathStatus
+        {
+            finished,
+            suspended,
+
+            // Waiting for its bounce ray to be traced with the stream.
+            deferred
+        };
+
+        // Paths a worker thread has set aside, to be continued later.
+        struct PendingPaths
+        {
+            std::vector<PathState> suspended;
+            std::vector<PathState> stream;
+        };
+
+        // Suspension works path by path, so paged scenes do not use streams.
+        bool uses_streams(Scene const& scene, RenderSettings const& settings)
+        {
+            return settings.stream_size > 0 && scene.pager() == nullptr;
+        }
+
+        // Runs a query for `path` through `run(resident)`, which must wait
+        // for paged geometry if `resident` is null and otherwise leave it
+        // and clear it instead. Returns false if the path has to be
+        // suspended, in which case the query is repeated on resumption.
+        template<typename Query>
+        bool run_query(Scene const& scene,
+                       RenderSettings const& settings,
+                       PathState& path,
+                       Query const& run)
+        {
+            auto pager{scene.pager()};
+            if (pager == nullptr ||
+                path.suspensions >= settings.max_suspensions)
+            {
+                run(nullptr);
+                return true;
+            }
+
+            // Read before the query, so a load that finishes during it still
+            // lets the path resume.
+            path.generation = pager->generation();
+            bool resident{true};
+            run(&resident);
+            if (!resident)
+            {
+                ++path.suspensions;
+                core::increment_stat(core::StatCounter::path_suspensions);
+            }
+            return resident;
+        }
+
+        // Closest-hit query for `path`; see run_query().
+        bool query(Scene const& scene,
+                   RenderSettings const& settings,
+                   PathState& path,
+                   core::Ray<Real> const& ray,
+                   Real& t_max,
+                   shapes::SurfaceInteraction& hit,
+                   bool& found)
+        {
+            return run_query(scene, settings, path, [&](bool* resident) {
+                found = (resident == nullptr)
+                            ? scene.intersect(ray, t_max, hit)
+                            : scene.try_intersect(ray, t_max, hit, *resident);
+            });
+        }
+
+        // Occlusion query for the shadow rays of `path`; see run_query().
+        bool query_occluded(Scene const& scene,
+                            RenderSettings const& settings,
+                            PathState& path,
+                            core::Ray<Real> const& ray,
+                            Real t_max,
+                            bool& occluded)
+        {
+            return run_query(scene, settings, path, [&](bool* resident) {
+                occluded = (resident == nullptr)
+                               ? scene.occluded(ray, t_max)
+                               : scene.try_occluded(ray, t_max, *resident);
+            });
+        }
+
+        // Starts shading the hit found by the closest-hit query of the
+        // path. Returns false if the ray left the scene, which ends the path.
+        bool begin_shading(Scene const& scene,
+                           RenderSettings const& settings,
+                           PathState& path,
+                           bool found,
+                           shapes::SurfaceInteraction const& hit)
+        {
+            if (!found)
+            {
+                path.radiance += core::vector_cast<AccumReal>(
+                    multiply(path.throughput, settings.background));
+                return false;
+            }
+            ++path.length;
+
+            auto n{hit.normal};
+            if (core::dot(n, path.ray.d) > 0)
+            {
+                n = -n;
+            }
+
+            path.shading = true;
+            path.light   = 0;
+            path.normal  = n;
+            path.origin  = core::offset_ray_origin(hit.point, hit.error, n);
+            path.albedo  = scene.material(hit.material).albedo;
+            return true;
+        }
+
+        // Sets up the shadow ray from the current hit of the path towards
+        // `light`, along with the radiance it carries if unoccluded. Returns
+        // false if the light is below the surface.
+        bool sample_light(PathState const& path,
+                          PointLight const& light,
+                          core::Ray<Real>& ray,
+                          Real& t_max,
+                          core::Vector3<Real>& radiance)
+        {
+            return sample_point_light(path.origin,
+                                      path.normal,
+                                      multiply(path.throughput, path.albedo),
+                                      light,
+                                      path.ray.time,
+                                      ray,
+                                      t_max,
+                                      radiance);
+        }
+
+        // Advances the path until it ends, until it has to be suspended or,
+        // with streams, until it reaches a bounce ray.
+        PathStatus trace_path(Scene const& scene,
+                              RenderSettings const& settings,
+                              core::CounterRng const& rng,
+                              PathState& path,
+                              RayCounts& counts)
+        {
+            for (; path.depth < settings.max_depth; ++path.depth)
+            {
+                if (!path.shading)
+                {
+                    if (path.depth > 0 && uses_streams(scene, settings))
+                    {
+                        return PathStatus::deferred;
+                    }
+
+                    auto t_max{std::numeric_limits<Real>::infinity()};
+                    shapes::SurfaceInteraction hit;
+                    bool found{false};
+                    if (!query(
+                            scene, settings, path, path.ray, t_max, hit, found))
+                    {
+                        return PathStatus::suspended;
+                    }
+
+                    ++counts.rays;
+                    if (!begin_shading(scene, settings, path, found, hit))
+                    {
+                        break;
+                    }
+                }
+
+                auto& lights = scene.lights();
+                for (; path.light < lights.size(); ++path.light)
+                {
+                    core::Ray<Real> shadow_ray;
+                    Real shadow_t;
+                    core::Vector3<Real> radiance;
+                    if (!sample_light(path,
+                                      lights[path.light],
+                                      shadow_ray,
+                                      shadow_t,
+                                      radiance))
+                    {
+                        continue;
+                    }
+
+                    bool occluded{false};
+                    if (!query_occluded(scene,
+                                        settings,
+                                        path,
+                                        shadow_ray,
+                                        shadow_t,
+                                        occluded))
+                    {
+                        return PathStatus::suspended;
+                    }
+
+                    ++counts.shadow_rays;
+                    if (!occluded)
+                    {
+                        path.radiance += core::vector_cast<AccumReal>(radiance);
+                    }
+                }
+
+                path.shading    = false;
+                path.throughput = multiply(path.throughput, path.albedo);
+                auto u1{
+                    rng.uniform(path.pixel, path.sample, 2 + 2 * path.depth)};
+                auto u2{
+                    rng.uniform(path.pixel, path.sample, 3 + 2 * path.depth)};
+                path.ray = core::Ray<Real>{
+                    path.origin,
+                    sample_cosine_hemisphere(path.normal, u1, u2),
+                    path.ray.time};
+            }
+
+            core::record_path_length(path.length);
+            return PathStatus::finished;
+        }
+
+        void finish_path(PathState const& path)
+        {
+            path.tile->samples[path.slot] = path.radiance;
+            --path.tile->remaining;
+        }
+
+        // Traces the path on and sets it aside if it cannot finish yet.
+        void continue_path(Scene const& scene,
+                           RenderSettings const& settings,
+                           core::CounterRng const& rng,
+                           PathState& path,
+                           PendingPaths& pending,
+                           RayCounts& counts)
+        {
+            switch (trace_path(scene, settings, rng, path, counts))
+            {
+            case PathStatus::finished:
+                finish_path(path);
+                break;
+            case PathStatus::suspended:
+                pending.suspended.push_back(path);
+                break;
+            case PathStatus::deferred:
+                pending.stream.push_back(path);
+                break;
+            }
+        }
+
+        // Camera rays of a packet cover a block of pixels this wide and
+        // high, as close to square as the packet size allows.
+        std::array<std::size_t, 2> packet_block(std::size_t packet_size)
+        {
+            std::size_t width{1};
+            while (width * width < packet_size)
+            {
+                width *= 2;
+            }
+            return {width, packet_size / width};
+        }
+
+        // Traces the camera rays of the lanes of `mask` as a packet, then
+        // the shadow rays from their first hits, one packet per light. The
+        // paths then carry on one at a time. Each path takes the same steps
+        // as it would in trace_path() on its own.
+        void trace_packet(Scene const& scene,
+                          RenderSettings const& settings,
+                          core::CounterRng const& rng,
+                          std::array<PathState, shapes::max_packet_size>& paths,
+                          shapes::RayPacket const& packet,
+                          std::uint32_t mask,
+                          PendingPaths& pending,
+                          RayCounts& counts)
+        {
+            shapes::PacketDistances t_max;
+            t_max.fill(std::numeric_limits<Real>::infinity());
+            shapes::PacketHits hits;
+            auto found{scene.intersect_packet(packet, mask, t_max, hits)};
+
+            std::uint32_t shading{0};
+            for (std::size_t lane{0}; lane < shapes::max_packet_size; ++lane)
+            {
+                auto bit{std::uint32_t{1} << lane};
+                if ((mask & bit) == 0)
+                {
+                    continue;
+                }
+
+                ++counts.rays;
+                auto& path = paths[lane];
+                if (begin_shading(
+                        scene, settings, path, (found & bit) != 0, hits[lane]))
+                {
+                    shading |= bit;
+                }
+                else
+                {
+                    core::record_path_length(path.length);
+                    finish_path(path);
+                }
+            }
+
+            auto& lights = scene.lights();
+            for (auto& light : lights)
+            {
+                shapes::RayPacket shadow;
+                std::array<core::Vector3<Real>, shapes::max_packet_size>
+                    radiance;
+                std::uint32_t shadow_mask{0};
+                for (std::size_t lane{0}; lane < shapes::max_packet_size;
+                     ++lane)
+                {
+                    auto bit{std::uint32_t{1} << lane};
+                    core::Ray<Real> ray;
+                    if ((shading & bit) != 0 &&
+                        sample_light(paths[lane],
+                                     light,
+                                     ray,
+                                     t_max[lane],
+                                     radiance[lane]))
+                    {
+                        shadow.set(lane, ray);
+                        shadow_mask |= bit;
+                    }
+                }
+
+                auto occluded{
+                    scene.occluded_packet(shadow, shadow_mask, t_max)};
+                for (std::size_t lane{0}; lane < shapes::max_packet_size;
+                     ++lane)
+                {
+                    auto bit{std::uint32_t{1} << lane};
+                    if ((shadow_mask & bit) == 0)
+                    {
+                        continue;
+                    }
+
+                    ++counts.shadow_rays;
+                    if ((occluded & bit) == 0)
+                    {
+                        paths[lane].radiance +=
+                            core::vector_cast<AccumReal>(radiance[lane]);
+                    }
+                }
+            }
+
+            for (std::size_t lane{0}; lane < shapes::max_packet_size; ++lane)
+            {
+                if ((shading & (std::uint32_t{1} << lane)) == 0)
+                {
+                    continue;
+                }
+
+                paths[lane].light = lights.size();
+                continue_path(
+                    scene, settings, rng, paths[lane], pending, counts);
+            }
+        }
+
+        PathState start_path(Camera const& camera,
+                             RenderSettings const& settings,
+                             core::CounterRng const& rng,
+                             TileJob& job,
+                             std::size_t x,
+                             std::size_t y,
+                             std::uint32_t sample)
+        {
+            auto& tile = job.tile;
+            auto spp{settings.samples_per_pixel};
+            auto pixel{core::CounterRng::pixel_index(core::Point2<int>{
+                static_cast<int>(x), static_cast<int>(y)})};
+
+            PathState path;
+            path.ray    = camera_ray(
+                camera, rng, pixel, sample, x, y, settings.max_depth);
+            path.pixel  = pixel;
+            path.sample = sample;
+            path.tile   = &job;
+            path.slot =
+                ((y - tile.y0) * (tile.x1 - tile.x0) + (x - tile.x0)) * spp +
+                sample;
+            return path;
+        }
+
+        // Starts every path of the tile. Paths that cannot finish yet are
+        // added to `pending`.
+        void render_tile(Scene const& scene,
+                         RenderSettings const& settings,
+                         core::CounterRng const& rng,
+                         TileJob& job,
+                         PendingPaths& pending,
+                         RayCounts& counts)
+        {
+            auto& camera = scene.camera();
+            auto& tile   = job.tile;
+            auto spp{settings.samples_per_pixel};
+            job.samples.resize((tile.x1 - tile.x0) * (tile.y1 - tile.y0) *
+                               spp);
+            job.remaining = job.samples.size();
+
+            // Suspension works path by path, so paged scenes do not use
+            // packets.
+            if (settings.packet_size > 1 && settings.max_depth > 0 &&
+                scene.pager() == nullptr)
+            {
+                auto [block_width, block_height] =
+                    packet_block(settings.packet_size);
+                for (auto y0{tile.y0}; y0 < tile.y1; y0 += block_height)
+                {
+                    auto y1{std::min(y0 + block_height, tile.y1)};
+                    for (auto x0{tile.x0}; x0 < tile.x1; x0 += block_width)
+                    {
+                        auto x1{std::min(x0 + block_width, tile.x1)};
+                        for (std::uint32_t s{0}; s < spp; ++s)
+                        {
+                            std::array<PathState, shapes::max_packet_size>
+                                paths;
+                            shapes::RayPacket packet;
+                            std::size_t lane{0};
+                            for (auto y{y0}; y < y1; ++y)
+                            {
+                                for (auto x{x0}; x < x1; ++x, ++lane)
+                                {
+                                    paths[lane] = start_path(
+                                        camera, settings, rng, job, x, y, s);
+                                    packet.set(lane, paths[lane].ray);
+                                }
+                            }
+
+                            auto mask{(std::uint32_t{1} << lane) - 1};
+                            trace_packet(scene,
+                                         settings,
+                                         rng,
+                                         paths,
+                                         packet,
+                                         mask,
+                                         pending,
+                                         counts);
+                        }
+                    }
+                }
+                return;
+            }
+
+            for (auto y{tile.y0}; y < tile.y1; ++y)
+            {
+                for (auto x{tile.x0}; x < tile.x1; ++x)
+                {
+                    for (std::uint32_t s{0}; s < spp; ++s)
+                    {
+                        auto path{start_path(
+                            camera, settings, rng, job, x, y, s)};
+                        continue_path(
+                            scene, settings, rng, path, pending, counts);
+                    }
+                }
+            }
+        }
+
+        // Resumes the suspended paths for which a load has finished since
+        // they were suspended. Paged scenes do not use streams, so no path
+        // is deferred here.
+        void resume_paths(Scene const& scene,
+                          RenderSettings const& settings,
+                          core::CounterRng const& rng,
+                          std::vector<PathState>& suspended,
+                          RayCounts& counts)
+        {
+            APOLLO_PROFILE_ZONE("resume paths");
+            auto generation{scene.pager()->generation()};
+            std::size_t kept{0};
+            for (auto& path : suspended)
+            {
+                if (path.generation == generation ||
+                    trace_path(scene, settings, rng, path, counts) ==
+                        PathStatus::suspended)
+                {
+                    suspended[kept++] = path;
+                }
+                else
+                {
+                    finish_path(path);
+                }
+            }
+            suspended.resize(kept);
+        }
+
+        // Orders rays by the octant of their direction, then by their origin
+        // along a Morton curve through the scene bounds, then by their
+        // direction within the octant.
+        std::uint64_t ray_sort_key(core::Ray<Real> const& ray,
+                                   core::Bounds3<Real> const& bounds)
+        {
+            auto quantise = [](Real x, Real levels) {
+                return static_cast<std::uint32_t>(
+                    (x > 0) ? std::min(x, Real{1}) * levels : Real{0});
+            };
+
+            auto o{core::offset(bounds, ray.o)};
+            std::uint64_t origin{core::encode_morton_3(quantise(o[0], 1023),
+                                                       quantise(o[1], 1023),
+                                                       quantise(o[2], 1023))};
+
+            // Directions are unit length, so 4 bits per axis cover them.
+            auto& d = ray.d;
+            std::uint64_t direction{
+                core::encode_morton_3(quantise(std::abs(d[0]), 15),
+                                      quantise(std::abs(d[1]), 15),
+                                      quantise(std::abs(d[2]), 15))};
+            std::uint64_t octant{(d[0] < 0 ? 1u : 0u) | (d[1] < 0 ? 2u : 0u) |
+                                 (d[2] < 0 ? 4u : 0u)};
+            return (octant << 42) | (origin << 12) | direction;
+        }
+
+        struct StreamHit
+        {
+            shapes::SurfaceInteraction hit;
+            bool found{false};
+        };
+
+        // Traces the bounce rays of the stream in the order of their keys,
+        // so that rays traced one after the other, and those that share a
+        // packet, leave nearby points in similar directions and visit the
+        // same nodes. The paths then carry on in that order.
+        void trace_stream(Scene const& scene,
+                          RenderSettings const& settings,
+                          core::CounterRng const& rng,
+                          PendingPaths& pending,
+                          RayCounts& counts,
+                          StreamStats& stats)
+        {
+            APOLLO_PROFILE_ZONE("trace stream");
+
+            // The paths are moved out of the stream, which they may rejoin
+            // as they carry on. The scratch space of the batch comes from
+            // the thread's arena, so steady-state batches make no heap
+            // calls.
+            core::ArenaScope scope;
+            auto& arena = core::thread_arena();
+            auto num_paths{pending.stream.size()};
+            auto paths{arena.alloc_array<PathState>(num_paths)};
+            std::copy(pending.stream.begin(), pending.stream.end(), paths);
+            pending.stream.clear();
+
+            auto start{std::chrono::steady_clock::now()};
+            auto bounds{scene.bounds()};
+            auto order{arena.alloc_array<std::pair<std::uint64_t, std::size_t>>(
+                num_paths)};
+            for (std::size_t i{0}; i < num_paths; ++i)
+            {
+                order[i] = {ray_sort_key(paths[i].ray, bounds), i};
+            }
+            std::sort(order, order + num_paths);
+            stats.sort_seconds += seconds_since(start);
+
+            start = std::chrono::steady_clock::now();
+            auto results{arena.alloc_array<StreamHit>(num_paths)};
+            auto width{settings.packet_size};
+            for (std::size_t first{0}; first < num_paths; first += width)
+            {
+                auto count{std::min(width, num_paths - first)};
+                if (width == 1)
+                {
+                    auto t_max{std::numeric_limits<Real>::infinity()};
+                    auto& result = results[first];
+                    result.found = scene.intersect(
+                        paths[order[first].second].ray, t_max, result.hit);
+                    continue;
+                }
+
+                shapes::RayPacket packet;
+                for (std::size_t lane{0}; lane < count; ++lane)
+                {
+                    packet.set(lane, paths[order[first + lane].second].ray);
+                }
+
+                shapes::PacketDistances t_max;
+                t_max.fill(std::numeric_limits<Real>::infinity());
+                shapes::PacketHits hits;
+                auto mask{(std::uint32_t{1} << count) - 1};
+                auto found{scene.intersect_packet(packet, mask, t_max, hits)};
+                for (std::size_t lane{0}; lane < count; ++lane)
+                {
+                    auto& result = results[first + lane];
+                    result.hit   = hits[lane];
+                    result.found = (found & (std::uint32_t{1} << lane)) != 0;
+                }
+            }
+            stats.trace_seconds += seconds_since(start);
+            ++stats.batches;
+            stats.rays += num_paths;
+
+            for (std::size_t i{0}; i < num_paths; ++i)
+            {
+                ++counts.rays;
+                auto& path   = paths[order[i].second];
+                auto& result = results[i];
+                if (begin_shading(
+                        scene, settings, path, result.found, result.hit))
+                {
+                    continue_path(scene, settings, rng, path, pending, counts);
+                }
+                else
+                {
+                    core::record_path_length(path.length);
+                    finish_path(path);
+                }
+            }
+        }
+
+        void write_tile(TileJob const& job, Image& image)
+        {
+            auto& tile = job.tile;
+            auto spp{job.samples.size() /
+                     ((tile.x1 - tile.x0) * (tile.y1 - tile.y0))};
+            auto sample{job.samples.begin()};
+            for (auto y{tile.y0}; y < tile.y1; ++y)
+            {
+                for (auto x{tile.x0}; x < tile.x1; ++x)
+                {
+                    core::Vector3<AccumReal> sum;
+                    for (std::size_t s{0}; s < spp; ++s)
+                    {
+                        sum += *sample++;
+                    }
+
+                    auto value{sum / static_cast<AccumReal>(spp)};
+                    image(x, y) = core::Vector3<float>{
+                        static_cast<float>(value[0]),
+                        static_cast<float>(value[1]),
+                        static_cast<float>(value[2])};
+                }
+            }
+
+            auto pixels{(tile.x1 - tile.x0) * (tile.y1 - tile.y0)};
+            core::increment_stat(core::StatCounter::pixels, pixels);
+            core::increment_stat(core::StatCounter::samples, pixels * spp);
+        }
+    } // namespace
+
+    std::vector<Tile>
+    make_tiles(std::size_t width, std::size_t height, std::size_t tile_size)
+    {
+        ASSERT(tile_size > 0);
+
+        std::vector<Tile> tiles;
+        for (std::size_t y{0}; y < height; y += tile_size)
+        {
+            for (std::size_t x{0}; x < width; x += tile_size)
+            {
+                tiles.push_back({x,
+                                 y,
+                                 std::min(x + tile_size, width),
+                                 std::min(y + tile_size, height)});
+            }
+        }
+
+        return tiles;
+    }
+
+    RenderResult render(Scene const& scene, RenderSettings const& settings)
+    {
+        APOLLO_PROFILE_ZONE("render");
+        auto& camera = scene.camera();
+        RenderResult result;
+        result.image = Image{camera.width(), camera.height()};
+        ASSERT(settings.packet_size > 0 &&
+               settings.packet_size <= shapes::max_packet_size &&
+               (settings.packet_size & (settings.packet_size - 1)) == 0);
+        if (settings.integrator == Integrator::wavefront)
+        {
+            return render_wavefront(scene, settings);
+        }
+
+        auto tiles{
+            make_tiles(camera.width(), camera.height(), settings.tile_size)};
+        auto num_threads{settings.num_threads};
+        if (num_threads == 0)
+        {
+            num_threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        num_threads = std::min(num_threads, std::max<std::size_t>(
+                                                tiles.size(), 1));
+
+        if (settings.perf_counters)
+        {
+            result.thread_counters.resize(num_threads);
+        }
+
+        auto max_tiles_in_flight{
+            std::max<std::size_t>(settings.max_tiles_in_flight, 1)};
+        std::vector<StreamStats> stream_stats(num_threads);
+
+        core::CounterRng rng{settings.seed};
+        std::atomic<std::size_t> next_tile{0};
+        std::atomic<std::uint64_t> rays{0}, shadow_rays{0};
+
+        auto worker = [&](std::size_t index) {
+            APOLLO_PROFILE_THREAD_NAME("render worker " +
+                                       std::to_string(index));
+            if (settings.pin_threads)
+            {
+                core::pin_pool_thread(index, num_threads);
+            }
+
+            // Spans the whole worker so the time between its last tile and
+            // the end of the render shows up as idle time.
+            APOLLO_PROFILE_ZONE("render worker");
+            core::PerfCounterValues counters_start;
+            if (settings.perf_counters)
+            {
+                counters_start = core::thread_perf_counters().read();
+            }
+
+            // New tiles are started while paths wait for paged geometry or
+            // for the stream to fill up; the thread only blocks once it has
+            // nothing else to do.
+            RayCounts counts;
+            std::vector<std::unique_ptr<TileJob>> jobs;
+            PendingPaths pending;
+            auto& suspended = pending.suspended;
+            auto tiles_left{true};
+            for (;;)
+            {
+                if (!suspended.empty())
+                {
+                    resume_paths(scene, settings, rng, suspended, counts);
+                }
+
+                for (std::size_t j{0}; j < jobs.size();)
+                {
+                    if (jobs[j]->remaining == 0)
+                    {
+                        write_tile(*jobs[j], result.image);
+                        jobs[j] = std::move(jobs.back());
+                        jobs.pop_back();
+                    }
+                    else
+                    {
+                        ++j;
+                    }
+                }
+
+                if (settings.stream_size > 0 &&
+                    pending.stream.size() >= settings.stream_size)
+                {
+                    trace_stream(scene,
+                                 settings,
+                                 rng,
+                                 pending,
+                                 counts,
+                                 stream_stats[index]);
+                    continue;
+                }
+
+                if (tiles_left && jobs.size() < max_tiles_in_flight)
+                {
+                    auto i{next_tile++};
+                    if (i < tiles.size())
+                    {
+                        APOLLO_PROFILE_ZONE_ARG("render tile", i);
+                        auto& job =
+                            *jobs.emplace_back(std::make_unique<TileJob>());
+                        job.tile = tiles[i];
+                        render_tile(
+                            scene, settings, rng, job, pending, counts);
+                        continue;
+                    }
+                    tiles_left = false;
+                }
+
+                if (!pending.stream.empty())
+                {
+                    trace_stream(scene,
+                                 settings,
+                                 rng,
+                                 pending,
+                                 counts,
+                                 stream_stats[index]);
+                    continue;
+                }
+
+                if (suspended.empty())
+                {
+                    break;
+                }
+
+                auto pager{scene.pager()};
+                auto generation{pager->generation()};
+                if (std::all_of(suspended.begin(),
+                                suspended.end(),
+                                [generation](PathState const& path) {
+                                    return path.generation == generation;
+                                }))
+                {
+                    APOLLO_PROFILE_ZONE("wait for geometry");
+                    pager->wait(generation);
+                }
+            }
+
+            if (settings.perf_counters)
+            {
+                result.thread_counters[index] =
+                    core::thread_perf_counters().read() - counters_start;
+            }
+
+            rays += counts.rays;
+            shadow_rays += counts.shadow_rays;
+            core::increment_stat(core::StatCounter::rays_traced, counts.rays);
+            core::increment_stat(core::StatCounter::shadow_rays,
+                                 counts.shadow_rays);
+        };
+
+        auto start{std::chrono::steady_clock::now()};
+        std::vector<std::thread> threads;
+        for (std::size_t i{0}; i < num_threads; ++i)
+        {
+            threads.emplace_back(worker, i);
+        }
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        auto end{std::chrono::steady_clock::now()};
+
+        for (auto& stats : stream_stats)
+        {
+            result.stream.batches += stats.batches;
+            result.stream.rays += stats.rays;
+            result.stream.sort_seconds += stats.sort_seconds;
+            result.stream.trace_seconds += stats.trace_seconds;
+        }
+
+        result.rays        = rays;
+        result.shadow_rays = shadow_rays;
+        result.seconds = std::chrono::duration<double>(end - start).count();
+        return result;
+    }
+} // namespace render
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "image.hpp"
+#include "scene.hpp"
+
+#include <core/perf_counters.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace render
+{
+    using core::AccumReal;
+
+    enum class Integrator
+    {
+        // Each thread traces the paths of its tiles one at a time.
+        path,
+
+        // Paths advance together, one stage at a time (see wavefront.hpp).
+        wavefront
+    };
+
+    struct RenderSettings
+    {
+        Integrator integrator{Integrator::path};
+
+        std::uint32_t samples_per_pixel{16};
+
+        // Maximum number of surface interactions along a path.
+        std::uint32_t max_depth{4};
+
+        std::size_t tile_size{16};
+
+        // Camera rays of blocks of this many pixels (1, 2, 4, 8 or 16) are
+        // traced together as packets, as are the shadow rays from their
+        // first hits. 1 traces every ray on its own. Scenes with paged
+        // geometry always trace single rays. The image does not depend on
+        // this setting.
+        std::size_t packet_size{16};
+
+        // Bounce rays are set aside until this many have been gathered, then
+        // sorted by direction and origin and traced in that order, in
+        // packets of `packet_size`. 0 traces each path through on its own.
+        // The stream is also traced once no further tile may be started, so
+        // `max_tiles_in_flight` bounds its size. Scenes with paged geometry
+        // never use streams, and neither does the wavefront integrator. The
+        // image does not depend on this setting.
+        std::size_t stream_size{0};
+
+        // Paths traced together by the wavefront integrator. Each needs room
+        // for a shadow ray per light.
+        std::size_t wavefront_size{1 << 14};
+
+        // Paths that reach paged geometry which is not resident are
+        // suspended while it loads and the thread moves on to other work.
+        // After this many suspensions a path loads the geometry itself, so
+        // it cannot be starved by evictions.
+        std::uint32_t max_suspensions{8};
+
+        // Tiles a thread may have in progress while paths are suspended.
+        std::size_t max_tiles_in_flight{4};
+
+        // 0 selects one thread per hardware thread.
+        std::size_t num_threads{0};
+
+        // Pin worker threads to CPUs, spreading them over NUMA nodes.
+        bool pin_threads{false};
+
+        // Read the hardware counters of every worker thread, where
+        // available.
+        bool perf_counters{false};
+
+        std::uint64_t seed{0};
+
+        // Radiance of rays that leave the scene.
+        core::Vector3<Real> background{Real{0}};
+    };
+
+    // Half-open pixel rectangle [x0, x1) x [y0, y1).
+    struct Tile
+    {
+        std::size_t x0, y0, x1, y1;
+    };
+
+    std::vector<Tile>
+    make_tiles(std::size_t width, std::size_t height, std::size_t tile_size);
+
+    // Time spent on the ray streams, summed over the worker threads.
+    // Comparing a render with streams against one without them shows
+    // whether the sorting pays for itself in a given scene.
+    struct StreamStats
+    {
+        std::uint64_t batches{0};
+        std::uint64_t rays{0};
+
+        // Computing the keys and sorting the rays.
+        double sort_seconds{0};
+
+        // Closest-hit queries of the sorted rays.
+        double trace_seconds{0};
+    };
+
+    struct RenderResult
+    {
+        Image image;
+
+        // Rays found by closest-hit queries (camera and bounce rays) and by
+        // shadow queries. Counted independently of the statistics module so
+        // throughput is available in every build.
+        std::uint64_t rays{0};
+        std::uint64_t shadow_rays{0};
+
+        double seconds{0};
+
+        StreamStats stream;
+
+        // Wall time of each stage of the wavefront integrator, indexed by
+        // WavefrontStage. Empty for the path integrator.
+        std::vector<double> stage_seconds;
+
+        // Hardware counters of each worker thread when requested in the
+        // settings. Entries are empty if the counters are unavailable.
+        std::vector<core::PerfCounterValues> thread_counters;
+    };
+
+    // Renders the scene with a simple path tracer: diffuse bounces with next
+    // event estimation towards every point light. Tiles are handed out to
+    // the worker threads dynamically. The image does not depend on the
+    // order in which suspended paths are resumed.
+    RenderResult render(Scene const& scene, RenderSettings const& settings);
+} // namespace render
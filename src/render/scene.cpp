@@ -0,0 +1,253 @@
+#include "scene.hpp"
+
+#include <shapes/mesh_instance.hpp>
+#include <shapes/moving_mesh_instance.hpp>
+#include <shapes/paged_mesh_instance.hpp>
+
+#include <core/profiler.hpp>
+
+namespace render
+{
+    std::uint32_t Scene::add_material(Material const& material)
+    {
+        m_materials.push_back(material);
+        return static_cast<std::uint32_t>(m_materials.size() - 1);
+    }
+
+    void Scene::add_shape(std::unique_ptr<shapes::Shape> shape)
+    {
+        m_shapes.push_back(std::move(shape));
+    }
+
+    std::shared_ptr<shapes::TriangleMesh>
+    Scene::add_mesh(shapes::TriangleMesh mesh)
+    {
+        m_meshes.push_back(
+            std::make_shared<shapes::TriangleMesh>(std::move(mesh)));
+        return m_meshes.back();
+    }
+
+    void Scene::add_light(PointLight const& light)
+    {
+        m_lights.push_back(light);
+    }
+
+    void Scene::build(accelerators::BvhBuildOptions const& options)
+    {
+        APOLLO_PROFILE_ZONE("scene build");
+        for (auto& mesh : m_meshes)
+        {
+            if (!mesh->is_built())
+            {
+                mesh->build(options);
+            }
+        }
+
+        std::vector<core::Bounds3<Real>> bounds;
+        bounds.reserve(m_shapes.size());
+        for (auto& shape : m_shapes)
+        {
+            if (auto mesh = dynamic_cast<shapes::TriangleMesh*>(shape.get());
+                mesh != nullptr && !mesh->is_built())
+            {
+                mesh->build(options);
+            }
+
+            bounds.push_back(shape->bounds());
+        }
+
+        m_bvh = accelerators::Bvh{bounds, options};
+    }
+
+    void Scene::compress_meshes()
+    {
+        APOLLO_PROFILE_ZONE("scene compress");
+
+        // Compression leaves the bounds of meshes unchanged, so the
+        // top-level hierarchy stays valid.
+        for (auto& mesh : m_meshes)
+        {
+            mesh->compress();
+        }
+
+        for (auto& shape : m_shapes)
+        {
+            if (auto mesh = dynamic_cast<shapes::TriangleMesh*>(shape.get()))
+            {
+                mesh->compress();
+            }
+        }
+    }
+
+    bool Scene::intersect(core::Ray<Real> const& ray,
+                          Real& t_max,
+                          shapes::SurfaceInteraction& hit) const
+    {
+        return m_bvh.intersect(ray, t_max, [&](auto index, Real& t) {
+            return m_shapes[index]->intersect(ray, t, hit);
+        });
+    }
+
+    std::uint32_t Scene::intersect_packet(shapes::RayPacket const& packet,
+                                          std::uint32_t mask,
+                                          shapes::PacketDistances& t_max,
+                                          shapes::PacketHits& hits) const
+    {
+        return m_bvh.intersect_packet(
+            packet, mask, t_max, [&](auto index, std::uint32_t lanes) {
+                auto& shape = m_shapes[index];
+                if ((lanes & (lanes - 1)) != 0)
+                {
+                    return shape->intersect_packet(packet, lanes, t_max, hits);
+                }
+
+                // Lanes left on their own skip the packet setup of the shape.
+                std::size_t lane{0};
+                while ((lanes >> lane) != 1)
+                {
+                    ++lane;
+                }
+                return shape->intersect(
+                           packet.ray(lane), t_max[lane], hits[lane])
+                           ? lanes
+                           : 0;
+            });
+    }
+
+    bool Scene::try_intersect(core::Ray<Real> const& ray,
+                              Real& t_max,
+                              shapes::SurfaceInteraction& hit,
+                              bool& resident) const
+    {
+        // Traversal carries on past missing geometry so that everything the
+        // ray needs is requested at once.
+        resident = true;
+        return m_bvh.intersect(ray, t_max, [&](auto index, Real& t) {
+            return m_shapes[index]->try_intersect(ray, t, hit, resident);
+        });
+    }
+
+    bool Scene::occluded(core::Ray<Real> const& ray, Real t_max) const
+    {
+        return m_bvh.occluded(ray, t_max, [&](auto index) {
+            return m_shapes[index]->occluded(ray, t_max);
+        });
+    }
+
+    std::uint32_t
+    Scene::occluded_packet(shapes::RayPacket const& packet,
+                           std::uint32_t mask,
+                           shapes::PacketDistances const& t_max) const
+    {
+        return m_bvh.occluded_packet(
+            packet, mask, t_max, [&](auto index, std::uint32_t lanes) {
+                auto& shape = m_shapes[index];
+                if ((lanes & (lanes - 1)) != 0)
+                {
+                    return shape->occluded_packet(packet, lanes, t_max);
+                }
+
+                std::size_t lane{0};
+                while ((lanes >> lane) != 1)
+                {
+                    ++lane;
+                }
+                return shape->occluded(packet.ray(lane), t_max[lane]) ? lanes
+                                                                      : 0;
+            });
+    }
+
+    bool Scene::try_occluded(core::Ray<Real> const& ray,
+                             Real t_max,
+                             bool& resident) const
+    {
+        resident = true;
+        auto found = m_bvh.occluded(ray, t_max, [&](auto index) {
+            return m_shapes[index]->try_occluded(ray, t_max, resident);
+        });
+
+        if (found)
+        {
+            resident = true;
+        }
+        return found;
+    }
+
+    std::size_t Scene::num_primitives() const
+    {
+        std::size_t count{0};
+        for (auto& shape : m_shapes)
+        {
+            if (auto instance =
+                    dynamic_cast<shapes::MeshInstance const*>(shape.get()))
+            {
+                count += instance->mesh().num_triangles();
+            }
+            else if (auto moving =
+                         dynamic_cast<shapes::MovingMeshInstance const*>(
+                             shape.get()))
+            {
+                count += moving->mesh().num_triangles();
+            }
+            else if (auto paged =
+                         dynamic_cast<shapes::PagedMeshInstance const*>(
+                             shape.get()))
+            {
+                count += paged->num_triangles();
+            }
+            else if (auto mesh = dynamic_cast<shapes::TriangleMesh const*>(
+                         shape.get()))
+            {
+                count += mesh->num_triangles();
+            }
+            else
+            {
+                ++count;
+            }
+        }
+
+        return count;
+    }
+
+    void Scene::precompute_mesh_leaves(
+        shapes::LeafFormat format,
+        accelerators::BvhBuildOptions const& options)
+    {
+        APOLLO_PROFILE_ZONE("scene precompute leaves");
+
+        // The bounds of the meshes stay the same, quantised or not, so the
+        // top-level hierarchy stays valid.
+        for (auto& mesh : m_meshes)
+        {
+            mesh->precompute_leaves(format, options);
+        }
+
+        for (auto& shape : m_shapes)
+        {
+            if (auto mesh = dynamic_cast<shapes::TriangleMesh*>(shape.get()))
+            {
+                mesh->precompute_leaves(format, options);
+            }
+        }
+    }
+
+    std::size_t Scene::mesh_bytes() const
+    {
+        std::size_t bytes{0};
+        for (auto& mesh : m_meshes)
+        {
+            bytes += mesh->size_bytes();
+        }
+
+        for (auto& shape : m_shapes)
+        {
+            if (auto mesh =
+                    dynamic_cast<shapes::TriangleMesh const*>(shape.get()))
+            {
+                bytes += mesh->size_bytes();
+            }
+        }
+
+        return bytes;
+    }
+} // namespace render
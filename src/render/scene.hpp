@@ -0,0 +1,169 @@
+#pragma once
+
+#include "camera.hpp"
+#include "light.hpp"
+#include "material.hpp"
+
+#include <accelerators/bvh.hpp>
+#include <shapes/geometry_pager.hpp>
+#include <shapes/shape.hpp>
+#include <shapes/triangle_mesh.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace render
+{
+    // Everything needed to render an image. Shapes are added first and
+    // build() is then called once to construct the acceleration structures,
+    // after which the scene is read-only and may be shared between threads.
+    class Scene
+    {
+    public:
+        std::uint32_t add_material(Material const& material);
+
+        void add_shape(std::unique_ptr<shapes::Shape> shape);
+
+        // Meshes registered here are built together with the scene. Shapes
+        // that reference them (such as instances) take the returned pointer.
+        std::shared_ptr<shapes::TriangleMesh>
+        add_mesh(shapes::TriangleMesh mesh);
+
+        void add_light(PointLight const& light);
+
+        void set_camera(Camera const& camera)
+        {
+            m_camera = camera;
+        }
+
+        void build(accelerators::BvhBuildOptions const& options = {});
+
+        // Compresses every mesh of the scene (see
+        // shapes::TriangleMesh::compress()). Must be called after build().
+        // Paged meshes are left as they are loaded.
+        void compress_meshes();
+
+        // Precomputes the leaves of every mesh of the scene in `format` (see
+        // shapes::TriangleMesh::precompute_leaves()), which rebuilds their
+        // hierarchies with `options`. Must be called after build(), and not
+        // together with compress_meshes().
+        void precompute_mesh_leaves(
+            shapes::LeafFormat format = shapes::LeafFormat::full,
+            accelerators::BvhBuildOptions const& options = {});
+
+        // Uses a top-level hierarchy built earlier over the shapes, in the
+        // order they were added, instead of calling build(). Every mesh must
+        // already be built.
+        void set_bvh(accelerators::Bvh bvh)
+        {
+            m_bvh = std::move(bvh);
+        }
+
+        accelerators::Bvh const& bvh() const
+        {
+            return m_bvh;
+        }
+
+        // Pager that the paged mesh instances of the scene load through, if
+        // any. Kept here so its statistics can be read after rendering.
+        void set_pager(std::shared_ptr<shapes::GeometryPager> pager)
+        {
+            m_pager = std::move(pager);
+        }
+
+        shapes::GeometryPager const* pager() const
+        {
+            return m_pager.get();
+        }
+
+        bool intersect(core::Ray<Real> const& ray,
+                       Real& t_max,
+                       shapes::SurfaceInteraction& hit) const;
+
+        // Traces the lanes of `mask` together. Each lane finds the same hit
+        // intersect() would. Returns the lanes that hit.
+        std::uint32_t intersect_packet(shapes::RayPacket const& packet,
+                                       std::uint32_t mask,
+                                       shapes::PacketDistances& t_max,
+                                       shapes::PacketHits& hits) const;
+
+        // Like intersect(), but starts loading any paged geometry the ray
+        // reaches instead of waiting for it. If anything was missing,
+        // `resident` is cleared and the result must be discarded.
+        bool try_intersect(core::Ray<Real> const& ray,
+                           Real& t_max,
+                           shapes::SurfaceInteraction& hit,
+                           bool& resident) const;
+
+        // Answers whether anything lies along the ray in (0, t_max). Stops
+        // at the first hit found, so shadow rays should use it instead of
+        // intersect().
+        bool occluded(core::Ray<Real> const& ray, Real t_max) const;
+
+        // Batched occluded() for many shadow rays: traces the lanes of
+        // `mask` together and returns those that are occluded.
+        std::uint32_t
+        occluded_packet(shapes::RayPacket const& packet,
+                        std::uint32_t mask,
+                        shapes::PacketDistances const& t_max) const;
+
+        // occluded() with the paging behaviour of try_intersect(). An
+        // occluded ray needs nothing more, so `resident` is only cleared if
+        // the ray is not found to be occluded.
+        bool try_occluded(core::Ray<Real> const& ray,
+                          Real t_max,
+                          bool& resident) const;
+
+        core::Bounds3<Real> bounds() const
+        {
+            return m_bvh.bounds();
+        }
+
+        Camera const& camera() const
+        {
+            return m_camera;
+        }
+
+        std::vector<PointLight> const& lights() const
+        {
+            return m_lights;
+        }
+
+        Material const& material(std::uint32_t id) const
+        {
+            return m_materials[id];
+        }
+
+        std::vector<Material> const& materials() const
+        {
+            return m_materials;
+        }
+
+        std::vector<std::unique_ptr<shapes::Shape>> const& shapes() const
+        {
+            return m_shapes;
+        }
+
+        std::vector<std::shared_ptr<shapes::TriangleMesh>> const&
+        meshes() const
+        {
+            return m_meshes;
+        }
+
+        // Sum of the triangles of every instance plus one per other shape.
+        std::size_t num_primitives() const;
+
+        // Bytes taken by the meshes of the scene that are not paged, with
+        // shared meshes counted once.
+        std::size_t mesh_bytes() const;
+
+    private:
+        Camera m_camera;
+        std::vector<Material> m_materials{Material{}};
+        std::vector<PointLight> m_lights;
+        std::vector<std::unique_ptr<shapes::Shape>> m_shapes;
+        std::vector<std::shared_ptr<shapes::TriangleMesh>> m_meshes;
+        accelerators::Bvh m_bvh;
+        std::shared_ptr<shapes::GeometryPager> m_pager;
+    };
+} // namespace render
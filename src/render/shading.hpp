@@ -0,0 +1,110 @@
+#pragma once
+
+#include "camera.hpp"
+#include "light.hpp"
+
+#include <core/float_error.hpp>
+#include <core/ray.hpp>
+#include <core/rng.hpp>
+#include <core/vector.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace render
+{
+    // Shading shared by the integrators. Each computes the radiance of a path
+    // with exactly these operations, so their images are identical.
+    constexpr Real pi{3.14159265358979323846};
+
+    // Fraction of the distance to a light that shadow rays stop short by,
+    // so that the surface a light sits on does not occlude it.
+    constexpr Real shadow_epsilon{1e-4};
+
+    inline core::Vector3<Real> multiply(core::Vector3<Real> const& a,
+                                        core::Vector3<Real> const& b)
+    {
+        return core::binary_op(a, b, [](Real x, Real y) { return x * y; });
+    }
+
+    // Camera ray for `sample` of pixel (x, y). The offset within the pixel
+    // takes random dimensions 0 and 1 and each bounce the next two, so the
+    // time takes the first dimension past the last bounce. It is only drawn
+    // when the shutter is open, which leaves still images unchanged.
+    inline core::Ray<Real> camera_ray(Camera const& camera,
+                                      core::CounterRng const& rng,
+                                      std::uint64_t pixel,
+                                      std::uint32_t sample,
+                                      std::size_t x,
+                                      std::size_t y,
+                                      std::uint32_t max_depth)
+    {
+        auto jx{rng.uniform(pixel, sample, 0)};
+        auto jy{rng.uniform(pixel, sample, 1)};
+        Real time{0};
+        if (camera.has_shutter())
+        {
+            time = camera.shutter_time(
+                rng.uniform(pixel, sample, 2 + 2 * max_depth));
+        }
+
+        return camera.generate_ray(
+            static_cast<Real>(x) + jx, static_cast<Real>(y) + jy, time);
+    }
+
+    // Orthonormal basis around a unit vector (Duff et al. 2017).
+    inline void make_basis(core::Normal3<Real> const& n,
+                           core::Vector3<Real>& s,
+                           core::Vector3<Real>& t)
+    {
+        auto sign{static_cast<Real>(std::copysign(Real{1}, n[2]))};
+        auto a{Real{-1} / (sign + n[2])};
+        auto b{n[0] * n[1] * a};
+        s = core::Vector3<Real>{
+            Real{1} + sign * n[0] * n[0] * a, sign * b, -sign * n[0]};
+        t = core::Vector3<Real>{b, sign + n[1] * n[1] * a, -n[1]};
+    }
+
+    inline core::Vector3<Real>
+    sample_cosine_hemisphere(core::Normal3<Real> const& n, Real u1, Real u2)
+    {
+        core::Vector3<Real> s, t;
+        make_basis(n, s, t);
+
+        auto r{static_cast<Real>(std::sqrt(u1))};
+        auto phi{Real{2} * pi * u2};
+        auto z{static_cast<Real>(std::sqrt(std::max(Real{0}, 1 - u1)))};
+        return s * static_cast<Real>(r * std::cos(phi)) +
+               t * static_cast<Real>(r * std::sin(phi)) + n * z;
+    }
+
+    // Sets up the shadow ray from `origin` towards `light` at `time`, along
+    // with the radiance it carries if unoccluded, for a Lambertian surface
+    // with throughput times albedo `reflectance`. Returns false if the light
+    // is below the surface.
+    inline bool sample_point_light(core::Point3<Real> const& origin,
+                                   core::Normal3<Real> const& normal,
+                                   core::Vector3<Real> const& reflectance,
+                                   PointLight const& light,
+                                   Real time,
+                                   core::Ray<Real>& ray,
+                                   Real& t_max,
+                                   core::Vector3<Real>& radiance)
+    {
+        auto to_light{light.position - origin};
+        auto dist2{core::length_squared(to_light)};
+        auto dist{static_cast<Real>(std::sqrt(dist2))};
+        auto dir{to_light / dist};
+        auto cos_theta{core::dot(normal, dir)};
+        if (cos_theta <= 0)
+        {
+            return false;
+        }
+
+        auto f{reflectance / pi};
+        ray      = core::Ray<Real>{origin, dir, time};
+        t_max    = dist * (1 - shadow_epsilon);
+        radiance = multiply(f, light.intensity) * (cos_theta / dist2);
+        return true;
+    }
+} // namespace render
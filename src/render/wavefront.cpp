@@ -0,0 +1,852 @@
+#include "wavefront.hpp"
+#include "shading.hpp"
+
+#include <core/large_allocator.hpp>
+#include <core/memory_arena.hpp>
+#include <core/profiler.hpp>
+#include <core/rng.hpp>
+#include <core/stats.hpp>
+#include <core/thread_pool.hpp>
+#include <core/topology.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <limits>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace render
+{
+    namespace
+    {
+        using Clock = std::chrono::steady_clock;
+
+        // Work is handed to the threads in chunks of this many items, a
+        // multiple of every packet size.
+        constexpr std::size_t chunk_size{256};
+
+        // Storage of a wave. Its pages are left untouched when it is
+        // allocated, so that they are placed on the nodes of the pool
+        // threads that first write them rather than all on the node of the
+        // thread that sets up the wave.
+        constexpr core::AllocationPolicy wave_policy{
+            core::PagePolicy::standard, core::NumaPolicy::local};
+
+        template<typename T>
+        void allocate(core::LargeBuffer<T>& buffer, std::size_t size)
+        {
+            buffer = core::LargeBuffer<T>{size, wave_policy};
+        }
+
+        template<typename T>
+        struct Vector3Array
+        {
+            void resize(std::size_t size)
+            {
+                for (auto& component : components)
+                {
+                    allocate(component, size);
+                }
+            }
+
+            core::Vector3<T> get(std::size_t i) const
+            {
+                return core::Vector3<T>{
+                    components[0][i], components[1][i], components[2][i]};
+            }
+
+            void set(std::size_t i, core::Vector3<T> const& v)
+            {
+                components[0][i] = v[0];
+                components[1][i] = v[1];
+                components[2][i] = v[2];
+            }
+
+            std::array<core::LargeBuffer<T>, 3> components;
+        };
+
+        // State of every path of the wave, indexed by its position in the
+        // wave.
+        struct PathArrays
+        {
+            void resize(std::size_t size)
+            {
+                throughput.resize(size);
+                radiance.resize(size);
+                allocate(pixel, size);
+                allocate(sample, size);
+                allocate(time, size);
+                allocate(length, size);
+            }
+
+            Vector3Array<Real> throughput;
+            Vector3Array<AccumReal> radiance;
+            core::LargeBuffer<std::uint64_t> pixel;
+            core::LargeBuffer<std::uint32_t> sample;
+            core::LargeBuffer<Real> time;
+            core::LargeBuffer<std::uint32_t> length;
+        };
+
+        // Rays waiting for a query, each with the path it belongs to.
+        struct RayQueue
+        {
+            void resize(std::size_t capacity)
+            {
+                origins.resize(capacity);
+                directions.resize(capacity);
+                allocate(times, capacity);
+                allocate(t_max, capacity);
+                allocate(paths, capacity);
+            }
+
+            core::Ray<Real> ray(std::size_t i) const
+            {
+                return core::Ray<Real>{
+                    origins.get(i), directions.get(i), times[i]};
+            }
+
+            void set(std::size_t i,
+                     core::Ray<Real> const& ray,
+                     Real distance,
+                     std::uint32_t path)
+            {
+                origins.set(i, ray.o);
+                directions.set(i, ray.d);
+                times[i] = ray.time;
+                t_max[i] = distance;
+                paths[i] = path;
+            }
+
+            Vector3Array<Real> origins;
+            Vector3Array<Real> directions;
+            core::LargeBuffer<Real> times;
+            core::LargeBuffer<Real> t_max;
+            core::LargeBuffer<std::uint32_t> paths;
+            std::size_t size{0};
+        };
+
+        // Surfaces found by the closest-hit queries. Shading replaces the
+        // hit points by the origins of the rays leaving them and flips the
+        // normals to face the incoming rays.
+        struct HitQueue
+        {
+            void resize(std::size_t capacity)
+            {
+                points.resize(capacity);
+                errors.resize(capacity);
+                normals.resize(capacity);
+                directions.resize(capacity);
+                allocate(materials, capacity);
+                allocate(paths, capacity);
+            }
+
+            Vector3Array<Real> points;
+            Vector3Array<Real> errors;
+            Vector3Array<Real> normals;
+            Vector3Array<Real> directions;
+            core::LargeBuffer<std::uint32_t> materials;
+            core::LargeBuffer<std::uint32_t> paths;
+
+            // Appended to concurrently by reserving a range.
+            std::atomic<std::size_t> size{0};
+        };
+
+        // Shadow rays from every hit towards every light, light by light:
+        // the ray from hit `i` towards light `l` is entry `l * hits + i`.
+        // Neighbouring entries leave neighbouring hits towards the same
+        // light, which makes for coherent packets. Lights below the surface
+        // leave their entry unused.
+        struct ShadowQueue
+        {
+            void resize(std::size_t capacity)
+            {
+                rays.resize(capacity);
+                radiance.resize(capacity);
+                allocate(used, capacity);
+                allocate(occluded, capacity);
+            }
+
+            RayQueue rays;
+            Vector3Array<Real> radiance;
+            core::LargeBuffer<std::uint8_t> used;
+            core::LargeBuffer<std::uint8_t> occluded;
+        };
+
+        // Runs `fn(begin, end)` over the chunks of [0, count), which the
+        // threads of `pool`, if any, take in turn as they become free. The
+        // calling thread takes part.
+        template<typename Fn>
+        void parallel_for(core::ThreadPool* pool,
+                          std::size_t count,
+                          Fn const& fn)
+        {
+            std::atomic<std::size_t> next{0};
+            auto worker = [&]() {
+                for (;;)
+                {
+                    auto begin{next.fetch_add(chunk_size)};
+                    if (begin >= count)
+                    {
+                        break;
+                    }
+                    fn(begin, std::min(begin + chunk_size, count));
+                }
+            };
+
+            auto num_chunks{(count + chunk_size - 1) / chunk_size};
+            auto num_helpers{(pool == nullptr || num_chunks == 0)
+                                 ? std::size_t{0}
+                                 : std::min(pool->size(), num_chunks - 1)};
+            std::vector<std::future<void>> helpers;
+            for (std::size_t i{0}; i < num_helpers; ++i)
+            {
+                helpers.push_back(pool->submit(worker));
+            }
+
+            worker();
+            for (auto& helper : helpers)
+            {
+                helper.get();
+            }
+        }
+
+        // Queries the rays in [begin, end) of the queue for which
+        // `used(i)` holds, consecutive rays together as packets, and calls
+        // `fn(i, found, hit)` for each.
+        template<typename Used, typename Fn>
+        void trace_rays(Scene const& scene,
+                        std::size_t packet_size,
+                        RayQueue const& rays,
+                        std::size_t begin,
+                        std::size_t end,
+                        Used const& used,
+                        Fn const& fn)
+        {
+            for (auto first{begin}; first < end; first += packet_size)
+            {
+                if (packet_size == 1)
+                {
+                    if (used(first))
+                    {
+                        auto t_max{rays.t_max[first]};
+                        shapes::SurfaceInteraction hit;
+                        auto found{
+                            scene.intersect(rays.ray(first), t_max, hit)};
+                        fn(first, found, hit);
+                    }
+                    continue;
+                }
+
+                auto count{std::min(packet_size, end - first)};
+                shapes::RayPacket packet;
+                shapes::PacketDistances t_max;
+                t_max.fill(std::numeric_limits<Real>::infinity());
+                std::uint32_t mask{0};
+                for (std::size_t lane{0}; lane < count; ++lane)
+                {
+                    if (used(first + lane))
+                    {
+                        packet.set(lane, rays.ray(first + lane));
+                        t_max[lane] = rays.t_max[first + lane];
+                        mask |= std::uint32_t{1} << lane;
+                    }
+                }
+
+                shapes::PacketHits hits;
+                auto found{scene.intersect_packet(packet, mask, t_max, hits)};
+                for (std::size_t lane{0}; lane < count; ++lane)
+                {
+                    auto bit{std::uint32_t{1} << lane};
+                    if ((mask & bit) != 0)
+                    {
+                        fn(first + lane, (found & bit) != 0, hits[lane]);
+                    }
+                }
+            }
+        }
+
+        // Tests the rays in [begin, end) of the queue for which `used(i)`
+        // holds for occlusion, consecutive rays together as packets, and
+        // calls `fn(i, occluded)` for each.
+        template<typename Used, typename Fn>
+        void occlude_rays(Scene const& scene,
+                          std::size_t packet_size,
+                          RayQueue const& rays,
+                          std::size_t begin,
+                          std::size_t end,
+                          Used const& used,
+                          Fn const& fn)
+        {
+            for (auto first{begin}; first < end; first += packet_size)
+            {
+                if (packet_size == 1)
+                {
+                    if (used(first))
+                    {
+                        fn(first,
+                           scene.occluded(rays.ray(first), rays.t_max[first]));
+                    }
+                    continue;
+                }
+
+                auto count{std::min(packet_size, end - first)};
+                shapes::RayPacket packet;
+                shapes::PacketDistances t_max;
+                t_max.fill(std::numeric_limits<Real>::infinity());
+                std::uint32_t mask{0};
+                for (std::size_t lane{0}; lane < count; ++lane)
+                {
+                    if (used(first + lane))
+                    {
+                        packet.set(lane, rays.ray(first + lane));
+                        t_max[lane] = rays.t_max[first + lane];
+                        mask |= std::uint32_t{1} << lane;
+                    }
+                }
+
+                auto occluded{scene.occluded_packet(packet, mask, t_max)};
+                for (std::size_t lane{0}; lane < count; ++lane)
+                {
+                    auto bit{std::uint32_t{1} << lane};
+                    if ((mask & bit) != 0)
+                    {
+                        fn(first + lane, (occluded & bit) != 0);
+                    }
+                }
+            }
+        }
+
+        // Traces one wave of paths through every bounce.
+        class Wave
+        {
+        public:
+            Wave(Scene const& scene,
+                 RenderSettings const& settings,
+                 core::ThreadPool* pool,
+                 std::size_t capacity) :
+                m_scene{scene},
+                m_settings{settings},
+                m_rng{settings.seed},
+                m_pool{pool}
+            {
+                m_paths.resize(capacity);
+                m_queues[0].resize(capacity);
+                m_queues[1].resize(capacity);
+                m_hits.resize(capacity);
+                m_shadows.resize(capacity * scene.lights().size());
+            }
+
+            void render(std::size_t first_pixel,
+                        std::size_t num_pixels,
+                        RenderResult& result)
+            {
+                m_result     = &result;
+                m_rays       = &m_queues[0];
+                m_next_rays  = &m_queues[1];
+                m_rays->size = num_pixels * m_settings.samples_per_pixel;
+                run(WavefrontStage::generate,
+                    m_rays->size,
+                    [&](std::size_t begin, std::size_t end) {
+                        generate(first_pixel, begin, end);
+                    });
+
+                for (std::uint32_t depth{0}; depth < m_settings.max_depth;
+                     ++depth)
+                {
+                    if (m_rays->size == 0)
+                    {
+                        break;
+                    }
+
+                    m_hits.size = 0;
+                    run(WavefrontStage::intersect,
+                        m_rays->size,
+                        [&](std::size_t begin, std::size_t end) {
+                            intersect(depth, begin, end);
+                        });
+
+                    // Every hit but those of the last bounce leaves a bounce
+                    // ray, stored at the index of the hit.
+                    sort_hits();
+                    auto last{depth + 1 == m_settings.max_depth};
+                    m_next_rays->size = last ? 0 : m_hits.size.load();
+                    run(WavefrontStage::shade,
+                        m_hits.size,
+                        [&](std::size_t begin, std::size_t end) {
+                            shade(depth, last, begin, end);
+                        });
+
+                    run(WavefrontStage::sample_lights,
+                        m_hits.size,
+                        [&](std::size_t begin, std::size_t end) {
+                            sample_lights(begin, end);
+                        });
+
+                    auto num_shadow_rays{m_hits.size * m_scene.lights().size()};
+                    run(WavefrontStage::shadow_test,
+                        (packet_size(depth) > 1) ? num_shadow_rays
+                                                 : m_hits.size.load(),
+                        [&](std::size_t begin, std::size_t end) {
+                            shadow_test(depth, begin, end);
+                        });
+
+                    run(WavefrontStage::accumulate,
+                        m_hits.size,
+                        [&](std::size_t begin, std::size_t end) {
+                            accumulate(last, begin, end);
+                        });
+
+                    std::swap(m_rays, m_next_rays);
+                }
+
+                run(WavefrontStage::accumulate,
+                    num_pixels,
+                    [&](std::size_t begin, std::size_t end) {
+                        write_pixels(first_pixel, begin, end);
+                    });
+            }
+
+            std::uint64_t rays() const
+            {
+                return m_num_rays;
+            }
+
+            std::uint64_t shadow_rays() const
+            {
+                return m_num_shadow_rays;
+            }
+
+        private:
+            template<typename Fn>
+            void run(WavefrontStage stage, std::size_t count, Fn const& fn)
+            {
+                APOLLO_PROFILE_ZONE(wavefront_stage_name(stage).data());
+                auto start{Clock::now()};
+                parallel_for(m_pool, count, fn);
+                m_result->stage_seconds[static_cast<std::size_t>(stage)] +=
+                    std::chrono::duration<double>(Clock::now() - start)
+                        .count();
+            }
+
+            void generate(std::size_t first_pixel,
+                          std::size_t begin,
+                          std::size_t end)
+            {
+                auto& camera = m_scene.camera();
+                auto spp{m_settings.samples_per_pixel};
+                for (auto i{begin}; i < end; ++i)
+                {
+                    auto index{first_pixel + i / spp};
+                    auto x{index % camera.width()};
+                    auto y{index / camera.width()};
+                    auto sample{static_cast<std::uint32_t>(i % spp)};
+                    auto pixel{core::CounterRng::pixel_index(core::Point2<int>{
+                        static_cast<int>(x), static_cast<int>(y)})};
+                    auto ray{camera_ray(camera,
+                                        m_rng,
+                                        pixel,
+                                        sample,
+                                        x,
+                                        y,
+                                        m_settings.max_depth)};
+
+                    m_paths.throughput.set(i, core::Vector3<Real>{Real{1}});
+                    m_paths.radiance.set(i, core::Vector3<AccumReal>{});
+                    m_paths.pixel[i]  = pixel;
+                    m_paths.sample[i] = sample;
+                    m_paths.time[i]   = ray.time;
+                    m_paths.length[i] = 0;
+                    m_rays->set(i,
+                                ray,
+                                std::numeric_limits<Real>::infinity(),
+                                static_cast<std::uint32_t>(i));
+                }
+            }
+
+            // Only camera rays, and the shadow rays from where they hit, are
+            // coherent enough for packets to pay off, as in the path
+            // integrator.
+            std::size_t packet_size(std::uint32_t depth) const
+            {
+                return (depth == 0) ? m_settings.packet_size : 1;
+            }
+
+            // The hits of the chunk are gathered in the thread's arena and
+            // then appended to the queue together.
+            void intersect(std::uint32_t depth,
+                           std::size_t begin,
+                           std::size_t end)
+            {
+                core::ArenaScope scope;
+                auto& arena = core::thread_arena();
+                auto found_rays{arena.alloc_array<std::size_t>(end - begin)};
+                auto found_hits{
+                    arena.alloc_array<shapes::SurfaceInteraction>(end - begin)};
+                std::size_t num_found{0};
+                auto& rays = *m_rays;
+                trace_rays(m_scene,
+                           packet_size(depth),
+                           rays,
+                           begin,
+                           end,
+                           [](std::size_t) { return true; },
+                           [&](std::size_t i,
+                               bool found,
+                               shapes::SurfaceInteraction const& hit) {
+                               auto path{rays.paths[i]};
+                               if (found)
+                               {
+                                   ++m_paths.length[path];
+                                   found_rays[num_found] = i;
+                                   found_hits[num_found] = hit;
+                                   ++num_found;
+                                   return;
+                               }
+
+                               m_paths.radiance.set(
+                                   path,
+                                   m_paths.radiance.get(path) +
+                                       core::vector_cast<AccumReal>(multiply(
+                                           m_paths.throughput.get(path),
+                                           m_settings.background)));
+                               core::record_path_length(
+                                   m_paths.length[path]);
+                           });
+
+                auto first{m_hits.size.fetch_add(num_found,
+                                                 std::memory_order_relaxed)};
+                for (std::size_t k{0}; k < num_found; ++k)
+                {
+                    auto i{found_rays[k]};
+                    auto& hit = found_hits[k];
+                    m_hits.points.set(first + k, hit.point);
+                    m_hits.errors.set(first + k, hit.error);
+                    m_hits.normals.set(first + k, hit.normal);
+                    m_hits.directions.set(first + k, rays.directions.get(i));
+                    m_hits.materials[first + k] = hit.material;
+                    m_hits.paths[first + k]     = rays.paths[i];
+                }
+                m_num_rays += end - begin;
+            }
+
+            // Orders the hits by material with a counting sort, so that
+            // shading handles the hits of each material together.
+            void sort_hits()
+            {
+                APOLLO_PROFILE_ZONE("sort hits");
+                auto start{Clock::now()};
+                auto count{m_hits.size.load()};
+                core::ArenaScope scope;
+                auto num_offsets{m_scene.materials().size() + 1};
+                auto offsets{
+                    core::thread_arena().alloc_array<std::size_t>(num_offsets)};
+                for (std::size_t i{0}; i < count; ++i)
+                {
+                    ++offsets[m_hits.materials[i] + 1];
+                }
+                for (std::size_t m{1}; m < num_offsets; ++m)
+                {
+                    offsets[m] += offsets[m - 1];
+                }
+
+                m_order.resize(count);
+                for (std::size_t i{0}; i < count; ++i)
+                {
+                    m_order[offsets[m_hits.materials[i]]++] = i;
+                }
+
+                auto& seconds = m_result->stage_seconds[static_cast<
+                    std::size_t>(WavefrontStage::shade)];
+                seconds +=
+                    std::chrono::duration<double>(Clock::now() - start)
+                        .count();
+            }
+
+            void shade(std::uint32_t depth,
+                       bool last,
+                       std::size_t begin,
+                       std::size_t end)
+            {
+                for (auto k{begin}; k < end; ++k)
+                {
+                    auto i{m_order[k]};
+                    auto path{m_hits.paths[i]};
+                    auto& material = m_scene.material(m_hits.materials[i]);
+
+                    auto n{m_hits.normals.get(i)};
+                    if (core::dot(n, m_hits.directions.get(i)) > 0)
+                    {
+                        n = -n;
+                    }
+
+                    auto origin{core::offset_ray_origin(
+                        m_hits.points.get(i), m_hits.errors.get(i), n)};
+                    m_hits.normals.set(i, n);
+                    m_hits.points.set(i, origin);
+                    m_paths.throughput.set(
+                        path,
+                        multiply(m_paths.throughput.get(path),
+                                 material.albedo));
+                    if (last)
+                    {
+                        continue;
+                    }
+
+                    auto pixel{m_paths.pixel[path]};
+                    auto sample{m_paths.sample[path]};
+                    auto u1{m_rng.uniform(pixel, sample, 2 + 2 * depth)};
+                    auto u2{m_rng.uniform(pixel, sample, 3 + 2 * depth)};
+                    m_next_rays->set(
+                        i,
+                        core::Ray<Real>{origin,
+                                        sample_cosine_hemisphere(n, u1, u2),
+                                        m_paths.time[path]},
+                        std::numeric_limits<Real>::infinity(),
+                        path);
+                }
+            }
+
+            void sample_lights(std::size_t begin, std::size_t end)
+            {
+                // Light by light, so that the queue is written in order.
+                auto& lights = m_scene.lights();
+                auto num_hits{m_hits.size.load()};
+                for (std::size_t l{0}; l < lights.size(); ++l)
+                {
+                    for (auto i{begin}; i < end; ++i)
+                    {
+                        auto path{m_hits.paths[i]};
+                        core::Ray<Real> ray;
+                        Real t_max{0};
+                        core::Vector3<Real> radiance;
+                        auto k{l * num_hits + i};
+                        m_shadows.used[k] =
+                            sample_point_light(m_hits.points.get(i),
+                                               m_hits.normals.get(i),
+                                               m_paths.throughput.get(path),
+                                               lights[l],
+                                               m_paths.time[path],
+                                               ray,
+                                               t_max,
+                                               radiance);
+                        if (m_shadows.used[k])
+                        {
+                            m_shadows.rays.set(k, ray, t_max, path);
+                            m_shadows.radiance.set(k, radiance);
+                        }
+                    }
+                }
+            }
+
+            // Without packets, the shadow rays are traced hit by hit rather
+            // than light by light, so those sharing an origin follow each
+            // other and find the nodes around it in the cache. The range is
+            // one of hits then, and of queue entries otherwise.
+            void shadow_test(std::uint32_t depth,
+                             std::size_t begin,
+                             std::size_t end)
+            {
+                auto num_lights{m_scene.lights().size()};
+                auto num_hits{m_hits.size.load()};
+                auto used = [this](std::size_t k) {
+                    return m_shadows.used[k] != 0;
+                };
+                std::uint64_t count{0};
+                auto test = [&](std::size_t k, bool occluded) {
+                    m_shadows.occluded[k] = occluded;
+                    ++count;
+                };
+
+                if (packet_size(depth) > 1)
+                {
+                    occlude_rays(m_scene,
+                                 packet_size(depth),
+                                 m_shadows.rays,
+                                 begin,
+                                 end,
+                                 used,
+                                 test);
+                }
+                else
+                {
+                    for (auto i{begin}; i < end; ++i)
+                    {
+                        for (std::size_t l{0}; l < num_lights; ++l)
+                        {
+                            auto k{l * num_hits + i};
+                            occlude_rays(m_scene,
+                                         1,
+                                         m_shadows.rays,
+                                         k,
+                                         k + 1,
+                                         used,
+                                         test);
+                        }
+                    }
+                }
+                m_num_shadow_rays += count;
+            }
+
+            // Adds the unoccluded shadow rays of each hit to its path in
+            // light order, as the path integrator does.
+            void accumulate(bool last, std::size_t begin, std::size_t end)
+            {
+                auto num_lights{m_scene.lights().size()};
+                auto num_hits{m_hits.size.load()};
+                for (std::size_t l{0}; l < num_lights; ++l)
+                {
+                    for (auto i{begin}; i < end; ++i)
+                    {
+                        auto k{l * num_hits + i};
+                        if (m_shadows.used[k] && !m_shadows.occluded[k])
+                        {
+                            auto path{m_hits.paths[i]};
+                            m_paths.radiance.set(
+                                path,
+                                m_paths.radiance.get(path) +
+                                    core::vector_cast<AccumReal>(
+                                        m_shadows.radiance.get(k)));
+                        }
+                    }
+                }
+
+                for (auto i{begin}; i < end && last; ++i)
+                {
+                    core::record_path_length(m_paths.length[m_hits.paths[i]]);
+                }
+            }
+
+            void write_pixels(std::size_t first_pixel,
+                              std::size_t begin,
+                              std::size_t end)
+            {
+                auto& camera = m_scene.camera();
+                auto spp{m_settings.samples_per_pixel};
+                for (auto i{begin}; i < end; ++i)
+                {
+                    core::Vector3<AccumReal> sum;
+                    for (std::size_t s{0}; s < spp; ++s)
+                    {
+                        sum += m_paths.radiance.get(i * spp + s);
+                    }
+
+                    auto value{sum / static_cast<AccumReal>(spp)};
+                    auto index{first_pixel + i};
+                    m_result->image(index % camera.width(),
+                                    index / camera.width()) =
+                        core::Vector3<float>{static_cast<float>(value[0]),
+                                             static_cast<float>(value[1]),
+                                             static_cast<float>(value[2])};
+                }
+
+                core::increment_stat(core::StatCounter::pixels, end - begin);
+                core::increment_stat(core::StatCounter::samples,
+                                     (end - begin) * spp);
+            }
+
+            Scene const& m_scene;
+            RenderSettings const& m_settings;
+            core::CounterRng m_rng;
+            core::ThreadPool* m_pool;
+            RenderResult* m_result{nullptr};
+
+            PathArrays m_paths;
+            std::array<RayQueue, 2> m_queues;
+            RayQueue* m_rays{nullptr};
+            RayQueue* m_next_rays{nullptr};
+            HitQueue m_hits;
+            ShadowQueue m_shadows;
+            std::vector<std::size_t> m_order;
+
+            std::atomic<std::uint64_t> m_num_rays{0};
+            std::atomic<std::uint64_t> m_num_shadow_rays{0};
+        };
+    } // namespace
+
+    std::string_view wavefront_stage_name(WavefrontStage stage)
+    {
+        switch (stage)
+        {
+        case WavefrontStage::generate:
+            return "generate";
+        case WavefrontStage::intersect:
+            return "intersect";
+        case WavefrontStage::shade:
+            return "shade";
+        case WavefrontStage::sample_lights:
+            return "sample_lights";
+        case WavefrontStage::shadow_test:
+            return "shadow_test";
+        case WavefrontStage::accumulate:
+        default:
+            return "accumulate";
+        }
+    }
+
+    RenderResult render_wavefront(Scene const& scene,
+                                  RenderSettings const& settings)
+    {
+        APOLLO_PROFILE_ZONE("render wavefront");
+        auto& camera = scene.camera();
+        RenderResult result;
+        result.image = Image{camera.width(), camera.height()};
+        result.stage_seconds.resize(num_wavefront_stages);
+        ASSERT(settings.samples_per_pixel > 0);
+
+        auto num_threads{settings.num_threads};
+        if (num_threads == 0)
+        {
+            num_threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        // Waves hold whole pixels, so their samples are summed together.
+        std::size_t spp{settings.samples_per_pixel};
+        auto num_pixels{camera.width() * camera.height()};
+        auto wave_pixels{std::clamp<std::size_t>(
+            settings.wavefront_size / spp, 1, std::max<std::size_t>(
+                                                  num_pixels, 1))};
+
+        // One pool serves every stage of every wave, so each thread is
+        // started, pinned and registered with the statistics and the
+        // profiler once per render.
+        std::optional<core::ThreadPool> pool;
+        if (settings.pin_threads)
+        {
+            core::pin_pool_thread(0, num_threads);
+        }
+        if (num_threads > 1)
+        {
+            auto pin = [&settings, num_threads](std::size_t i) {
+                if (settings.pin_threads)
+                {
+                    core::pin_pool_thread(i + 1, num_threads);
+                }
+            };
+            pool.emplace(num_threads - 1, pin);
+        }
+
+        auto start{Clock::now()};
+        Wave wave{scene,
+                  settings,
+                  pool ? &*pool : nullptr,
+                  wave_pixels * spp};
+        for (std::size_t first{0}; first < num_pixels; first += wave_pixels)
+        {
+            wave.render(
+                first, std::min(wave_pixels, num_pixels - first), result);
+        }
+        auto end{Clock::now()};
+
+        result.rays        = wave.rays();
+        result.shadow_rays = wave.shadow_rays();
+        result.seconds = std::chrono::duration<double>(end - start).count();
+        core::increment_stat(core::StatCounter::rays_traced, result.rays);
+        core::increment_stat(core::StatCounter::shadow_rays,
+                             result.shadow_rays);
+        return result;
+    }
+} // namespace render
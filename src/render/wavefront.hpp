@@ -0,0 +1,45 @@
+#pragma once
+
+#include "renderer.hpp"
+
+#include <string_view>
+
+namespace render
+{
+    // Stages of the wavefront integrator, in the order each bounce runs
+    // them.
+    enum class WavefrontStage
+    {
+        // Camera rays for every path of the wave.
+        generate,
+
+        // Closest hits of the rays in the queue.
+        intersect,
+
+        // Shading frames and bounce rays, with the hits grouped by material.
+        shade,
+
+        // Shadow rays from every hit towards every light.
+        sample_lights,
+
+        // Occlusion of the shadow rays.
+        shadow_test,
+
+        // Radiance of the unoccluded shadow rays, and finally the pixels.
+        accumulate
+    };
+
+    constexpr std::size_t num_wavefront_stages{6};
+
+    std::string_view wavefront_stage_name(WavefrontStage stage);
+
+    // Renders the scene with the same path tracer as render(), breadth
+    // first: paths are traced in waves of `wavefront_size`, and every stage
+    // of a bounce runs over the whole wave, spread over the worker threads,
+    // before the next one starts. Stages pass rays and hits on through
+    // queues stored as structures of arrays. The image is identical to the
+    // one render() produces. Paged geometry is loaded as rays reach it
+    // rather than suspending them, and hardware counters are not read.
+    RenderResult render_wavefront(Scene const& scene,
+                                  RenderSettings const& settings);
+} // namespace render
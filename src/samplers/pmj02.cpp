@@ -0,0 +1,248 @@
+#include "pmj02.hpp"
+
+#include <core/bits.hpp>
+
+#include <array>
+#include <random>
+#include <zeus/assert.hpp>
+
+namespace samplers
+{
+    namespace
+    {
+        std::uint32_t log2_int(std::size_t n)
+        {
+            std::uint32_t log{0};
+            while ((std::size_t{1} << log) < n)
+            {
+                ++log;
+            }
+            return log;
+        }
+
+        class Pmj02Generator
+        {
+        public:
+            Pmj02Generator(Pmj02Table& table, std::uint64_t seed) :
+                m_table{table},
+                m_rng{seed}
+            {}
+
+            bool generate(std::size_t num_samples)
+            {
+                m_table.x.assign(1, random_bits());
+                m_table.y.assign(1, random_bits());
+
+                for (std::size_t n{1}; n < num_samples; n *= 4)
+                {
+                    // The current samples form an n = 4^k point net; each
+                    // of them lives in its own cell of a 2^k x 2^k grid.
+                    auto k{log2_int(n) / 2};
+
+                    // Extend to 2n samples: the new point of every cell goes
+                    // into the sub-quadrant diagonally opposite the old one.
+                    begin_level(2 * n);
+                    for (std::size_t i{0}; i < n; ++i)
+                    {
+                        auto [cx, cy, hx, hy] = sub_quadrant(i, k);
+                        if (!place(
+                                (cx << 1) | (hx ^ 1), (cy << 1) | (hy ^ 1), k))
+                        {
+                            return false;
+                        }
+                    }
+
+                    if (2 * n >= num_samples)
+                    {
+                        break;
+                    }
+
+                    // Extend to 4n samples: fill the two remaining
+                    // sub-quadrants of every cell, picking at random which
+                    // of them is filled first.
+                    begin_level(4 * n);
+                    std::vector<bool> swap_x(n);
+                    for (std::size_t i{0}; i < n; ++i)
+                    {
+                        swap_x[i] = (random_bits() & 1) != 0;
+                        auto [cx, cy, hx, hy] = sub_quadrant(i, k);
+                        auto fx{swap_x[i] ? hx ^ 1 : hx};
+                        auto fy{swap_x[i] ? hy : hy ^ 1};
+                        if (!place((cx << 1) | fx, (cy << 1) | fy, k))
+                        {
+                            return false;
+                        }
+                    }
+
+                    for (std::size_t i{0}; i < n; ++i)
+                    {
+                        auto [cx, cy, hx, hy] = sub_quadrant(i, k);
+                        auto fx{swap_x[i] ? hx : hx ^ 1};
+                        auto fy{swap_x[i] ? hy ^ 1 : hy};
+                        if (!place((cx << 1) | fx, (cy << 1) | fy, k))
+                        {
+                            return false;
+                        }
+                    }
+                }
+
+                m_table.x.resize(num_samples);
+                m_table.y.resize(num_samples);
+                return true;
+            }
+
+        private:
+            std::uint32_t random_bits()
+            {
+                return static_cast<std::uint32_t>(m_rng() >> 32);
+            }
+
+            // Cell of sample i in the 2^k x 2^k grid, and the half of that
+            // cell it occupies along each axis.
+            std::array<std::uint32_t, 4> sub_quadrant(std::size_t i,
+                                                      std::uint32_t k) const
+            {
+                auto x{m_table.x[i]}, y{m_table.y[i]};
+                return {core::top_bits(x, k),
+                        core::top_bits(y, k),
+                        core::top_bits(x, k + 1) & 1,
+                        core::top_bits(y, k + 1) & 1};
+            }
+
+            std::size_t cell(std::uint32_t a,
+                             std::uint32_t x_bits,
+                             std::uint32_t y_bits) const
+            {
+                // x_bits and y_bits hold the top m_log bits of each
+                // coordinate; the elementary interval of shape
+                // 2^a x 2^(m_log - a) keeps the top a and m_log - a of them.
+                auto b{m_log - a};
+                return (static_cast<std::size_t>(x_bits >> b) << b) |
+                       (y_bits >> a);
+            }
+
+            void begin_level(std::size_t target)
+            {
+                m_log = log2_int(target);
+                m_occupied.assign(m_log + 1, std::vector<bool>(target, false));
+                for (std::size_t i{0}; i < m_table.x.size(); ++i)
+                {
+                    mark(core::top_bits(m_table.x[i], m_log),
+                         core::top_bits(m_table.y[i], m_log));
+                }
+            }
+
+            void mark(std::uint32_t x_bits, std::uint32_t y_bits)
+            {
+                for (std::uint32_t a{0}; a <= m_log; ++a)
+                {
+                    m_occupied[a][cell(a, x_bits, y_bits)] = true;
+                }
+            }
+
+            // Places a new sample inside the sub-quadrant whose top k + 1
+            // bits are given, such that it does not share an elementary
+            // interval with any existing sample.
+            bool place(std::uint32_t x_prefix,
+                       std::uint32_t y_prefix,
+                       std::uint32_t k)
+            {
+                auto free_bits{m_log - (k + 1)};
+                std::uint32_t range{1u << free_bits};
+
+                // Columns and rows of width 2^-m_log are the most
+                // restrictive intervals, so use them to prune first.
+                m_columns.clear();
+                m_rows.clear();
+                for (std::uint32_t v{0}; v < range; ++v)
+                {
+                    auto x_bits{(x_prefix << free_bits) | v};
+                    auto y_bits{(y_prefix << free_bits) | v};
+                    if (!m_occupied[m_log][cell(m_log, x_bits, 0)])
+                    {
+                        m_columns.push_back(x_bits);
+                    }
+                    if (!m_occupied[0][cell(0, 0, y_bits)])
+                    {
+                        m_rows.push_back(y_bits);
+                    }
+                }
+
+                m_candidates.clear();
+                for (auto x_bits : m_columns)
+                {
+                    for (auto y_bits : m_rows)
+                    {
+                        bool valid{true};
+                        for (std::uint32_t a{1}; a < m_log && valid; ++a)
+                        {
+                            valid = !m_occupied[a][cell(a, x_bits, y_bits)];
+                        }
+
+                        if (valid)
+                        {
+                            m_candidates.push_back({x_bits, y_bits});
+                        }
+                    }
+                }
+
+                if (m_candidates.empty())
+                {
+                    return false;
+                }
+
+                auto choice = m_candidates[m_rng() % m_candidates.size()];
+                mark(choice[0], choice[1]);
+
+                // Jitter the sample uniformly within its finest cell.
+                auto low{32 - m_log};
+                std::uint32_t mask{(low == 32) ? ~0u : (1u << low) - 1};
+                m_table.x.push_back((choice[0] << low) |
+                                    (random_bits() & mask));
+                m_table.y.push_back((choice[1] << low) |
+                                    (random_bits() & mask));
+                return true;
+            }
+
+            Pmj02Table& m_table;
+            std::mt19937_64 m_rng;
+            std::uint32_t m_log{0};
+            std::vector<std::vector<bool>> m_occupied;
+            std::vector<std::uint32_t> m_columns;
+            std::vector<std::uint32_t> m_rows;
+            std::vector<std::array<std::uint32_t, 2>> m_candidates;
+        };
+    } // namespace
+
+    Pmj02Table generate_pmj02(std::size_t num_samples, std::uint64_t seed)
+    {
+        ASSERT(num_samples > 0);
+        ASSERT(num_samples <= (std::size_t{1} << 16));
+
+        Pmj02Table table;
+        Pmj02Generator generator{table, seed};
+
+        // Should the greedy placement ever run out of valid positions, start
+        // over with the next random stream.
+        while (!generator.generate(num_samples))
+        {}
+
+        return table;
+    }
+
+    Pmj02Table const& pmj02_table(std::size_t i)
+    {
+        ASSERT(i < pmj02_num_tables);
+
+        static std::array<Pmj02Table, pmj02_num_tables> const tables = []() {
+            std::array<Pmj02Table, pmj02_num_tables> out;
+            for (std::size_t j{0}; j < pmj02_num_tables; ++j)
+            {
+                out[j] = generate_pmj02(pmj02_table_size, j + 1);
+            }
+            return out;
+        }();
+
+        return tables[i];
+    }
+} // namespace samplers
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace samplers
+{
+    // Number of independent pmj02 sequences kept in memory and the number of
+    // points in each one. The size must be a power of 2 so every table is a
+    // complete (0, m, 2)-net.
+    inline constexpr std::size_t pmj02_num_tables{4};
+    inline constexpr std::size_t pmj02_table_size{4096};
+
+    // Points are stored as 32-bit fixed-point values in structure-of-arrays
+    // form so that batches of samples are contiguous loads.
+    struct Pmj02Table
+    {
+        std::vector<std::uint32_t> x;
+        std::vector<std::uint32_t> y;
+    };
+
+    // Generates `num_samples` points of a progressive multi-jittered (0, 2)
+    // sequence (Christensen et al. 2018). Every power-of-2 prefix of the
+    // result is stratified over all 2D elementary intervals.
+    Pmj02Table generate_pmj02(std::size_t num_samples, std::uint64_t seed);
+
+    // Returns one of the shared tables. They are generated once, on first
+    // use, and are read-only afterwards.
+    Pmj02Table const& pmj02_table(std::size_t i);
+} // namespace samplers
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "pmj02.hpp"
+#include "sampler.hpp"
+
+#include <core/bits.hpp>
+#include <core/hash.hpp>
+
+#include <algorithm>
+
+namespace samplers
+{
+    // Sampler backed by the precomputed pmj02 tables. Each pixel and
+    // dimension pair picks a table and applies a random digital shift (an
+    // XOR of the fixed-point coordinates), which keeps every elementary
+    // interval stratification of the underlying sequence intact.
+    template<typename T>
+    class Pmj02Sampler : public Sampler<T>
+    {
+    public:
+        using Sampler<T>::get_2d_batch;
+
+        Pmj02Sampler() = default;
+
+        explicit Pmj02Sampler(std::uint32_t seed) : m_seed{seed}
+        {}
+
+        void start_pixel_sample(core::Point2<int> const& pixel,
+                                std::uint32_t sample_index,
+                                std::uint32_t dimension = 0) override
+        {
+            m_pixel        = pixel;
+            m_sample_index = sample_index;
+            m_dimension    = dimension;
+        }
+
+        T get_1d() override
+        {
+            auto h{pixel_seed(m_pixel, m_dimension++, m_seed)};
+            auto& table = select_table(h, m_sample_index);
+            auto i{m_sample_index % pmj02_table_size};
+            return core::unit_from_bits<T>(table.x[i] ^
+                                           static_cast<std::uint32_t>(h));
+        }
+
+        core::Point2<T> get_2d() override
+        {
+            core::Point2<T> p;
+            get_2d_batch(m_pixel, m_sample_index, m_dimension, 1, &p[0], &p[1]);
+            m_dimension += 2;
+            return p;
+        }
+
+        void get_2d_batch(core::Point2<int> const& pixel,
+                          std::uint32_t first_sample,
+                          std::uint32_t dimension,
+                          std::size_t count,
+                          T* xs,
+                          T* ys) const override
+        {
+            auto h{pixel_seed(pixel, dimension, m_seed)};
+            auto shift_x{static_cast<std::uint32_t>(h)};
+            auto shift_y{static_cast<std::uint32_t>(h >> 32)};
+
+            std::size_t i{0};
+            while (i < count)
+            {
+                // Split the request at table boundaries so the inner loop
+                // reads a single table with unit stride.
+                auto sample{first_sample + static_cast<std::uint32_t>(i)};
+                auto& table = select_table(h, sample);
+                auto start{sample % pmj02_table_size};
+                auto run{std::min(count - i, pmj02_table_size - start)};
+
+                auto tx = table.x.data() + start;
+                auto ty = table.y.data() + start;
+                for (std::size_t j{0}; j < run; ++j)
+                {
+                    xs[i + j] = core::unit_from_bits<T>(tx[j] ^ shift_x);
+                    ys[i + j] = core::unit_from_bits<T>(ty[j] ^ shift_y);
+                }
+
+                i += run;
+            }
+        }
+
+    private:
+        static Pmj02Table const& select_table(std::uint64_t h,
+                                              std::uint32_t sample_index)
+        {
+            // Once a pixel runs past the end of a table, move on to the next
+            // one rather than repeating points.
+            auto wrap{sample_index / pmj02_table_size};
+            return pmj02_table(((h >> 16) + wrap) % pmj02_num_tables);
+        }
+
+        std::uint32_t m_seed{0};
+        core::Point2<int> m_pixel;
+        std::uint32_t m_sample_index{0};
+        std::uint32_t m_dimension{0};
+    };
+} // namespace samplers
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <core/hash.hpp>
+#include <core/vector.hpp>
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+namespace samplers
+{
+    // Structure-of-arrays block of 2D samples. Keeping the coordinates in
+    // separate, cache-line aligned arrays lets the generators fill them with
+    // straight-line loops the compiler can vectorise.
+    template<typename T, std::size_t N>
+    struct SampleBatch2D
+    {
+        static constexpr auto size{N};
+
+        core::Point2<T> operator[](std::size_t i) const
+        {
+            return core::Point2<T>{x[i], y[i]};
+        }
+
+        alignas(64) std::array<T, N> x;
+        alignas(64) std::array<T, N> y;
+    };
+
+    template<typename T>
+    using SampleBatch8 = SampleBatch2D<T, 8>;
+
+    template<typename T>
+    using SampleBatch16 = SampleBatch2D<T, 16>;
+
+    // Seed shared by every sample of a given pixel and dimension. Samplers
+    // derive all of their per-pixel randomisation from this value, so the
+    // sequences never depend on the order in which pixels are visited.
+    inline std::uint64_t pixel_seed(core::Point2<int> const& pixel,
+                                    std::uint32_t dimension,
+                                    std::uint32_t seed)
+    {
+        return core::hash(pixel[0], pixel[1], dimension, seed);
+    }
+
+    template<typename T,
+             typename = std::enable_if_t<std::is_floating_point_v<T>>>
+    class Sampler
+    {
+    public:
+        virtual ~Sampler() = default;
+
+        virtual void start_pixel_sample(core::Point2<int> const& pixel,
+                                        std::uint32_t sample_index,
+                                        std::uint32_t dimension = 0) = 0;
+
+        virtual T get_1d() = 0;
+
+        virtual core::Point2<T> get_2d() = 0;
+
+        // Fills `count` consecutive samples starting at `first_sample` for
+        // the 2D dimension pair starting at `dimension`.
+        virtual void get_2d_batch(core::Point2<int> const& pixel,
+                                  std::uint32_t first_sample,
+                                  std::uint32_t dimension,
+                                  std::size_t count,
+                                  T* xs,
+                                  T* ys) const = 0;
+
+        template<std::size_t N>
+        void get_2d_batch(core::Point2<int> const& pixel,
+                          std::uint32_t first_sample,
+                          std::uint32_t dimension,
+                          SampleBatch2D<T, N>& batch) const
+        {
+            get_2d_batch(pixel,
+                         first_sample,
+                         dimension,
+                         N,
+                         batch.x.data(),
+                         batch.y.data());
+        }
+    };
+} // namespace samplers
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <core/bits.hpp>
+
+#include <array>
+#include <cstdint>
+
+namespace samplers
+{
+    // Generator matrix for the second Sobol' dimension, stored as columns
+    // with the most significant bit first. The first dimension is the van der
+    // Corput sequence, whose matrix is the identity and reduces to a bit
+    // reversal.
+    constexpr std::array<std::uint32_t, 32> make_sobol_matrix_1()
+    {
+        std::array<std::uint32_t, 32> matrix{};
+        std::uint32_t v{0x80000000};
+        for (std::size_t i{0}; i < 32; ++i)
+        {
+            matrix[i] = v;
+            v ^= v >> 1;
+        }
+
+        return matrix;
+    }
+
+    inline constexpr std::array<std::uint32_t, 32> sobol_matrix_1{
+        make_sobol_matrix_1()};
+
+    constexpr std::uint32_t sobol_sample_0(std::uint32_t index)
+    {
+        return core::reverse_bits_32(index);
+    }
+
+    constexpr std::uint32_t sobol_sample_1(std::uint32_t index)
+    {
+        std::uint32_t v{0};
+        for (std::uint32_t i{0}; i < 32; ++i)
+        {
+            // Branch-free select of the column when bit i is set.
+            v ^= sobol_matrix_1[i] & (0u - ((index >> i) & 1u));
+        }
+
+        return v;
+    }
+
+    // Hash-based approximation of a random base-2 permutation tree from
+    // Laine and Karras, with the improved constants by Vegdahl. It only
+    // propagates bits upwards, so applying it to bit-reversed values yields
+    // an Owen (nested uniform) scramble.
+    constexpr std::uint32_t laine_karras_permutation(std::uint32_t v,
+                                                     std::uint32_t seed)
+    {
+        v ^= v * 0x3d20adea;
+        v += seed;
+        v *= (seed >> 16) | 1;
+        v ^= v * 0x05526c56;
+        v ^= v * 0x53a22864;
+        return v;
+    }
+
+    constexpr std::uint32_t nested_uniform_scramble(std::uint32_t v,
+                                                    std::uint32_t seed)
+    {
+        return core::reverse_bits_32(
+            laine_karras_permutation(core::reverse_bits_32(v), seed));
+    }
+} // namespace samplers
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "sampler.hpp"
+#include "sobol.hpp"
+
+#include <core/bits.hpp>
+#include <core/hash.hpp>
+
+namespace samplers
+{
+    // Owen-scrambled 2D Sobol' sampler. Higher dimensions are padded with
+    // independently scrambled and shuffled copies of the first two Sobol'
+    // dimensions (Burley, "Practical Hash-based Owen Scrambling"), so every
+    // dimension pair is a (0, 2)-sequence in base 2.
+    template<typename T>
+    class SobolSampler : public Sampler<T>
+    {
+    public:
+        using Sampler<T>::get_2d_batch;
+
+        SobolSampler() = default;
+
+        explicit SobolSampler(std::uint32_t seed) : m_seed{seed}
+        {}
+
+        void start_pixel_sample(core::Point2<int> const& pixel,
+                                std::uint32_t sample_index,
+                                std::uint32_t dimension = 0) override
+        {
+            m_pixel        = pixel;
+            m_sample_index = sample_index;
+            m_dimension    = dimension;
+        }
+
+        T get_1d() override
+        {
+            auto seeds = make_seeds(m_pixel, m_dimension++);
+            auto index{nested_uniform_scramble(m_sample_index, seeds.index)};
+            return core::unit_from_bits<T>(
+                nested_uniform_scramble(sobol_sample_0(index), seeds.x));
+        }
+
+        core::Point2<T> get_2d() override
+        {
+            auto seeds = make_seeds(m_pixel, m_dimension);
+            m_dimension += 2;
+
+            auto index{nested_uniform_scramble(m_sample_index, seeds.index)};
+            return core::Point2<T>{
+                core::unit_from_bits<T>(
+                    nested_uniform_scramble(sobol_sample_0(index), seeds.x)),
+                core::unit_from_bits<T>(
+                    nested_uniform_scramble(sobol_sample_1(index), seeds.y))};
+        }
+
+        void get_2d_batch(core::Point2<int> const& pixel,
+                          std::uint32_t first_sample,
+                          std::uint32_t dimension,
+                          std::size_t count,
+                          T* xs,
+                          T* ys) const override
+        {
+            auto seeds = make_seeds(pixel, dimension);
+            for (std::size_t i{0}; i < count; ++i)
+            {
+                auto index{nested_uniform_scramble(
+                    first_sample + static_cast<std::uint32_t>(i),
+                    seeds.index)};
+                xs[i] = core::unit_from_bits<T>(
+                    nested_uniform_scramble(sobol_sample_0(index), seeds.x));
+                ys[i] = core::unit_from_bits<T>(
+                    nested_uniform_scramble(sobol_sample_1(index), seeds.y));
+            }
+        }
+
+    private:
+        struct Seeds
+        {
+            std::uint32_t index;
+            std::uint32_t x;
+            std::uint32_t y;
+        };
+
+        Seeds make_seeds(core::Point2<int> const& pixel,
+                         std::uint32_t dimension) const
+        {
+            auto h{pixel_seed(pixel, dimension, m_seed)};
+            auto h2{core::mix_bits(h)};
+            return {static_cast<std::uint32_t>(h),
+                    static_cast<std::uint32_t>(h >> 32),
+                    static_cast<std::uint32_t>(h2)};
+        }
+
+        std::uint32_t m_seed{0};
+        core::Point2<int> m_pixel;
+        std::uint32_t m_sample_index{0};
+        std::uint32_t m_dimension{0};
+    };
+} // namespace samplers
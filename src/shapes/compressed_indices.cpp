@@ -0,0 +1,71 @@
+#include "compressed_indices.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace shapes
+{
+    CompressedIndices::CompressedIndices(
+        std::vector<std::uint32_t> const& indices) :
+        m_num_triangles{indices.size() / 3}
+    {
+        if (indices.size() % 3 != 0)
+        {
+            throw std::runtime_error{
+                "error: triangle mesh index count is not a multiple of 3"};
+        }
+
+        constexpr auto block_indices{3 * block_size};
+        auto num_blocks{(indices.size() + block_indices - 1) / block_indices};
+
+        std::vector<Header> headers;
+        std::vector<std::uint8_t> data;
+        headers.reserve(num_blocks);
+        for (std::size_t block{0}; block < num_blocks; ++block)
+        {
+            auto begin{indices.begin() + block * block_indices};
+            auto end{indices.begin() +
+                     std::min((block + 1) * block_indices, indices.size())};
+            auto [lo, hi] = std::minmax_element(begin, end);
+
+            std::uint32_t bits{0};
+            while (bits < 32 && (std::uint64_t{*hi - *lo} >> bits) != 0)
+            {
+                ++bits;
+            }
+
+            if (data.size() > std::numeric_limits<std::uint32_t>::max())
+            {
+                throw std::runtime_error{
+                    "error: compressed triangle indices exceed 4 GB"};
+            }
+            headers.push_back({*lo, static_cast<std::uint32_t>(data.size())});
+            data.push_back(static_cast<std::uint8_t>(bits));
+
+            // Offsets are written for the whole block, with zeros past the
+            // end of the mesh, so that every block decodes the same way.
+            auto start{data.size()};
+            data.resize(start + (block_indices * bits + 7) / 8);
+            for (std::size_t i{0}; i < block_indices; ++i)
+            {
+                auto index{block * block_indices + i};
+                std::uint64_t offset{
+                    index < indices.size() ? indices[index] - *lo : 0};
+                for (std::uint32_t b{0}; b < bits; ++b)
+                {
+                    auto bit{i * bits + b};
+                    data[start + bit / 8] |=
+                        static_cast<std::uint8_t>(((offset >> b) & 1)
+                                                  << (bit % 8));
+                }
+            }
+        }
+
+        // Padding for the 64-bit loads of decode().
+        data.resize(data.size() + sizeof(std::uint64_t));
+
+        m_headers = core::SharedArray<Header>{std::move(headers)};
+        m_data    = core::SharedArray<std::uint8_t>{std::move(data)};
+    }
+} // namespace shapes
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <core/shared_array.hpp>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace shapes
+{
+    // Triangle vertex indices compressed in blocks of `block_size`
+    // triangles. A block stores the smallest index it uses and the offsets
+    // of its indices from it, packed with as many bits as the largest offset
+    // needs. When nearby triangles use nearby vertices, as they do once the
+    // vertices are numbered in the order the triangles first use them, most
+    // blocks need a byte or less per index.
+    //
+    // Blocks decode independently and as a whole, with no branches, so a
+    // caller that tests the triangles of a block one after the other decodes
+    // the block once.
+    class CompressedIndices
+    {
+    public:
+        static constexpr std::size_t block_size{8};
+
+        // Indices of one block, three per triangle. Entries past the last
+        // triangle of the mesh hold the smallest index of the block.
+        using Block = std::array<std::uint32_t, 3 * block_size>;
+
+        CompressedIndices() = default;
+
+        explicit CompressedIndices(std::vector<std::uint32_t> const& indices);
+
+        void decode(std::size_t block, Block& out) const
+        {
+            auto& header = m_headers[block];
+            auto data{m_data.data() + header.offset};
+            auto bits{std::uint32_t{data[0]}};
+            auto mask{(std::uint64_t{1} << bits) - 1};
+            ++data;
+
+            // An offset is at most 32 bits and starts within a byte, so a
+            // single unaligned 64-bit load holds all of it. The data is
+            // padded so that the load never runs past its end.
+            for (std::uint32_t i{0}; i < 3 * block_size; ++i)
+            {
+                auto bit{i * bits};
+                std::uint64_t word;
+                std::memcpy(&word, data + bit / 8, sizeof(std::uint64_t));
+                out[i] = header.base +
+                         static_cast<std::uint32_t>((word >> (bit % 8)) & mask);
+            }
+        }
+
+        std::size_t num_triangles() const
+        {
+            return m_num_triangles;
+        }
+
+        std::size_t num_blocks() const
+        {
+            return m_headers.size();
+        }
+
+        bool empty() const
+        {
+            return m_num_triangles == 0;
+        }
+
+        std::size_t size_bytes() const
+        {
+            return m_headers.size() * sizeof(Header) + m_data.size();
+        }
+
+    private:
+        struct Header
+        {
+            // Smallest index of the block.
+            std::uint32_t base;
+
+            // Start of the block in the data: a byte with the number of
+            // bits per offset, followed by the packed offsets.
+            std::uint32_t offset;
+        };
+
+        core::SharedArray<Header> m_headers;
+        core::SharedArray<std::uint8_t> m_data;
+        std::size_t m_num_triangles{0};
+    };
+} // namespace shapes
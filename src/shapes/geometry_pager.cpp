@@ -0,0 +1,166 @@
+#include "geometry_pager.hpp"
+
+#include <core/profiler.hpp>
+#include <core/stats.hpp>
+
+#include <algorithm>
+
+namespace shapes
+{
+    GeometryPager::GeometryPager(std::size_t budget_bytes,
+                                 Loader loader,
+                                 std::size_t num_fetch_threads) :
+        m_budget{budget_bytes},
+        m_loader{std::move(loader)},
+        m_num_fetch_threads{std::max<std::size_t>(num_fetch_threads, 1)}
+    {}
+
+    std::size_t GeometryPager::add(std::size_t size_bytes)
+    {
+        m_entries.emplace_back().size = size_bytes;
+        return m_entries.size() - 1;
+    }
+
+    std::shared_ptr<TriangleMesh const> GeometryPager::acquire(std::size_t id)
+    {
+        if (auto mesh = try_acquire(id))
+        {
+            return mesh;
+        }
+
+        // Only one thread loads a given mesh; the others wait for it.
+        auto& entry = m_entries[id];
+        std::scoped_lock load_lock{entry.load_mutex};
+        if (auto mesh = std::atomic_load(&entry.mesh))
+        {
+            core::increment_stat(core::StatCounter::geometry_page_hits);
+            return mesh;
+        }
+
+        std::shared_ptr<TriangleMesh const> mesh;
+        {
+            APOLLO_PROFILE_ZONE_ARG("geometry page in", id);
+            mesh = std::make_shared<TriangleMesh const>(m_loader(id));
+        }
+        core::increment_stat(core::StatCounter::geometry_page_misses);
+
+        std::unique_lock lock{m_mutex};
+        make_room(entry.size);
+        // Misses advance the clock by two so that hits since the last miss
+        // rank between it and the next one.
+        entry.last_use.store(m_clock += 2, std::memory_order_relaxed);
+        std::atomic_store(&entry.mesh, mesh);
+        m_resident.push_back(id);
+
+        ++m_stats.misses;
+        m_stats.bytes_loaded += entry.size;
+        m_stats.resident_bytes += entry.size;
+        m_stats.peak_resident_bytes =
+            std::max(m_stats.peak_resident_bytes, m_stats.resident_bytes);
+        lock.unlock();
+
+        advance_generation();
+        return mesh;
+    }
+
+    std::shared_ptr<TriangleMesh const>
+    GeometryPager::try_acquire(std::size_t id)
+    {
+        ASSERT(id < m_entries.size());
+        auto& entry = m_entries[id];
+        auto mesh{std::atomic_load(&entry.mesh)};
+        if (mesh)
+        {
+            entry.last_use.store(m_clock.load(std::memory_order_relaxed) + 1,
+                                 std::memory_order_relaxed);
+            core::increment_stat(core::StatCounter::geometry_page_hits);
+        }
+        return mesh;
+    }
+
+    void GeometryPager::fetch(std::size_t id)
+    {
+        ASSERT(id < m_entries.size());
+        auto& entry = m_entries[id];
+        if (is_resident(id) || entry.fetching.exchange(true))
+        {
+            return;
+        }
+
+        std::scoped_lock lock{m_mutex};
+        if (!m_fetch_pool)
+        {
+            m_fetch_pool =
+                std::make_unique<core::ThreadPool>(m_num_fetch_threads);
+        }
+
+        m_fetch_pool->submit([this, id, &entry]() {
+            try
+            {
+                acquire(id);
+            }
+            catch (...)
+            {
+            }
+            entry.fetching = false;
+            advance_generation();
+        });
+    }
+
+    void GeometryPager::wait(std::uint64_t generation) const
+    {
+        std::unique_lock lock{m_generation_mutex};
+        m_generation_changed.wait(
+            lock, [&]() { return this->generation() != generation; });
+    }
+
+    void GeometryPager::advance_generation()
+    {
+        {
+            std::scoped_lock lock{m_generation_mutex};
+            ++m_generation;
+        }
+        m_generation_changed.notify_all();
+    }
+
+    void GeometryPager::make_room(std::size_t size)
+    {
+        while (!m_resident.empty() &&
+               m_stats.resident_bytes + size > m_budget)
+        {
+            auto oldest = std::min_element(
+                m_resident.begin(),
+                m_resident.end(),
+                [this](std::size_t a, std::size_t b) {
+                    return m_entries[a].last_use.load(
+                               std::memory_order_relaxed) <
+                           m_entries[b].last_use.load(
+                               std::memory_order_relaxed);
+                });
+
+            auto& entry = m_entries[*oldest];
+            std::atomic_store(&entry.mesh,
+                              std::shared_ptr<TriangleMesh const>{});
+            m_stats.resident_bytes -= entry.size;
+            ++m_stats.evictions;
+            core::increment_stat(core::StatCounter::geometry_page_evictions);
+
+            *oldest = m_resident.back();
+            m_resident.pop_back();
+        }
+    }
+
+    bool GeometryPager::is_resident(std::size_t id) const
+    {
+        ASSERT(id < m_entries.size());
+        return std::atomic_load(&m_entries[id].mesh) != nullptr;
+    }
+
+    PagerStats GeometryPager::stats() const
+    {
+        std::scoped_lock lock{m_mutex};
+        auto stats{m_stats};
+        stats.resident_meshes = m_resident.size();
+        return stats;
+    }
+} // namespace shapes
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "triangle_mesh.hpp"
+
+#include <core/thread_pool.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace shapes
+{
+    struct PagerStats
+    {
+        std::uint64_t misses{0};
+        std::uint64_t evictions{0};
+        std::uint64_t bytes_loaded{0};
+        std::size_t resident_meshes{0};
+        std::size_t resident_bytes{0};
+        std::size_t peak_resident_bytes{0};
+    };
+
+    // Keeps a bounded set of meshes in memory and loads the others from
+    // backing storage on demand. When loading a mesh would exceed the budget,
+    // the least recently used resident meshes are evicted first.
+    //
+    // Hits take no lock: a mesh that is resident is returned after an atomic
+    // load and a timestamp update. Recency is measured in misses, which is
+    // the only time it is needed. An evicted mesh stays alive for as long as
+    // a thread still holds it, so usage can briefly exceed the budget by the
+    // meshes in flight, and a single mesh larger than the budget is still
+    // loaded on its own.
+    //
+    // Callers that cannot afford to block use try_acquire() and fetch(),
+    // which loads on the pager's own threads, and wait for generation() to
+    // change before trying again.
+    class GeometryPager
+    {
+    public:
+        // Loads mesh `id` (already built) from storage. May be called from
+        // several threads at once, for different meshes.
+        using Loader = std::function<TriangleMesh(std::size_t id)>;
+
+        // The fetch threads are only started by the first fetch().
+        GeometryPager(std::size_t budget_bytes,
+                      Loader loader,
+                      std::size_t num_fetch_threads = 2);
+
+        GeometryPager(GeometryPager const&) = delete;
+        GeometryPager& operator=(GeometryPager const&) = delete;
+
+        // Registers a mesh that occupies `size_bytes` once loaded and
+        // returns its id. Not thread-safe; meshes are added before
+        // rendering.
+        std::size_t add(std::size_t size_bytes);
+
+        // Returns mesh `id`, loading it first if it is not resident.
+        // Rethrows errors from the loader.
+        std::shared_ptr<TriangleMesh const> acquire(std::size_t id);
+
+        // Returns mesh `id` if it is resident and null otherwise.
+        std::shared_ptr<TriangleMesh const> try_acquire(std::size_t id);
+
+        // Starts loading mesh `id` in the background unless it is resident
+        // or already being fetched. Loader errors are dropped; they surface
+        // again from a later acquire().
+        void fetch(std::size_t id);
+
+        // Increases whenever a load or fetch finishes, successfully or not.
+        std::uint64_t generation() const
+        {
+            return m_generation.load(std::memory_order_acquire);
+        }
+
+        // Blocks until generation() differs from `generation`.
+        void wait(std::uint64_t generation) const;
+
+        bool is_resident(std::size_t id) const;
+
+        std::size_t budget() const
+        {
+            return m_budget;
+        }
+
+        std::size_t size() const
+        {
+            return m_entries.size();
+        }
+
+        PagerStats stats() const;
+
+    private:
+        struct Entry
+        {
+            std::size_t size{0};
+            std::shared_ptr<TriangleMesh const> mesh;
+            std::atomic<std::uint64_t> last_use{0};
+            std::atomic<bool> fetching{false};
+            std::mutex load_mutex;
+        };
+
+        void make_room(std::size_t size);
+        void advance_generation();
+
+        std::size_t m_budget;
+        Loader m_loader;
+        std::deque<Entry> m_entries;
+
+        // Guards the resident set and the statistics.
+        mutable std::mutex m_mutex;
+        std::vector<std::size_t> m_resident;
+        std::atomic<std::uint64_t> m_clock{0};
+        PagerStats m_stats;
+
+        std::atomic<std::uint64_t> m_generation{0};
+        mutable std::mutex m_generation_mutex;
+        mutable std::condition_variable m_generation_changed;
+
+        // Declared last so that pending fetches finish before anything they
+        // use is destroyed.
+        std::size_t m_num_fetch_threads;
+        std::unique_ptr<core::ThreadPool> m_fetch_pool;
+    };
+} // namespace shapes
@@ -0,0 +1,70 @@
+#include "mesh_instance.hpp"
+
+namespace shapes
+{
+    MeshInstance::MeshInstance(std::shared_ptr<TriangleMesh const> mesh,
+                               core::Transform<Real> const& object_to_world) :
+        m_mesh{std::move(mesh)},
+        m_object_to_world{object_to_world},
+        m_world_to_object{core::inverse(object_to_world)}
+    {
+        ASSERT(m_mesh != nullptr);
+    }
+
+    core::Bounds3<Real> MeshInstance::bounds() const
+    {
+        return m_object_to_world.bounds(m_mesh->bounds());
+    }
+
+    bool MeshInstance::intersect(core::Ray<Real> const& ray,
+                                 Real& t_max,
+                                 SurfaceInteraction& hit) const
+    {
+        // The object space direction is not renormalised, so t_max carries
+        // over unchanged.
+        if (!m_mesh->intersect(m_world_to_object.ray(ray), t_max, hit))
+        {
+            return false;
+        }
+
+        hit.point  = m_object_to_world.point(hit.point, hit.error, hit.error);
+        hit.normal = core::normalise(m_object_to_world.normal(hit.normal));
+        return true;
+    }
+
+    std::uint32_t MeshInstance::intersect_packet(RayPacket const& packet,
+                                                 std::uint32_t mask,
+                                                 PacketDistances& t_max,
+                                                 PacketHits& hits) const
+    {
+        auto found{m_mesh->intersect_packet(
+            m_world_to_object.ray(packet), mask, t_max, hits)};
+        for (std::size_t lane{0}; lane < max_packet_size; ++lane)
+        {
+            if (found & (std::uint32_t{1} << lane))
+            {
+                auto& hit = hits[lane];
+                hit.point =
+                    m_object_to_world.point(hit.point, hit.error, hit.error);
+                hit.normal =
+                    core::normalise(m_object_to_world.normal(hit.normal));
+            }
+        }
+
+        return found;
+    }
+
+    bool MeshInstance::occluded(core::Ray<Real> const& ray, Real t_max) const
+    {
+        return m_mesh->occluded(m_world_to_object.ray(ray), t_max);
+    }
+
+    std::uint32_t
+    MeshInstance::occluded_packet(RayPacket const& packet,
+                                  std::uint32_t mask,
+                                  PacketDistances const& t_max) const
+    {
+        return m_mesh->occluded_packet(
+            m_world_to_object.ray(packet), mask, t_max);
+    }
+} // namespace shapes
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "shape.hpp"
+#include "triangle_mesh.hpp"
+
+#include <core/transform.hpp>
+
+#include <memory>
+
+namespace shapes
+{
+    // Places a shared triangle mesh in the scene under a transform. Rays are
+    // moved into the space of the mesh instead of the other way around, so
+    // any number of instances share a single copy of the geometry and its
+    // BVH.
+    class MeshInstance : public Shape
+    {
+    public:
+        MeshInstance(std::shared_ptr<TriangleMesh const> mesh,
+                     core::Transform<Real> const& object_to_world);
+
+        core::Bounds3<Real> bounds() const override;
+
+        bool intersect(core::Ray<Real> const& ray,
+                       Real& t_max,
+                       SurfaceInteraction& hit) const override;
+
+        std::uint32_t intersect_packet(RayPacket const& packet,
+                                       std::uint32_t mask,
+                                       PacketDistances& t_max,
+                                       PacketHits& hits) const override;
+
+        bool occluded(core::Ray<Real> const& ray, Real t_max) const override;
+
+        std::uint32_t
+        occluded_packet(RayPacket const& packet,
+                        std::uint32_t mask,
+                        PacketDistances const& t_max) const override;
+
+        TriangleMesh const& mesh() const
+        {
+            return *m_mesh;
+        }
+
+        core::Transform<Real> const& transform() const
+        {
+            return m_object_to_world;
+        }
+
+    private:
+        std::shared_ptr<TriangleMesh const> m_mesh;
+        core::Transform<Real> m_object_to_world;
+        core::Transform<Real> m_world_to_object;
+    };
+} // namespace shapes
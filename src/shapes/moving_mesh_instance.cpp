@@ -0,0 +1,119 @@
+#include "moving_mesh_instance.hpp"
+
+namespace shapes
+{
+    namespace
+    {
+        // Returns true if every lane of `mask` has the time of the first,
+        // which is stored in `time`.
+        bool shared_time(RayPacket const& packet,
+                         std::uint32_t mask,
+                         Real& time)
+        {
+            bool found{false};
+            for (std::size_t lane{0}; lane < max_packet_size; ++lane)
+            {
+                if ((mask & (std::uint32_t{1} << lane)) == 0)
+                {
+                    continue;
+                }
+
+                if (!found)
+                {
+                    time  = packet.time[lane];
+                    found = true;
+                }
+                else if (packet.time[lane] != time)
+                {
+                    return false;
+                }
+            }
+
+            return found;
+        }
+    } // namespace
+
+    MovingMeshInstance::MovingMeshInstance(
+        std::shared_ptr<TriangleMesh const> mesh,
+        core::AnimatedTransform<Real> const& object_to_world) :
+        m_mesh{std::move(mesh)}, m_object_to_world{object_to_world}
+    {
+        ASSERT(m_mesh != nullptr);
+        m_bounds = m_object_to_world.motion_bounds(m_mesh->bounds());
+    }
+
+    core::Bounds3<Real> MovingMeshInstance::bounds() const
+    {
+        return m_bounds;
+    }
+
+    bool MovingMeshInstance::intersect(core::Ray<Real> const& ray,
+                                       Real& t_max,
+                                       SurfaceInteraction& hit) const
+    {
+        auto object_to_world{m_object_to_world.interpolate(ray.time)};
+        if (!m_mesh->intersect(
+                core::inverse(object_to_world).ray(ray), t_max, hit))
+        {
+            return false;
+        }
+
+        hit.point  = object_to_world.point(hit.point, hit.error, hit.error);
+        hit.normal = core::normalise(object_to_world.normal(hit.normal));
+        return true;
+    }
+
+    std::uint32_t MovingMeshInstance::intersect_packet(RayPacket const& packet,
+                                                       std::uint32_t mask,
+                                                       PacketDistances& t_max,
+                                                       PacketHits& hits) const
+    {
+        Real time{0};
+        if (!shared_time(packet, mask, time))
+        {
+            return Shape::intersect_packet(packet, mask, t_max, hits);
+        }
+
+        auto object_to_world{m_object_to_world.interpolate(time)};
+        auto found{m_mesh->intersect_packet(
+            core::inverse(object_to_world).ray(packet), mask, t_max, hits)};
+        for (std::size_t lane{0}; lane < max_packet_size; ++lane)
+        {
+            if (found & (std::uint32_t{1} << lane))
+            {
+                auto& hit = hits[lane];
+                hit.point =
+                    object_to_world.point(hit.point, hit.error, hit.error);
+                hit.normal =
+                    core::normalise(object_to_world.normal(hit.normal));
+            }
+        }
+
+        return found;
+    }
+
+    bool MovingMeshInstance::occluded(core::Ray<Real> const& ray,
+                                      Real t_max) const
+    {
+        auto world_to_object{
+            core::inverse(m_object_to_world.interpolate(ray.time))};
+        return m_mesh->occluded(world_to_object.ray(ray), t_max);
+    }
+
+    std::uint32_t
+    MovingMeshInstance::occluded_packet(RayPacket const& packet,
+                                        std::uint32_t mask,
+                                        PacketDistances const& t_max) const
+    {
+        Real time{0};
+        if (!shared_time(packet, mask, time))
+        {
+            return Shape::occluded_packet(packet, mask, t_max);
+        }
+
+        auto world_to_object{
+            core::inverse(m_object_to_world.interpolate(time))};
+        return m_mesh->occluded_packet(
+            world_to_object.ray(packet), mask, t_max);
+    }
+} // namespace shapes
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "shape.hpp"
+#include "triangle_mesh.hpp"
+
+#include <core/animated_transform.hpp>
+
+#include <memory>
+
+namespace shapes
+{
+    // MeshInstance whose transform changes over the shutter interval, for
+    // motion blur. Each ray is moved into the space of the mesh by the
+    // transform at its own time, which core::AnimatedTransform builds
+    // together with its inverse, so no matrix is inverted while rendering.
+    // The bounds enclose the mesh over the whole interval.
+    class MovingMeshInstance : public Shape
+    {
+    public:
+        MovingMeshInstance(
+            std::shared_ptr<TriangleMesh const> mesh,
+            core::AnimatedTransform<Real> const& object_to_world);
+
+        core::Bounds3<Real> bounds() const override;
+
+        bool intersect(core::Ray<Real> const& ray,
+                       Real& t_max,
+                       SurfaceInteraction& hit) const override;
+
+        // Lanes that share a time, as those of a packet taken while the
+        // shutter is closed do, are traced as a packet; the others one by
+        // one.
+        std::uint32_t intersect_packet(RayPacket const& packet,
+                                       std::uint32_t mask,
+                                       PacketDistances& t_max,
+                                       PacketHits& hits) const override;
+
+        bool occluded(core::Ray<Real> const& ray, Real t_max) const override;
+
+        std::uint32_t
+        occluded_packet(RayPacket const& packet,
+                        std::uint32_t mask,
+                        PacketDistances const& t_max) const override;
+
+        TriangleMesh const& mesh() const
+        {
+            return *m_mesh;
+        }
+
+        core::AnimatedTransform<Real> const& transform() const
+        {
+            return m_object_to_world;
+        }
+
+    private:
+        std::shared_ptr<TriangleMesh const> m_mesh;
+        core::AnimatedTransform<Real> m_object_to_world;
+        core::Bounds3<Real> m_bounds;
+    };
+} // namespace shapes
@@ -0,0 +1,82 @@
+#include "paged_mesh_instance.hpp"
+
+namespace shapes
+{
+    PagedMeshInstance::PagedMeshInstance(
+        std::shared_ptr<GeometryPager> pager,
+        std::size_t mesh,
+        core::Bounds3<Real> const& object_bounds,
+        std::size_t num_triangles,
+        core::Transform<Real> const& object_to_world) :
+        m_pager{std::move(pager)},
+        m_mesh{mesh},
+        m_num_triangles{num_triangles},
+        m_bounds{object_to_world.bounds(object_bounds)},
+        m_object_to_world{object_to_world},
+        m_world_to_object{core::inverse(object_to_world)}
+    {
+        ASSERT(m_pager != nullptr && m_mesh < m_pager->size());
+    }
+
+    bool PagedMeshInstance::intersect(core::Ray<Real> const& ray,
+                                      Real& t_max,
+                                      SurfaceInteraction& hit) const
+    {
+        // The top-level hierarchy has already tested the bounds, so the
+        // mesh is paged in right away.
+        return intersect(*m_pager->acquire(m_mesh), ray, t_max, hit);
+    }
+
+    bool PagedMeshInstance::try_intersect(core::Ray<Real> const& ray,
+                                          Real& t_max,
+                                          SurfaceInteraction& hit,
+                                          bool& resident) const
+    {
+        auto mesh{m_pager->try_acquire(m_mesh)};
+        if (!mesh)
+        {
+            m_pager->fetch(m_mesh);
+            resident = false;
+            return false;
+        }
+
+        return intersect(*mesh, ray, t_max, hit);
+    }
+
+    bool PagedMeshInstance::occluded(core::Ray<Real> const& ray,
+                                     Real t_max) const
+    {
+        auto mesh{m_pager->acquire(m_mesh)};
+        return mesh->occluded(m_world_to_object.ray(ray), t_max);
+    }
+
+    bool PagedMeshInstance::try_occluded(core::Ray<Real> const& ray,
+                                         Real t_max,
+                                         bool& resident) const
+    {
+        auto mesh{m_pager->try_acquire(m_mesh)};
+        if (!mesh)
+        {
+            m_pager->fetch(m_mesh);
+            resident = false;
+            return false;
+        }
+
+        return mesh->occluded(m_world_to_object.ray(ray), t_max);
+    }
+
+    bool PagedMeshInstance::intersect(TriangleMesh const& mesh,
+                                      core::Ray<Real> const& ray,
+                                      Real& t_max,
+                                      SurfaceInteraction& hit) const
+    {
+        if (!mesh.intersect(m_world_to_object.ray(ray), t_max, hit))
+        {
+            return false;
+        }
+
+        hit.point  = m_object_to_world.point(hit.point, hit.error, hit.error);
+        hit.normal = core::normalise(m_object_to_world.normal(hit.normal));
+        return true;
+    }
+} // namespace shapes
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "geometry_pager.hpp"
+#include "shape.hpp"
+
+#include <core/transform.hpp>
+
+#include <memory>
+
+namespace shapes
+{
+    // Instance of a mesh owned by a GeometryPager. The mesh is only loaded
+    // once a ray reaches the instance, and may be evicted again afterwards,
+    // so the bounds and triangle count are supplied up front.
+    class PagedMeshInstance : public Shape
+    {
+    public:
+        PagedMeshInstance(std::shared_ptr<GeometryPager> pager,
+                          std::size_t mesh,
+                          core::Bounds3<Real> const& object_bounds,
+                          std::size_t num_triangles,
+                          core::Transform<Real> const& object_to_world);
+
+        core::Bounds3<Real> bounds() const override
+        {
+            return m_bounds;
+        }
+
+        bool intersect(core::Ray<Real> const& ray,
+                       Real& t_max,
+                       SurfaceInteraction& hit) const override;
+
+        bool try_intersect(core::Ray<Real> const& ray,
+                           Real& t_max,
+                           SurfaceInteraction& hit,
+                           bool& resident) const override;
+
+        bool occluded(core::Ray<Real> const& ray, Real t_max) const override;
+
+        bool try_occluded(core::Ray<Real> const& ray,
+                          Real t_max,
+                          bool& resident) const override;
+
+        std::size_t mesh() const
+        {
+            return m_mesh;
+        }
+
+        std::size_t num_triangles() const
+        {
+            return m_num_triangles;
+        }
+
+        core::Transform<Real> const& transform() const
+        {
+            return m_object_to_world;
+        }
+
+        GeometryPager& pager() const
+        {
+            return *m_pager;
+        }
+
+    private:
+        bool intersect(TriangleMesh const& mesh,
+                       core::Ray<Real> const& ray,
+                       Real& t_max,
+                       SurfaceInteraction& hit) const;
+
+        std::shared_ptr<GeometryPager> m_pager;
+        std::size_t m_mesh;
+        std::size_t m_num_triangles;
+        core::Bounds3<Real> m_bounds;
+        core::Transform<Real> m_object_to_world;
+        core::Transform<Real> m_world_to_object;
+    };
+} // namespace shapes
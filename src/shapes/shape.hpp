@@ -0,0 +1,119 @@
+#pragma once
+
+#include <core/bounds.hpp>
+#include <core/ray.hpp>
+#include <core/ray_packet.hpp>
+#include <core/real.hpp>
+#include <core/vector.hpp>
+
+#include <array>
+#include <cstdint>
+
+namespace shapes
+{
+    using core::Real;
+
+    struct SurfaceInteraction
+    {
+        core::Point3<Real> point;
+
+        // Bound on the rounding error of each coordinate of `point`, which
+        // rays leaving the surface are offset by.
+        core::Vector3<Real> error;
+
+        core::Normal3<Real> normal;
+        std::uint32_t material{0};
+    };
+
+    // Packets hold up to this many rays; fewer lanes may be active.
+    constexpr std::size_t max_packet_size{16};
+
+    using RayPacket = core::RayPacket<Real, max_packet_size>;
+    using PacketDistances = std::array<Real, max_packet_size>;
+    using PacketHits = std::array<SurfaceInteraction, max_packet_size>;
+
+    class Shape
+    {
+    public:
+        virtual ~Shape() = default;
+
+        virtual core::Bounds3<Real> bounds() const = 0;
+
+        // Finds the closest hit in (0, t_max). On success `t_max` is set to
+        // the hit distance and `hit` describes the surface there.
+        virtual bool intersect(core::Ray<Real> const& ray,
+                               Real& t_max,
+                               SurfaceInteraction& hit) const = 0;
+
+        // Like intersect(), but never waits for data that is not in memory.
+        // A shape that would have to starts loading it, clears `resident`
+        // and reports no hit instead.
+        virtual bool try_intersect(core::Ray<Real> const& ray,
+                                   Real& t_max,
+                                   SurfaceInteraction& hit,
+                                   bool& resident) const
+        {
+            static_cast<void>(resident);
+            return intersect(ray, t_max, hit);
+        }
+
+        // Intersects every lane of `mask` as intersect() would on its own,
+        // with the lane's entries of `t_max` and `hits`. Returns the lanes
+        // that hit.
+        virtual std::uint32_t intersect_packet(RayPacket const& packet,
+                                               std::uint32_t mask,
+                                               PacketDistances& t_max,
+                                               PacketHits& hits) const
+        {
+            std::uint32_t found{0};
+            for (std::size_t lane{0}; lane < max_packet_size; ++lane)
+            {
+                auto bit{std::uint32_t{1} << lane};
+                if ((mask & bit) != 0 &&
+                    intersect(packet.ray(lane), t_max[lane], hits[lane]))
+                {
+                    found |= bit;
+                }
+            }
+            return found;
+        }
+
+        // Answers whether anything of the shape lies along the ray in
+        // (0, t_max), without finding the closest hit or describing the
+        // surface. Shapes that can stop at the first hit they find should
+        // override it.
+        virtual bool occluded(core::Ray<Real> const& ray, Real t_max) const
+        {
+            SurfaceInteraction hit;
+            return intersect(ray, t_max, hit);
+        }
+
+        // occluded() with the paging behaviour of try_intersect().
+        virtual bool try_occluded(core::Ray<Real> const& ray,
+                                  Real t_max,
+                                  bool& resident) const
+        {
+            static_cast<void>(resident);
+            return occluded(ray, t_max);
+        }
+
+        // occluded() for every lane of `mask`. Returns the occluded lanes.
+        virtual std::uint32_t
+        occluded_packet(RayPacket const& packet,
+                        std::uint32_t mask,
+                        PacketDistances const& t_max) const
+        {
+            std::uint32_t found{0};
+            for (std::size_t lane{0}; lane < max_packet_size; ++lane)
+            {
+                auto bit{std::uint32_t{1} << lane};
+                if ((mask & bit) != 0 &&
+                    occluded(packet.ray(lane), t_max[lane]))
+                {
+                    found |= bit;
+                }
+            }
+            return found;
+        }
+    };
+} // namespace shapes
@@ -0,0 +1,103 @@
+#include "sphere.hpp"
+
+#include <core/float_error.hpp>
+
+#include <cmath>
+#include <utility>
+
+namespace shapes
+{
+    Sphere::Sphere(core::Point3<Real> const& center,
+                   Real radius,
+                   std::uint32_t material) :
+        m_center{center}, m_radius{radius}, m_material{material}
+    {
+        ASSERT(radius > 0);
+    }
+
+    core::Bounds3<Real> Sphere::bounds() const
+    {
+        core::Vector3<Real> extent{m_radius};
+        return core::Bounds3<Real>{m_center - extent, m_center + extent};
+    }
+
+    bool Sphere::intersect(core::Ray<Real> const& ray,
+                           Real& t_max,
+                           SurfaceInteraction& hit) const
+    {
+        Real t;
+        if (!hit_distance(ray, t_max, t))
+        {
+            return false;
+        }
+
+        // The point along the ray is projected back onto the sphere, which
+        // leaves it within a few roundings of the surface whatever the
+        // error in t (Pharr et al. 2016, 3.9.4).
+        auto offset{ray(t) - m_center};
+        offset *= m_radius / core::length(offset);
+
+        t_max        = t;
+        hit.point    = m_center + offset;
+        hit.error    = core::gamma<Real>(6) * core::abs(offset) +
+                       core::gamma<Real>(1) * core::abs(hit.point);
+        hit.normal   = offset / m_radius;
+        hit.material = m_material;
+        return true;
+    }
+
+    bool Sphere::occluded(core::Ray<Real> const& ray, Real t_max) const
+    {
+        Real t;
+        return hit_distance(ray, t_max, t);
+    }
+
+    bool Sphere::hit_distance(core::Ray<Real> const& ray,
+                              Real t_max,
+                              Real& t) const
+    {
+        // Half-b form of the quadratic, which saves a few multiplications
+        // and keeps the discriminant better conditioned.
+        auto oc{ray.o - m_center};
+        auto a{core::length_squared(ray.d)};
+        auto half_b{core::dot(oc, ray.d)};
+        auto c{core::length_squared(oc) - m_radius * m_radius};
+        auto discriminant{half_b * half_b - a * c};
+        if (discriminant < 0)
+        {
+            return false;
+        }
+
+        // The root whose terms cancel is taken from the product of the
+        // roots instead, so both have a small relative error and the sign
+        // of each can be trusted near 0. Rays leaving the surface then do
+        // not find it again.
+        auto root{static_cast<Real>(std::sqrt(discriminant))};
+        auto q{(half_b < 0) ? root - half_b : -half_b - root};
+        if (q == 0)
+        {
+            // Both roots are 0: the ray grazes the surface where it starts,
+            // or has no direction. c / q would be NaN.
+            return false;
+        }
+
+        auto t0{q / a};
+        auto t1{c / q};
+        if (t0 > t1)
+        {
+            std::swap(t0, t1);
+        }
+
+        t = t0;
+        if (t <= 0 || t >= t_max)
+        {
+            t = t1;
+            if (t <= 0 || t >= t_max)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+} // namespace shapes
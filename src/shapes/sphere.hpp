@@ -0,0 +1,46 @@
+#pragma once
+
+#include "shape.hpp"
+
+namespace shapes
+{
+    class Sphere : public Shape
+    {
+    public:
+        Sphere(core::Point3<Real> const& center,
+               Real radius,
+               std::uint32_t material = 0);
+
+        core::Bounds3<Real> bounds() const override;
+
+        bool intersect(core::Ray<Real> const& ray,
+                       Real& t_max,
+                       SurfaceInteraction& hit) const override;
+
+        bool occluded(core::Ray<Real> const& ray, Real t_max) const override;
+
+        core::Point3<Real> const& center() const
+        {
+            return m_center;
+        }
+
+        Real radius() const
+        {
+            return m_radius;
+        }
+
+        std::uint32_t material() const
+        {
+            return m_material;
+        }
+
+    private:
+        // Distance to the nearest intersection in (0, t_max), if any.
+        bool
+        hit_distance(core::Ray<Real> const& ray, Real t_max, Real& t) const;
+
+        core::Point3<Real> m_center;
+        Real m_radius;
+        std::uint32_t m_material;
+    };
+} // namespace shapes
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <core/compact_vector.hpp>
+#include <core/real.hpp>
+
+#include <array>
+#include <cstdint>
+
+namespace shapes
+{
+    using core::Real;
+
+    // The triangles of a leaf of a mesh hierarchy, stored together so that
+    // testing them reads neither indices nor vertices elsewhere. Each
+    // coordinate is an array with one entry per triangle, and the edges
+    // that the intersection test needs are computed ahead of time. Groups
+    // are aligned like the nodes of a hierarchy in `float` builds (32
+    // bytes), and take 160 bytes there, the size of five nodes.
+    //
+    // Lanes past the last triangle of a leaf hold a triangle with no area,
+    // which rays never hit.
+    struct alignas(32) TriangleGroup
+    {
+        static constexpr std::size_t size{4};
+
+        using Lanes = std::array<std::array<Real, size>, 3>;
+
+        core::Point3<Real> p0(std::size_t lane) const
+        {
+            return core::Point3<Real>{
+                first[0][lane], first[1][lane], first[2][lane]};
+        }
+
+        core::Vector3<Real> e1(std::size_t lane) const
+        {
+            return core::Vector3<Real>{
+                edge1[0][lane], edge1[1][lane], edge1[2][lane]};
+        }
+
+        core::Vector3<Real> e2(std::size_t lane) const
+        {
+            return core::Vector3<Real>{
+                edge2[0][lane], edge2[1][lane], edge2[2][lane]};
+        }
+
+        // First vertex of each triangle and the edges from it to the second
+        // and third, by axis then by lane.
+        Lanes first;
+        Lanes edge1;
+        Lanes edge2;
+
+        // Triangle of the mesh in each lane.
+        std::array<std::uint32_t, size> triangles;
+    };
+
+    // TriangleGroup with the vertices stored as 16-bit fractions of the
+    // bounds of the mesh (see core::PointQuantiser), for scenes short of
+    // memory. Takes 96 bytes in every build, against 160 for a group of
+    // `float`. Vertices shared between groups decode to the same point, so
+    // the quantised mesh has no cracks. Edges are found as the group is
+    // decoded.
+    struct alignas(32) QuantisedTriangleGroup
+    {
+        static constexpr std::size_t size{TriangleGroup::size};
+
+        std::array<core::Point3<Real>, 3>
+        vertices(std::size_t lane, core::PointQuantiser<Real> const& q) const
+        {
+            std::array<core::Point3<Real>, 3> out;
+            for (std::size_t v{0}; v < 3; ++v)
+            {
+                out[v] = q.decode(core::QuantisedPoint3{{bits[v][0][lane],
+                                                          bits[v][1][lane],
+                                                          bits[v][2][lane]}});
+            }
+            return out;
+        }
+
+        TriangleGroup decode(core::PointQuantiser<Real> const& q) const
+        {
+            TriangleGroup out;
+            for (std::size_t lane{0}; lane < size; ++lane)
+            {
+                auto p{vertices(lane, q)};
+                auto e1{p[1] - p[0]};
+                auto e2{p[2] - p[0]};
+                for (std::size_t axis{0}; axis < 3; ++axis)
+                {
+                    out.first[axis][lane] = p[0][axis];
+                    out.edge1[axis][lane] = e1[axis];
+                    out.edge2[axis][lane] = e2[axis];
+                }
+            }
+            out.triangles = triangles;
+            return out;
+        }
+
+        // Quantised coordinates by vertex, axis, then lane.
+        std::array<std::array<std::array<std::uint16_t, size>, 3>, 3> bits;
+
+        std::array<std::uint32_t, size> triangles;
+    };
+
+    // Groups fill whole 32-byte blocks, so the groups of an array all start
+    // on one.
+    static_assert(sizeof(TriangleGroup) % 32 == 0);
+    static_assert(sizeof(QuantisedTriangleGroup) == 96);
+} // namespace shapes
@@ -0,0 +1,469 @@
+#include "triangle_mesh.hpp"
+
+#include <core/large_allocator.hpp>
+
+#include <limits>
+#include <stdexcept>
+
+namespace shapes
+{
+    namespace
+    {
+        // Nearest hit among the groups that hold the triangles `first` to
+        // `first + count - 1` of a leaf, as intersect_group(). `group(i)`
+        // returns group `i`. On a hit `primitive` is set to the lane of the
+        // triangle that was hit, numbered across groups.
+        template<typename GroupFetch>
+        bool intersect_groups(GroupFetch const& group,
+                              std::uint32_t first,
+                              std::uint32_t count,
+                              core::Ray<Real> const& ray,
+                              Real& t_max,
+                              std::uint32_t& primitive,
+                              Real& b1,
+                              Real& b2)
+        {
+            constexpr auto size{TriangleGroup::size};
+            bool found{false};
+            for (auto i{first / size}; i * size < first + count; ++i)
+            {
+                auto lane{intersect_group(group(i), ray, t_max, t_max, b1, b2)};
+                if (lane != size)
+                {
+                    primitive = static_cast<std::uint32_t>(i * size + lane);
+                    found     = true;
+                }
+            }
+
+            return found;
+        }
+    } // namespace
+
+    TriangleMesh::TriangleMesh(
+        std::vector<core::Point3<Real>> const& positions,
+        std::vector<std::uint32_t> indices,
+        std::uint32_t material) :
+        m_material{material}
+    {
+        if (indices.size() % 3 != 0)
+        {
+            throw std::runtime_error{
+                "error: triangle mesh index count is not a multiple of 3"};
+        }
+
+        for (auto index : indices)
+        {
+            if (index >= positions.size())
+            {
+                throw std::runtime_error{
+                    "error: triangle mesh index is out of range"};
+            }
+        }
+
+        std::array<std::vector<Real>, 3> coordinates;
+        for (auto& axis : coordinates)
+        {
+            axis.reserve(positions.size());
+        }
+
+        for (auto& p : positions)
+        {
+            for (std::size_t axis{0}; axis < 3; ++axis)
+            {
+                coordinates[axis].push_back(p[axis]);
+            }
+            m_bounds = core::bounds_union(m_bounds, p);
+        }
+
+        for (std::size_t axis{0}; axis < 3; ++axis)
+        {
+            m_coordinates[axis] =
+                core::make_large_array(std::move(coordinates[axis]));
+        }
+        m_indices = core::make_large_array(std::move(indices));
+    }
+
+    TriangleMesh::TriangleMesh(
+        std::array<core::SharedArray<Real>, 3> coordinates,
+        core::SharedArray<std::uint32_t> indices,
+        core::Bounds3<Real> const& bounds,
+        std::uint32_t material,
+        accelerators::Bvh bvh) :
+        m_coordinates{std::move(coordinates)},
+        m_indices{std::move(indices)},
+        m_bounds{bounds},
+        m_bvh{std::move(bvh)},
+        m_material{material}
+    {}
+
+    void TriangleMesh::build(accelerators::BvhBuildOptions const& options)
+    {
+        std::vector<core::Bounds3<Real>> bounds(num_triangles());
+        for (std::size_t i{0}; i < bounds.size(); ++i)
+        {
+            bounds[i] = triangle_bounds(i);
+        }
+
+        m_bvh = accelerators::Bvh{bounds, options};
+    }
+
+    void TriangleMesh::compress()
+    {
+        ASSERT(is_built());
+        ASSERT(!has_precomputed_leaves());
+        if (is_compressed() || num_triangles() == 0)
+        {
+            return;
+        }
+
+        auto order{m_bvh.make_leaves_contiguous()};
+
+        constexpr auto unused{std::numeric_limits<std::uint32_t>::max()};
+        std::vector<std::uint32_t> vertex_map(num_vertices(), unused);
+        std::vector<std::uint32_t> indices;
+        std::vector<core::Point3<Real>> positions;
+        indices.reserve(3 * order.size());
+        for (auto tri : order)
+        {
+            for (std::size_t i{0}; i < 3; ++i)
+            {
+                auto vertex{m_indices[3 * tri + i]};
+                if (vertex_map[vertex] == unused)
+                {
+                    vertex_map[vertex] =
+                        static_cast<std::uint32_t>(positions.size());
+                    positions.push_back(position(vertex));
+                }
+                indices.push_back(vertex_map[vertex]);
+            }
+        }
+
+        core::PointQuantiser<Real> quantiser{m_bounds};
+        std::array<std::vector<std::uint16_t>, 3> quantised;
+        for (auto& axis : quantised)
+        {
+            axis.reserve(positions.size());
+        }
+
+        for (auto& p : positions)
+        {
+            auto q{quantiser.encode(p)};
+            for (std::size_t axis{0}; axis < 3; ++axis)
+            {
+                quantised[axis].push_back(q.bits[axis]);
+            }
+        }
+
+        m_coordinates = {};
+        m_indices     = {};
+        for (std::size_t axis{0}; axis < 3; ++axis)
+        {
+            m_quantised[axis] =
+                core::SharedArray<std::uint16_t>{std::move(quantised[axis])};
+        }
+        m_quantiser          = quantiser;
+        m_compressed_indices = CompressedIndices{indices};
+
+        // Quantisation moves the vertices slightly, but never out of the
+        // bounds of the mesh, so only the hierarchy needs updating.
+        std::vector<core::Bounds3<Real>> bounds(num_triangles());
+        for (std::size_t i{0}; i < bounds.size(); ++i)
+        {
+            bounds[i] = triangle_bounds(i);
+        }
+        m_bvh.refit(bounds);
+    }
+
+    void TriangleMesh::precompute_leaves(LeafFormat format,
+                                         accelerators::BvhBuildOptions options)
+    {
+        ASSERT(!is_compressed());
+        if (has_precomputed_leaves() || num_triangles() == 0)
+        {
+            return;
+        }
+
+        constexpr auto size{TriangleGroup::size};
+        options.group_size = size;
+        build(options);
+
+        // Groups start out zeroed, which leaves the lanes of the padding
+        // with triangles of no area.
+        auto order{m_bvh.make_leaves_contiguous(size)};
+        VertexFetch fetch{*this};
+        if (format == LeafFormat::full)
+        {
+            std::vector<TriangleGroup> groups(order.size() / size);
+            for (std::size_t i{0}; i < order.size(); ++i)
+            {
+                auto& group = groups[i / size];
+                auto lane{i % size};
+                group.triangles[lane] = order[i];
+                if (order[i] == accelerators::Bvh::padding)
+                {
+                    continue;
+                }
+
+                auto p{fetch(order[i])};
+                auto e1{p[1] - p[0]};
+                auto e2{p[2] - p[0]};
+                for (std::size_t axis{0}; axis < 3; ++axis)
+                {
+                    group.first[axis][lane] = p[0][axis];
+                    group.edge1[axis][lane] = e1[axis];
+                    group.edge2[axis][lane] = e2[axis];
+                }
+            }
+
+            m_groups = core::make_large_array(std::move(groups));
+            return;
+        }
+
+        core::PointQuantiser<Real> quantiser{m_bounds};
+        std::vector<QuantisedTriangleGroup> groups(order.size() / size);
+        std::vector<core::Bounds3<Real>> bounds(order.size());
+        for (std::size_t i{0}; i < order.size(); ++i)
+        {
+            auto& group = groups[i / size];
+            auto lane{i % size};
+            group.triangles[lane] = order[i];
+            if (order[i] == accelerators::Bvh::padding)
+            {
+                continue;
+            }
+
+            auto p{fetch(order[i])};
+            for (std::size_t v{0}; v < 3; ++v)
+            {
+                auto q{quantiser.encode(p[v])};
+                for (std::size_t axis{0}; axis < 3; ++axis)
+                {
+                    group.bits[v][axis][lane] = q.bits[axis];
+                }
+            }
+
+            auto decoded{group.vertices(lane, quantiser)};
+            bounds[i] = core::bounds_union(
+                core::bounds_union(core::Bounds3<Real>{decoded[0]},
+                                   decoded[1]),
+                decoded[2]);
+        }
+
+        // Quantisation can move a triangle out of its leaf, though not out
+        // of the bounds of the mesh, so the hierarchy is refit around the
+        // triangles that are tested.
+        m_quantiser        = quantiser;
+        m_quantised_groups = core::make_large_array(std::move(groups));
+        m_bvh.refit(bounds);
+    }
+
+    std::size_t TriangleMesh::size_bytes() const
+    {
+        auto vertex_bytes{is_compressed() ? sizeof(std::uint16_t)
+                                          : sizeof(Real)};
+        return 3 * num_vertices() * vertex_bytes +
+               m_indices.size() * sizeof(std::uint32_t) +
+               m_compressed_indices.size_bytes() +
+               m_bvh.nodes().size() * sizeof(accelerators::BvhNode) +
+               m_bvh.indices().size() * sizeof(std::uint32_t) +
+               m_groups.size() * sizeof(TriangleGroup) +
+               m_quantised_groups.size() * sizeof(QuantisedTriangleGroup);
+    }
+
+    core::Bounds3<Real> TriangleMesh::triangle_bounds(std::size_t tri) const
+    {
+        auto p{VertexFetch{*this}(static_cast<std::uint32_t>(tri))};
+        core::Bounds3<Real> out{p[0]};
+        out = core::bounds_union(out, p[1]);
+        return core::bounds_union(out, p[2]);
+    }
+
+    bool TriangleMesh::intersect(core::Ray<Real> const& ray,
+                                 Real& t_max,
+                                 SurfaceInteraction& hit) const
+    {
+        ASSERT(is_built());
+
+        VertexFetch fetch{*this};
+        std::uint32_t hit_primitive{0};
+        Real b1{0}, b2{0};
+        bool found{false};
+        if (has_precomputed_leaves())
+        {
+            found = visit_groups([&](auto const& group) {
+                return m_bvh.intersect_leaves(
+                    ray, t_max, [&](auto first, auto count, Real& t) {
+                        return intersect_groups(
+                            group, first, count, ray, t, hit_primitive, b1, b2);
+                    });
+            });
+        }
+        else
+        {
+            found = m_bvh.intersect(ray, t_max, [&](auto tri, Real& t) {
+                auto p{fetch(tri)};
+                if (!intersect_triangle(p[0], p[1], p[2], ray, t, t, b1, b2))
+                {
+                    return false;
+                }
+
+                hit_primitive = tri;
+                return true;
+            });
+        }
+
+        if (found)
+        {
+            set_hit(primitive_vertices(fetch, hit_primitive), b1, b2, hit);
+        }
+
+        return found;
+    }
+
+    std::uint32_t TriangleMesh::intersect_packet(RayPacket const& packet,
+                                                 std::uint32_t mask,
+                                                 PacketDistances& t_max,
+                                                 PacketHits& hits) const
+    {
+        ASSERT(is_built());
+
+        VertexFetch fetch{*this};
+        std::array<std::uint32_t, max_packet_size> hit_primitives;
+        PacketDistances b1, b2;
+        auto found = m_bvh.intersect_packet(
+            packet, mask, t_max, [&](auto primitive, std::uint32_t lanes) {
+                auto hit_lanes{intersect_primitive(
+                    fetch, primitive, packet, lanes, t_max, b1, b2)};
+                for (std::size_t lane{0}; lane < max_packet_size; ++lane)
+                {
+                    if (hit_lanes & (std::uint32_t{1} << lane))
+                    {
+                        hit_primitives[lane] = primitive;
+                    }
+                }
+                return hit_lanes;
+            });
+
+        for (std::size_t lane{0}; lane < max_packet_size; ++lane)
+        {
+            if (found & (std::uint32_t{1} << lane))
+            {
+                set_hit(primitive_vertices(fetch, hit_primitives[lane]),
+                        b1[lane],
+                        b2[lane],
+                        hits[lane]);
+            }
+        }
+
+        return found;
+    }
+
+    std::array<core::Point3<Real>, 3>
+    TriangleMesh::primitive_vertices(VertexFetch& fetch,
+                                     std::uint32_t primitive) const
+    {
+        auto group{primitive / TriangleGroup::size};
+        auto lane{primitive % TriangleGroup::size};
+        if (!m_quantised_groups.empty())
+        {
+            return m_quantised_groups[group].vertices(lane, m_quantiser);
+        }
+
+        if (!m_groups.empty())
+        {
+            return fetch(m_groups[group].triangles[lane]);
+        }
+
+        return fetch(primitive);
+    }
+
+    std::uint32_t
+    TriangleMesh::intersect_primitive(VertexFetch& fetch,
+                                      std::uint32_t primitive,
+                                      RayPacket const& packet,
+                                      std::uint32_t mask,
+                                      PacketDistances& t_max,
+                                      PacketDistances& b1,
+                                      PacketDistances& b2) const
+    {
+        if (!m_groups.empty())
+        {
+            auto& group = m_groups[primitive / TriangleGroup::size];
+            auto lane{primitive % TriangleGroup::size};
+            return intersect_triangle_edges(group.p0(lane),
+                                            group.e1(lane),
+                                            group.e2(lane),
+                                            packet,
+                                            mask,
+                                            t_max,
+                                            b1,
+                                            b2);
+        }
+
+        auto p{primitive_vertices(fetch, primitive)};
+        return intersect_triangle(
+            p[0], p[1], p[2], packet, mask, t_max, b1, b2);
+    }
+
+    void TriangleMesh::set_hit(std::array<core::Point3<Real>, 3> const& p,
+                               Real b1,
+                               Real b2,
+                               SurfaceInteraction& hit) const
+    {
+        hit.point    = triangle_point(p[0], p[1], p[2], b1, b2, hit.error);
+        hit.normal   = core::normalise(core::cross(p[1] - p[0], p[2] - p[0]));
+        hit.material = m_material;
+    }
+
+    bool TriangleMesh::occluded(core::Ray<Real> const& ray, Real t_max) const
+    {
+        ASSERT(is_built());
+
+        if (has_precomputed_leaves())
+        {
+            return visit_groups([&](auto const& group) {
+                return m_bvh.occluded_leaves(
+                    ray, t_max, [&](auto first, auto count) {
+                        constexpr auto size{TriangleGroup::size};
+                        for (auto i{first / size}; i * size < first + count;
+                             ++i)
+                        {
+                            Real t, b1, b2;
+                            if (intersect_group<true>(
+                                    group(i), ray, t_max, t, b1, b2) != size)
+                            {
+                                return true;
+                            }
+                        }
+                        return false;
+                    });
+            });
+        }
+
+        VertexFetch fetch{*this};
+        return m_bvh.occluded(ray, t_max, [&](auto tri) {
+            auto p{fetch(tri)};
+            Real t;
+            return intersect_triangle(p[0], p[1], p[2], ray, t_max, t);
+        });
+    }
+
+    std::uint32_t
+    TriangleMesh::occluded_packet(RayPacket const& packet,
+                                  std::uint32_t mask,
+                                  PacketDistances const& t_max) const
+    {
+        ASSERT(is_built());
+
+        // The test shortens the distances of the lanes it hits, which is
+        // harmless as those lanes are done with.
+        VertexFetch fetch{*this};
+        auto t{t_max};
+        PacketDistances b1, b2;
+        return m_bvh.occluded_packet(
+            packet, mask, t_max, [&](auto primitive, std::uint32_t lanes) {
+                return intersect_primitive(
+                    fetch, primitive, packet, lanes, t, b1, b2);
+            });
+    }
+} // namespace shapes
@@ -0,0 +1,558 @@
+#pragma once
+
+#include "compressed_indices.hpp"
+#include "shape.hpp"
+#include "triangle_leaves.hpp"
+
+#include <accelerators/bvh.hpp>
+
+#include <core/compact_vector.hpp>
+#include <core/float_error.hpp>
+#include <core/shared_array.hpp>
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace shapes
+{
+    // Conservative check that rounding leaves no doubt about the signs of
+    // the denominator `det` and numerator `t_num` of the distance found by
+    // intersect_triangle() (bounds as in Pharr et al. 2016, 3.9). Hits that
+    // fail it are within rounding error of the ray origin or come from rays
+    // that graze the triangle, and are rejected, so that a ray leaving the
+    // triangle from an offset origin cannot find it again.
+    inline bool is_robust_triangle_hit(core::Vector3<Real> const& e1,
+                                       core::Vector3<Real> const& e2,
+                                       core::Vector3<Real> const& s,
+                                       core::Vector3<Real> const& d,
+                                       Real det,
+                                       Real t_num)
+    {
+        auto det_error{core::gamma<Real>(9) *
+                       core::dot(core::abs(e1), core::abs_cross(d, e2))};
+        auto t_error{core::gamma<Real>(9) *
+                     core::dot(core::abs(e2), core::abs_cross(s, e1))};
+        return std::abs(det) > det_error && std::abs(t_num) > t_error;
+    }
+
+    // Möller-Trumbore test against a single triangle. On a hit in (0, t_max)
+    // returns true and writes the distance and the barycentric coordinates
+    // of the hit with respect to `p1` and `p2`.
+    inline bool intersect_triangle(core::Point3<Real> const& p0,
+                                   core::Point3<Real> const& p1,
+                                   core::Point3<Real> const& p2,
+                                   core::Ray<Real> const& ray,
+                                   Real t_max,
+                                   Real& t,
+                                   Real& b1,
+                                   Real& b2)
+    {
+        auto e1{p1 - p0};
+        auto e2{p2 - p0};
+        auto p{core::cross(ray.d, e2)};
+        auto det{core::dot(e1, p)};
+        if (det == 0)
+        {
+            return false;
+        }
+
+        auto inv_det{Real{1} / det};
+        auto s{ray.o - p0};
+        auto u{core::dot(s, p) * inv_det};
+        if (u < 0 || u > 1)
+        {
+            return false;
+        }
+
+        auto q{core::cross(s, e1)};
+        auto v{core::dot(ray.d, q) * inv_det};
+        if (v < 0 || u + v > 1)
+        {
+            return false;
+        }
+
+        auto t_num{core::dot(e2, q)};
+        auto t_hit{t_num * inv_det};
+        if (t_hit <= 0 || t_hit >= t_max ||
+            !is_robust_triangle_hit(e1, e2, s, ray.d, det, t_num))
+        {
+            return false;
+        }
+
+        t  = t_hit;
+        b1 = u;
+        b2 = v;
+        return true;
+    }
+
+    // As above, for callers that only need the distance.
+    inline bool intersect_triangle(core::Point3<Real> const& p0,
+                                   core::Point3<Real> const& p1,
+                                   core::Point3<Real> const& p2,
+                                   core::Ray<Real> const& ray,
+                                   Real t_max,
+                                   Real& t)
+    {
+        Real b1, b2;
+        return intersect_triangle(p0, p1, p2, ray, t_max, t, b1, b2);
+    }
+
+    // Point of the triangle at barycentric coordinates `b1` and `b2`, along
+    // with a bound on its rounding error. Interpolating the vertices keeps
+    // the point within a few roundings of the plane of the triangle,
+    // however far along the ray it was found.
+    inline core::Point3<Real> triangle_point(core::Point3<Real> const& p0,
+                                             core::Point3<Real> const& p1,
+                                             core::Point3<Real> const& p2,
+                                             Real b1,
+                                             Real b2,
+                                             core::Vector3<Real>& error)
+    {
+        auto a0{p0 * (1 - b1 - b2)};
+        auto a1{p1 * b1};
+        auto a2{p2 * b2};
+        error = core::gamma<Real>(7) *
+                (core::abs(a0) + core::abs(a1) + core::abs(a2));
+        return a0 + a1 + a2;
+    }
+
+    // intersect_triangle() for every lane of a packet at once, with the same
+    // arithmetic so each lane gets the result it would on its own, for a
+    // triangle given by its first vertex and the edges `e1 = p1 - p0` and
+    // `e2 = p2 - p0`. Returns the lanes of `mask` that hit; their entries of
+    // `t_max`, `b1` and `b2` are set to the hit distance and barycentric
+    // coordinates.
+    template<std::size_t N>
+    std::uint32_t
+    intersect_triangle_edges(core::Point3<Real> const& p0,
+                             core::Vector3<Real> const& e1,
+                             core::Vector3<Real> const& e2,
+                             core::RayPacket<Real, N> const& packet,
+                             std::uint32_t mask,
+                             std::array<Real, N>& t_max,
+                             std::array<Real, N>& b1,
+                             std::array<Real, N>& b2)
+    {
+        auto& o_x = packet.o[0];
+        auto& o_y = packet.o[1];
+        auto& o_z = packet.o[2];
+        auto& d_x = packet.d[0];
+        auto& d_y = packet.d[1];
+        auto& d_z = packet.d[2];
+
+        // Branch free, so that the lanes are computed side by side. Lanes
+        // outside of `mask` are computed too but left unchanged.
+        constexpr auto bits{core::lane_bits<N>()};
+        std::array<Real, N> dets, t_nums, ts, us, vs;
+        std::uint32_t found{0};
+        for (std::size_t lane{0}; lane < N; ++lane)
+        {
+            auto p_x{d_y[lane] * e2[2] - d_z[lane] * e2[1]};
+            auto p_y{d_z[lane] * e2[0] - d_x[lane] * e2[2]};
+            auto p_z{d_x[lane] * e2[1] - d_y[lane] * e2[0]};
+            auto det{Real{0} + e1[0] * p_x + e1[1] * p_y + e1[2] * p_z};
+
+            auto inv_det{Real{1} / det};
+            auto s_x{o_x[lane] - p0[0]};
+            auto s_y{o_y[lane] - p0[1]};
+            auto s_z{o_z[lane] - p0[2]};
+            auto u{(Real{0} + s_x * p_x + s_y * p_y + s_z * p_z) * inv_det};
+
+            auto q_x{s_y * e1[2] - s_z * e1[1]};
+            auto q_y{s_z * e1[0] - s_x * e1[2]};
+            auto q_z{s_x * e1[1] - s_y * e1[0]};
+            auto v{(Real{0} + d_x[lane] * q_x + d_y[lane] * q_y +
+                    d_z[lane] * q_z) *
+                   inv_det};
+            auto t_num{Real{0} + e2[0] * q_x + e2[1] * q_y + e2[2] * q_z};
+            auto t{t_num * inv_det};
+
+            // The negations of the single-ray rejections, so that NaNs are
+            // treated alike.
+            auto active{mask & bits[lane]};
+            bool hit = !(det == 0) & !(u < 0) & !(u > 1) & !(v < 0) &
+                       !(u + v > 1) & !(t <= 0) & !(t >= t_max[lane]) &
+                       (active != 0);
+            dets[lane]   = det;
+            t_nums[lane] = t_num;
+            ts[lane]     = t;
+            us[lane]     = u;
+            vs[lane]     = v;
+            found |= hit ? active : 0;
+        }
+
+        // Hits are rare enough that the lanes with one are checked for
+        // robustness one at a time.
+        for (std::size_t lane{0}; found != 0 && lane < N; ++lane)
+        {
+            if ((found & bits[lane]) != 0)
+            {
+                core::Vector3<Real> s{
+                    o_x[lane] - p0[0], o_y[lane] - p0[1], o_z[lane] - p0[2]};
+                core::Vector3<Real> d{d_x[lane], d_y[lane], d_z[lane]};
+                if (!is_robust_triangle_hit(
+                        e1, e2, s, d, dets[lane], t_nums[lane]))
+                {
+                    found &= ~bits[lane];
+                }
+            }
+        }
+
+        for (std::size_t lane{0}; lane < N; ++lane)
+        {
+            auto hit{(found & bits[lane]) != 0};
+            t_max[lane] = hit ? ts[lane] : t_max[lane];
+            b1[lane]    = hit ? us[lane] : b1[lane];
+            b2[lane]    = hit ? vs[lane] : b2[lane];
+        }
+
+        return found;
+    }
+
+    // As above, for a triangle given by its vertices.
+    template<std::size_t N>
+    std::uint32_t intersect_triangle(core::Point3<Real> const& p0,
+                                     core::Point3<Real> const& p1,
+                                     core::Point3<Real> const& p2,
+                                     core::RayPacket<Real, N> const& packet,
+                                     std::uint32_t mask,
+                                     std::array<Real, N>& t_max,
+                                     std::array<Real, N>& b1,
+                                     std::array<Real, N>& b2)
+    {
+        return intersect_triangle_edges(
+            p0, p1 - p0, p2 - p0, packet, mask, t_max, b1, b2);
+    }
+
+    // Tests the ray against every triangle of the group at once, with the
+    // arithmetic of intersect_triangle(), and keeps the hits that testing
+    // the triangles one after the other would: the nearest in (0, t_max),
+    // or the first lane of those tied for it. Returns the lane of the hit,
+    // or TriangleGroup::size on a miss; on a hit `t`, `b1` and `b2` are set
+    // as by intersect_triangle(). With `any_hit` the first hit found is
+    // returned instead.
+    template<bool any_hit = false>
+    std::size_t intersect_group(TriangleGroup const& group,
+                                core::Ray<Real> const& ray,
+                                Real t_max,
+                                Real& t,
+                                Real& b1,
+                                Real& b2)
+    {
+        constexpr auto size{TriangleGroup::size};
+        auto& p0 = group.first;
+        auto& e1 = group.edge1;
+        auto& e2 = group.edge2;
+        auto& d  = ray.d;
+
+        // Branch free, so that the lanes are computed side by side.
+        std::array<Real, size> dets, t_nums, ts, us, vs;
+        std::array<bool, size> candidates;
+        for (std::size_t lane{0}; lane < size; ++lane)
+        {
+            auto p_x{d[1] * e2[2][lane] - d[2] * e2[1][lane]};
+            auto p_y{d[2] * e2[0][lane] - d[0] * e2[2][lane]};
+            auto p_z{d[0] * e2[1][lane] - d[1] * e2[0][lane]};
+            auto det{Real{0} + e1[0][lane] * p_x + e1[1][lane] * p_y +
+                     e1[2][lane] * p_z};
+
+            auto inv_det{Real{1} / det};
+            auto s_x{ray.o[0] - p0[0][lane]};
+            auto s_y{ray.o[1] - p0[1][lane]};
+            auto s_z{ray.o[2] - p0[2][lane]};
+            auto u{(Real{0} + s_x * p_x + s_y * p_y + s_z * p_z) * inv_det};
+
+            auto q_x{s_y * e1[2][lane] - s_z * e1[1][lane]};
+            auto q_y{s_z * e1[0][lane] - s_x * e1[2][lane]};
+            auto q_z{s_x * e1[1][lane] - s_y * e1[0][lane]};
+            auto v{(Real{0} + d[0] * q_x + d[1] * q_y + d[2] * q_z) *
+                   inv_det};
+            auto t_num{Real{0} + e2[0][lane] * q_x + e2[1][lane] * q_y +
+                       e2[2][lane] * q_z};
+
+            // The negations of the single-triangle rejections, so that NaNs
+            // are treated alike.
+            ts[lane]         = t_num * inv_det;
+            candidates[lane] = !(det == 0) & !(u < 0) & !(u > 1) & !(v < 0) &
+                               !(u + v > 1) & !(ts[lane] <= 0) &
+                               !(ts[lane] >= t_max);
+            dets[lane]       = det;
+            t_nums[lane]     = t_num;
+            us[lane]         = u;
+            vs[lane]         = v;
+        }
+
+        // Hits are rare enough that they are checked for robustness, and
+        // against the nearest so far, one at a time.
+        auto found{size};
+        auto nearest{t_max};
+        for (std::size_t lane{0}; lane < size; ++lane)
+        {
+            if (!candidates[lane] || ts[lane] >= nearest ||
+                !is_robust_triangle_hit(group.e1(lane),
+                                        group.e2(lane),
+                                        ray.o - group.p0(lane),
+                                        ray.d,
+                                        dets[lane],
+                                        t_nums[lane]))
+            {
+                continue;
+            }
+
+            found   = lane;
+            nearest = ts[lane];
+            if constexpr (any_hit)
+            {
+                break;
+            }
+        }
+
+        if (found != size)
+        {
+            t  = ts[found];
+            b1 = us[found];
+            b2 = vs[found];
+        }
+
+        return found;
+    }
+    // Storage of the triangles of precomputed leaves (see
+    // TriangleMesh::precompute_leaves()).
+    enum class LeafFormat
+    {
+        full,
+        quantised
+    };
+
+    // Indexed triangle mesh with its own BVH. Positions are kept as
+    // separate coordinate arrays, which is both more compact than an array
+    // of points and friendlier to streaming loads. Meshes in scenes limited
+    // by memory can be compressed once built (see compress()), and meshes
+    // that are traced often can store the triangles of each leaf together
+    // (see precompute_leaves()).
+    class TriangleMesh : public Shape
+    {
+    public:
+        TriangleMesh(std::vector<core::Point3<Real>> const& positions,
+                     std::vector<std::uint32_t> indices,
+                     std::uint32_t material = 0);
+
+        // Wraps existing vertex coordinate and index arrays, such as those
+        // mapped from a scene cache, without copying or validating them. A
+        // hierarchy built earlier may be supplied as well.
+        TriangleMesh(std::array<core::SharedArray<Real>, 3> coordinates,
+                     core::SharedArray<std::uint32_t> indices,
+                     core::Bounds3<Real> const& bounds,
+                     std::uint32_t material = 0,
+                     accelerators::Bvh bvh = {});
+
+        // Builds the BVH over the triangles. Must be called before the mesh
+        // is intersected, unless precompute_leaves() is.
+        void build(accelerators::BvhBuildOptions const& options = {});
+
+        bool is_built() const
+        {
+            return !m_bvh.empty() || num_triangles() == 0;
+        }
+
+        // Shrinks the vertices and indices of the mesh to under a third of
+        // their size; the nodes of the hierarchy are left as they are. The
+        // triangles are put in the order the leaves of the hierarchy reach
+        // them, which lets the hierarchy drop its index array, and the
+        // vertices in the order the triangles first use them, which keeps
+        // the vertices of nearby triangles close together. The indices are
+        // then stored in compressed blocks (see CompressedIndices) and the
+        // positions as 16-bit fractions of the bounds of the mesh (see
+        // core::PointQuantiser), to which the hierarchy is refit. The mesh
+        // must be built. Triangles are renumbered, and coordinates() and
+        // indices() are empty afterwards.
+        void compress();
+
+        bool is_compressed() const
+        {
+            return !m_compressed_indices.empty();
+        }
+
+        // Rebuilds the hierarchy with leaves sized for groups of triangles
+        // (see BvhBuildOptions::group_size) and copies the triangles of each
+        // leaf into groups (see TriangleGroup), so that single rays test the
+        // triangles of a leaf together, with no indices to follow and no
+        // edges to compute. The vertices and indices are kept for shading,
+        // and the groups come on top of them: about 53 bytes per triangle in
+        // `float` builds, or 32 with LeafFormat::quantised, which hits the
+        // triangles of the quantised groups instead (see
+        // QuantisedTriangleGroup). The larger leaves shrink the hierarchy,
+        // by about 25 bytes per triangle on a height field. The mesh cannot
+        // be compressed.
+        void precompute_leaves(LeafFormat format = LeafFormat::full,
+                               accelerators::BvhBuildOptions options = {});
+
+        bool has_precomputed_leaves() const
+        {
+            return !m_groups.empty() || !m_quantised_groups.empty();
+        }
+
+        core::Bounds3<Real> bounds() const override
+        {
+            return m_bounds;
+        }
+
+        bool intersect(core::Ray<Real> const& ray,
+                       Real& t_max,
+                       SurfaceInteraction& hit) const override;
+
+        std::uint32_t intersect_packet(RayPacket const& packet,
+                                       std::uint32_t mask,
+                                       PacketDistances& t_max,
+                                       PacketHits& hits) const override;
+
+        bool occluded(core::Ray<Real> const& ray, Real t_max) const override;
+
+        std::uint32_t
+        occluded_packet(RayPacket const& packet,
+                        std::uint32_t mask,
+                        PacketDistances const& t_max) const override;
+
+        std::size_t num_triangles() const
+        {
+            return is_compressed() ? m_compressed_indices.num_triangles()
+                                   : m_indices.size() / 3;
+        }
+
+        std::size_t num_vertices() const
+        {
+            return is_compressed() ? m_quantised[0].size()
+                                   : m_coordinates[0].size();
+        }
+
+        core::Point3<Real> position(std::size_t i) const
+        {
+            if (is_compressed())
+            {
+                return m_quantiser.decode(core::QuantisedPoint3{
+                    {m_quantised[0][i], m_quantised[1][i], m_quantised[2][i]}});
+            }
+
+            return core::Point3<Real>{
+                m_coordinates[0][i], m_coordinates[1][i], m_coordinates[2][i]};
+        }
+
+        // Bytes taken by the vertices, indices and hierarchy of the mesh.
+        std::size_t size_bytes() const;
+
+        // Vertex coordinates along one axis.
+        core::SharedArray<Real> const& coordinates(std::size_t axis) const
+        {
+            return m_coordinates[axis];
+        }
+
+        core::Bounds3<Real> triangle_bounds(std::size_t tri) const;
+
+        core::SharedArray<std::uint32_t> const& indices() const
+        {
+            return m_indices;
+        }
+
+        std::uint32_t material() const
+        {
+            return m_material;
+        }
+
+        accelerators::Bvh const& bvh() const
+        {
+            return m_bvh;
+        }
+
+    private:
+        // Reads the vertices of triangles. For compressed meshes the block
+        // of indices of the last triangle is kept decoded, so that the
+        // triangles of a leaf, which are consecutive, decode each of their
+        // blocks once.
+        class VertexFetch
+        {
+        public:
+            explicit VertexFetch(TriangleMesh const& mesh) : m_mesh{mesh}
+            {}
+
+            std::array<core::Point3<Real>, 3> operator()(std::uint32_t tri)
+            {
+                if (!m_mesh.is_compressed())
+                {
+                    auto& indices = m_mesh.m_indices;
+                    return {m_mesh.position(indices[3 * tri]),
+                            m_mesh.position(indices[3 * tri + 1]),
+                            m_mesh.position(indices[3 * tri + 2])};
+                }
+
+                auto block{tri / CompressedIndices::block_size};
+                if (block != m_block)
+                {
+                    m_mesh.m_compressed_indices.decode(block, m_indices);
+                    m_block = block;
+                }
+
+                auto first{3 * (tri % CompressedIndices::block_size)};
+                return {m_mesh.position(m_indices[first]),
+                        m_mesh.position(m_indices[first + 1]),
+                        m_mesh.position(m_indices[first + 2])};
+            }
+
+        private:
+            TriangleMesh const& m_mesh;
+            std::size_t m_block{std::numeric_limits<std::size_t>::max()};
+            CompressedIndices::Block m_indices;
+        };
+
+        // Calls `test(group)` with a function that returns a group of the
+        // precomputed leaves by number, decoding it if it is quantised.
+        template<typename GroupTest>
+        auto visit_groups(GroupTest&& test) const
+        {
+            if (!m_quantised_groups.empty())
+            {
+                return test([this](std::size_t i) {
+                    return m_quantised_groups[i].decode(m_quantiser);
+                });
+            }
+
+            return test([this](std::size_t i) -> TriangleGroup const& {
+                return m_groups[i];
+            });
+        }
+
+        // Vertices of primitive `primitive` of the hierarchy, which is a
+        // triangle, or a lane of a group once the leaves are precomputed.
+        std::array<core::Point3<Real>, 3>
+        primitive_vertices(VertexFetch& fetch, std::uint32_t primitive) const;
+
+        // Packet test against primitive `primitive` of the hierarchy, as
+        // intersect_triangle().
+        std::uint32_t intersect_primitive(VertexFetch& fetch,
+                                          std::uint32_t primitive,
+                                          RayPacket const& packet,
+                                          std::uint32_t mask,
+                                          PacketDistances& t_max,
+                                          PacketDistances& b1,
+                                          PacketDistances& b2) const;
+
+        // Fills in the hit at barycentric coordinates `b1` and `b2` of the
+        // triangle with vertices `p`.
+        void set_hit(std::array<core::Point3<Real>, 3> const& p,
+                     Real b1,
+                     Real b2,
+                     SurfaceInteraction& hit) const;
+
+        std::array<core::SharedArray<Real>, 3> m_coordinates;
+        core::SharedArray<std::uint32_t> m_indices;
+        std::array<core::SharedArray<std::uint16_t>, 3> m_quantised;
+        core::PointQuantiser<Real> m_quantiser;
+        CompressedIndices m_compressed_indices;
+        core::SharedArray<TriangleGroup> m_groups;
+        core::SharedArray<QuantisedTriangleGroup> m_quantised_groups;
+        core::Bounds3<Real> m_bounds;
+        accelerators::Bvh m_bvh;
+        std::uint32_t m_material;
+    };
+} // namespace shapes
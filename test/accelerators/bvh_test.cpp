@@ -0,0 +1,426 @@
+#include <accelerators/bvh.hpp>
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <random>
+
+using accelerators::Real;
+
+namespace
+{
+    struct Ball
+    {
+        core::Point3<Real> center;
+        Real radius;
+    };
+
+    bool hit_ball(Ball const& ball, core::Ray<Real> const& ray, Real& t_max)
+    {
+        auto oc{ray.o - ball.center};
+        auto b{core::dot(oc, ray.d)};
+        auto c{core::length_squared(oc) - ball.radius * ball.radius};
+        auto disc{b * b - c};
+        if (disc < 0)
+        {
+            return false;
+        }
+
+        auto t{-b - static_cast<Real>(std::sqrt(disc))};
+        if (t <= 0 || t >= t_max)
+        {
+            return false;
+        }
+
+        t_max = t;
+        return true;
+    }
+
+    std::vector<Ball> make_balls(std::size_t count)
+    {
+        std::mt19937 engine{7};
+        std::uniform_real_distribution<Real> pos{-10, 10}, rad{0.05f, 0.5f};
+        std::vector<Ball> balls;
+        for (std::size_t i{0}; i < count; ++i)
+        {
+            balls.push_back(
+                {core::Point3<Real>{pos(engine), pos(engine), pos(engine)},
+                 rad(engine)});
+        }
+
+        return balls;
+    }
+
+    std::vector<core::Bounds3<Real>> ball_bounds(std::vector<Ball> const& balls)
+    {
+        std::vector<core::Bounds3<Real>> bounds;
+        for (auto& ball : balls)
+        {
+            core::Vector3<Real> r{ball.radius};
+            bounds.emplace_back(ball.center - r, ball.center + r);
+        }
+
+        return bounds;
+    }
+
+    bool contains(core::Bounds3<Real> const& outer,
+                  core::Bounds3<Real> const& inner)
+    {
+        return core::inside(inner.p_min, outer) &&
+               core::inside(inner.p_max, outer);
+    }
+
+    // Level of the deepest node under `node`, which is at `depth`.
+    std::size_t tree_depth(accelerators::Bvh const& bvh,
+                           std::uint32_t node,
+                           std::size_t depth)
+    {
+        auto& n = bvh.nodes()[node];
+        if (n.is_leaf())
+        {
+            return depth;
+        }
+
+        return std::max(tree_depth(bvh, node + 1, depth + 1),
+                        tree_depth(bvh, n.offset, depth + 1));
+    }
+} // namespace
+
+TEST_CASE("[Bvh] - empty", "[accelerators]")
+{
+    accelerators::Bvh bvh{{}};
+    REQUIRE(bvh.empty());
+
+    core::Ray<Real> ray{core::Point3<Real>{},
+                        core::Vector3<Real>{Real{0}, Real{0}, Real{1}}};
+    auto t_max{std::numeric_limits<Real>::infinity()};
+    REQUIRE_FALSE(bvh.intersect(ray, t_max, [](auto, Real&) { return true; }));
+}
+
+TEST_CASE("[Bvh] - structure", "[accelerators]")
+{
+    auto balls{make_balls(1000)};
+    auto bounds{ball_bounds(balls)};
+    accelerators::Bvh bvh{bounds};
+
+    SECTION("Every primitive is referenced once")
+    {
+        std::vector<std::uint32_t> indices(bvh.indices().begin(),
+                                           bvh.indices().end());
+        std::sort(indices.begin(), indices.end());
+        REQUIRE(indices.size() == balls.size());
+        for (std::uint32_t i{0}; i < indices.size(); ++i)
+        {
+            REQUIRE(indices[i] == i);
+        }
+    }
+
+    SECTION("Nodes enclose their contents")
+    {
+        auto& nodes = bvh.nodes();
+        for (std::size_t i{0}; i < nodes.size(); ++i)
+        {
+            auto& node = nodes[i];
+            if (node.is_leaf())
+            {
+                REQUIRE(node.count <= accelerators::BvhBuildOptions{}
+                                          .max_leaf_size);
+                for (std::uint32_t j{0}; j < node.count; ++j)
+                {
+                    auto prim{bvh.indices()[node.offset + j]};
+                    REQUIRE(contains(node.bounds, bounds[prim]));
+                }
+            }
+            else
+            {
+                REQUIRE(contains(node.bounds, nodes[i + 1].bounds));
+                REQUIRE(contains(node.bounds, nodes[node.offset].bounds));
+            }
+        }
+    }
+}
+
+TEST_CASE("[Bvh] - degenerate input", "[accelerators]")
+{
+    // Identical boxes cannot be separated by any plane.
+    std::vector<core::Bounds3<Real>> bounds(
+        100, core::Bounds3<Real>{core::Point3<Real>{Real{0}},
+                                 core::Point3<Real>{Real{1}}});
+    accelerators::Bvh bvh{bounds};
+    REQUIRE(bvh.indices().size() == bounds.size());
+}
+
+TEST_CASE("[Bvh] - depth stays within the traversal stack", "[accelerators]")
+{
+    // Slabs at x = 3^-k, each of which the surface area heuristic splits off
+    // on its own, in front of a cluster of slabs close to x = 0 that is too
+    // large for median splits to finish in the levels that remain.
+    std::vector<core::Bounds3<Real>> bounds;
+    auto slab = [&](Real x) {
+        bounds.emplace_back(core::Point3<Real>{x, Real{-1}, Real{-1}},
+                            core::Point3<Real>{x, Real{1}, Real{1}});
+    };
+
+    Real x{1};
+    for (std::size_t i{0}; i <= 60; ++i)
+    {
+        slab(x);
+        x /= 3;
+    }
+
+    constexpr std::size_t cluster{70000};
+    for (std::size_t i{0}; i < cluster; ++i)
+    {
+        slab(x * static_cast<Real>(i) / static_cast<Real>(cluster));
+    }
+
+    accelerators::BvhBuildOptions options;
+    options.num_bins = 2;
+    accelerators::Bvh bvh{bounds, options};
+    REQUIRE(tree_depth(bvh, 0, 0) <= accelerators::Bvh::max_depth);
+
+    // The ray crosses every slab, so the traversal reaches every leaf.
+    core::Ray<Real> ray{core::Point3<Real>{Real{-1}, Real{0}, Real{0}},
+                        core::Vector3<Real>{Real{1}, Real{0}, Real{0}}};
+    std::size_t visited{0};
+    auto t_max{std::numeric_limits<Real>::infinity()};
+    bvh.intersect(ray, t_max, [&](auto, Real&) {
+        ++visited;
+        return false;
+    });
+    REQUIRE(visited == bounds.size());
+}
+
+TEST_CASE("[Bvh] - closest hit matches brute force", "[accelerators]")
+{
+    auto balls{make_balls(500)};
+    accelerators::Bvh bvh{ball_bounds(balls)};
+
+    std::mt19937 engine{11};
+    std::uniform_real_distribution<Real> dist{-1, 1};
+    for (std::size_t i{0}; i < 200; ++i)
+    {
+        core::Ray<Real> ray{
+            core::Point3<Real>{dist(engine), dist(engine), dist(engine)} *
+                Real{12},
+            core::normalise(core::Vector3<Real>{
+                dist(engine), dist(engine), dist(engine)})};
+
+        auto expected{std::numeric_limits<Real>::infinity()};
+        for (auto& ball : balls)
+        {
+            hit_ball(ball, ray, expected);
+        }
+
+        auto t_max{std::numeric_limits<Real>::infinity()};
+        auto hit = bvh.intersect(ray, t_max, [&](auto prim, Real& t) {
+            return hit_ball(balls[prim], ray, t);
+        });
+
+        REQUIRE(hit == (expected < std::numeric_limits<Real>::infinity()));
+        REQUIRE(t_max == expected);
+    }
+}
+
+TEST_CASE("[Bvh] - aligned contiguous leaves", "[accelerators]")
+{
+    auto balls{make_balls(500)};
+    accelerators::Bvh bvh{ball_bounds(balls)};
+    auto order{bvh.make_leaves_contiguous(4)};
+    REQUIRE(bvh.indices().empty());
+    REQUIRE(order.size() % 4 == 0);
+
+    SECTION("Every primitive has one place")
+    {
+        std::vector<std::uint32_t> sorted;
+        std::copy_if(order.begin(),
+                     order.end(),
+                     std::back_inserter(sorted),
+                     [](auto i) { return i != accelerators::Bvh::padding; });
+        std::sort(sorted.begin(), sorted.end());
+        REQUIRE(sorted.size() == balls.size());
+        for (std::uint32_t i{0}; i < sorted.size(); ++i)
+        {
+            REQUIRE(sorted[i] == i);
+        }
+
+        for (auto& node : bvh.nodes())
+        {
+            if (node.is_leaf())
+            {
+                REQUIRE(node.offset % 4 == 0);
+                for (std::uint32_t j{0}; j < node.count; ++j)
+                {
+                    REQUIRE(order[node.offset + j] !=
+                            accelerators::Bvh::padding);
+                }
+            }
+        }
+    }
+
+    SECTION("Whole leaves find the closest hit")
+    {
+        std::mt19937 engine{13};
+        std::uniform_real_distribution<Real> dist{-1, 1};
+        for (std::size_t i{0}; i < 200; ++i)
+        {
+            core::Ray<Real> ray{
+                core::Point3<Real>{dist(engine), dist(engine), dist(engine)} *
+                    Real{12},
+                core::normalise(core::Vector3<Real>{
+                    dist(engine), dist(engine), dist(engine)})};
+
+            auto expected{std::numeric_limits<Real>::infinity()};
+            for (auto& ball : balls)
+            {
+                hit_ball(ball, ray, expected);
+            }
+
+            auto leaf_test = [&](auto first, auto count, Real& t) {
+                bool hit{false};
+                for (auto j{first}; j < first + count; ++j)
+                {
+                    hit |= hit_ball(balls[order[j]], ray, t);
+                }
+                return hit;
+            };
+            auto t_max{std::numeric_limits<Real>::infinity()};
+            auto hit{bvh.intersect_leaves(ray, t_max, leaf_test)};
+            REQUIRE(hit == (expected < std::numeric_limits<Real>::infinity()));
+            REQUIRE(t_max == expected);
+            REQUIRE(bvh.occluded_leaves(
+                        ray, t_max, [&](auto first, auto count) {
+                            Real t{t_max};
+                            return leaf_test(first, count, t);
+                        }) == false);
+        }
+    }
+}
+
+TEST_CASE("[Bvh] - packets match single rays", "[accelerators]")
+{
+    constexpr std::size_t N{8};
+    auto balls{make_balls(500)};
+    accelerators::Bvh bvh{ball_bounds(balls)};
+
+    std::mt19937 engine{13};
+    std::uniform_real_distribution<Real> dist{-1, 1};
+    std::uniform_real_distribution<Real> spread{-0.1f, 0.1f};
+
+    // Packets of rays from a shared origin in nearly the same direction,
+    // with one lane turned around in every other packet so that the lanes
+    // disagree on their direction signs.
+    for (std::size_t i{0}; i < 50; ++i)
+    {
+        core::Point3<Real> origin{
+            core::Point3<Real>{dist(engine), dist(engine), dist(engine)} *
+            Real{12}};
+        core::Vector3<Real> centre{dist(engine), dist(engine), dist(engine)};
+
+        core::RayPacket<Real, N> packet;
+        for (std::size_t lane{0}; lane < N; ++lane)
+        {
+            core::Vector3<Real> jitter{
+                spread(engine), spread(engine), spread(engine)};
+            auto d{core::normalise(centre + jitter)};
+            auto flip{i % 2 == 1 && lane == 0};
+            packet.set(lane, core::Ray<Real>{origin, flip ? -d : d});
+        }
+
+        std::uint32_t mask{packet.full_mask() & ~std::uint32_t{4}};
+        std::array<Real, N> t_max;
+        t_max.fill(std::numeric_limits<Real>::infinity());
+        auto hits = bvh.intersect_packet(
+            packet, mask, t_max, [&](auto prim, std::uint32_t lanes) {
+                std::uint32_t hit{0};
+                for (std::size_t lane{0}; lane < N; ++lane)
+                {
+                    if ((lanes & (1u << lane)) != 0 &&
+                        hit_ball(balls[prim], packet.ray(lane), t_max[lane]))
+                    {
+                        hit |= 1u << lane;
+                    }
+                }
+                return hit;
+            });
+
+        for (std::size_t lane{0}; lane < N; ++lane)
+        {
+            auto expected{std::numeric_limits<Real>::infinity()};
+            auto hit = (mask & (1u << lane)) != 0 &&
+                       bvh.intersect(packet.ray(lane),
+                                     expected,
+                                     [&](auto prim, Real& t) {
+                                         return hit_ball(
+                                             balls[prim], packet.ray(lane), t);
+                                     });
+
+            REQUIRE(((hits & (1u << lane)) != 0) == hit);
+            REQUIRE(t_max[lane] == expected);
+        }
+    }
+}
+
+TEST_CASE("[Bvh] - occlusion matches brute force", "[accelerators]")
+{
+    constexpr std::size_t N{8};
+    auto balls{make_balls(500)};
+    accelerators::Bvh bvh{ball_bounds(balls)};
+
+    std::mt19937 engine{17};
+    std::uniform_real_distribution<Real> dist{-1, 1};
+    std::uniform_real_distribution<Real> length{0, 30};
+    for (std::size_t i{0}; i < 50; ++i)
+    {
+        core::Point3<Real> origin{
+            core::Point3<Real>{dist(engine), dist(engine), dist(engine)} *
+            Real{12}};
+
+        core::RayPacket<Real, N> packet;
+        std::array<Real, N> t_max;
+        std::uint32_t expected{0};
+        for (std::size_t lane{0}; lane < N; ++lane)
+        {
+            core::Ray<Real> ray{origin,
+                                core::normalise(core::Vector3<Real>{
+                                    dist(engine), dist(engine), dist(engine)})};
+            packet.set(lane, ray);
+            t_max[lane] = length(engine);
+
+            auto blocked{false};
+            for (auto& ball : balls)
+            {
+                auto t{t_max[lane]};
+                blocked = blocked || hit_ball(ball, ray, t);
+            }
+            expected |= blocked ? (1u << lane) : 0;
+
+            REQUIRE(bvh.occluded(ray, t_max[lane], [&](auto prim) {
+                auto t{t_max[lane]};
+                return hit_ball(balls[prim], ray, t);
+            }) == blocked);
+        }
+
+        auto occluded = bvh.occluded_packet(
+            packet,
+            packet.full_mask(),
+            t_max,
+            [&](auto prim, std::uint32_t lanes) {
+                std::uint32_t hit{0};
+                for (std::size_t lane{0}; lane < N; ++lane)
+                {
+                    auto t{t_max[lane]};
+                    if ((lanes & (1u << lane)) != 0 &&
+                        hit_ball(balls[prim], packet.ray(lane), t))
+                    {
+                        hit |= 1u << lane;
+                    }
+                }
+                return hit;
+            });
+
+        REQUIRE(occluded == expected);
+    }
+}
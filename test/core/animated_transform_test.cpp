@@ -0,0 +1,172 @@
+#include <core/animated_transform.hpp>
+
+#include <catch2/catch.hpp>
+#include <random>
+#include <stdexcept>
+
+namespace
+{
+    template<typename T>
+    bool approx_equal(core::Vector3<T> const& a, core::Vector3<T> const& b)
+    {
+        return core::length(a - b) < T{1e-4};
+    }
+} // namespace
+
+TEMPLATE_TEST_CASE("[AnimatedTransform] - interpolate", "[core]", float, double)
+{
+    using Point  = core::Point3<TestType>;
+    using Vector = core::Vector3<TestType>;
+
+    Vector axis{TestType{0}, TestType{0}, TestType{1}};
+    auto start{core::translate(Vector{TestType{1}, TestType{2}, TestType{3}}) *
+               core::scale(TestType{2}, TestType{2}, TestType{2})};
+    auto end{core::translate(Vector{TestType{5}, TestType{2}, TestType{-1}}) *
+             core::rotate(TestType{1.5}, axis) *
+             core::scale(TestType{2}, TestType{4}, TestType{2})};
+    core::AnimatedTransform<TestType> animated{
+        start, TestType{1}, end, TestType{3}};
+    REQUIRE(animated.is_animated());
+
+    Point p{TestType{1}, TestType{-1}, TestType{0.5}};
+
+    SECTION("Keyframes are exact")
+    {
+        REQUIRE(animated.interpolate(TestType{1}).m == start.m);
+        REQUIRE(animated.interpolate(TestType{3}).m == end.m);
+        REQUIRE(animated.interpolate(TestType{0}).m == start.m);
+        REQUIRE(animated.interpolate(TestType{4}).m_inv == end.m_inv);
+    }
+
+    SECTION("Components interpolate separately")
+    {
+        auto mid{
+            core::translate(Vector{TestType{3}, TestType{2}, TestType{1}}) *
+            core::rotate(TestType{0.75}, axis) *
+            core::scale(TestType{2}, TestType{3}, TestType{2})};
+        auto t{animated.interpolate(TestType{2})};
+        REQUIRE(approx_equal(t.point(p), mid.point(p)));
+    }
+
+    SECTION("Inverse matches the transform")
+    {
+        for (auto time : {TestType{1.1}, TestType{1.7}, TestType{2.9}})
+        {
+            auto t{animated.interpolate(time)};
+            REQUIRE(approx_equal(core::inverse(t).point(t.point(p)), p));
+            auto n{core::normalise(t.normal(Vector{TestType{0}, TestType{1},
+                                                   TestType{0}}))};
+            REQUIRE(core::dot(n, t.vector(Vector{TestType{1}, TestType{0},
+                                                 TestType{0}})) ==
+                    Approx(TestType{0}).margin(1e-5));
+        }
+    }
+
+    SECTION("Rays keep their time")
+    {
+        core::Ray<TestType> ray{p, axis, TestType{2}};
+        REQUIRE(animated.interpolate(ray.time).ray(ray).time == TestType{2});
+    }
+
+    SECTION("Translation only")
+    {
+        auto slide{core::translate(Vector{TestType{4}, TestType{0},
+                                          TestType{0}}) *
+                   start};
+        core::AnimatedTransform<TestType> moving{
+            start, TestType{0}, slide, TestType{1}};
+        auto t{moving.interpolate(TestType{0.25})};
+        REQUIRE(approx_equal(t.point(p),
+                             start.point(p) + Vector{TestType{1}, TestType{0},
+                                                     TestType{0}}));
+        REQUIRE(approx_equal(core::inverse(t).point(t.point(p)), p));
+    }
+
+    SECTION("Static transforms")
+    {
+        core::AnimatedTransform<TestType> fixed{end};
+        REQUIRE(!fixed.is_animated());
+        REQUIRE(fixed.interpolate(TestType{0.5}).m == end.m);
+    }
+
+    SECTION("Invalid keyframes")
+    {
+        REQUIRE_THROWS_AS((core::AnimatedTransform<TestType>{
+                              start, TestType{1}, end, TestType{1}}),
+                          std::runtime_error);
+
+        core::Transform<TestType> projective;
+        projective.m(3, 2) = TestType{1};
+        REQUIRE_THROWS_AS(
+            core::AnimatedTransform<TestType>{projective}, std::runtime_error);
+
+        auto mirrored{core::scale(TestType{-1}, TestType{1}, TestType{1}) *
+                      end};
+        REQUIRE_THROWS_AS((core::AnimatedTransform<TestType>{
+                              start, TestType{1}, mirrored, TestType{3}}),
+                          std::runtime_error);
+        REQUIRE_NOTHROW(core::AnimatedTransform<TestType>{
+            mirrored * start, TestType{1}, mirrored, TestType{3}});
+    }
+}
+
+TEMPLATE_TEST_CASE("[AnimatedTransform] - motion bounds",
+                   "[core]",
+                   float,
+                   double)
+{
+    using Point  = core::Point3<TestType>;
+    using Vector = core::Vector3<TestType>;
+
+    core::Bounds3<TestType> box{Point{TestType{-1}, TestType{0}, TestType{2}},
+                                Point{TestType{3}, TestType{1}, TestType{4}}};
+
+    SECTION("Static transforms bound as Transform does")
+    {
+        auto t{core::rotate(TestType{0.4},
+                            Vector{TestType{1}, TestType{1}, TestType{1}})};
+        auto b{core::AnimatedTransform<TestType>{t}.motion_bounds(box)};
+        auto exact{t.bounds(box)};
+        REQUIRE(core::inside(exact.p_min, b));
+        REQUIRE(core::inside(exact.p_max, b));
+        REQUIRE(core::length(b.p_min - exact.p_min) < TestType{1e-4});
+        REQUIRE(core::length(b.p_max - exact.p_max) < TestType{1e-4});
+    }
+
+    SECTION("Every point at every time is enclosed")
+    {
+        auto start{core::translate(Vector{TestType{-2}, TestType{0},
+                                          TestType{0}})};
+        auto end{
+            core::translate(Vector{TestType{2}, TestType{1}, TestType{0}}) *
+            core::rotate(TestType{3},
+                         Vector{TestType{0}, TestType{1}, TestType{1}}) *
+            core::scale(TestType{0.5}, TestType{2}, TestType{1})};
+        core::AnimatedTransform<TestType> animated{
+            start, TestType{0}, end, TestType{1}};
+        auto b{animated.motion_bounds(box)};
+
+        std::mt19937 engine{5};
+        std::uniform_real_distribution<TestType> dist;
+        auto d{core::diagonal(box)};
+        for (int i{0}; i < 10000; ++i)
+        {
+            auto t{animated.interpolate(dist(engine))};
+            Point p{box.p_min[0] + dist(engine) * d[0],
+                    box.p_min[1] + dist(engine) * d[1],
+                    box.p_min[2] + dist(engine) * d[2]};
+            REQUIRE(core::inside(t.point(p), b));
+        }
+
+        // Close to the sweep of the box rather than a loose sphere around
+        // it.
+        auto sweep{core::bounds_union(start.bounds(box), end.bounds(box))};
+        for (int i{1}; i < 100; ++i)
+        {
+            auto t{animated.interpolate(static_cast<TestType>(i) / 100)};
+            sweep = core::bounds_union(sweep, t.bounds(box));
+        }
+        REQUIRE(core::surface_area(b) <
+                core::surface_area(sweep) * TestType{1.05});
+    }
+}
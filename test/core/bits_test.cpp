@@ -0,0 +1,57 @@
+#include <core/bits.hpp>
+
+#include <catch2/catch.hpp>
+
+TEST_CASE("[bits] - reverse_bits", "[core]")
+{
+    REQUIRE(core::reverse_bits_32(0) == 0);
+    REQUIRE(core::reverse_bits_32(1) == 0x80000000);
+    REQUIRE(core::reverse_bits_32(0x0000ffff) == 0xffff0000);
+    REQUIRE(core::reverse_bits_32(0x12345678) == 0x1e6a2c48);
+
+    REQUIRE(core::reverse_bits_64(1) == 0x8000000000000000);
+    REQUIRE(core::reverse_bits_64(0x00000000ffffffff) == 0xffffffff00000000);
+}
+
+TEST_CASE("[bits] - top_bits", "[core]")
+{
+    REQUIRE(core::top_bits(0xdeadbeef, 0) == 0);
+    REQUIRE(core::top_bits(0xdeadbeef, 4) == 0xd);
+    REQUIRE(core::top_bits(0xdeadbeef, 32) == 0xdeadbeef);
+}
+
+TEST_CASE("[bits] - encode_morton_3", "[core]")
+{
+    REQUIRE(core::left_shift_3(0) == 0);
+    REQUIRE(core::left_shift_3(0b1011) == 0b001000001001);
+    REQUIRE(core::left_shift_3(0x7ff) == 0x09249249);
+
+    REQUIRE(core::encode_morton_3(1, 0, 0) == 1);
+    REQUIRE(core::encode_morton_3(0, 1, 0) == 2);
+    REQUIRE(core::encode_morton_3(0, 0, 1) == 4);
+    REQUIRE(core::encode_morton_3(3, 1, 2) == 0b101011);
+    REQUIRE(core::encode_morton_3(0x3ff, 0x3ff, 0x3ff) == 0x3fffffff);
+}
+
+TEMPLATE_TEST_CASE("[bits] - unit_from_bits", "[core]", float, double)
+{
+    SECTION("32-bit values")
+    {
+        REQUIRE(core::unit_from_bits<TestType>(std::uint32_t{0}) ==
+                TestType{0});
+        REQUIRE(core::unit_from_bits<TestType>(std::uint32_t{0x80000000}) ==
+                TestType{0.5});
+        REQUIRE(core::unit_from_bits<TestType>(std::uint32_t{0xffffffff}) <
+                TestType{1});
+    }
+
+    SECTION("64-bit values")
+    {
+        REQUIRE(core::unit_from_bits<TestType>(std::uint64_t{0}) ==
+                TestType{0});
+        REQUIRE(core::unit_from_bits<TestType>(
+                    std::uint64_t{0x8000000000000000}) == TestType{0.5});
+        REQUIRE(core::unit_from_bits<TestType>(
+                    std::uint64_t{0xffffffffffffffff}) < TestType{1});
+    }
+}
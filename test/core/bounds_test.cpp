@@ -0,0 +1,107 @@
+#include <core/bounds.hpp>
+
+#include <catch2/catch.hpp>
+#include <limits>
+
+TEMPLATE_TEST_CASE("[Bounds3] - construction", "[core]", float, double)
+{
+    using Point = core::Point3<TestType>;
+
+    SECTION("Default constructed box is empty")
+    {
+        core::Bounds3<TestType> b;
+        REQUIRE(core::is_empty(b));
+        REQUIRE(core::surface_area(b) == TestType{0});
+    }
+
+    SECTION("Corners are sorted")
+    {
+        core::Bounds3<TestType> b{Point{TestType{1}, TestType{0}, TestType{3}},
+                                  Point{TestType{0}, TestType{2}, TestType{1}}};
+        REQUIRE(b.p_min == Point{TestType{0}, TestType{0}, TestType{1}});
+        REQUIRE(b.p_max == Point{TestType{1}, TestType{2}, TestType{3}});
+    }
+}
+
+TEMPLATE_TEST_CASE("[Bounds3] - functions", "[core]", float, double)
+{
+    using Point = core::Point3<TestType>;
+
+    core::Bounds3<TestType> b{Point{TestType{0}},
+                              Point{TestType{1}, TestType{2}, TestType{4}}};
+
+    SECTION("Union with a point")
+    {
+        auto u = core::bounds_union(core::Bounds3<TestType>{},
+                                    Point{TestType{1}});
+        REQUIRE(u.p_min == Point{TestType{1}});
+        REQUIRE(u.p_max == Point{TestType{1}});
+    }
+
+    SECTION("Union with a box")
+    {
+        core::Bounds3<TestType> other{Point{TestType{-1}}, Point{TestType{1}}};
+        auto u = core::bounds_union(b, other);
+        REQUIRE(u.p_min == Point{TestType{-1}});
+        REQUIRE(u.p_max == Point{TestType{1}, TestType{2}, TestType{4}});
+    }
+
+    SECTION("Measures")
+    {
+        REQUIRE(core::surface_area(b) == TestType{28});
+        REQUIRE(core::max_extent(b) == 2);
+        REQUIRE(core::centroid(b) ==
+                Point{TestType{0.5}, TestType{1}, TestType{2}});
+        REQUIRE(core::offset(b, Point{TestType{0.5}, TestType{1}, TestType{1}})
+                == Point{TestType{0.5}, TestType{0.5}, TestType{0.25}});
+        REQUIRE(core::inside(Point{TestType{0.5}}, b));
+        REQUIRE_FALSE(core::inside(Point{TestType{-0.5}}, b));
+    }
+}
+
+TEMPLATE_TEST_CASE("[Bounds3] - intersect_p", "[core]", float, double)
+{
+    using Point  = core::Point3<TestType>;
+    using Vector = core::Vector3<TestType>;
+
+    core::Bounds3<TestType> b{Point{TestType{-1}}, Point{TestType{1}}};
+    auto test = [&b](core::Ray<TestType> const& ray, TestType t_max) {
+        Vector inv_dir{TestType{1} / ray.d[0],
+                       TestType{1} / ray.d[1],
+                       TestType{1} / ray.d[2]};
+        std::array<int, 3> neg{
+            inv_dir[0] < 0, inv_dir[1] < 0, inv_dir[2] < 0};
+        return core::intersect_p(b, ray, inv_dir, neg, t_max);
+    };
+
+    auto inf{std::numeric_limits<TestType>::infinity()};
+    Vector z{TestType{0}, TestType{0}, TestType{1}};
+
+    SECTION("Hit from outside")
+    {
+        core::Ray<TestType> ray{Point{TestType{0}, TestType{0}, TestType{-5}},
+                                z};
+        REQUIRE(test(ray, inf));
+        REQUIRE_FALSE(test(ray, TestType{3}));
+    }
+
+    SECTION("Hit from inside")
+    {
+        core::Ray<TestType> ray{Point{TestType{0}}, z};
+        REQUIRE(test(ray, inf));
+    }
+
+    SECTION("Miss")
+    {
+        core::Ray<TestType> ray{Point{TestType{2}, TestType{0}, TestType{-5}},
+                                z};
+        REQUIRE_FALSE(test(ray, inf));
+    }
+
+    SECTION("Box behind the ray")
+    {
+        core::Ray<TestType> ray{Point{TestType{0}, TestType{0}, TestType{5}},
+                                z};
+        REQUIRE_FALSE(test(ray, inf));
+    }
+}
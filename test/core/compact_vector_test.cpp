@@ -0,0 +1,154 @@
+#include <core/compact_vector.hpp>
+
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <cstdint>
+#include <random>
+
+TEST_CASE("[compact_vector] - half conversions", "[core]")
+{
+    SECTION("Every half survives a round trip")
+    {
+        for (std::uint32_t bits{0}; bits <= 0xffff; ++bits)
+        {
+            auto half{static_cast<std::uint16_t>(bits)};
+            auto value{core::half_to_float(half)};
+            if (std::isnan(value))
+            {
+                REQUIRE((bits & 0x7fff) > 0x7c00);
+                REQUIRE((core::float_to_half(value) & 0x7fff) > 0x7c00);
+            }
+            else
+            {
+                REQUIRE(core::float_to_half(value) == half);
+            }
+        }
+    }
+
+    SECTION("Known values")
+    {
+        REQUIRE(core::float_to_half(1.0f) == 0x3c00);
+        REQUIRE(core::float_to_half(-2.0f) == 0xc000);
+        REQUIRE(core::float_to_half(65504.0f) == 0x7bff);
+        REQUIRE(core::half_to_float(0x0001) == 0x1p-24f);
+    }
+
+    SECTION("Rounds to nearest even")
+    {
+        REQUIRE(core::float_to_half(1.0f + 0x1p-11f) == 0x3c00);
+        REQUIRE(core::float_to_half(1.0f + 0x3p-11f) == 0x3c02);
+        REQUIRE(core::float_to_half(0x1p-25f) == 0x0000);
+        REQUIRE(core::float_to_half(0x3p-25f) == 0x0002);
+    }
+
+    SECTION("Out of range values")
+    {
+        REQUIRE(core::float_to_half(65520.0f) == 0x7c00);
+        REQUIRE(core::float_to_half(-1e10f) == 0xfc00);
+        REQUIRE(core::float_to_half(1e-10f) == 0x0000);
+        REQUIRE(std::isinf(core::half_to_float(0x7c00)));
+    }
+}
+
+TEMPLATE_TEST_CASE("[compact_vector] - HalfVector", "[core]", float, double)
+{
+    using Vector = core::Vector3<TestType>;
+
+    REQUIRE(sizeof(core::HalfVector3) == 6);
+
+    Vector v{TestType{0.1}, TestType{-300.7}, TestType{1e-3}};
+    auto decoded{core::HalfVector3{v}.template decode<TestType>()};
+    for (std::size_t i{0}; i < 3; ++i)
+    {
+        REQUIRE(std::abs(decoded[i] - v[i]) <= std::abs(v[i]) * 0x1p-11);
+    }
+}
+
+TEMPLATE_TEST_CASE("[compact_vector] - OctNormal", "[core]", float, double)
+{
+    using Normal = core::Normal3<TestType>;
+
+    REQUIRE(sizeof(core::OctNormal) == 4);
+
+    // 0.003 degrees.
+    constexpr TestType max_error{5.3e-5};
+
+    SECTION("Axes are exact")
+    {
+        for (std::size_t axis{0}; axis < 3; ++axis)
+        {
+            for (TestType sign : {TestType{1}, TestType{-1}})
+            {
+                Normal n{TestType{0}};
+                n[axis] = sign;
+                REQUIRE(core::OctNormal{n}.template decode<TestType>() == n);
+            }
+        }
+    }
+
+    SECTION("Random directions")
+    {
+        std::mt19937 engine{11};
+        std::normal_distribution<TestType> dist;
+        for (int i{0}; i < 10000; ++i)
+        {
+            auto n{core::normalise(
+                Normal{dist(engine), dist(engine), dist(engine)})};
+            auto decoded{core::OctNormal{n}.template decode<TestType>()};
+            REQUIRE(core::length(decoded) ==
+                    Approx(TestType{1}).epsilon(max_error));
+            REQUIRE(core::length(decoded - n) < max_error);
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE("[compact_vector] - PointQuantiser", "[core]", float, double)
+{
+    using Point = core::Point3<TestType>;
+
+    core::Bounds3<TestType> bounds{
+        Point{TestType{1000}, TestType{-2}, TestType{5}},
+        Point{TestType{1010}, TestType{3}, TestType{5}}};
+    core::PointQuantiser<TestType> quantiser{bounds};
+    auto& error = quantiser.error();
+
+    SECTION("Corners are exact")
+    {
+        REQUIRE(quantiser.decode(quantiser.encode(bounds.p_min)) ==
+                bounds.p_min);
+        auto q{quantiser.encode(bounds.p_max)};
+        REQUIRE(core::inside(quantiser.decode(q), bounds));
+        REQUIRE(q.bits[0] == 65535);
+        REQUIRE(q.bits[1] == 65535);
+        REQUIRE(q.bits[2] == 0);
+    }
+
+    SECTION("Decoded points are within the error bound")
+    {
+        std::mt19937 engine{3};
+        std::uniform_real_distribution<TestType> dist;
+        auto d{core::diagonal(bounds)};
+        for (int i{0}; i < 10000; ++i)
+        {
+            Point p{bounds.p_min[0] + dist(engine) * d[0],
+                    bounds.p_min[1] + dist(engine) * d[1],
+                    bounds.p_min[2]};
+            auto decoded{quantiser.decode(quantiser.encode(p))};
+            for (std::size_t axis{0}; axis < 3; ++axis)
+            {
+                REQUIRE(std::abs(decoded[axis] - p[axis]) <= error[axis]);
+            }
+            REQUIRE(core::inside(decoded, bounds));
+        }
+
+        REQUIRE(error[0] < d[0] * TestType{1e-4});
+        REQUIRE(error[1] < d[1] * TestType{1e-4});
+    }
+
+    SECTION("Points outside the box are clamped")
+    {
+        auto q{quantiser.encode(Point{TestType{2000}, TestType{-9}, 0})};
+        REQUIRE(q.bits[0] == 65535);
+        REQUIRE(q.bits[1] == 0);
+    }
+}
@@ -0,0 +1,63 @@
+#include <core/float_error.hpp>
+
+#include <catch2/catch.hpp>
+#include <limits>
+
+TEMPLATE_TEST_CASE("[float_error] - gamma", "[core]", float, double)
+{
+    auto eps{core::machine_epsilon<TestType>()};
+    REQUIRE(eps == std::numeric_limits<TestType>::epsilon() / 2);
+    REQUIRE(core::gamma<TestType>(0) == TestType{0});
+    REQUIRE(core::gamma<TestType>(1) > eps);
+    REQUIRE(core::gamma<TestType>(3) > 3 * eps);
+    REQUIRE(core::gamma<TestType>(3) < 4 * eps);
+}
+
+TEMPLATE_TEST_CASE("[float_error] - next_float", "[core]", float, double)
+{
+    TestType one{1};
+    REQUIRE(core::next_float_up(one) ==
+            one + std::numeric_limits<TestType>::epsilon());
+    REQUIRE(core::next_float_down(core::next_float_up(one)) == one);
+    REQUIRE(core::next_float_up(TestType{-0.0}) > TestType{0});
+    REQUIRE(core::next_float_down(TestType{0}) < TestType{0});
+}
+
+TEMPLATE_TEST_CASE("[float_error] - offset_ray_origin", "[core]", float, double)
+{
+    using Point  = core::Point3<TestType>;
+    using Vector = core::Vector3<TestType>;
+
+    Point p{TestType{1000}, TestType{-2}, TestType{0.5}};
+    Vector error{TestType{0.001}, TestType{0.002}, TestType{0}};
+
+    SECTION("Moves past the error box along the normal")
+    {
+        Vector n{TestType{0}, TestType{-1}, TestType{0}};
+        auto o{core::offset_ray_origin(p, error, n)};
+        REQUIRE(o[0] == p[0]);
+        REQUIRE(o[1] < p[1] - error[1]);
+        REQUIRE(o[2] == p[2]);
+    }
+
+    SECTION("Diagonal normals move every axis")
+    {
+        auto n{core::normalise(Vector{TestType{1}, TestType{1}, TestType{1}})};
+        auto o{core::offset_ray_origin(p, error, n)};
+        auto d{core::dot(core::abs(n), error)};
+        for (std::size_t i{0}; i < 3; ++i)
+        {
+            REQUIRE(o[i] > p[i]);
+            REQUIRE(o[i] >= p[i] + n[i] * d);
+        }
+    }
+
+    SECTION("No error leaves the point in place up to rounding")
+    {
+        Vector n{TestType{0}, TestType{0}, TestType{1}};
+        auto o{core::offset_ray_origin(p, Vector{TestType{0}}, n)};
+        REQUIRE(o[0] == p[0]);
+        REQUIRE(o[1] == p[1]);
+        REQUIRE(o[2] == p[2]);
+    }
+}
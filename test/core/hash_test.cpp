@@ -0,0 +1,27 @@
+#include <core/hash.hpp>
+
+#include <catch2/catch.hpp>
+
+TEST_CASE("[hash] - mix_bits", "[core]")
+{
+    REQUIRE(core::mix_bits(0) == 0);
+    REQUIRE(core::mix_bits(1) != core::mix_bits(2));
+}
+
+TEST_CASE("[hash] - hash", "[core]")
+{
+    SECTION("Deterministic")
+    {
+        REQUIRE(core::hash(1, 2, 3) == core::hash(1, 2, 3));
+    }
+
+    SECTION("Order dependent")
+    {
+        REQUIRE(core::hash(1, 2, 3) != core::hash(3, 2, 1));
+    }
+
+    SECTION("Type dependent")
+    {
+        REQUIRE(core::hash(1) != core::hash(std::uint64_t{1}));
+    }
+}
@@ -0,0 +1,151 @@
+#include <core/large_allocator.hpp>
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#if defined(__linux__)
+#    include <sys/mman.h>
+#    include <unistd.h>
+#endif
+
+TEST_CASE("[LargeAllocation] - allocate_large", "[core]")
+{
+    auto pages = GENERATE(core::PagePolicy::standard,
+                          core::PagePolicy::transparent_huge,
+                          core::PagePolicy::explicit_huge);
+    auto numa  = GENERATE(core::NumaPolicy::local,
+                         core::NumaPolicy::interleave,
+                         core::NumaPolicy::bind);
+
+    constexpr std::size_t size{3 * core::huge_page_size + 17};
+    auto allocation = core::allocate_large(size, {pages, numa, 0});
+
+    REQUIRE(allocation.ptr != nullptr);
+    REQUIRE(allocation.size >= size);
+    REQUIRE(static_cast<int>(allocation.pages) <= static_cast<int>(pages));
+    REQUIRE(reinterpret_cast<std::uintptr_t>(allocation.ptr) % 4096 == 0);
+
+    auto bytes = static_cast<unsigned char*>(allocation.ptr);
+    REQUIRE(bytes[0] == 0);
+    REQUIRE(bytes[size - 1] == 0);
+    bytes[0]        = 1;
+    bytes[size - 1] = 2;
+    REQUIRE(bytes[0] == 1);
+    REQUIRE(bytes[size - 1] == 2);
+
+    core::free_large(allocation);
+}
+
+TEST_CASE("[LargeBuffer] - construction", "[core]")
+{
+    SECTION("Empty buffer")
+    {
+        core::LargeBuffer<float> buffer;
+        REQUIRE(buffer.empty());
+        REQUIRE(buffer.data() == nullptr);
+    }
+
+    SECTION("Sized buffer")
+    {
+        core::LargeBuffer<float> buffer{1000};
+        REQUIRE(buffer.size() == 1000);
+        REQUIRE(std::all_of(
+            buffer.begin(), buffer.end(), [](float v) { return v == 0.0f; }));
+
+        std::iota(buffer.begin(), buffer.end(), 0.0f);
+        REQUIRE(buffer[999] == 999.0f);
+    }
+
+    SECTION("Move")
+    {
+        core::LargeBuffer<int> a{10};
+        a[3] = 42;
+        core::LargeBuffer<int> b{std::move(a)};
+        REQUIRE(a.empty());
+        REQUIRE(b[3] == 42);
+
+        core::LargeBuffer<int> c;
+        c = std::move(b);
+        REQUIRE(c[3] == 42);
+    }
+}
+
+#if defined(__linux__)
+TEST_CASE("[LargeBuffer] - first touch", "[core]")
+{
+    // Pages of the buffer that have been faulted in.
+    auto resident = [](void const* ptr, std::size_t size) {
+        auto page_size{static_cast<std::size_t>(sysconf(_SC_PAGESIZE))};
+        std::vector<unsigned char> pages((size + page_size - 1) / page_size);
+        REQUIRE(mincore(const_cast<void*>(ptr), size, pages.data()) == 0);
+        return std::count_if(pages.begin(), pages.end(), [](auto page) {
+            return (page & 1) != 0;
+        });
+    };
+
+    core::AllocationPolicy policy{core::PagePolicy::standard,
+                                  core::NumaPolicy::local};
+
+    SECTION("Trivial types are left untouched")
+    {
+        constexpr std::size_t count{core::huge_page_size / sizeof(float)};
+        core::LargeBuffer<float> buffer{count, policy};
+        REQUIRE(resident(buffer.data(), count * sizeof(float)) == 0);
+
+        buffer[0] = 1.0f;
+        REQUIRE(resident(buffer.data(), count * sizeof(float)) == 1);
+    }
+
+    SECTION("Other types are constructed")
+    {
+        struct Marked
+        {
+            int value{7};
+        };
+
+        core::LargeBuffer<Marked> buffer{1000, policy};
+        REQUIRE(std::all_of(buffer.begin(), buffer.end(), [](auto& m) {
+            return m.value == 7;
+        }));
+    }
+}
+#endif
+
+TEST_CASE("[LargeBuffer] - make_large_array", "[core]")
+{
+    auto size = GENERATE(std::size_t{100}, core::huge_page_size);
+    std::vector<std::uint32_t> values(size);
+    std::iota(values.begin(), values.end(), 0u);
+
+    auto array{core::make_large_array(values)};
+    REQUIRE(array.size() == values.size());
+    REQUIRE(std::equal(array.begin(), array.end(), values.begin()));
+
+    // Arrays of a huge page or more are copied into page-aligned memory.
+    if (size * sizeof(std::uint32_t) >= core::huge_page_size)
+    {
+        REQUIRE(reinterpret_cast<std::uintptr_t>(array.data()) % 4096 == 0);
+    }
+}
+
+TEST_CASE("[ReplicatedBuffer] - replicas", "[core]")
+{
+    std::vector<int> source(5000);
+    std::iota(source.begin(), source.end(), 0);
+
+    core::ReplicatedBuffer<int> buffer{source.data(), source.size()};
+    REQUIRE(buffer.num_replicas() == core::numa_nodes().size());
+
+    auto& local = buffer.local();
+    REQUIRE(local.size() == source.size());
+    REQUIRE(std::equal(local.begin(), local.end(), source.begin()));
+
+    for (auto& node : core::numa_nodes())
+    {
+        auto& replica = buffer.replica(node.id);
+        REQUIRE(std::equal(replica.begin(), replica.end(), source.begin()));
+    }
+}
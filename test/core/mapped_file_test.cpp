@@ -0,0 +1,80 @@
+#include <core/mapped_file.hpp>
+#include <core/shared_array.hpp>
+
+#include <catch2/catch.hpp>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+
+TEST_CASE("[MappedFile] - contents", "[core]")
+{
+    std::string path{"apollo_mapped_file_test.bin"};
+
+    SECTION("Non-empty files")
+    {
+        {
+            std::ofstream file{path, std::ios::binary};
+            file << "apollo";
+        }
+
+        core::MappedFile file{path};
+        REQUIRE(file.size() == 6);
+        REQUIRE(std::string(reinterpret_cast<char const*>(file.data()),
+                            file.size()) == "apollo");
+
+        file.prefetch();
+        REQUIRE(file.data()[5] == 'o');
+    }
+
+    SECTION("Empty files")
+    {
+        {
+            std::ofstream file{path, std::ios::binary};
+        }
+
+        core::MappedFile file{path};
+        REQUIRE(file.size() == 0);
+        file.prefetch();
+    }
+
+    SECTION("Missing files")
+    {
+        REQUIRE_THROWS_AS(core::MappedFile{"apollo_missing_file.bin"},
+                          std::runtime_error);
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST_CASE("[SharedArray] - ownership", "[core]")
+{
+    SECTION("Owned values")
+    {
+        core::SharedArray<int> values{std::vector<int>{1, 2, 3}};
+        auto copy{values};
+        REQUIRE(copy.data() == values.data());
+        REQUIRE(copy.size() == 3);
+        REQUIRE(copy.front() == 1);
+        REQUIRE(copy.back() == 3);
+        REQUIRE(std::vector<int>(copy.begin(), copy.end()) ==
+                std::vector<int>{1, 2, 3});
+    }
+
+    SECTION("External storage")
+    {
+        auto storage = std::make_shared<std::vector<int>>(4, 7);
+        core::SharedArray<int> values{
+            storage->data() + 1, 2, std::shared_ptr<void const>{storage}};
+        std::weak_ptr<std::vector<int>> weak{storage};
+        storage.reset();
+
+        REQUIRE_FALSE(weak.expired());
+        REQUIRE(values.size() == 2);
+        REQUIRE(values[1] == 7);
+
+        values = {};
+        REQUIRE(values.empty());
+        REQUIRE(weak.expired());
+    }
+}
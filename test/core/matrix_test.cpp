@@ -108,6 +108,22 @@ TEMPLATE_TEST_CASE("[Matrix] - vector accessors", "[core]", float, double)
             REQUIRE(col == expected[i]);
         }
     }
+
+    SECTION("Column of non-symmetric matrix")
+    {
+        // clang-format off
+        core::Matrix<TestType> a{
+            TestType{1},  TestType{2},  TestType{3},  TestType{4},
+            TestType{5},  TestType{6},  TestType{7},  TestType{8},
+            TestType{9},  TestType{10}, TestType{11}, TestType{12},
+            TestType{13}, TestType{14}, TestType{15}, TestType{16}};
+        // clang-format on
+
+        auto col = a.col(1);
+        REQUIRE(col ==
+                core::Vector<TestType, 4>{
+                    TestType{2}, TestType{6}, TestType{10}, TestType{14}});
+    }
 }
 
 TEMPLATE_TEST_CASE("[Matrix] - operator()", "[core]", float, double)
@@ -398,6 +414,28 @@ TEMPLATE_TEST_CASE("[Matrix] - operator*", "[core]", float, double)
             REQUIRE(result.data[i] == TestType{8});
         }
     }
+
+    SECTION("Non-symmetric matrix * matrix")
+    {
+        // clang-format off
+        core::Matrix<TestType> a{
+            TestType{1}, TestType{2}, TestType{0}, TestType{0},
+            TestType{0}, TestType{1}, TestType{0}, TestType{0},
+            TestType{0}, TestType{0}, TestType{1}, TestType{0},
+            TestType{0}, TestType{0}, TestType{0}, TestType{1}};
+        core::Matrix<TestType> b{
+            TestType{1}, TestType{0}, TestType{0}, TestType{3},
+            TestType{0}, TestType{1}, TestType{0}, TestType{0},
+            TestType{0}, TestType{0}, TestType{1}, TestType{0},
+            TestType{0}, TestType{0}, TestType{0}, TestType{1}};
+        // clang-format on
+
+        auto result = a * b;
+
+        REQUIRE(result(0, 1) == TestType{2});
+        REQUIRE(result(0, 3) == TestType{3});
+        REQUIRE(result(1, 0) == TestType{0});
+    }
 }
 
 TEMPLATE_TEST_CASE("[Matrix] - transpose", "[core]", float, double)
@@ -0,0 +1,106 @@
+#include <core/memory_arena.hpp>
+
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <thread>
+
+namespace
+{
+    struct HitRecord
+    {
+        float t;
+        int id;
+    };
+} // namespace
+
+TEST_CASE("[MemoryArena] - allocate", "[core]")
+{
+    core::MemoryArena arena{1024};
+
+    SECTION("Alignment")
+    {
+        arena.allocate(1, 1);
+        for (std::size_t align : {2, 4, 8, 16, 32, 64})
+        {
+            auto ptr = arena.allocate(3, align);
+            REQUIRE(reinterpret_cast<std::uintptr_t>(ptr) % align == 0);
+        }
+    }
+
+    SECTION("Blocks are cache-line aligned")
+    {
+        auto ptr = arena.allocate(8, 1);
+        REQUIRE(reinterpret_cast<std::uintptr_t>(ptr) %
+                    core::cache_line_size ==
+                0);
+    }
+
+    SECTION("Allocations larger than a block")
+    {
+        auto ptr = static_cast<char*>(arena.allocate(4096));
+        ptr[4095] = 'a';
+        REQUIRE(arena.bytes_in_use() >= 4096);
+        REQUIRE(arena.bytes_reserved() >= 1024 + 4096);
+    }
+}
+
+TEST_CASE("[MemoryArena] - alloc", "[core]")
+{
+    core::MemoryArena arena;
+
+    auto rec = arena.alloc<HitRecord>(1.0f, 3);
+    REQUIRE(rec->t == 1.0f);
+    REQUIRE(rec->id == 3);
+
+    auto values = arena.alloc_array<int>(16);
+    for (std::size_t i{0}; i < 16; ++i)
+    {
+        REQUIRE(values[i] == 0);
+    }
+}
+
+TEST_CASE("[MemoryArena] - reset", "[core]")
+{
+    core::MemoryArena arena{1024};
+
+    auto first = arena.allocate(100);
+    for (int i{0}; i < 10; ++i)
+    {
+        arena.allocate(500);
+    }
+
+    auto reserved{arena.bytes_reserved()};
+    auto high_water{arena.high_water_mark()};
+    REQUIRE(high_water >= 100 + 10 * 500);
+
+    arena.reset();
+    REQUIRE(arena.bytes_in_use() == 0);
+    REQUIRE(arena.high_water_mark() == high_water);
+
+    // The same pattern of allocations must reuse the existing blocks.
+    REQUIRE(arena.allocate(100) == first);
+    for (int i{0}; i < 10; ++i)
+    {
+        arena.allocate(500);
+    }
+    REQUIRE(arena.bytes_reserved() == reserved);
+    REQUIRE(core::MemoryArena::global_high_water_mark() >= high_water);
+}
+
+TEST_CASE("[MemoryArena] - thread_arena", "[core]")
+{
+    auto& arena = core::thread_arena();
+    REQUIRE(&arena == &core::thread_arena());
+
+    core::MemoryArena* other{nullptr};
+    std::thread thread{[&other]() { other = &core::thread_arena(); }};
+    thread.join();
+    REQUIRE(other != &arena);
+
+    {
+        core::ArenaScope scope;
+        arena.allocate(64);
+        REQUIRE(arena.bytes_in_use() >= 64);
+    }
+    REQUIRE(arena.bytes_in_use() == 0);
+}
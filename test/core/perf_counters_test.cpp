@@ -0,0 +1,69 @@
+#include <core/perf_counters.hpp>
+
+#include <catch2/catch.hpp>
+#include <string>
+
+TEST_CASE("[perf_counters] - values", "[core]")
+{
+    core::PerfCounterValues start, end;
+    start.mask = end.mask = (1u << core::num_perf_counters) - 1;
+    start.values = {100, 50, 7, 3, 1};
+    end.values   = {300, 450, 17, 5, 1};
+
+    auto delta{end - start};
+    REQUIRE(delta[core::PerfCounter::cycles] == 200);
+    REQUIRE(delta[core::PerfCounter::instructions] == 400);
+    REQUIRE(delta[core::PerfCounter::l1d_misses] == 10);
+    REQUIRE(delta[core::PerfCounter::branch_misses] == 0);
+    REQUIRE(delta.ipc() == Approx(2.0));
+
+    core::PerfCounterValues total;
+    REQUIRE(total.empty());
+    total += delta;
+    total += delta;
+    REQUIRE(total[core::PerfCounter::cycles] == 400);
+    REQUIRE(total.mask == delta.mask);
+
+    // Counters missing from either side are dropped.
+    core::PerfCounterValues partial;
+    partial.mask = 1u << static_cast<std::size_t>(core::PerfCounter::cycles);
+    partial.values[0] = 10;
+    total += partial;
+    REQUIRE(total.has(core::PerfCounter::cycles));
+    REQUIRE(!total.has(core::PerfCounter::instructions));
+    REQUIRE(total.ipc() == 0.0);
+
+    auto json{core::perf_counters_to_json(delta)};
+    REQUIRE(json.find("\"cycles\": 200") != std::string::npos);
+    REQUIRE(json.find("\"ipc\": 2") != std::string::npos);
+    REQUIRE(core::perf_counters_to_json({}) == "{}");
+}
+
+TEST_CASE("[perf_counters] - group", "[core]")
+{
+    auto& group = core::thread_perf_counters();
+    REQUIRE(group.available() == core::perf_counters_supported());
+
+    auto start{group.read()};
+    volatile std::uint64_t sum{0};
+    for (std::uint64_t i{0}; i < 100000; ++i)
+    {
+        sum = sum + i;
+    }
+    auto delta{group.read() - start};
+
+    if (group.available())
+    {
+        REQUIRE(!delta.empty());
+        if (delta.has(core::PerfCounter::instructions))
+        {
+            REQUIRE(delta[core::PerfCounter::instructions] > 100000);
+        }
+    }
+    else
+    {
+        // Without counters reads are empty and the harness falls back to
+        // timings.
+        REQUIRE(delta.empty());
+    }
+}
@@ -0,0 +1,142 @@
+#include <core/profiler.hpp>
+
+#include <catch2/catch.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    core::ThreadTrace const* find_trace(std::vector<core::ThreadTrace> const&
+                                            traces,
+                                        std::string const& name)
+    {
+        for (auto& trace : traces)
+        {
+            if (trace.name == name)
+            {
+                return &trace;
+            }
+        }
+
+        return nullptr;
+    }
+} // namespace
+
+TEST_CASE("[profiler] - zones", "[core]")
+{
+    core::reset_profile();
+
+    std::vector<std::thread> threads;
+    for (int t{0}; t < 3; ++t)
+    {
+        threads.emplace_back([t]() {
+            core::set_profile_thread_name("worker " + std::to_string(t));
+            core::ProfileZone outer{"outer"};
+            for (int i{0}; i < 10; ++i)
+            {
+                core::ProfileZone zone{"tile", i};
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    {
+        core::ProfileZone zone{"main"};
+    }
+
+    auto traces{core::collect_profile()};
+    for (int t{0}; t < 3; ++t)
+    {
+        auto trace = find_trace(traces, "worker " + std::to_string(t));
+        REQUIRE(trace != nullptr);
+        REQUIRE(trace->events.size() == 11);
+        REQUIRE(trace->dropped == 0);
+
+        // Nested zones finish first.
+        REQUIRE(std::string{trace->events.front().name} == "tile");
+        REQUIRE(trace->events.front().arg == 0);
+        REQUIRE(std::string{trace->events.back().name} == "outer");
+        REQUIRE(trace->events.back().arg == -1);
+        REQUIRE(trace->events.back().start_ns <=
+                trace->events.front().start_ns);
+        REQUIRE(trace->events.back().end_ns >= trace->events[9].end_ns);
+    }
+
+    bool found_main{false};
+    for (auto& trace : traces)
+    {
+        for (auto& event : trace.events)
+        {
+            found_main = found_main || std::string{event.name} == "main";
+        }
+    }
+    REQUIRE(found_main);
+
+    core::reset_profile();
+    REQUIRE(core::collect_profile().empty());
+}
+
+TEST_CASE("[profiler] - ring buffer", "[core]")
+{
+    core::reset_profile();
+
+    std::thread thread{[]() {
+        core::set_profile_thread_name("busy");
+        for (std::size_t i{0}; i < core::profile_buffer_size + 5; ++i)
+        {
+            core::ProfileZone zone{"zone", static_cast<std::int64_t>(i)};
+        }
+    }};
+    thread.join();
+
+    auto traces{core::collect_profile()};
+    auto trace = find_trace(traces, "busy");
+    REQUIRE(trace != nullptr);
+    REQUIRE(trace->events.size() == core::profile_buffer_size);
+    REQUIRE(trace->dropped == 5);
+    REQUIRE(trace->events.front().arg == 5);
+    REQUIRE(trace->events.back().arg ==
+            static_cast<std::int64_t>(core::profile_buffer_size + 4));
+}
+
+TEST_CASE("[profiler] - chrome json", "[core]")
+{
+    core::ThreadTrace trace;
+    trace.thread_id = 3;
+    trace.name      = "render \"worker\"";
+    trace.events.push_back({"render tile", 2000, 5000, 7});
+    trace.events.push_back({"image write", 1000, 1500, -1});
+
+    auto json{core::profile_to_chrome_json({trace})};
+    REQUIRE(json.find("\"traceEvents\"") != std::string::npos);
+    REQUIRE(json.find("render \\\"worker\\\"") != std::string::npos);
+    REQUIRE(json.find("\"name\": \"render tile\", \"cat\": \"apollo\", "
+                      "\"ph\": \"X\", \"pid\": 1, \"tid\": 3, "
+                      "\"ts\": 1.000, \"dur\": 3.000, "
+                      "\"args\": {\"index\": 7}") != std::string::npos);
+    REQUIRE(json.find("\"ts\": 0.000, \"dur\": 0.500}") != std::string::npos);
+}
+
+#if defined(APOLLO_ENABLE_PROFILER)
+TEST_CASE("[profiler] - macros", "[core]")
+{
+    core::reset_profile();
+    {
+        APOLLO_PROFILE_THREAD_NAME("macro thread");
+        APOLLO_PROFILE_ZONE("first");
+        APOLLO_PROFILE_ZONE_ARG("second", 4);
+    }
+
+    auto traces{core::collect_profile()};
+    auto trace = find_trace(traces, "macro thread");
+    REQUIRE(trace != nullptr);
+    REQUIRE(trace->events.size() == 2);
+    REQUIRE(std::string{trace->events[0].name} == "second");
+    REQUIRE(trace->events[0].arg == 4);
+}
+#endif
@@ -0,0 +1,88 @@
+#include <core/quaternion.hpp>
+#include <core/transform.hpp>
+
+#include <catch2/catch.hpp>
+
+namespace
+{
+    template<typename T>
+    bool approx_equal(core::Matrix<T> const& a, core::Matrix<T> const& b)
+    {
+        for (std::size_t i{0}; i < core::Matrix<T>::size; ++i)
+        {
+            if (std::abs(a.data[i] - b.data[i]) > T{1e-5})
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+} // namespace
+
+TEMPLATE_TEST_CASE("[Quaternion] - matrix conversions", "[core]", float, double)
+{
+    using Vector = core::Vector3<TestType>;
+
+    SECTION("Identity")
+    {
+        core::Quaternion<TestType> q;
+        REQUIRE(core::is_identity(q.to_matrix()));
+        REQUIRE(core::Quaternion<TestType>{core::Matrix<TestType>(TestType{1})}
+                    .w == TestType{1});
+    }
+
+    SECTION("Round trip")
+    {
+        // Covers each branch of the conversion, up to a half turn.
+        for (auto angle : {TestType{0.3}, TestType{2}, TestType{3.14159265}})
+        {
+            for (auto axis : {Vector{TestType{1}, TestType{2}, TestType{3}},
+                              Vector{TestType{1}, TestType{0}, TestType{0}},
+                              Vector{TestType{0}, TestType{-1}, TestType{0}},
+                              Vector{TestType{0}, TestType{0.1}, TestType{1}}})
+            {
+                auto m{core::rotate(angle, axis).m};
+                core::Quaternion<TestType> q{m};
+                REQUIRE(core::dot(q, q) == Approx(TestType{1}));
+                REQUIRE(approx_equal(q.to_matrix(), m));
+            }
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE("[Quaternion] - slerp", "[core]", float, double)
+{
+    using Vector = core::Vector3<TestType>;
+
+    Vector axis{TestType{1}, TestType{1}, TestType{0}};
+    core::Quaternion<TestType> q0;
+    core::Quaternion<TestType> q1{core::rotate(TestType{2}, axis).m};
+
+    SECTION("End points")
+    {
+        REQUIRE(approx_equal(core::slerp(TestType{0}, q0, q1).to_matrix(),
+                             q0.to_matrix()));
+        REQUIRE(approx_equal(core::slerp(TestType{1}, q0, q1).to_matrix(),
+                             q1.to_matrix()));
+    }
+
+    SECTION("Turns at a constant rate")
+    {
+        for (auto t : {TestType{0.25}, TestType{0.5}, TestType{0.8}})
+        {
+            auto q{core::slerp(t, q0, q1)};
+            REQUIRE(core::dot(q, q) == Approx(TestType{1}));
+            REQUIRE(approx_equal(q.to_matrix(),
+                                 core::rotate(TestType{2} * t, axis).m));
+        }
+    }
+
+    SECTION("Nearly equal rotations")
+    {
+        core::Quaternion<TestType> q2{
+            core::rotate(TestType{0.01}, axis).m};
+        auto q{core::slerp(TestType{0.5}, q0, q2)};
+        REQUIRE(approx_equal(q.to_matrix(),
+                             core::rotate(TestType{0.005}, axis).m));
+    }
+}
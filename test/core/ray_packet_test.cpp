@@ -0,0 +1,93 @@
+#include <core/ray_packet.hpp>
+
+#include <catch2/catch.hpp>
+#include <limits>
+#include <random>
+
+TEMPLATE_TEST_CASE("[RayPacket] - lanes", "[core]", float, double)
+{
+    using Point  = core::Point3<TestType>;
+    using Vector = core::Vector3<TestType>;
+
+    REQUIRE(core::RayPacket<TestType, 4>::full_mask() == 0xF);
+    REQUIRE(core::RayPacket<TestType, 32>::full_mask() == 0xFFFFFFFF);
+    REQUIRE(core::lane_bits<4>() == std::array<std::uint32_t, 4>{1, 2, 4, 8});
+
+    core::RayPacket<TestType, 4> packet;
+    core::Ray<TestType> ray{Point{TestType{1}, TestType{2}, TestType{3}},
+                            Vector{TestType{2}, TestType{-4}, TestType{1}}};
+    packet.set(2, ray);
+
+    REQUIRE(packet.ray(2).o == ray.o);
+    REQUIRE(packet.ray(2).d == ray.d);
+    REQUIRE(packet.inv_dir(2) ==
+            Vector{TestType{0.5}, TestType{-0.25}, TestType{1}});
+    REQUIRE(packet.ray(0).o == Point{TestType{0}});
+}
+
+TEMPLATE_TEST_CASE("[RayPacket] - intersect_p", "[core]", float, double)
+{
+    using Point  = core::Point3<TestType>;
+    using Vector = core::Vector3<TestType>;
+    constexpr std::size_t N{8};
+    constexpr auto inf{std::numeric_limits<TestType>::infinity()};
+
+    std::mt19937 engine{5};
+    std::uniform_real_distribution<TestType> dist{-1, 1};
+    std::uniform_real_distribution<TestType> dir{0.1f, 1};
+
+    // Every lane points into the positive octant.
+    core::RayPacket<TestType, N> packet;
+    for (std::size_t lane{0}; lane < N; ++lane)
+    {
+        packet.set(lane,
+                   core::Ray<TestType>{
+                       Point{dist(engine), dist(engine), dist(engine)} *
+                           TestType{4},
+                       Vector{dir(engine), dir(engine), dir(engine)}});
+    }
+
+    auto mask{packet.full_mask() & ~std::uint32_t{2}};
+    auto interval{core::packet_interval(packet, mask)};
+    REQUIRE(interval.valid);
+    REQUIRE(interval.dir_is_neg == std::array<int, 3>{0, 0, 0});
+
+    std::array<TestType, N> t_max;
+    t_max.fill(inf);
+    for (std::size_t i{0}; i < 200; ++i)
+    {
+        auto p = Point{dist(engine), dist(engine), dist(engine)} * TestType{8};
+        core::Bounds3<TestType> b{p, p + Vector{TestType{1}}};
+
+        std::uint32_t expected{0};
+        for (std::size_t lane{0}; lane < N; ++lane)
+        {
+            if ((mask & (1u << lane)) != 0 &&
+                core::intersect_p(
+                    b, packet.ray(lane), packet.inv_dir(lane), {0, 0, 0}, inf))
+            {
+                expected |= 1u << lane;
+            }
+        }
+
+        REQUIRE(core::intersect_p(b, packet, mask, {0, 0, 0}, t_max) ==
+                expected);
+
+        // The interval test never rejects a box that some lane hits.
+        if (expected != 0)
+        {
+            REQUIRE(core::intersect_p(b, interval, inf));
+        }
+    }
+
+    SECTION("Mixed directions have no interval")
+    {
+        packet.set(3,
+                   core::Ray<TestType>{Point{TestType{0}},
+                                       Vector{TestType{-1}, TestType{1},
+                                              TestType{1}}});
+        REQUIRE_FALSE(core::packet_interval(packet, mask).valid);
+        REQUIRE(core::packet_interval(packet, mask & ~8u).valid);
+        REQUIRE_FALSE(core::packet_interval(packet, 0).valid);
+    }
+}
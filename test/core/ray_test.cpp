@@ -10,6 +10,7 @@ TEMPLATE_TEST_CASE("[Ray] - constructors", "[core]", float, double)
 
         REQUIRE(r.o == core::Point3<TestType>{});
         REQUIRE(r.d == core::Vector3<TestType>{});
+        REQUIRE(r.time == TestType{0});
     }
 
     SECTION("Parametrised constructor")
@@ -20,6 +21,10 @@ TEMPLATE_TEST_CASE("[Ray] - constructors", "[core]", float, double)
 
         REQUIRE(r.o == origin);
         REQUIRE(r.d == dir);
+        REQUIRE(r.time == TestType{0});
+
+        core::Ray<TestType> timed{origin, dir, TestType{0.5}};
+        REQUIRE(timed.time == TestType{0.5});
     }
 }
 
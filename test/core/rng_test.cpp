@@ -0,0 +1,145 @@
+#include <core/rng.hpp>
+
+#include <catch2/catch.hpp>
+#include <thread>
+#include <vector>
+
+TEST_CASE("[rng] - philox_4x32", "[core]")
+{
+    // Known-answer tests from the Random123 distribution.
+    SECTION("Zero counter and key")
+    {
+        auto out = core::philox_4x32({0, 0, 0, 0}, {0, 0});
+        REQUIRE(out == core::PhiloxCounter{
+                           0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8});
+    }
+
+    SECTION("Saturated counter and key")
+    {
+        auto out = core::philox_4x32(
+            {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff},
+            {0xffffffff, 0xffffffff});
+        REQUIRE(out == core::PhiloxCounter{
+                           0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd});
+    }
+
+    SECTION("Digits of pi")
+    {
+        auto out = core::philox_4x32(
+            {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344},
+            {0xa4093822, 0x299f31d0});
+        REQUIRE(out == core::PhiloxCounter{
+                           0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1});
+    }
+}
+
+TEST_CASE("[rng] - philox_4x32_lanes", "[core]")
+{
+    std::array<std::uint32_t, core::philox::lanes> x0, x1, x2, x3;
+    for (std::uint32_t l{0}; l < core::philox::lanes; ++l)
+    {
+        x0[l] = l;
+        x1[l] = 2 * l;
+        x2[l] = 3 * l;
+        x3[l] = 4 * l;
+    }
+
+    core::PhiloxKey key{17, 42};
+    core::philox_4x32_lanes(x0.data(), x1.data(), x2.data(), x3.data(), key);
+
+    for (std::uint32_t l{0}; l < core::philox::lanes; ++l)
+    {
+        auto expected = core::philox_4x32({l, 2 * l, 3 * l, 4 * l}, key);
+        REQUIRE(core::PhiloxCounter{x0[l], x1[l], x2[l], x3[l]} == expected);
+    }
+}
+
+TEMPLATE_TEST_CASE("[CounterRng] - uniform", "[core]", float, double)
+{
+    core::CounterRng rng{1234};
+
+    SECTION("Range")
+    {
+        for (std::uint32_t d{0}; d < 1000; ++d)
+        {
+            auto u = rng.uniform<TestType>(7, 3, d);
+            REQUIRE(u >= TestType{0});
+            REQUIRE(u < TestType{1});
+        }
+    }
+
+    SECTION("Deterministic")
+    {
+        core::CounterRng other{1234};
+        REQUIRE(rng.uniform<TestType>(1, 2, 3) ==
+                other.uniform<TestType>(1, 2, 3));
+    }
+
+    SECTION("Decorrelated inputs")
+    {
+        auto u = rng.uniform<TestType>(1, 2, 3);
+        REQUIRE(u != rng.uniform<TestType>(2, 2, 3));
+        REQUIRE(u != rng.uniform<TestType>(1, 3, 3));
+        REQUIRE(u != rng.uniform<TestType>(1, 2, 4));
+        REQUIRE(u != core::CounterRng{4321}.uniform<TestType>(1, 2, 3));
+    }
+
+    SECTION("Mean")
+    {
+        TestType sum{0};
+        constexpr std::uint32_t n{10000};
+        for (std::uint32_t s{0}; s < n; ++s)
+        {
+            sum += rng.uniform<TestType>(0, s, 0);
+        }
+
+        REQUIRE(sum / n == Approx(0.5).margin(0.02));
+    }
+}
+
+TEMPLATE_TEST_CASE("[CounterRng] - fill_uniform", "[core]", float, double)
+{
+    core::CounterRng rng{99};
+    core::Point2<int> pixel{12, 34};
+
+    // Start and end on odd dimensions so partial blocks are exercised.
+    constexpr std::uint32_t first{3};
+    constexpr std::size_t count{37};
+    std::vector<TestType> values(count);
+    rng.fill_uniform<TestType>(pixel, 5, first, count, values.data());
+
+    for (std::uint32_t i{0}; i < count; ++i)
+    {
+        REQUIRE(values[i] == rng.uniform<TestType>(pixel, 5, first + i));
+    }
+}
+
+TEMPLATE_TEST_CASE(
+    "[CounterRng] - thread independence", "[core]", float, double)
+{
+    core::CounterRng rng{5};
+    constexpr std::size_t count{64};
+
+    std::vector<TestType> serial(count);
+    rng.fill_uniform<TestType>(9, 0, 0, count, serial.data());
+
+    std::vector<TestType> threaded(count);
+    std::vector<std::thread> threads;
+    for (std::size_t t{0}; t < 4; ++t)
+    {
+        threads.emplace_back([&, t]() {
+            for (auto d{t}; d < count; d += 4)
+            {
+                threaded[d] = rng.uniform<TestType>(
+                    9, 0, static_cast<std::uint32_t>(d));
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    REQUIRE(serial == threaded);
+}
@@ -0,0 +1,77 @@
+#include <core/stats.hpp>
+
+#include <catch2/catch.hpp>
+#include <thread>
+#include <vector>
+
+TEST_CASE("[stats] - counters", "[core]")
+{
+    core::reset_stats();
+
+    std::vector<std::thread> threads;
+    for (int t{0}; t < 4; ++t)
+    {
+        threads.emplace_back([]() {
+            for (int i{0}; i < 1000; ++i)
+            {
+                core::increment_stat(core::StatCounter::rays_traced);
+                core::increment_stat(core::StatCounter::bvh_nodes_visited, 3);
+                core::record_path_length(static_cast<std::size_t>(i % 4));
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    // Counters from the main thread are still live when collected.
+    core::increment_stat(core::StatCounter::shadow_rays, 5);
+    core::record_path_length(1000);
+
+    auto report = core::collect_stats();
+#if defined(APOLLO_ENABLE_STATS)
+    REQUIRE(report[core::StatCounter::rays_traced] == 4000);
+    REQUIRE(report[core::StatCounter::bvh_nodes_visited] == 12000);
+    REQUIRE(report[core::StatCounter::shadow_rays] == 5);
+    REQUIRE(report.path_lengths[0] == 1000);
+    REQUIRE(report.path_lengths[3] == 1000);
+    REQUIRE(report.path_lengths.back() == 1);
+#else
+    REQUIRE(report[core::StatCounter::rays_traced] == 0);
+    REQUIRE(report.path_lengths[0] == 0);
+#endif
+
+    core::reset_stats();
+    report = core::collect_stats();
+    REQUIRE(report[core::StatCounter::rays_traced] == 0);
+    REQUIRE(report[core::StatCounter::shadow_rays] == 0);
+}
+
+TEST_CASE("[stats] - reports", "[core]")
+{
+    core::StatsReport report;
+    report.counters[static_cast<std::size_t>(core::StatCounter::samples)] = 64;
+    report.counters[static_cast<std::size_t>(core::StatCounter::pixels)]  = 4;
+    report.path_lengths[2] = 3;
+    report.seconds         = 2.0;
+
+    SECTION("Text")
+    {
+        auto text = core::stats_to_text(report);
+        REQUIRE(text.find("samples_per_pixel") != std::string::npos);
+        REQUIRE(text.find("16") != std::string::npos);
+        REQUIRE(text.find("rays_per_second") != std::string::npos);
+    }
+
+    SECTION("JSON")
+    {
+        auto json = core::stats_to_json(report);
+        REQUIRE(json.front() == '{');
+        REQUIRE(json.back() == '}');
+        REQUIRE(json.find("\"samples\": 64") != std::string::npos);
+        REQUIRE(json.find("\"samples_per_pixel\": 16") != std::string::npos);
+        REQUIRE(json.find("\"path_lengths\": [0, 0, 3") != std::string::npos);
+    }
+}
@@ -0,0 +1,72 @@
+#include <core/thread_pool.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+TEST_CASE("[ThreadPool] - submit", "[core]")
+{
+    std::atomic<int> count{0};
+    std::vector<std::future<int>> results;
+    {
+        core::ThreadPool pool{3};
+        REQUIRE(pool.size() == 3);
+
+        for (int i{0}; i < 100; ++i)
+        {
+            results.push_back(pool.submit([i, &count]() {
+                ++count;
+                return i * i;
+            }));
+        }
+
+        for (int i{0}; i < 100; ++i)
+        {
+            REQUIRE(results[i].get() == i * i);
+        }
+    }
+    REQUIRE(count == 100);
+
+    SECTION("Exceptions")
+    {
+        core::ThreadPool pool{1};
+        auto future =
+            pool.submit([]() -> int { throw std::runtime_error{"failed"}; });
+        REQUIRE_THROWS_AS(future.get(), std::runtime_error);
+    }
+
+    SECTION("Destruction drains the queue")
+    {
+        std::atomic<int> done{0};
+        {
+            core::ThreadPool pool{2};
+            for (int i{0}; i < 50; ++i)
+            {
+                pool.submit([&done]() { ++done; });
+            }
+        }
+        REQUIRE(done == 50);
+    }
+
+    SECTION("Workers start once")
+    {
+        std::mutex mutex;
+        std::vector<std::size_t> started;
+        {
+            core::ThreadPool pool{4, [&](std::size_t index) {
+                                      std::scoped_lock lock{mutex};
+                                      started.push_back(index);
+                                  }};
+            for (int i{0}; i < 50; ++i)
+            {
+                pool.submit([]() {});
+            }
+        }
+
+        std::sort(started.begin(), started.end());
+        REQUIRE(started == std::vector<std::size_t>{0, 1, 2, 3});
+    }
+}
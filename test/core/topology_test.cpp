@@ -0,0 +1,57 @@
+#include <core/topology.hpp>
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <thread>
+
+TEST_CASE("[topology] - numa_nodes", "[core]")
+{
+    auto& nodes = core::numa_nodes();
+    REQUIRE_FALSE(nodes.empty());
+
+    for (auto& node : nodes)
+    {
+        REQUIRE_FALSE(node.cpus.empty());
+    }
+
+    auto current{core::current_numa_node()};
+    REQUIRE(std::any_of(nodes.begin(), nodes.end(), [current](auto& node) {
+        return node.id == current;
+    }));
+}
+
+TEST_CASE("[topology] - numa_node_for_thread", "[core]")
+{
+    auto& nodes = core::numa_nodes();
+    for (std::size_t num_threads : {1, 3, 16, 256})
+    {
+        for (std::size_t i{0}; i < num_threads; ++i)
+        {
+            auto id{core::numa_node_for_thread(i, num_threads)};
+            REQUIRE(std::any_of(nodes.begin(), nodes.end(), [id](auto& node) {
+                return node.id == id;
+            }));
+        }
+    }
+
+    // Threads are assigned in contiguous groups.
+    REQUIRE(core::numa_node_for_thread(0, 8) == nodes.front().id);
+    REQUIRE(core::numa_node_for_thread(7, 8) == nodes.back().id);
+}
+
+TEST_CASE("[topology] - pinning", "[core]")
+{
+    // Pinning may legitimately be refused (e.g. inside a restricted
+    // container), so only check that a pinned thread keeps running on the
+    // node it asked for.
+    std::thread thread{[]() {
+        auto node{core::numa_nodes().front().id};
+        if (core::pin_thread_to_numa_node(node))
+        {
+            REQUIRE(core::current_numa_node() == node);
+        }
+    }};
+    thread.join();
+
+    REQUIRE_FALSE(core::pin_thread_to_numa_node(-1));
+}
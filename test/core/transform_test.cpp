@@ -0,0 +1,121 @@
+#include <core/transform.hpp>
+
+#include <catch2/catch.hpp>
+
+namespace
+{
+    template<typename T>
+    bool approx_equal(core::Vector3<T> const& a, core::Vector3<T> const& b)
+    {
+        return core::length(a - b) < T{1e-4};
+    }
+} // namespace
+
+TEMPLATE_TEST_CASE("[Transform] - factories", "[core]", float, double)
+{
+    using Point  = core::Point3<TestType>;
+    using Vector = core::Vector3<TestType>;
+
+    Point p{TestType{1}, TestType{2}, TestType{3}};
+
+    SECTION("Identity")
+    {
+        core::Transform<TestType> t;
+        REQUIRE(core::is_identity(t));
+        REQUIRE(t.point(p) == p);
+    }
+
+    SECTION("Translate")
+    {
+        auto t =
+            core::translate(Vector{TestType{1}, TestType{0}, TestType{-1}});
+        REQUIRE(t.point(p) == Point{TestType{2}, TestType{2}, TestType{2}});
+        REQUIRE(t.vector(p) == p);
+        REQUIRE(core::inverse(t).point(t.point(p)) == p);
+    }
+
+    SECTION("Scale")
+    {
+        auto t = core::scale(TestType{2}, TestType{2}, TestType{4});
+        REQUIRE(t.point(p) == Point{TestType{2}, TestType{4}, TestType{12}});
+
+        // Normals use the inverse transpose.
+        auto n = t.normal(Vector{TestType{0}, TestType{0}, TestType{1}});
+        REQUIRE(n == Vector{TestType{0}, TestType{0}, TestType{0.25}});
+    }
+
+    SECTION("Rotate")
+    {
+        auto t = core::rotate(TestType{3.14159265358979 / 2},
+                              Vector{TestType{0}, TestType{0}, TestType{1}});
+        REQUIRE(approx_equal(
+            t.vector(Vector{TestType{1}, TestType{0}, TestType{0}}),
+            Vector{TestType{0}, TestType{1}, TestType{0}}));
+        REQUIRE(approx_equal(core::inverse(t).point(t.point(p)), p));
+    }
+}
+
+TEMPLATE_TEST_CASE("[Transform] - composition", "[core]", float, double)
+{
+    using Point  = core::Point3<TestType>;
+    using Vector = core::Vector3<TestType>;
+
+    auto t = core::translate(Vector{TestType{1}, TestType{0}, TestType{0}}) *
+             core::scale(TestType{2}, TestType{2}, TestType{2});
+    Point p{TestType{1}};
+
+    // Scale first, then translate.
+    REQUIRE(t.point(p) == Point{TestType{3}, TestType{2}, TestType{2}});
+    REQUIRE(approx_equal(core::inverse(t).point(t.point(p)), p));
+
+    SECTION("Bounds")
+    {
+        auto b = t.bounds(core::Bounds3<TestType>{Point{TestType{-1}},
+                                                  Point{TestType{1}}});
+        REQUIRE(b.p_min == Point{TestType{-1}, TestType{-2}, TestType{-2}});
+        REQUIRE(b.p_max == Point{TestType{3}, TestType{2}, TestType{2}});
+    }
+
+    SECTION("Ray")
+    {
+        core::Ray<TestType> ray{Point{TestType{0}},
+                                Vector{TestType{1}, TestType{0}, TestType{0}}};
+        auto r = t.ray(ray);
+        REQUIRE(r(TestType{1}) == t.point(ray(TestType{1})));
+    }
+}
+
+TEMPLATE_TEST_CASE("[Transform] - point error bound", "[core]", float, double)
+{
+    using Point  = core::Point3<TestType>;
+    using Vector = core::Vector3<TestType>;
+
+    auto t = core::translate(
+                 Vector{TestType{1000}, TestType{-3}, TestType{7}}) *
+             core::rotate(TestType{0.7},
+                          core::normalise(Vector{
+                              TestType{1}, TestType{2}, TestType{3}})) *
+             core::scale(TestType{3}, TestType{0.5}, TestType{2});
+
+    // The same transform applied in long double stands in for the exact
+    // result.
+    Point p{TestType{0.1}, TestType{-123.25}, TestType{9.7}};
+    Vector error{TestType{0.01}, TestType{0}, TestType{0.02}};
+    Vector out_error;
+    auto out{t.point(p, error, out_error)};
+    REQUIRE(out == t.point(p));
+
+    for (auto corner : {TestType{-1}, TestType{1}})
+    {
+        for (std::size_t i{0}; i < 3; ++i)
+        {
+            long double exact{t.m(i, 3)};
+            for (std::size_t j{0}; j < 3; ++j)
+            {
+                exact += static_cast<long double>(t.m(i, j)) *
+                         (static_cast<long double>(p[j]) + corner * error[j]);
+            }
+            REQUIRE(std::abs(exact - out[i]) <= out_error[i]);
+        }
+    }
+}
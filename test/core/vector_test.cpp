@@ -2,6 +2,7 @@
 #include <core/vector.hpp>
 
 #include <catch2/catch.hpp>
+#include <type_traits>
 
 static constexpr auto N{3};
 
@@ -464,3 +465,13 @@ TEMPLATE_TEST_CASE("[vector] - distance_squared", "[core]", float, double, int)
 
     REQUIRE(d == TestType{d});
 }
+
+TEMPLATE_TEST_CASE("[Vector] - vector_cast", "[core]", float, double, int)
+{
+    core::Vector<TestType, N> v{TestType{-1}, TestType{2}, TestType{3}};
+
+    auto d = core::vector_cast<double>(v);
+    REQUIRE(std::is_same<decltype(d), core::Vector<double, N>>::value);
+    REQUIRE(d == core::Vector<double, N>{-1.0, 2.0, 3.0});
+    REQUIRE(core::vector_cast<TestType>(d) == v);
+}
@@ -0,0 +1,103 @@
+#include <loaders/lua_scene.hpp>
+
+#include <shapes/mesh_instance.hpp>
+
+#include <catch2/catch.hpp>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+
+using loaders::Real;
+
+TEST_CASE("[lua_scene] - load", "[loaders]")
+{
+    std::string mesh_path{"apollo_lua_test.obj"};
+    {
+        std::ofstream file{mesh_path};
+        file << "v -1 -1 0\nv 1 -1 0\nv 0 1 0\nf 1 2 3\n";
+    }
+
+    SECTION("Scene description")
+    {
+        auto scene{loaders::load_lua_scene_from_string(
+            R"(
+                camera{eye = {0, 0, 5}, look_at = {0, 0, 0}, fov = 60,
+                       width = 32, height = 16}
+                local red = material{albedo = {1, 0, 0}}
+                local grey = material{}
+                sphere{center = {0, 0, -20}, radius = 2, material = grey}
+                light{position = {0, 10, 0}, intensity = {50, 50, 50}}
+
+                local tri = mesh{file = "apollo_lua_test.obj", material = red}
+                for i = 0, 3 do
+                    instance{mesh = tri,
+                             transform = translate(0, 0, -2 * i) *
+                                         rotate(90, {0, 0, 1}) * scale(2)}
+                end
+                instance{mesh = mesh "apollo_lua_test.obj",
+                         transform = inverse(matrix{1, 0, 0, 0,
+                                                    0, 1, 0, 0,
+                                                    0, 0, 1, 30,
+                                                    0, 0, 0, 1})}
+            )",
+            ".")};
+
+        REQUIRE(scene.camera().width() == 32);
+        REQUIRE(scene.camera().height() == 16);
+        REQUIRE(scene.lights().size() == 1);
+        REQUIRE(scene.meshes().size() == 2);
+        REQUIRE(scene.shapes().size() == 6);
+        REQUIRE(scene.material(1).albedo == core::Vector3<Real>{1, 0, 0});
+
+        scene.build();
+        auto t_max{std::numeric_limits<Real>::infinity()};
+        shapes::SurfaceInteraction hit;
+        REQUIRE(scene.intersect(
+            core::Ray<Real>{core::Point3<Real>{0, 0, 5},
+                            core::Vector3<Real>{0, 0, -1}},
+            t_max,
+            hit));
+        REQUIRE(t_max == Approx(5));
+        REQUIRE(hit.material == 1);
+    }
+
+    SECTION("Script file")
+    {
+        std::string path{"apollo_lua_test.lua"};
+        {
+            std::ofstream file{path};
+            file << "instance{mesh = mesh 'apollo_lua_test.obj'}\n";
+        }
+
+        auto scene{loaders::load_lua_scene(path)};
+        REQUIRE(scene.shapes().size() == 1);
+        std::remove(path.c_str());
+    }
+
+    SECTION("Errors")
+    {
+        REQUIRE_THROWS_AS(loaders::load_lua_scene_from_string("sphere{}", "."),
+                          std::runtime_error);
+        REQUIRE_THROWS_AS(
+            loaders::load_lua_scene_from_string(
+                "sphere{center = {0, 0}, radius = 1}", "."),
+            std::runtime_error);
+        REQUIRE_THROWS_AS(
+            loaders::load_lua_scene_from_string(
+                "sphere{center = {0, 0, 0}, radius = 1, material = 4}", "."),
+            std::runtime_error);
+        REQUIRE_THROWS_AS(
+            loaders::load_lua_scene_from_string("instance{mesh = 1}", "."),
+            std::runtime_error);
+        REQUIRE_THROWS_AS(
+            loaders::load_lua_scene_from_string("this is not lua", "."),
+            std::runtime_error);
+        REQUIRE_THROWS_AS(loaders::load_lua_scene_from_string(
+                              "instance{mesh = mesh 'missing.obj'}", "."),
+                          std::runtime_error);
+        REQUIRE_THROWS_AS(loaders::load_lua_scene("apollo_missing.lua"),
+                          std::runtime_error);
+    }
+
+    std::remove(mesh_path.c_str());
+}
@@ -0,0 +1,84 @@
+#include <loaders/mesh_pipeline.hpp>
+
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+namespace
+{
+    void write_quad(std::string const& path)
+    {
+        std::ofstream file{path};
+        file << "v -1 -1 0\nv 1 -1 0\nv 1 1 0\nv -1 1 0\nf 1 2 3 4\n";
+    }
+
+    void write_ply_triangle(std::string const& path)
+    {
+        std::ofstream file{path};
+        file << "ply\nformat ascii 1.0\nelement vertex 3\n"
+             << "property float x\nproperty float y\nproperty float z\n"
+             << "element face 1\nproperty list uchar int vertex_indices\n"
+             << "end_header\n0 0 0\n1 0 0\n0 1 0\n3 0 1 2\n";
+    }
+} // namespace
+
+TEST_CASE("[MeshPipeline] - load", "[loaders]")
+{
+    std::string obj_path{"apollo_pipeline_test.obj"};
+    std::string ply_path{"apollo_pipeline_test.ply"};
+    write_quad(obj_path);
+    write_ply_triangle(ply_path);
+
+    loaders::MeshPipelineOptions options;
+    options.num_io_threads = 1;
+    options.num_threads    = 2;
+
+    SECTION("Meshes come out built")
+    {
+        loaders::MeshPipeline pipeline{options};
+        std::vector<std::future<shapes::TriangleMesh>> meshes;
+        for (int i{0}; i < 8; ++i)
+        {
+            meshes.push_back(pipeline.load(
+                i % 2 == 0 ? obj_path : ply_path,
+                static_cast<std::uint32_t>(i)));
+        }
+        pipeline.wait();
+
+        for (std::size_t i{0}; i < meshes.size(); ++i)
+        {
+            auto mesh{meshes[i].get()};
+            REQUIRE(mesh.is_built());
+            REQUIRE(mesh.num_triangles() == (i % 2 == 0 ? 2 : 1));
+        }
+    }
+
+    SECTION("Errors reach the future of their mesh only")
+    {
+        loaders::MeshPipeline pipeline{options};
+        auto missing{pipeline.load("apollo_missing.obj")};
+        auto unsupported{pipeline.load("apollo_pipeline_test.stl")};
+        auto mesh{pipeline.load(obj_path)};
+        pipeline.wait();
+
+        REQUIRE_THROWS_AS(missing.get(), std::runtime_error);
+        REQUIRE_THROWS_AS(unsupported.get(), std::runtime_error);
+        REQUIRE(mesh.get().num_triangles() == 2);
+    }
+
+    SECTION("Meshes still in flight are finished on destruction")
+    {
+        std::future<shapes::TriangleMesh> mesh;
+        {
+            loaders::MeshPipeline pipeline{options};
+            mesh = pipeline.load(obj_path);
+        }
+        REQUIRE(mesh.wait_for(std::chrono::seconds{0}) ==
+                std::future_status::ready);
+    }
+
+    std::remove(obj_path.c_str());
+    std::remove(ply_path.c_str());
+}
@@ -0,0 +1,109 @@
+#include <loaders/obj.hpp>
+
+#include <catch2/catch.hpp>
+#include <cstdio>
+#include <fstream>
+
+using loaders::Real;
+
+namespace
+{
+    void write_file(std::string const& path, std::string const& contents)
+    {
+        std::ofstream file{path};
+        file << contents;
+    }
+} // namespace
+
+TEST_CASE("[obj] - load_obj", "[loaders]")
+{
+    std::string path{"apollo_obj_test.obj"};
+
+    SECTION("Triangles and polygons")
+    {
+        write_file(path,
+                   "# a quad and a triangle\n"
+                   "v 0 0 0\n"
+                   "v 1 0 0\n"
+                   "v 1 1 0\n"
+                   "v 0 1 0\n"
+                   "vt 0 0\n"
+                   "vn 0 0 1\n"
+                   "g quad\n"
+                   "f 1/1/1 2/1/1 3/1/1 4/1/1\n"
+                   "f -4 -3 -1\n");
+
+        auto mesh{loaders::load_obj(path, 2)};
+        REQUIRE(mesh.num_vertices() == 4);
+        REQUIRE(mesh.num_triangles() == 3);
+        REQUIRE(mesh.material() == 2);
+        REQUIRE(std::vector<std::uint32_t>(mesh.indices().begin(),
+                                           mesh.indices().end()) ==
+                std::vector<std::uint32_t>{0, 1, 2, 0, 2, 3, 0, 1, 3});
+        REQUIRE(mesh.position(2) == core::Point3<Real>{1, 1, 0});
+    }
+
+    SECTION("Parallel chunks")
+    {
+        // A strip of quads, with relative indices that reach back across
+        // chunk boundaries.
+        std::string contents{"# strip\r\n"};
+        for (int i{0}; i <= 200; ++i)
+        {
+            contents += "v " + std::to_string(i) + " 0 0\r\nv " +
+                        std::to_string(i) + " 1 +1e0\r\n";
+            if (i > 0)
+            {
+                contents += "f -4 -3 -1 -2\r\n";
+            }
+        }
+        write_file(path, contents);
+
+        loaders::MeshLoadOptions serial;
+        serial.num_threads = 1;
+        auto expected{loaders::load_obj(path, 0, serial)};
+        REQUIRE(expected.num_vertices() == 402);
+        REQUIRE(expected.num_triangles() == 400);
+        REQUIRE(expected.position(401) == core::Point3<Real>{200, 1, 1});
+
+        loaders::MeshLoadOptions parallel;
+        parallel.num_threads    = 4;
+        parallel.min_chunk_size = 64;
+        auto mesh{loaders::load_obj(path, 0, parallel)};
+        REQUIRE(mesh.num_vertices() == expected.num_vertices());
+        REQUIRE(std::vector<std::uint32_t>(mesh.indices().begin(),
+                                           mesh.indices().end()) ==
+                std::vector<std::uint32_t>(expected.indices().begin(),
+                                           expected.indices().end()));
+        for (std::size_t i{0}; i < mesh.num_vertices(); ++i)
+        {
+            REQUIRE(mesh.position(i) == expected.position(i));
+        }
+        REQUIRE(mesh.bounds() == expected.bounds());
+
+        contents += "f 1 2 x\n";
+        write_file(path, contents);
+        REQUIRE_THROWS_AS(loaders::load_obj(path, 0, parallel),
+                          std::runtime_error);
+    }
+
+    SECTION("Out of range index")
+    {
+        write_file(path, "v 0 0 0\nv 1 0 0\nv 1 1 0\nf 1 2 4\n");
+        REQUIRE_THROWS_AS(loaders::load_obj(path), std::runtime_error);
+    }
+
+    SECTION("Malformed vertex")
+    {
+        write_file(path, "v 0 0\n");
+        REQUIRE_THROWS_AS(loaders::load_obj(path), std::runtime_error);
+    }
+
+    SECTION("Missing file")
+    {
+        REQUIRE_THROWS_AS(loaders::load_obj("apollo_missing.obj"),
+                          std::runtime_error);
+    }
+
+    std::remove(path.c_str());
+}
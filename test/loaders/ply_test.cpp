@@ -0,0 +1,234 @@
+#include <loaders/ply.hpp>
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+using loaders::Real;
+
+namespace
+{
+    void write_file(std::string const& path, std::string const& contents)
+    {
+        std::ofstream file{path, std::ios::binary};
+        file << contents;
+    }
+
+    bool is_little_endian()
+    {
+        std::uint16_t value{1};
+        unsigned char first;
+        std::memcpy(&first, &value, 1);
+        return first == 1;
+    }
+
+    // Appends `value` to `out` in the given byte order.
+    template<typename T>
+    void append(std::string& out, T value, bool little_endian = true)
+    {
+        char bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        if (little_endian != is_little_endian())
+        {
+            std::reverse(bytes, bytes + sizeof(T));
+        }
+        out.append(bytes, sizeof(T));
+    }
+
+    std::vector<std::uint32_t> indices(shapes::TriangleMesh const& mesh)
+    {
+        return {mesh.indices().begin(), mesh.indices().end()};
+    }
+} // namespace
+
+TEST_CASE("[ply] - load_ply", "[loaders]")
+{
+    std::string path{"apollo_ply_test.ply"};
+
+    SECTION("ASCII")
+    {
+        write_file(path,
+                   "ply\r\n"
+                   "format ascii 1.0\r\n"
+                   "comment a quad and a triangle\r\n"
+                   "element vertex 4\r\n"
+                   "property float x\r\n"
+                   "property float y\r\n"
+                   "property float z\r\n"
+                   "property uchar red\r\n"
+                   "element face 2\r\n"
+                   "property list uchar int vertex_indices\r\n"
+                   "end_header\r\n"
+                   "0 0 0 255\r\n1 0 0 255\r\n1 1 0 255\r\n0 1 -0.5 255\r\n"
+                   "4 0 1 2 3\r\n3 0 1 3\r\n");
+
+        auto mesh{loaders::load_ply(path, 2)};
+        REQUIRE(mesh.num_vertices() == 4);
+        REQUIRE(mesh.material() == 2);
+        REQUIRE(indices(mesh) ==
+                std::vector<std::uint32_t>{0, 1, 2, 0, 2, 3, 0, 1, 3});
+        REQUIRE(mesh.position(3) == core::Point3<Real>{0, 1, Real{-0.5}});
+    }
+
+    SECTION("Binary triangles")
+    {
+        // Many triangles so the vertices and faces are split into chunks.
+        constexpr std::uint32_t num_triangles{300};
+        for (bool little_endian : {true, false})
+        {
+            std::string contents{
+                std::string{"ply\nformat "} +
+                (little_endian ? "binary_little_endian"
+                               : "binary_big_endian") +
+                " 1.0\n"
+                "element vertex " +
+                std::to_string(3 * num_triangles) +
+                "\n"
+                "property double x\n"
+                "property float y\n"
+                "property short nx\n"
+                "property float z\n"
+                "element face " +
+                std::to_string(num_triangles) +
+                "\n"
+                "property list uchar uint vertex_indices\n"
+                "end_header\n"};
+            for (std::uint32_t i{0}; i < 3 * num_triangles; ++i)
+            {
+                append(contents, static_cast<double>(i), little_endian);
+                append(contents, 1.0f, little_endian);
+                append(contents, std::int16_t{-1}, little_endian);
+                append(contents, -static_cast<float>(i), little_endian);
+            }
+            for (std::uint32_t i{0}; i < num_triangles; ++i)
+            {
+                contents += '\3';
+                for (std::uint32_t k{0}; k < 3; ++k)
+                {
+                    append(contents, 3 * i + 2 - k, little_endian);
+                }
+            }
+            write_file(path, contents);
+
+            loaders::MeshLoadOptions options;
+            options.num_threads    = 3;
+            options.min_chunk_size = 256;
+            auto mesh{loaders::load_ply(path, 0, options)};
+            REQUIRE(mesh.num_vertices() == 3 * num_triangles);
+            REQUIRE(mesh.num_triangles() == num_triangles);
+            REQUIRE(mesh.position(7) == core::Point3<Real>{7, 1, -7});
+            REQUIRE(indices(mesh)[3] == 5);
+            REQUIRE(indices(mesh).back() == 3 * num_triangles - 3);
+            REQUIRE(mesh.bounds().p_max[0] == Real{3 * num_triangles - 1});
+        }
+    }
+
+    SECTION("Binary polygons and other elements")
+    {
+        std::string contents{"ply\n"
+                             "format binary_little_endian 1.0\n"
+                             "element face 2\n"
+                             "property list uchar int vertex_index\n"
+                             "property uchar flags\n"
+                             "element edge 1\n"
+                             "property list uchar int vertices\n"
+                             "element vertex 4\n"
+                             "property float x\n"
+                             "property float y\n"
+                             "property float z\n"
+                             "end_header\n"};
+        contents += '\4';
+        for (std::int32_t index : {0, 1, 2, 3})
+        {
+            append(contents, index);
+        }
+        contents += '\1';
+        contents += '\3';
+        for (std::int32_t index : {3, 2, 1})
+        {
+            append(contents, index);
+        }
+        contents += '\0';
+        contents += '\2';
+        append(contents, std::int32_t{0});
+        append(contents, std::int32_t{1});
+        for (float v : {0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0})
+        {
+            append(contents, v);
+        }
+        write_file(path, contents);
+
+        auto mesh{loaders::load_ply(path)};
+        REQUIRE(mesh.num_vertices() == 4);
+        REQUIRE(indices(mesh) ==
+                std::vector<std::uint32_t>{0, 1, 2, 0, 2, 3, 3, 2, 1});
+        REQUIRE(mesh.position(2) == core::Point3<Real>{1, 1, 0});
+    }
+
+    SECTION("Errors")
+    {
+        std::string header{"ply\n"
+                           "format binary_little_endian 1.0\n"
+                           "element vertex 3\n"
+                           "property float x\n"
+                           "property float y\n"
+                           "property float z\n"
+                           "element face 1\n"
+                           "property list uchar int vertex_indices\n"
+                           "end_header\n"};
+        std::string contents{header};
+        for (int i{0}; i < 9; ++i)
+        {
+            append(contents, 0.0f);
+        }
+        contents += '\3';
+        for (std::int32_t index : {0, 1, 3})
+        {
+            append(contents, index);
+        }
+
+        // Out of range index.
+        write_file(path, contents);
+        REQUIRE_THROWS_AS(loaders::load_ply(path), std::runtime_error);
+
+        // Truncated data.
+        write_file(path, contents.substr(0, contents.size() - 2));
+        REQUIRE_THROWS_AS(loaders::load_ply(path), std::runtime_error);
+
+        // Missing coordinates.
+        write_file(path,
+                   "ply\nformat ascii 1.0\nelement vertex 1\n"
+                   "property float x\nend_header\n0\n");
+        REQUIRE_THROWS_AS(loaders::load_ply(path), std::runtime_error);
+
+        write_file(path, "not a ply file\n");
+        REQUIRE_THROWS_AS(loaders::load_ply(path), std::runtime_error);
+
+        REQUIRE_THROWS_AS(loaders::load_ply("apollo_missing.ply"),
+                          std::runtime_error);
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST_CASE("[mesh_loader] - load_mesh", "[loaders]")
+{
+    write_file("apollo_mesh_test.ply",
+               "ply\nformat ascii 1.0\nelement vertex 3\nproperty float x\n"
+               "property float y\nproperty float z\nelement face 1\n"
+               "property list uchar int vertex_indices\nend_header\n"
+               "0 0 0\n1 0 0\n0 1 0\n3 0 1 2\n");
+    write_file("apollo_mesh_test.OBJ", "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n");
+
+    auto ply{loaders::load_mesh("apollo_mesh_test.ply")};
+    auto obj{loaders::load_mesh("apollo_mesh_test.OBJ")};
+    REQUIRE(indices(ply) == indices(obj));
+    REQUIRE(ply.bounds() == obj.bounds());
+    REQUIRE_THROWS_AS(loaders::load_mesh("apollo_mesh_test.stl"),
+                      std::runtime_error);
+
+    std::remove("apollo_mesh_test.ply");
+    std::remove("apollo_mesh_test.OBJ");
+}
@@ -0,0 +1,88 @@
+#include <loaders/scene_builder.hpp>
+
+#include <shapes/mesh_instance.hpp>
+#include <shapes/sphere.hpp>
+
+#include <catch2/catch.hpp>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+
+using loaders::Real;
+
+namespace
+{
+    void write_triangle(std::string const& path, Real z)
+    {
+        std::ofstream file{path};
+        file << "v -1 -1 " << z << "\nv 1 -1 " << z << "\nv 0 1 " << z
+             << "\nf 1 2 3\n";
+    }
+} // namespace
+
+TEST_CASE("[SceneBuilder] - assets", "[loaders]")
+{
+    std::vector<std::string> paths{"apollo_builder_a.obj",
+                                   "apollo_builder_b.obj"};
+    write_triangle(paths[0], 0);
+    write_triangle(paths[1], -1);
+
+    SECTION("Concurrent loads")
+    {
+        loaders::SceneBuilderOptions options;
+        options.num_threads = 2;
+        loaders::SceneBuilder builder{options};
+        auto red = builder.add_material({core::Vector3<Real>{1, 0, 0}});
+        REQUIRE(builder.num_materials() == 2);
+
+        auto a = builder.request_mesh(paths[0], red);
+        auto b = builder.request_mesh(paths[1]);
+        REQUIRE(builder.request_mesh(paths[0], red) == a);
+        REQUIRE(builder.request_mesh(paths[0]) != a);
+        REQUIRE(builder.num_meshes() == 3);
+
+        builder.add_instance(a);
+        builder.add_instance(
+            a, core::translate(core::Vector3<Real>{0, 0, Real{-10}}));
+        builder.add_instance(b);
+        builder.add_shape(std::make_unique<shapes::Sphere>(
+            core::Point3<Real>{0, 0, -20}, Real{1}, red));
+        REQUIRE_THROWS_AS(builder.add_instance(7), std::runtime_error);
+
+        auto scene{builder.finish()};
+        REQUIRE(builder.num_meshes() == 0);
+        REQUIRE(scene.meshes().size() == 3);
+        REQUIRE(scene.shapes().size() == 4);
+        for (auto& mesh : scene.meshes())
+        {
+            // Meshes are built on the loading threads.
+            REQUIRE(mesh->is_built());
+        }
+
+        scene.build();
+        auto t_max{std::numeric_limits<Real>::infinity()};
+        shapes::SurfaceInteraction hit;
+        REQUIRE(scene.intersect(
+            core::Ray<Real>{core::Point3<Real>{0, 0, 5},
+                            core::Vector3<Real>{0, 0, -1}},
+            t_max,
+            hit));
+        REQUIRE(t_max == Approx(5));
+        REQUIRE(hit.material == red);
+    }
+
+    SECTION("Loading errors")
+    {
+        loaders::SceneBuilderOptions options;
+        options.num_threads = 2;
+        loaders::SceneBuilder builder{options};
+        builder.add_instance(builder.request_mesh(paths[0]));
+        builder.add_instance(builder.request_mesh("apollo_missing.obj"));
+        REQUIRE_THROWS_AS(builder.finish(), std::runtime_error);
+    }
+
+    for (auto& path : paths)
+    {
+        std::remove(path.c_str());
+    }
+}
@@ -0,0 +1,250 @@
+#include <loaders/obj.hpp>
+#include <loaders/scene_cache.hpp>
+
+#include <shapes/mesh_instance.hpp>
+#include <shapes/sphere.hpp>
+
+#include <catch2/catch.hpp>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+using loaders::Real;
+
+namespace
+{
+    void write_file(std::string const& path, std::string const& contents)
+    {
+        std::ofstream file{path, std::ios::binary};
+        file << contents;
+    }
+
+    std::string read_file(std::string const& path)
+    {
+        std::ifstream file{path, std::ios::binary};
+        return {std::istreambuf_iterator<char>{file},
+                std::istreambuf_iterator<char>{}};
+    }
+
+    render::Scene make_scene(std::string const& obj_path)
+    {
+        render::Scene scene;
+        scene.set_camera(render::Camera{core::Point3<Real>{0, 0, 5},
+                                        core::Point3<Real>{0, 0, 0},
+                                        core::Vector3<Real>{0, 1, 0},
+                                        45,
+                                        32,
+                                        16});
+        auto red = scene.add_material({core::Vector3<Real>{1, 0, 0}});
+        scene.add_light({core::Point3<Real>{0, 5, 5},
+                         core::Vector3<Real>{10, 10, 10}});
+
+        auto mesh = scene.add_mesh(loaders::load_obj(obj_path, red));
+        scene.add_shape(std::make_unique<shapes::MeshInstance>(
+            mesh, core::translate(core::Vector3<Real>{-3, 0, 0})));
+        scene.add_shape(std::make_unique<shapes::MeshInstance>(
+            mesh, core::translate(core::Vector3<Real>{3, 0, 0})));
+        scene.add_shape(std::make_unique<shapes::TriangleMesh>(
+            loaders::load_obj(obj_path)));
+        scene.add_shape(std::make_unique<shapes::Sphere>(
+            core::Point3<Real>{0, 3, 0}, Real{1}, red));
+        return scene;
+    }
+
+    void require_same_hits(render::Scene const& expected,
+                           render::Scene const& scene)
+    {
+        for (Real x : {Real{-3}, Real{0}, Real{3}, Real{6}})
+        {
+            for (Real y : {Real{0}, Real{0.25}, Real{3}})
+            {
+                core::Ray<Real> ray{core::Point3<Real>{x, y, 10},
+                                    core::Vector3<Real>{0, 0, -1}};
+
+                Real expected_t{std::numeric_limits<Real>::max()};
+                Real t{std::numeric_limits<Real>::max()};
+                shapes::SurfaceInteraction expected_hit, hit;
+                REQUIRE(scene.intersect(ray, t, hit) ==
+                        expected.intersect(ray, expected_t, expected_hit));
+                REQUIRE(t == expected_t);
+                REQUIRE(hit.material == expected_hit.material);
+            }
+        }
+    }
+} // namespace
+
+TEST_CASE("[scene_cache] - round trip", "[loaders]")
+{
+    std::string obj_path{"apollo_cache_test.obj"};
+    std::string cache_path{"apollo_cache_test.cache"};
+    write_file(obj_path,
+               "v -1 -1 0\nv 1 -1 0\nv 1 1 0\nv -1 1 0\nf 1 2 3 4\n");
+
+    auto expected{make_scene(obj_path)};
+    expected.build();
+
+    SECTION("With hierarchies")
+    {
+        loaders::write_scene_cache(expected, {obj_path}, cache_path);
+
+        auto scene{loaders::load_scene_cache(cache_path)};
+        REQUIRE(scene.has_value());
+        REQUIRE(scene->materials().size() == 2);
+        REQUIRE(scene->lights().size() == 1);
+        REQUIRE(scene->meshes().size() == 1);
+        REQUIRE(scene->shapes().size() == 4);
+        REQUIRE(scene->camera().width() == 32);
+        REQUIRE(scene->camera().height() == 16);
+        REQUIRE(scene->meshes()[0]->is_built());
+        REQUIRE(scene->bvh().nodes().size() == expected.bvh().nodes().size());
+        REQUIRE(scene->num_primitives() == expected.num_primitives());
+        require_same_hits(expected, *scene);
+    }
+
+    SECTION("Without hierarchies")
+    {
+        loaders::SceneCacheOptions options;
+        options.include_bvh = false;
+        loaders::write_scene_cache(
+            make_scene(obj_path), {obj_path}, cache_path, options);
+
+        auto scene{loaders::load_scene_cache(cache_path)};
+        REQUIRE(scene.has_value());
+        REQUIRE(scene->meshes()[0]->is_built());
+        require_same_hits(expected, *scene);
+    }
+
+    SECTION("Paged meshes")
+    {
+        loaders::write_scene_cache(expected, {obj_path}, cache_path);
+
+        // Too small for more than one mesh, so every switch evicts.
+        loaders::SceneCacheLoadOptions options;
+        options.page_budget = 1;
+        auto scene{loaders::load_scene_cache(cache_path, options)};
+        REQUIRE(scene.has_value());
+        REQUIRE(scene->meshes().empty());
+        REQUIRE(scene->shapes().size() == 4);
+        REQUIRE(scene->pager() != nullptr);
+        REQUIRE(scene->pager()->size() == 2);
+        REQUIRE(scene->num_primitives() == expected.num_primitives());
+        require_same_hits(expected, *scene);
+
+        auto stats{scene->pager()->stats()};
+        REQUIRE(stats.misses > 2);
+        REQUIRE(stats.evictions == stats.misses - 1);
+        REQUIRE(stats.resident_meshes == 1);
+    }
+
+    SECTION("Spheres only")
+    {
+        render::Scene spheres;
+        spheres.add_shape(std::make_unique<shapes::Sphere>(
+            core::Point3<Real>{0, 0, 0}, Real{1}, 0));
+        spheres.build();
+        loaders::write_scene_cache(spheres, {}, cache_path);
+
+        auto scene{loaders::load_scene_cache(cache_path)};
+        REQUIRE(scene.has_value());
+        REQUIRE(scene->shapes().size() == 1);
+        REQUIRE(scene->meshes().empty());
+        require_same_hits(spheres, *scene);
+    }
+
+    SECTION("Unbuilt scenes")
+    {
+        REQUIRE_THROWS_AS(loaders::write_scene_cache(
+                              make_scene(obj_path), {obj_path}, cache_path),
+                          std::runtime_error);
+    }
+
+    SECTION("Stale caches")
+    {
+        loaders::write_scene_cache(expected, {obj_path}, cache_path);
+        REQUIRE(loaders::load_scene_cache(cache_path).has_value());
+
+        write_file(obj_path, "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n");
+        REQUIRE_FALSE(loaders::load_scene_cache(cache_path).has_value());
+
+        std::remove(obj_path.c_str());
+        REQUIRE_FALSE(loaders::load_scene_cache(cache_path).has_value());
+    }
+
+    SECTION("Invalid caches")
+    {
+        REQUIRE_FALSE(
+            loaders::load_scene_cache("apollo_missing.cache").has_value());
+
+        loaders::write_scene_cache(expected, {obj_path}, cache_path);
+        auto contents{read_file(cache_path)};
+
+        write_file(cache_path, contents.substr(0, contents.size() / 2));
+        REQUIRE_FALSE(loaders::load_scene_cache(cache_path).has_value());
+
+        // The version follows the 8 byte magic.
+        auto modified{contents};
+        modified[8] = static_cast<char>(loaders::scene_cache_version + 1);
+        write_file(cache_path, modified);
+        REQUIRE_FALSE(loaders::load_scene_cache(cache_path).has_value());
+
+        // Version 1 caches store a camera without the shutter interval.
+        modified    = contents;
+        modified[8] = 1;
+        write_file(cache_path, modified);
+        REQUIRE_FALSE(loaders::load_scene_cache(cache_path).has_value());
+
+        modified    = contents;
+        modified[0] = 'X';
+        write_file(cache_path, modified);
+        REQUIRE_FALSE(loaders::load_scene_cache(cache_path).has_value());
+
+        // A root node whose children or primitives lie past the arrays.
+        auto& nodes = expected.bvh().nodes();
+        auto position{contents.find(
+            std::string{reinterpret_cast<char const*>(nodes.data()),
+                        nodes.size() * sizeof(accelerators::BvhNode)})};
+        REQUIRE(position != std::string::npos);
+        modified = contents;
+        accelerators::BvhNode root{nodes[0]};
+        root.offset = 1000000;
+        std::memcpy(&modified[position], &root, sizeof(root));
+        write_file(cache_path, modified);
+        REQUIRE_FALSE(loaders::load_scene_cache(cache_path).has_value());
+
+        // A mesh that is both placed directly and instanced, which the
+        // writer never produces.
+        render::Scene shared;
+        shared.add_shape(std::make_unique<shapes::TriangleMesh>(
+            loaders::load_obj(obj_path)));
+        auto placed = static_cast<shapes::TriangleMesh const*>(
+            shared.shapes().back().get());
+        shared.add_shape(std::make_unique<shapes::MeshInstance>(
+            std::shared_ptr<shapes::TriangleMesh const>{
+                std::shared_ptr<void>{}, placed},
+            core::translate(core::Vector3<Real>{3, 0, 0})));
+        shared.build();
+        loaders::write_scene_cache(shared, {obj_path}, cache_path);
+        REQUIRE_FALSE(loaders::load_scene_cache(cache_path).has_value());
+    }
+
+    std::remove(obj_path.c_str());
+    std::remove(cache_path.c_str());
+}
+
+TEST_CASE("[scene_cache] - hash_file", "[loaders]")
+{
+    std::string path{"apollo_hash_test.txt"};
+    write_file(path, "apollo");
+    auto hash{loaders::hash_file(path)};
+    REQUIRE(loaders::hash_file(path) == hash);
+
+    write_file(path, "apollo!");
+    REQUIRE(loaders::hash_file(path) != hash);
+
+    write_file(path, "");
+    REQUIRE_NOTHROW(loaders::hash_file(path));
+
+    std::remove(path.c_str());
+    REQUIRE_THROWS_AS(loaders::hash_file(path), std::runtime_error);
+}
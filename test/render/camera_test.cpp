@@ -0,0 +1,52 @@
+#include <render/camera.hpp>
+
+#include <catch2/catch.hpp>
+
+using render::Real;
+
+TEST_CASE("[Camera] - generate_ray", "[render]")
+{
+    render::Camera camera{core::Point3<Real>{Real{0}, Real{0}, Real{5}},
+                          core::Point3<Real>{},
+                          core::Vector3<Real>{Real{0}, Real{1}, Real{0}},
+                          Real{90},
+                          100,
+                          50};
+    REQUIRE(camera.width() == 100);
+    REQUIRE(camera.height() == 50);
+
+    SECTION("Centre of the image looks at the target")
+    {
+        auto ray = camera.generate_ray(Real{50}, Real{25});
+        REQUIRE(ray.o[2] == Real{5});
+        REQUIRE(ray.d[0] == Approx(0).margin(1e-6));
+        REQUIRE(ray.d[1] == Approx(0).margin(1e-6));
+        REQUIRE(ray.d[2] == Approx(-1));
+    }
+
+    SECTION("Raster y points down")
+    {
+        REQUIRE(camera.generate_ray(Real{50}, Real{0}).d[1] > 0);
+        REQUIRE(camera.generate_ray(Real{0}, Real{25}).d[0] < 0);
+    }
+
+    SECTION("Field of view")
+    {
+        // A 90 degree vertical field of view puts the top edge at 45 degrees.
+        auto d = camera.generate_ray(Real{50}, Real{0}).d;
+        REQUIRE(d[1] == Approx(-d[2]));
+    }
+
+    SECTION("Shutter")
+    {
+        REQUIRE_FALSE(camera.has_shutter());
+        REQUIRE(camera.generate_ray(Real{50}, Real{25}).time == Real{0});
+
+        camera.set_shutter(Real{1}, Real{3});
+        REQUIRE(camera.has_shutter());
+        REQUIRE(camera.shutter_time(Real{0}) == Real{1});
+        REQUIRE(camera.shutter_time(Real{0.5}) == Real{2});
+        REQUIRE(camera.generate_ray(Real{50}, Real{25}, Real{2.5}).time ==
+                Real{2.5});
+    }
+}
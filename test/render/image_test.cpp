@@ -0,0 +1,55 @@
+#include <render/image.hpp>
+
+#include <catch2/catch.hpp>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+TEST_CASE("[Image] - access", "[render]")
+{
+    render::Image image{4, 2};
+    REQUIRE(image.width() == 4);
+    REQUIRE(image.height() == 2);
+    REQUIRE(image.pixels().size() == 8);
+
+    image(3, 1) = core::Vector3<float>{1.0f};
+    REQUIRE(image.pixels()[7] == core::Vector3<float>{1.0f});
+}
+
+TEST_CASE("[Image] - write_ppm", "[render]")
+{
+    render::Image image{2, 1};
+    image(0, 0) = core::Vector3<float>{0.0f};
+    image(1, 0) = core::Vector3<float>{2.0f};
+
+    SECTION("Header and clamped values")
+    {
+        std::string path{"apollo_image_test.ppm"};
+        render::write_ppm(image, path);
+
+        std::ifstream file{path, std::ios::binary};
+        std::string magic;
+        std::size_t width, height, max;
+        file >> magic >> width >> height >> max;
+        file.get();
+        REQUIRE(magic == "P6");
+        REQUIRE(width == 2);
+        REQUIRE(height == 1);
+        REQUIRE(max == 255);
+
+        unsigned char bytes[6];
+        file.read(reinterpret_cast<char*>(bytes), 6);
+        REQUIRE(bytes[0] == 0);
+        REQUIRE(bytes[5] == 255);
+
+        file.close();
+        std::remove(path.c_str());
+    }
+
+    SECTION("Unwritable path")
+    {
+        REQUIRE_THROWS_AS(
+            render::write_ppm(image, "missing_directory/image.ppm"),
+            std::runtime_error);
+    }
+}
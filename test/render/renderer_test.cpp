@@ -0,0 +1,172 @@
+#include <render/renderer.hpp>
+
+#include <core/memory_arena.hpp>
+
+#include <shapes/paged_mesh_instance.hpp>
+#include <shapes/sphere.hpp>
+
+#include <catch2/catch.hpp>
+
+using render::Real;
+
+namespace
+{
+    render::Scene make_scene(std::size_t width, std::size_t height)
+    {
+        render::Scene scene;
+        scene.add_shape(std::make_unique<shapes::Sphere>(
+            core::Point3<Real>{}, Real{1}));
+        scene.add_light({core::Point3<Real>{Real{0}, Real{0}, Real{5}},
+                         core::Vector3<Real>{Real{10}}});
+        scene.set_camera(
+            render::Camera{core::Point3<Real>{Real{0}, Real{0}, Real{4}},
+                           core::Point3<Real>{},
+                           core::Vector3<Real>{Real{0}, Real{1}, Real{0}},
+                           Real{45},
+                           width,
+                           height});
+        scene.build();
+        return scene;
+    }
+
+    // Two paged quads, one behind the sphere and one below it, with a
+    // budget that only ever holds one of them.
+    render::Scene make_paged_scene(std::size_t width, std::size_t height)
+    {
+        auto pager = std::make_shared<shapes::GeometryPager>(
+            1, [](std::size_t) {
+                std::vector<core::Point3<Real>> positions{
+                    core::Point3<Real>{Real{-4}, Real{-4}, Real{0}},
+                    core::Point3<Real>{Real{4}, Real{-4}, Real{0}},
+                    core::Point3<Real>{Real{4}, Real{4}, Real{0}},
+                    core::Point3<Real>{Real{-4}, Real{4}, Real{0}}};
+                shapes::TriangleMesh mesh{positions, {0, 1, 2, 0, 2, 3}};
+                mesh.build();
+                return mesh;
+            });
+
+        auto scene{make_scene(width, height)};
+        core::Bounds3<Real> bounds{
+            core::Point3<Real>{Real{-4}, Real{-4}, Real{0}},
+            core::Point3<Real>{Real{4}, Real{4}, Real{0}}};
+        auto behind{
+            core::translate(core::Vector3<Real>{Real{0}, Real{0}, Real{-2}})};
+        auto below{
+            core::translate(core::Vector3<Real>{Real{0}, Real{-1}, Real{0}}) *
+            core::rotate(Real{90},
+                         core::Vector3<Real>{Real{1}, Real{0}, Real{0}})};
+        for (auto& transform : {behind, below})
+        {
+            scene.add_shape(std::make_unique<shapes::PagedMeshInstance>(
+                pager, pager->add(100), bounds, 2, transform));
+        }
+
+        scene.set_pager(pager);
+        scene.build();
+        return scene;
+    }
+} // namespace
+
+TEST_CASE("[Renderer] - make_tiles", "[render]")
+{
+    auto tiles = render::make_tiles(35, 20, 16);
+    REQUIRE(tiles.size() == 6);
+
+    std::size_t area{0};
+    for (auto& tile : tiles)
+    {
+        area += (tile.x1 - tile.x0) * (tile.y1 - tile.y0);
+    }
+    REQUIRE(area == 35 * 20);
+    REQUIRE(tiles.back().x1 == 35);
+    REQUIRE(tiles.back().y1 == 20);
+}
+
+TEST_CASE("[Renderer] - render", "[render]")
+{
+    auto scene{make_scene(32, 24)};
+    render::RenderSettings settings;
+    settings.samples_per_pixel = 2;
+    settings.tile_size         = 8;
+    settings.num_threads       = 3;
+
+    auto result = render::render(scene, settings);
+    REQUIRE(result.image.width() == 32);
+    REQUIRE(result.image.height() == 24);
+    REQUIRE(result.rays >= 32 * 24 * 2);
+
+    SECTION("The sphere is lit and the background is black")
+    {
+        REQUIRE(result.image(16, 12)[0] > 0.0f);
+        REQUIRE(result.image(0, 0)[0] == 0.0f);
+    }
+
+    SECTION("Output does not depend on the thread count")
+    {
+        settings.num_threads = 1;
+        auto single = render::render(scene, settings);
+        REQUIRE(single.image.pixels() == result.image.pixels());
+        REQUIRE(single.rays == result.rays);
+    }
+
+    SECTION("Output does not depend on the packet size")
+    {
+        for (std::size_t size : {1, 2, 8})
+        {
+            settings.packet_size = size;
+            auto packets = render::render(scene, settings);
+            REQUIRE(packets.image.pixels() == result.image.pixels());
+            REQUIRE(packets.rays == result.rays);
+            REQUIRE(packets.shadow_rays == result.shadow_rays);
+        }
+    }
+
+    SECTION("Output does not depend on ray streams")
+    {
+        settings.max_depth = 3;
+        auto direct        = render::render(scene, settings);
+        for (std::size_t size : {1, 100})
+        {
+            settings.stream_size = size;
+            auto streamed        = render::render(scene, settings);
+            REQUIRE(streamed.image.pixels() == direct.image.pixels());
+            REQUIRE(streamed.rays == direct.rays);
+            REQUIRE(streamed.stream.rays > 0);
+            REQUIRE(streamed.stream.batches > 0);
+        }
+        REQUIRE(direct.stream.batches == 0);
+    }
+
+    SECTION("Ray streams reach a steady state in the arena")
+    {
+        settings.max_depth   = 3;
+        settings.num_threads = 1;
+        settings.stream_size = 100;
+        render::render(scene, settings);
+        auto high_water{core::MemoryArena::global_high_water_mark()};
+        REQUIRE(high_water > 0);
+
+        render::render(scene, settings);
+        REQUIRE(core::MemoryArena::global_high_water_mark() == high_water);
+    }
+}
+
+TEST_CASE("[Renderer] - paged geometry", "[render]")
+{
+    render::RenderSettings settings;
+    settings.samples_per_pixel = 2;
+    settings.tile_size         = 8;
+    settings.num_threads       = 3;
+
+    // Paths are suspended while the quads are fetched; with no
+    // suspensions allowed every path loads them itself instead.
+    auto scene{make_paged_scene(32, 24)};
+    auto result = render::render(scene, settings);
+    REQUIRE(scene.pager()->stats().evictions > 0);
+
+    settings.max_suspensions = 0;
+    auto blocking = render::render(make_paged_scene(32, 24), settings);
+    REQUIRE(blocking.image.pixels() == result.image.pixels());
+    REQUIRE(blocking.rays == result.rays);
+    REQUIRE(blocking.shadow_rays == result.shadow_rays);
+}
@@ -0,0 +1,71 @@
+#include <render/scene.hpp>
+
+#include <shapes/mesh_instance.hpp>
+#include <shapes/sphere.hpp>
+
+#include <catch2/catch.hpp>
+#include <limits>
+
+using render::Real;
+
+TEST_CASE("[Scene] - build and intersect", "[render]")
+{
+    render::Scene scene;
+    auto red = scene.add_material({core::Vector3<Real>{Real{1}, 0, 0}});
+    REQUIRE(red == 1);
+
+    scene.add_shape(std::make_unique<shapes::Sphere>(
+        core::Point3<Real>{Real{0}, Real{0}, Real{-5}}, Real{1}, red));
+
+    std::vector<core::Point3<Real>> positions{
+        core::Point3<Real>{Real{-1}, Real{-1}, Real{0}},
+        core::Point3<Real>{Real{1}, Real{-1}, Real{0}},
+        core::Point3<Real>{Real{0}, Real{1}, Real{0}}};
+    auto mesh = scene.add_mesh(shapes::TriangleMesh{positions, {0, 1, 2}});
+    for (int i{0}; i < 3; ++i)
+    {
+        scene.add_shape(std::make_unique<shapes::MeshInstance>(
+            mesh,
+            core::translate(core::Vector3<Real>{
+                Real{0}, Real{0}, static_cast<Real>(-10 - i)})));
+    }
+
+    scene.build();
+    REQUIRE(mesh->is_built());
+    REQUIRE(scene.num_primitives() == 4);
+    REQUIRE(scene.bounds().p_min[2] == Approx(-12));
+
+    core::Ray<Real> ray{core::Point3<Real>{},
+                        core::Vector3<Real>{Real{0}, Real{0}, Real{-1}}};
+    shapes::SurfaceInteraction hit;
+
+    SECTION("Closest hit")
+    {
+        auto t{std::numeric_limits<Real>::infinity()};
+        REQUIRE(scene.intersect(ray, t, hit));
+        REQUIRE(t == Approx(4));
+        REQUIRE(hit.material == red);
+        REQUIRE(scene.material(hit.material).albedo[0] == Real{1});
+    }
+
+    SECTION("Hits beyond t_max are ignored")
+    {
+        auto t{Real{3}};
+        REQUIRE_FALSE(scene.intersect(ray, t, hit));
+    }
+
+    SECTION("Occlusion")
+    {
+        REQUIRE(scene.occluded(ray, Real{4.5}));
+        REQUIRE_FALSE(scene.occluded(ray, Real{3}));
+
+        shapes::RayPacket packet;
+        shapes::PacketDistances t_max{};
+        for (std::size_t lane{0}; lane < 4; ++lane)
+        {
+            packet.set(lane, ray);
+            t_max[lane] = Real{2} + Real{1.5} * static_cast<Real>(lane);
+        }
+        REQUIRE(scene.occluded_packet(packet, 0xf, t_max) == 0xc);
+    }
+}
@@ -0,0 +1,130 @@
+#include <render/wavefront.hpp>
+
+#include <core/memory_arena.hpp>
+
+#include <shapes/mesh_instance.hpp>
+#include <shapes/moving_mesh_instance.hpp>
+#include <shapes/sphere.hpp>
+
+#include <catch2/catch.hpp>
+
+using render::Real;
+
+namespace
+{
+    // A sphere resting on a floor, lit by two lights, so that paths bounce
+    // between surfaces of different materials. With `motion`, the floor
+    // tilts while the shutter is open.
+    render::Scene make_scene(bool motion = false)
+    {
+        render::Scene scene;
+        auto red = scene.add_material(
+            {core::Vector3<Real>{Real{0.8}, Real{0.2}, Real{0.2}}});
+        scene.add_shape(std::make_unique<shapes::Sphere>(
+            core::Point3<Real>{Real{0}, Real{1}, Real{0}}, Real{1}, red));
+
+        std::vector<core::Point3<Real>> positions{
+            core::Point3<Real>{Real{-5}, Real{0}, Real{-5}},
+            core::Point3<Real>{Real{5}, Real{0}, Real{-5}},
+            core::Point3<Real>{Real{5}, Real{0}, Real{5}},
+            core::Point3<Real>{Real{-5}, Real{0}, Real{5}}};
+        auto floor{scene.add_mesh(
+            shapes::TriangleMesh{positions, {0, 2, 1, 0, 3, 2}})};
+        if (motion)
+        {
+            core::AnimatedTransform<Real> tilt{
+                core::Transform<Real>{},
+                Real{0},
+                core::rotate(Real{0.3},
+                             core::Vector3<Real>{Real{1}, Real{0}, Real{0}}),
+                Real{1}};
+            scene.add_shape(
+                std::make_unique<shapes::MovingMeshInstance>(floor, tilt));
+        }
+        else
+        {
+            scene.add_shape(std::make_unique<shapes::MeshInstance>(
+                floor, core::Transform<Real>{}));
+        }
+
+        scene.add_light({core::Point3<Real>{Real{2}, Real{4}, Real{2}},
+                         core::Vector3<Real>{Real{20}}});
+        scene.add_light({core::Point3<Real>{Real{-3}, Real{3}, Real{1}},
+                         core::Vector3<Real>{Real{10}}});
+        scene.set_camera(
+            render::Camera{core::Point3<Real>{Real{0}, Real{2}, Real{6}},
+                           core::Point3<Real>{Real{0}, Real{1}, Real{0}},
+                           core::Vector3<Real>{Real{0}, Real{1}, Real{0}},
+                           Real{45},
+                           24,
+                           18});
+        if (motion)
+        {
+            auto camera{scene.camera()};
+            camera.set_shutter(Real{0}, Real{1});
+            scene.set_camera(camera);
+        }
+        scene.build();
+        return scene;
+    }
+} // namespace
+
+TEST_CASE("[Wavefront] - stage names", "[render]")
+{
+    REQUIRE(render::wavefront_stage_name(render::WavefrontStage::generate) ==
+            "generate");
+    REQUIRE(render::wavefront_stage_name(
+                render::WavefrontStage::accumulate) == "accumulate");
+}
+
+TEST_CASE("[Wavefront] - matches the path integrator", "[render]")
+{
+    auto motion = GENERATE(false, true);
+    auto scene{make_scene(motion)};
+    render::RenderSettings settings;
+    settings.samples_per_pixel = 3;
+    settings.max_depth         = 3;
+    settings.tile_size         = 8;
+    settings.num_threads       = 2;
+    auto expected = render::render(scene, settings);
+
+    settings.integrator     = render::Integrator::wavefront;
+    settings.wavefront_size = 100;
+    for (std::size_t packet_size : {1, 16})
+    {
+        settings.packet_size = packet_size;
+        for (std::size_t threads : {1, 3})
+        {
+            settings.num_threads = threads;
+            auto result          = render::render(scene, settings);
+            REQUIRE(result.image.pixels() == expected.image.pixels());
+            REQUIRE(result.rays == expected.rays);
+            REQUIRE(result.shadow_rays == expected.shadow_rays);
+            REQUIRE(result.stage_seconds.size() ==
+                    render::num_wavefront_stages);
+        }
+    }
+
+    REQUIRE(expected.stage_seconds.empty());
+}
+
+TEST_CASE("[Wavefront] - scratch memory reaches a steady state", "[render]")
+{
+    // On a single thread every stage runs on this one, with its arena.
+    auto scene{make_scene()};
+    render::RenderSettings settings;
+    settings.integrator     = render::Integrator::wavefront;
+    settings.max_depth      = 3;
+    settings.num_threads    = 1;
+    settings.wavefront_size = 100;
+
+    render::render(scene, settings);
+    auto& arena = core::thread_arena();
+    auto reserved{arena.bytes_reserved()};
+    auto high_water{arena.high_water_mark()};
+    REQUIRE(high_water > 0);
+
+    render::render(scene, settings);
+    REQUIRE(arena.bytes_reserved() == reserved);
+    REQUIRE(arena.high_water_mark() == high_water);
+}
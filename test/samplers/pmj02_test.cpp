@@ -0,0 +1,85 @@
+#include <samplers/pmj02_sampler.hpp>
+
+#include <catch2/catch.hpp>
+#include <vector>
+
+namespace
+{
+    bool is_net(samplers::Pmj02Table const& table, std::size_t count)
+    {
+        std::uint32_t log{0};
+        while ((std::size_t{1} << log) < count)
+        {
+            ++log;
+        }
+
+        for (std::uint32_t a{0}; a <= log; ++a)
+        {
+            std::vector<int> counts(count, 0);
+            for (std::size_t i{0}; i < count; ++i)
+            {
+                auto x{core::top_bits(table.x[i], a)};
+                auto y{core::top_bits(table.y[i], log - a)};
+                if (++counts[(x << (log - a)) | y] > 1)
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+} // namespace
+
+TEST_CASE("[pmj02] - generate_pmj02", "[samplers]")
+{
+    auto table = samplers::generate_pmj02(1024, 42);
+    REQUIRE(table.x.size() == 1024);
+    REQUIRE(table.y.size() == 1024);
+
+    for (std::size_t n{1}; n <= 1024; n *= 2)
+    {
+        REQUIRE(is_net(table, n));
+    }
+}
+
+TEST_CASE("[pmj02] - generate_pmj02 is deterministic", "[samplers]")
+{
+    auto a = samplers::generate_pmj02(64, 3);
+    auto b = samplers::generate_pmj02(64, 3);
+
+    REQUIRE(a.x == b.x);
+    REQUIRE(a.y == b.y);
+}
+
+TEST_CASE("[pmj02] - pmj02_table", "[samplers]")
+{
+    for (std::size_t i{0}; i < samplers::pmj02_num_tables; ++i)
+    {
+        auto& table = samplers::pmj02_table(i);
+        REQUIRE(table.x.size() == samplers::pmj02_table_size);
+        REQUIRE(is_net(table, samplers::pmj02_table_size));
+    }
+}
+
+TEMPLATE_TEST_CASE("[Pmj02Sampler] - batches", "[samplers]", float, double)
+{
+    samplers::Pmj02Sampler<TestType> sampler{11};
+    core::Point2<int> pixel{4, 9};
+
+    // Straddle the end of a table to exercise the wrap-around.
+    auto first{static_cast<std::uint32_t>(samplers::pmj02_table_size - 4)};
+    samplers::SampleBatch8<TestType> batch;
+    sampler.get_2d_batch(pixel, first, 2, batch);
+
+    for (std::uint32_t i{0}; i < 8; ++i)
+    {
+        sampler.start_pixel_sample(pixel, first + i, 2);
+        auto p = sampler.get_2d();
+        REQUIRE(batch[i] == p);
+        REQUIRE(p[0] >= TestType{0});
+        REQUIRE(p[0] < TestType{1});
+        REQUIRE(p[1] >= TestType{0});
+        REQUIRE(p[1] < TestType{1});
+    }
+}
@@ -0,0 +1,102 @@
+#include <samplers/sobol_sampler.hpp>
+
+#include <catch2/catch.hpp>
+#include <vector>
+
+namespace
+{
+    template<typename T>
+    bool is_net(std::vector<core::Point2<T>> const& points)
+    {
+        std::size_t log{0};
+        while ((std::size_t{1} << log) < points.size())
+        {
+            ++log;
+        }
+
+        for (std::size_t a{0}; a <= log; ++a)
+        {
+            auto cols{std::size_t{1} << a};
+            auto rows{std::size_t{1} << (log - a)};
+            std::vector<int> counts(points.size(), 0);
+            for (auto const& p : points)
+            {
+                auto i{static_cast<std::size_t>(p[0] * cols)};
+                auto j{static_cast<std::size_t>(p[1] * rows)};
+                if (++counts[i * rows + j] > 1)
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+} // namespace
+
+TEST_CASE("[Sobol] - generator matrices", "[samplers]")
+{
+    REQUIRE(samplers::sobol_sample_0(0) == 0);
+    REQUIRE(samplers::sobol_sample_0(1) == 0x80000000);
+    REQUIRE(samplers::sobol_sample_0(2) == 0x40000000);
+
+    REQUIRE(samplers::sobol_sample_1(0) == 0);
+    REQUIRE(samplers::sobol_sample_1(1) == 0x80000000);
+    REQUIRE(samplers::sobol_sample_1(2) == 0xc0000000);
+    REQUIRE(samplers::sobol_sample_1(3) == 0x40000000);
+}
+
+TEST_CASE("[Sobol] - nested_uniform_scramble", "[samplers]")
+{
+    // An Owen scramble is a bijection that preserves the elementary
+    // intervals, so scrambling every 4-bit value must give a permutation of
+    // the top 4 bits.
+    std::vector<bool> seen(16, false);
+    for (std::uint32_t i{0}; i < 16; ++i)
+    {
+        auto v{samplers::nested_uniform_scramble(i << 28, 0xdeadbeef)};
+        seen[v >> 28] = true;
+    }
+
+    REQUIRE(std::all_of(seen.begin(), seen.end(), [](bool b) { return b; }));
+}
+
+TEMPLATE_TEST_CASE(
+    "[SobolSampler] - stratification", "[samplers]", float, double)
+{
+    samplers::SobolSampler<TestType> sampler{7};
+    core::Point2<int> pixel{3, 5};
+
+    for (std::uint32_t dim : {0u, 2u, 10u})
+    {
+        std::vector<core::Point2<TestType>> points;
+        for (std::uint32_t i{0}; i < 256; ++i)
+        {
+            sampler.start_pixel_sample(pixel, i, dim);
+            auto p = sampler.get_2d();
+            REQUIRE(p[0] >= TestType{0});
+            REQUIRE(p[0] < TestType{1});
+            REQUIRE(p[1] >= TestType{0});
+            REQUIRE(p[1] < TestType{1});
+            points.push_back(p);
+        }
+
+        REQUIRE(is_net(points));
+    }
+}
+
+TEMPLATE_TEST_CASE("[SobolSampler] - batches", "[samplers]", float, double)
+{
+    samplers::SobolSampler<TestType> sampler{7};
+    core::Point2<int> pixel{1, 2};
+
+    samplers::SampleBatch16<TestType> batch;
+    sampler.get_2d_batch(pixel, 16, 4, batch);
+
+    for (std::uint32_t i{0}; i < 16; ++i)
+    {
+        sampler.start_pixel_sample(pixel, 16 + i, 4);
+        auto p = sampler.get_2d();
+        REQUIRE(batch[i] == p);
+    }
+}
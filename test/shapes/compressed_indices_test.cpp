@@ -0,0 +1,71 @@
+#include <shapes/compressed_indices.hpp>
+
+#include <catch2/catch.hpp>
+#include <random>
+#include <stdexcept>
+
+namespace
+{
+    std::vector<std::uint32_t>
+    decode_all(shapes::CompressedIndices const& compressed)
+    {
+        std::vector<std::uint32_t> out;
+        shapes::CompressedIndices::Block block;
+        for (std::size_t b{0}; b < compressed.num_blocks(); ++b)
+        {
+            compressed.decode(b, block);
+            out.insert(out.end(), block.begin(), block.end());
+        }
+
+        out.resize(3 * compressed.num_triangles());
+        return out;
+    }
+} // namespace
+
+TEST_CASE("[CompressedIndices] - round trip", "[shapes]")
+{
+    std::mt19937 engine{7};
+
+    SECTION("Empty")
+    {
+        shapes::CompressedIndices compressed{{}};
+        REQUIRE(compressed.empty());
+        REQUIRE(compressed.num_blocks() == 0);
+    }
+
+    SECTION("Coherent indices")
+    {
+        // Triangles of a strip, whose indices only ever grow slowly.
+        std::vector<std::uint32_t> indices;
+        for (std::uint32_t i{0}; i < 1001; ++i)
+        {
+            indices.insert(indices.end(), {i, i + 1, i + 2});
+        }
+
+        shapes::CompressedIndices compressed{indices};
+        REQUIRE(compressed.num_triangles() == 1001);
+        REQUIRE(decode_all(compressed) == indices);
+        REQUIRE(compressed.size_bytes() < indices.size());
+    }
+
+    SECTION("Arbitrary indices")
+    {
+        std::uniform_int_distribution<std::uint32_t> dist;
+        std::vector<std::uint32_t> indices(3 * 100);
+        for (auto& index : indices)
+        {
+            index = dist(engine);
+        }
+        indices[5] = 0;
+        indices[6] = 0xffffffff;
+
+        shapes::CompressedIndices compressed{indices};
+        REQUIRE(decode_all(compressed) == indices);
+    }
+
+    SECTION("Invalid index count")
+    {
+        REQUIRE_THROWS_AS((shapes::CompressedIndices{{0, 1}}),
+                          std::runtime_error);
+    }
+}
@@ -0,0 +1,147 @@
+#include <shapes/paged_mesh_instance.hpp>
+
+#include <catch2/catch.hpp>
+#include <limits>
+#include <stdexcept>
+
+using shapes::Real;
+
+namespace
+{
+    // A single triangle in the z = 0 plane, offset along x by its id.
+    shapes::TriangleMesh make_triangle(std::size_t id)
+    {
+        auto x{static_cast<Real>(id)};
+        std::vector<core::Point3<Real>> positions{
+            core::Point3<Real>{x - Real{1}, Real{-1}, Real{0}},
+            core::Point3<Real>{x + Real{1}, Real{-1}, Real{0}},
+            core::Point3<Real>{x, Real{1}, Real{0}}};
+        shapes::TriangleMesh mesh{positions, {0, 1, 2}};
+        mesh.build();
+        return mesh;
+    }
+} // namespace
+
+TEST_CASE("[GeometryPager] - paging", "[shapes]")
+{
+    std::vector<std::size_t> loads;
+    shapes::GeometryPager pager{200, [&loads](std::size_t id) {
+                                    loads.push_back(id);
+                                    return make_triangle(id);
+                                }};
+    for (std::size_t i{0}; i < 3; ++i)
+    {
+        REQUIRE(pager.add(100) == i);
+    }
+    REQUIRE(pager.size() == 3);
+    REQUIRE(pager.budget() == 200);
+
+    SECTION("Meshes are loaded once while resident")
+    {
+        auto first{pager.acquire(0)};
+        auto second{pager.acquire(0)};
+        REQUIRE(first == second);
+        REQUIRE(loads == std::vector<std::size_t>{0});
+        REQUIRE(pager.is_resident(0));
+        REQUIRE_FALSE(pager.is_resident(1));
+
+        auto stats{pager.stats()};
+        REQUIRE(stats.misses == 1);
+        REQUIRE(stats.evictions == 0);
+        REQUIRE(stats.resident_meshes == 1);
+        REQUIRE(stats.resident_bytes == 100);
+    }
+
+    SECTION("The least recently used mesh is evicted")
+    {
+        pager.acquire(0);
+        pager.acquire(1);
+        pager.acquire(0);
+        pager.acquire(2);
+
+        REQUIRE(pager.is_resident(0));
+        REQUIRE_FALSE(pager.is_resident(1));
+        REQUIRE(pager.is_resident(2));
+
+        auto stats{pager.stats()};
+        REQUIRE(stats.misses == 3);
+        REQUIRE(stats.evictions == 1);
+        REQUIRE(stats.bytes_loaded == 300);
+        REQUIRE(stats.resident_bytes == 200);
+        REQUIRE(stats.peak_resident_bytes == 200);
+
+        pager.acquire(1);
+        REQUIRE(loads == std::vector<std::size_t>{0, 1, 2, 1});
+        REQUIRE_FALSE(pager.is_resident(0));
+    }
+
+    SECTION("Fetches load in the background")
+    {
+        REQUIRE(pager.try_acquire(1) == nullptr);
+
+        auto generation{pager.generation()};
+        pager.fetch(1);
+        pager.wait(generation);
+        while (!pager.is_resident(1))
+        {
+            generation = pager.generation();
+            pager.wait(generation);
+        }
+
+        REQUIRE(pager.try_acquire(1) != nullptr);
+        REQUIRE(pager.stats().misses == 1);
+        REQUIRE(loads == std::vector<std::size_t>{1});
+    }
+
+    SECTION("Evicted meshes stay valid while held")
+    {
+        auto mesh{pager.acquire(0)};
+        pager.acquire(1);
+        pager.acquire(2);
+        REQUIRE_FALSE(pager.is_resident(0));
+        REQUIRE(mesh->num_triangles() == 1);
+    }
+}
+
+TEST_CASE("[GeometryPager] - loader errors", "[shapes]")
+{
+    shapes::GeometryPager pager{100, [](std::size_t) -> shapes::TriangleMesh {
+                                    throw std::runtime_error{"error: load"};
+                                }};
+    pager.add(10);
+
+    REQUIRE_THROWS_AS(pager.acquire(0), std::runtime_error);
+    REQUIRE_FALSE(pager.is_resident(0));
+    REQUIRE(pager.stats().resident_bytes == 0);
+
+    // Failed fetches still advance the generation so waiters wake up.
+    auto generation{pager.generation()};
+    pager.fetch(0);
+    pager.wait(generation);
+    REQUIRE_FALSE(pager.is_resident(0));
+}
+
+TEST_CASE("[PagedMeshInstance] - intersect", "[shapes]")
+{
+    auto pager = std::make_shared<shapes::GeometryPager>(
+        100, [](std::size_t id) { return make_triangle(id); });
+    auto id{pager->add(10)};
+
+    auto transform =
+        core::translate(core::Vector3<Real>{Real{0}, Real{0}, Real{5}});
+    shapes::PagedMeshInstance instance{
+        pager, id, make_triangle(id).bounds(), 1, transform};
+
+    REQUIRE(instance.bounds().p_min ==
+            core::Point3<Real>{Real{-1}, Real{-1}, Real{5}});
+    REQUIRE(instance.num_triangles() == 1);
+    REQUIRE_FALSE(pager->is_resident(id));
+
+    core::Ray<Real> ray{core::Point3<Real>{Real{0}, Real{0}, Real{0}},
+                        core::Vector3<Real>{Real{0}, Real{0}, Real{1}}};
+    auto t{std::numeric_limits<Real>::infinity()};
+    shapes::SurfaceInteraction hit;
+    REQUIRE(instance.intersect(ray, t, hit));
+    REQUIRE(t == Approx(5));
+    REQUIRE(pager->is_resident(id));
+}
@@ -0,0 +1,214 @@
+#include <shapes/mesh_instance.hpp>
+#include <shapes/moving_mesh_instance.hpp>
+
+#include <catch2/catch.hpp>
+#include <limits>
+
+using shapes::Real;
+
+TEST_CASE("[MeshInstance] - intersect", "[shapes]")
+{
+    std::vector<core::Point3<Real>> positions{
+        core::Point3<Real>{Real{-1}, Real{-1}, Real{0}},
+        core::Point3<Real>{Real{1}, Real{-1}, Real{0}},
+        core::Point3<Real>{Real{0}, Real{1}, Real{0}}};
+    auto mesh = std::make_shared<shapes::TriangleMesh>(
+        positions, std::vector<std::uint32_t>{0, 1, 2});
+    mesh->build();
+
+    auto transform =
+        core::translate(core::Vector3<Real>{Real{0}, Real{0}, Real{5}}) *
+        core::scale(Real{2}, Real{2}, Real{2});
+    shapes::MeshInstance instance{mesh, transform};
+
+    SECTION("Bounds are in world space")
+    {
+        auto b = instance.bounds();
+        REQUIRE(b.p_min == core::Point3<Real>{Real{-2}, Real{-2}, Real{5}});
+        REQUIRE(b.p_max == core::Point3<Real>{Real{2}, Real{2}, Real{5}});
+    }
+
+    SECTION("Hit distance and normal are in world space")
+    {
+        core::Ray<Real> ray{core::Point3<Real>{Real{1.5}, Real{-1.5}, Real{0}},
+                            core::Vector3<Real>{Real{0}, Real{0}, Real{1}}};
+        auto t{std::numeric_limits<Real>::infinity()};
+        shapes::SurfaceInteraction hit;
+        REQUIRE(instance.intersect(ray, t, hit));
+        REQUIRE(t == Approx(5));
+        REQUIRE(hit.point[2] == Approx(5));
+        REQUIRE(core::length(hit.normal) == Approx(1));
+
+        // Outside the scaled triangle, but inside the original one.
+        core::Ray<Real> outside{
+            core::Point3<Real>{Real{-0.9}, Real{1.5}, Real{0}},
+            core::Vector3<Real>{Real{0}, Real{0}, Real{1}}};
+        t = std::numeric_limits<Real>::infinity();
+        REQUIRE_FALSE(instance.intersect(outside, t, hit));
+    }
+
+    SECTION("Packets match single rays")
+    {
+        shapes::RayPacket packet;
+        shapes::PacketDistances t_max;
+        shapes::PacketHits hits;
+        t_max.fill(std::numeric_limits<Real>::infinity());
+        for (std::size_t lane{0}; lane < shapes::max_packet_size; ++lane)
+        {
+            auto x{Real{-2.5} + static_cast<Real>(lane) / Real{3}};
+            packet.set(lane,
+                       core::Ray<Real>{core::Point3<Real>{x, Real{0}, Real{0}},
+                                       core::Vector3<Real>{
+                                           Real{0}, Real{0}, Real{1}}});
+        }
+
+        auto mask{packet.full_mask() & ~std::uint32_t{1 << 8}};
+        auto found = instance.intersect_packet(packet, mask, t_max, hits);
+        REQUIRE(found != 0);
+        REQUIRE(found != mask);
+        for (std::size_t lane{0}; lane < shapes::max_packet_size; ++lane)
+        {
+            auto t{std::numeric_limits<Real>::infinity()};
+            shapes::SurfaceInteraction hit;
+            auto expected = (mask & (1u << lane)) != 0 &&
+                            instance.intersect(packet.ray(lane), t, hit);
+            REQUIRE(((found & (1u << lane)) != 0) == expected);
+            REQUIRE(t_max[lane] == t);
+            if (expected)
+            {
+                REQUIRE(hits[lane].point == hit.point);
+                REQUIRE(hits[lane].normal == hit.normal);
+            }
+        }
+    }
+
+    SECTION("Occlusion matches intersect")
+    {
+        shapes::RayPacket packet;
+        shapes::PacketDistances t_max;
+        std::uint32_t expected{0};
+        for (std::size_t lane{0}; lane < shapes::max_packet_size; ++lane)
+        {
+            auto x{Real{-2.5} + static_cast<Real>(lane) / Real{3}};
+            core::Ray<Real> ray{
+                core::Point3<Real>{x, Real{0}, Real{0}},
+                core::Vector3<Real>{Real{0}, Real{0}, Real{1}}};
+            packet.set(lane, ray);
+
+            // Every other lane stops short of the instance.
+            t_max[lane] = (lane % 2 == 0) ? Real{10} : Real{4};
+            auto t{t_max[lane]};
+            shapes::SurfaceInteraction hit;
+            auto blocked{instance.intersect(ray, t, hit)};
+            REQUIRE(instance.occluded(ray, t_max[lane]) == blocked);
+            expected |= blocked ? (1u << lane) : 0;
+        }
+
+        REQUIRE(expected != 0);
+        REQUIRE(instance.occluded_packet(
+                    packet, packet.full_mask(), t_max) == expected);
+    }
+}
+
+TEST_CASE("[MovingMeshInstance] - intersect", "[shapes]")
+{
+    std::vector<core::Point3<Real>> positions{
+        core::Point3<Real>{Real{-1}, Real{-1}, Real{0}},
+        core::Point3<Real>{Real{1}, Real{-1}, Real{0}},
+        core::Point3<Real>{Real{0}, Real{1}, Real{0}}};
+    auto mesh = std::make_shared<shapes::TriangleMesh>(
+        positions, std::vector<std::uint32_t>{0, 1, 2});
+    mesh->build();
+
+    // Slides along x by 4 while turning a quarter turn about z.
+    auto start{
+        core::translate(core::Vector3<Real>{Real{0}, Real{0}, Real{5}})};
+    auto end{core::translate(core::Vector3<Real>{Real{4}, Real{0}, Real{5}}) *
+             core::rotate(Real{1.5707963},
+                          core::Vector3<Real>{Real{0}, Real{0}, Real{1}})};
+    core::AnimatedTransform<Real> motion{start, Real{0}, end, Real{1}};
+    shapes::MovingMeshInstance instance{mesh, motion};
+
+    auto make_ray = [](Real x, Real time) {
+        return core::Ray<Real>{core::Point3<Real>{x, Real{0}, Real{0}},
+                               core::Vector3<Real>{Real{0}, Real{0}, Real{1}},
+                               time};
+    };
+
+    SECTION("Bounds cover the whole motion")
+    {
+        auto b = instance.bounds();
+        for (auto time : {Real{0}, Real{0.3}, Real{0.5}, Real{1}})
+        {
+            auto t{motion.interpolate(time).bounds(mesh->bounds())};
+            REQUIRE(core::inside(t.p_min, b));
+            REQUIRE(core::inside(t.p_max, b));
+        }
+        REQUIRE(b.p_min[0] == Approx(-1).margin(0.1));
+        REQUIRE(b.p_max[0] == Approx(5).margin(0.1));
+    }
+
+    SECTION("Rays see the instance where it is at their time")
+    {
+        for (auto time : {Real{0}, Real{0.5}, Real{1}})
+        {
+            shapes::MeshInstance still{mesh, motion.interpolate(time)};
+            for (auto x : {Real{0}, Real{2}, Real{3.5}})
+            {
+                auto ray{make_ray(x, time)};
+                auto t{std::numeric_limits<Real>::infinity()};
+                auto t_still{t};
+                shapes::SurfaceInteraction hit, hit_still;
+                auto found{instance.intersect(ray, t, hit)};
+                REQUIRE(found == still.intersect(ray, t_still, hit_still));
+                REQUIRE(instance.occluded(ray, Real{10}) == found);
+                if (found)
+                {
+                    REQUIRE(t == t_still);
+                    REQUIRE(hit.point == hit_still.point);
+                }
+            }
+        }
+
+        REQUIRE(instance.occluded(make_ray(Real{0}, Real{0}), Real{10}));
+        REQUIRE_FALSE(instance.occluded(make_ray(Real{0}, Real{1}), Real{10}));
+    }
+
+    SECTION("Packets match single rays")
+    {
+        // Shared time, then a time per lane.
+        for (bool shared : {true, false})
+        {
+            shapes::RayPacket packet;
+            shapes::PacketDistances t_max;
+            shapes::PacketHits hits;
+            t_max.fill(std::numeric_limits<Real>::infinity());
+            for (std::size_t lane{0}; lane < shapes::max_packet_size; ++lane)
+            {
+                auto x{Real{-1} + static_cast<Real>(lane) / Real{3}};
+                auto time{shared ? Real{0.25}
+                                 : static_cast<Real>(lane) / Real{15}};
+                packet.set(lane, make_ray(x, time));
+            }
+
+            auto mask{packet.full_mask() & ~std::uint32_t{1 << 3}};
+            auto found{instance.intersect_packet(packet, mask, t_max, hits)};
+            auto occluded{instance.occluded_packet(packet, mask, t_max)};
+            REQUIRE(found != 0);
+            REQUIRE(occluded == 0);
+            for (std::size_t lane{0}; lane < shapes::max_packet_size; ++lane)
+            {
+                auto t{std::numeric_limits<Real>::infinity()};
+                shapes::SurfaceInteraction hit;
+                auto expected = (mask & (1u << lane)) != 0 &&
+                                instance.intersect(packet.ray(lane), t, hit);
+                REQUIRE(((found & (1u << lane)) != 0) == expected);
+                REQUIRE(t_max[lane] == t);
+                if (expected)
+                {
+                    REQUIRE(hits[lane].point == hit.point);
+                }
+            }
+        }
+    }
+}
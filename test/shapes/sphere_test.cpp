@@ -0,0 +1,110 @@
+#include <shapes/sphere.hpp>
+
+#include <core/float_error.hpp>
+
+#include <catch2/catch.hpp>
+#include <limits>
+#include <random>
+
+using shapes::Real;
+
+TEST_CASE("[Sphere] - bounds", "[shapes]")
+{
+    shapes::Sphere sphere{core::Point3<Real>{Real{1}, Real{2}, Real{3}},
+                          Real{2}};
+    auto b = sphere.bounds();
+    REQUIRE(b.p_min == core::Point3<Real>{Real{-1}, Real{0}, Real{1}});
+    REQUIRE(b.p_max == core::Point3<Real>{Real{3}, Real{4}, Real{5}});
+}
+
+TEST_CASE("[Sphere] - intersect", "[shapes]")
+{
+    shapes::Sphere sphere{core::Point3<Real>{}, Real{1}, 3};
+    core::Vector3<Real> z{Real{0}, Real{0}, Real{1}};
+    auto inf{std::numeric_limits<Real>::infinity()};
+    shapes::SurfaceInteraction hit;
+
+    SECTION("Hit from outside")
+    {
+        core::Ray<Real> ray{core::Point3<Real>{Real{0}, Real{0}, Real{-5}}, z};
+        auto t{inf};
+        REQUIRE(sphere.intersect(ray, t, hit));
+        REQUIRE(t == Approx(4));
+        REQUIRE(hit.normal[2] == Approx(-1));
+        REQUIRE(hit.material == 3);
+    }
+
+    SECTION("Hit from inside")
+    {
+        core::Ray<Real> ray{core::Point3<Real>{}, z};
+        auto t{inf};
+        REQUIRE(sphere.intersect(ray, t, hit));
+        REQUIRE(t == Approx(1));
+    }
+
+    SECTION("Respects t_max")
+    {
+        core::Ray<Real> ray{core::Point3<Real>{Real{0}, Real{0}, Real{-5}}, z};
+        auto t{Real{3}};
+        REQUIRE_FALSE(sphere.intersect(ray, t, hit));
+        REQUIRE(t == Real{3});
+    }
+
+    SECTION("Miss")
+    {
+        core::Ray<Real> ray{core::Point3<Real>{Real{2}, Real{0}, Real{-5}}, z};
+        auto t{inf};
+        REQUIRE_FALSE(sphere.intersect(ray, t, hit));
+    }
+
+    SECTION("Occlusion")
+    {
+        core::Ray<Real> ray{core::Point3<Real>{Real{0}, Real{0}, Real{-5}}, z};
+        REQUIRE(sphere.occluded(ray, inf));
+        REQUIRE(sphere.occluded(ray, Real{4.5}));
+        REQUIRE_FALSE(sphere.occluded(ray, Real{3}));
+    }
+
+    SECTION("Tangent from the surface")
+    {
+        core::Ray<Real> ray{core::Point3<Real>{Real{1}, Real{0}, Real{0}}, z};
+        auto t{inf};
+        REQUIRE_FALSE(sphere.intersect(ray, t, hit));
+        REQUIRE(t == inf);
+        REQUIRE_FALSE(sphere.occluded(ray, inf));
+    }
+}
+
+TEST_CASE("[Sphere] - rays leaving the surface miss it", "[shapes]")
+{
+    // Far from the origin, where a fixed offset would be lost to rounding.
+    core::Point3<Real> center{Real{-20000}, Real{5000}, Real{12000}};
+    shapes::Sphere sphere{center, Real{300}};
+
+    std::mt19937 engine{3};
+    std::uniform_real_distribution<Real> dist{-1, 1};
+    auto inf{std::numeric_limits<Real>::infinity()};
+    for (std::size_t i{0}; i < 1000; ++i)
+    {
+        core::Vector3<Real> from{dist(engine), dist(engine), dist(engine)};
+        core::Ray<Real> ray{center + from * Real{1000}, -from};
+
+        auto t{inf};
+        shapes::SurfaceInteraction hit;
+        REQUIRE(sphere.intersect(ray, t, hit));
+
+        // Leave outwards, which never meets a sphere again.
+        auto n{hit.normal};
+        auto origin{core::offset_ray_origin(hit.point, hit.error, n)};
+        core::Vector3<Real> d{dist(engine), dist(engine), dist(engine)};
+        if (core::dot(d, n) < 0)
+        {
+            d = -d;
+        }
+
+        core::Ray<Real> leaving{origin, d};
+        t = inf;
+        REQUIRE_FALSE(sphere.intersect(leaving, t, hit));
+        REQUIRE_FALSE(sphere.occluded(leaving, inf));
+    }
+}
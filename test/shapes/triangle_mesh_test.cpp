@@ -0,0 +1,348 @@
+#include <shapes/triangle_mesh.hpp>
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+using shapes::Real;
+
+namespace
+{
+    // Unit quad in the z = 0 plane, split into two triangles.
+    shapes::TriangleMesh make_quad()
+    {
+        std::vector<core::Point3<Real>> positions{
+            core::Point3<Real>{Real{0}, Real{0}, Real{0}},
+            core::Point3<Real>{Real{1}, Real{0}, Real{0}},
+            core::Point3<Real>{Real{1}, Real{1}, Real{0}},
+            core::Point3<Real>{Real{0}, Real{1}, Real{0}}};
+        return shapes::TriangleMesh{positions, {0, 1, 2, 0, 2, 3}, 2};
+    }
+
+    // Bumpy unit square in the y = 0 plane, with its vertices shuffled so
+    // that the indices of neighbouring triangles are far apart.
+    shapes::TriangleMesh make_bumpy_grid(std::uint32_t resolution)
+    {
+        auto row{resolution + 1};
+        std::vector<std::uint32_t> shuffle(row * row);
+        for (std::uint32_t i{0}; i < shuffle.size(); ++i)
+        {
+            shuffle[i] = i;
+        }
+        std::shuffle(shuffle.begin(), shuffle.end(), std::mt19937{3});
+
+        std::vector<core::Point3<Real>> positions(shuffle.size());
+        for (std::uint32_t j{0}; j < row; ++j)
+        {
+            for (std::uint32_t i{0}; i < row; ++i)
+            {
+                auto x{static_cast<Real>(i) / resolution};
+                auto z{static_cast<Real>(j) / resolution};
+                positions[shuffle[j * row + i]] = core::Point3<Real>{
+                    x, Real{0.1} * std::sin(x * 9) * std::cos(z * 7), z};
+            }
+        }
+
+        std::vector<std::uint32_t> indices;
+        for (std::uint32_t j{0}; j < resolution; ++j)
+        {
+            for (std::uint32_t i{0}; i < resolution; ++i)
+            {
+                auto v0{j * row + i};
+                for (auto v : {v0, v0 + row, v0 + 1, v0 + 1, v0 + row,
+                               v0 + row + 1})
+                {
+                    indices.push_back(shuffle[v]);
+                }
+            }
+        }
+
+        return shapes::TriangleMesh{positions, std::move(indices)};
+    }
+} // namespace
+
+TEST_CASE("[TriangleMesh] - construction", "[shapes]")
+{
+    auto mesh{make_quad()};
+    REQUIRE(mesh.num_triangles() == 2);
+    REQUIRE(mesh.num_vertices() == 4);
+    REQUIRE(mesh.bounds().p_max ==
+            core::Point3<Real>{Real{1}, Real{1}, Real{0}});
+    REQUIRE_FALSE(mesh.is_built());
+
+    SECTION("Invalid indices")
+    {
+        std::vector<core::Point3<Real>> positions(3);
+        REQUIRE_THROWS_AS((shapes::TriangleMesh{positions, {0, 1}}),
+                          std::runtime_error);
+        REQUIRE_THROWS_AS((shapes::TriangleMesh{positions, {0, 1, 3}}),
+                          std::runtime_error);
+    }
+}
+
+TEST_CASE("[TriangleMesh] - intersect", "[shapes]")
+{
+    auto mesh{make_quad()};
+    mesh.build();
+    REQUIRE(mesh.is_built());
+
+    core::Vector3<Real> down{Real{0}, Real{0}, Real{-1}};
+    shapes::SurfaceInteraction hit;
+
+    SECTION("Hit")
+    {
+        core::Ray<Real> ray{
+            core::Point3<Real>{Real{0.25}, Real{0.75}, Real{2}}, down};
+        auto t{std::numeric_limits<Real>::infinity()};
+        REQUIRE(mesh.intersect(ray, t, hit));
+        REQUIRE(t == Approx(2));
+        REQUIRE(std::abs(hit.normal[2]) == Approx(1));
+        REQUIRE(hit.material == 2);
+    }
+
+    SECTION("Miss")
+    {
+        core::Ray<Real> ray{
+            core::Point3<Real>{Real{1.5}, Real{0.5}, Real{2}}, down};
+        auto t{std::numeric_limits<Real>::infinity()};
+        REQUIRE_FALSE(mesh.intersect(ray, t, hit));
+    }
+}
+
+TEST_CASE("[TriangleMesh] - intersect_triangle", "[shapes]")
+{
+    core::Point3<Real> p0{}, p1{Real{1}, Real{0}, Real{0}},
+        p2{Real{0}, Real{1}, Real{0}};
+    core::Ray<Real> ray{core::Point3<Real>{Real{0.2}, Real{0.2}, Real{1}},
+                        core::Vector3<Real>{Real{0}, Real{0}, Real{-1}}};
+
+    Real t, b1, b2;
+    REQUIRE(shapes::intersect_triangle(p0, p1, p2, ray, Real{10}, t, b1, b2));
+    REQUIRE(t == Approx(1));
+    REQUIRE(b1 == Approx(0.2));
+    REQUIRE(b2 == Approx(0.2));
+    REQUIRE_FALSE(shapes::intersect_triangle(p0, p1, p2, ray, Real{0.5}, t));
+
+    core::Vector3<Real> error;
+    auto p{shapes::triangle_point(p0, p1, p2, b1, b2, error)};
+    REQUIRE(p[0] == Approx(0.2));
+    REQUIRE(p[1] == Approx(0.2));
+    REQUIRE(p[2] == Real{0});
+    REQUIRE(error[0] > 0);
+
+    // Parallel rays never hit.
+    core::Ray<Real> parallel{core::Point3<Real>{Real{0.2}, Real{0.2}, Real{0}},
+                             core::Vector3<Real>{Real{1}, Real{0}, Real{0}}};
+    REQUIRE_FALSE(
+        shapes::intersect_triangle(p0, p1, p2, parallel, Real{10}, t));
+}
+
+TEST_CASE("[TriangleMesh] - rays leaving a triangle miss it", "[shapes]")
+{
+    // A tilted triangle far from the origin, where a fixed offset would be
+    // lost to rounding.
+    std::vector<core::Point3<Real>> positions{
+        core::Point3<Real>{Real{10000}, Real{-3000}, Real{20000}},
+        core::Point3<Real>{Real{10400}, Real{-2900}, Real{20100}},
+        core::Point3<Real>{Real{10100}, Real{-2600}, Real{19800}}};
+    shapes::TriangleMesh mesh{positions, {0, 1, 2}};
+    mesh.build();
+
+    std::mt19937 engine{5};
+    std::uniform_real_distribution<Real> dist{-1, 1};
+    std::uniform_real_distribution<Real> bary{0, 0.5f};
+    auto inf{std::numeric_limits<Real>::infinity()};
+    std::size_t num_hits{0};
+    for (std::size_t i{0}; i < 1000; ++i)
+    {
+        auto e1{positions[1] - positions[0]};
+        auto e2{positions[2] - positions[0]};
+        auto target{positions[0] + e1 * bary(engine) + e2 * bary(engine)};
+        core::Vector3<Real> from{dist(engine), dist(engine), dist(engine)};
+        core::Ray<Real> ray{target + from * Real{500}, -from};
+
+        auto t{inf};
+        shapes::SurfaceInteraction hit;
+        if (!mesh.intersect(ray, t, hit))
+        {
+            continue;
+        }
+        ++num_hits;
+
+        auto n{hit.normal};
+        if (core::dot(n, ray.d) > 0)
+        {
+            n = -n;
+        }
+
+        auto origin{core::offset_ray_origin(hit.point, hit.error, n)};
+        core::Vector3<Real> d{dist(engine), dist(engine), dist(engine)};
+        if (core::dot(d, n) < 0)
+        {
+            d = -d;
+        }
+
+        core::Ray<Real> leaving{origin, d};
+        t = inf;
+        REQUIRE_FALSE(mesh.intersect(leaving, t, hit));
+        REQUIRE_FALSE(mesh.occluded(leaving, inf));
+    }
+
+    REQUIRE(num_hits > 500);
+}
+
+TEST_CASE("[TriangleMesh] - compress", "[shapes]")
+{
+    auto mesh{make_bumpy_grid(64)};
+    mesh.build();
+    auto compressed{mesh};
+    compressed.compress();
+
+    REQUIRE(compressed.is_compressed());
+    REQUIRE(compressed.num_triangles() == mesh.num_triangles());
+    REQUIRE(compressed.num_vertices() == mesh.num_vertices());
+    REQUIRE(compressed.bounds() == mesh.bounds());
+    REQUIRE(compressed.indices().empty());
+    REQUIRE(compressed.bvh().indices().empty());
+    REQUIRE(compressed.bvh().nodes().size() == mesh.bvh().nodes().size());
+
+    // Only the vertices and indices are compressed.
+    auto node_bytes{mesh.bvh().nodes().size() *
+                    sizeof(accelerators::BvhNode)};
+    REQUIRE((compressed.size_bytes() - node_bytes) * 3 <
+            mesh.size_bytes() - node_bytes);
+
+    SECTION("Hierarchy encloses the quantised triangles")
+    {
+        auto& nodes = compressed.bvh().nodes();
+        for (auto& node : nodes)
+        {
+            for (std::uint32_t i{0}; i < node.count; ++i)
+            {
+                auto b{compressed.triangle_bounds(node.offset + i)};
+                REQUIRE(core::bounds_union(node.bounds, b) == node.bounds);
+            }
+        }
+    }
+
+    SECTION("Hits match the uncompressed mesh")
+    {
+        std::mt19937 engine{9};
+        std::uniform_real_distribution<Real> dist{Real{0.01}, Real{0.99}};
+        core::Vector3<Real> down{Real{0}, Real{-1}, Real{0}};
+        auto inf{std::numeric_limits<Real>::infinity()};
+        for (std::size_t i{0}; i < 1000; ++i)
+        {
+            core::Ray<Real> ray{
+                core::Point3<Real>{dist(engine), Real{1}, dist(engine)}, down};
+            auto t{inf}, t_compressed{inf};
+            shapes::SurfaceInteraction hit, hit_compressed;
+            REQUIRE(mesh.intersect(ray, t, hit));
+            REQUIRE(compressed.intersect(ray, t_compressed, hit_compressed));
+            REQUIRE(t_compressed == Approx(t).margin(1e-4));
+            REQUIRE(core::dot(hit.normal, hit_compressed.normal) > 0.99f);
+            REQUIRE(compressed.occluded(ray, inf));
+        }
+    }
+}
+
+TEST_CASE("[TriangleMesh] - precomputed leaves", "[shapes]")
+{
+    auto mesh{make_bumpy_grid(32)};
+    mesh.build();
+    auto full{mesh};
+    full.precompute_leaves();
+    auto quantised{mesh};
+    quantised.precompute_leaves(shapes::LeafFormat::quantised);
+
+    REQUIRE(full.has_precomputed_leaves());
+    REQUIRE(quantised.has_precomputed_leaves());
+    REQUIRE(full.bvh().indices().empty());
+    REQUIRE(full.num_triangles() == mesh.num_triangles());
+    REQUIRE(full.size_bytes() > mesh.size_bytes());
+    REQUIRE(quantised.size_bytes() < full.size_bytes());
+
+    // Rays from above the grid in every downward direction, some of which
+    // miss it.
+    std::mt19937 engine{5};
+    std::uniform_real_distribution<Real> dist{Real{-0.2}, Real{1.2}};
+    auto random_ray = [&]() {
+        core::Vector3<Real> d{dist(engine) - Real{0.5},
+                              Real{-1},
+                              dist(engine) - Real{0.5}};
+        return core::Ray<Real>{
+            core::Point3<Real>{dist(engine), Real{1}, dist(engine)},
+            core::normalise(d)};
+    };
+    auto inf{std::numeric_limits<Real>::infinity()};
+
+    SECTION("Hits match the indexed mesh")
+    {
+        std::size_t num_hits{0}, num_quantised_hits{0};
+        for (std::size_t i{0}; i < 2000; ++i)
+        {
+            auto ray{random_ray()};
+            auto t{inf}, t_full{inf}, t_quantised{inf};
+            shapes::SurfaceInteraction hit, hit_full, hit_quantised;
+            auto found{mesh.intersect(ray, t, hit)};
+            REQUIRE(full.intersect(ray, t_full, hit_full) == found);
+            REQUIRE(full.occluded(ray, inf) == found);
+            if (!found)
+            {
+                continue;
+            }
+
+            ++num_hits;
+            REQUIRE(t_full == t);
+            REQUIRE(hit_full.point == hit.point);
+            REQUIRE(hit_full.normal == hit.normal);
+
+            // Rays that only graze the mesh may miss the quantised one.
+            if (quantised.intersect(ray, t_quantised, hit_quantised))
+            {
+                ++num_quantised_hits;
+                REQUIRE(t_quantised == Approx(t).margin(1e-3));
+                REQUIRE(quantised.occluded(ray, inf));
+            }
+        }
+
+        REQUIRE(num_hits > 500);
+        REQUIRE(num_quantised_hits > num_hits * 99 / 100);
+    }
+
+    SECTION("Packets match single rays")
+    {
+        for (auto const* shape : {&full, &quantised})
+        {
+            shapes::RayPacket packet;
+            shapes::PacketDistances t_max, t_occluded;
+            shapes::PacketHits hits;
+            t_max.fill(inf);
+            t_occluded.fill(inf);
+            for (std::size_t lane{0}; lane < shapes::max_packet_size; ++lane)
+            {
+                packet.set(lane, random_ray());
+            }
+
+            auto mask{packet.full_mask()};
+            auto found{shape->intersect_packet(packet, mask, t_max, hits)};
+            REQUIRE(shape->occluded_packet(packet, mask, t_occluded) == found);
+            for (std::size_t lane{0}; lane < shapes::max_packet_size; ++lane)
+            {
+                auto t{inf};
+                shapes::SurfaceInteraction hit;
+                auto expected{shape->intersect(packet.ray(lane), t, hit)};
+                REQUIRE(((found & (1u << lane)) != 0) == expected);
+                REQUIRE(t_max[lane] == t);
+                if (expected)
+                {
+                    REQUIRE(hits[lane].point == hit.point);
+                    REQUIRE(hits[lane].normal == hit.normal);
+                }
+            }
+        }
+    }
+}